@@ -21,6 +21,7 @@ typedef struct BlobMetadataArray
 {
 	int count;
 	Oid oids[MAX_BLOB_PER_FETCH];
+	int64_t bytes[MAX_BLOB_PER_FETCH];
 } BlobMetadataArray;
 
 typedef struct BlobMetadataArrayContext
@@ -32,6 +33,47 @@ typedef struct BlobMetadataArrayContext
 
 void parseBlobMetadataArray(void *ctx, PGresult *result);
 
+typedef struct BlobQueueContext
+{
+	CopyDataSpec *specs;
+	uint64_t count;
+	uint64_t bytes;
+} BlobQueueContext;
+
+static bool copydb_fetch_largeobject_metadata(CopyDataSpec *specs,
+											  bool *sizeKnown);
+
+static bool copydb_queue_blob_hook(void *ctx, SourceBlob *blob);
+
+/*
+ * With --large-objects-batch-size, each Large Objects worker uses two
+ * batches: while the target database writes the contents of the previous
+ * batch, the worker fetches the next one from the source database.
+ */
+typedef struct BlobWorkerBatches
+{
+	LargeObjectBatch array[2];
+	LargeObjectBatch *current;
+	LargeObjectBatch *previous;
+	instr_time previousStartTime;
+	LargeObjectWorkerSummary *summary;
+} BlobWorkerBatches;
+
+static bool copydb_blob_worker_copy_oid(CopyDataSpec *specs,
+										PGSQL *src,
+										PGSQL *dst,
+										uint32_t oid,
+										LargeObjectWorkerSummary *summary);
+
+static bool copydb_blob_worker_flush_batch(CopyDataSpec *specs,
+										   PGSQL *src,
+										   PGSQL *dst,
+										   BlobWorkerBatches *batches);
+
+static bool copydb_blob_worker_wait_batch(CopyDataSpec *specs,
+										  PGSQL *dst,
+										  BlobWorkerBatches *batches);
+
 
 /*
  * copydb_start_blob_process starts a process that fetches the large object
@@ -375,8 +417,6 @@ copydb_blob_worker(CopyDataSpec *specs)
 	PGSQL *src = &(specs->sourceSnapshot.pgsql);
 	PGSQL dst = { 0 };
 
-	bool dropIfExists = specs->restoreOptions.dropIfExists;
-
 	/* initialize our connection to the target database */
 	if (!pgsql_init(&dst, specs->connStrings.target_pguri, PGSQL_CONN_TARGET))
 	{
@@ -390,6 +430,31 @@ copydb_blob_worker(CopyDataSpec *specs)
 		return false;
 	}
 
+	LargeObjectWorkerSummary summary = { 0 };
+
+	if (!summary_add_lo_worker(sourceDB, &summary))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	int batchSize = specs->lObjectBatchSize;
+	BlobWorkerBatches batches = { 0 };
+
+	batches.current = &(batches.array[0]);
+	batches.previous = &(batches.array[1]);
+	batches.summary = &summary;
+
+	if (batchSize > 0)
+	{
+		if (!pg_large_object_batch_init(batches.current, batchSize) ||
+			!pg_large_object_batch_init(batches.previous, batchSize))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
 	int errors = 0;
 	bool stop = false;
 
@@ -417,6 +482,18 @@ copydb_blob_worker(CopyDataSpec *specs)
 				stop = true;
 				log_debug("Stop message received by Large Objects worker");
 
+				/* copy the last batch, and wait until the target is done */
+				if (batchSize > 0)
+				{
+					if (!copydb_blob_worker_flush_batch(specs, src, &dst,
+														&batches) ||
+						!copydb_blob_worker_wait_batch(specs, &dst, &batches))
+					{
+						/* errors have already been logged */
+						return false;
+					}
+				}
+
 				if (!pgsql_commit(&dst))
 				{
 					/* errors have already been logged */
@@ -428,37 +505,56 @@ copydb_blob_worker(CopyDataSpec *specs)
 
 			case QMSG_TYPE_BLOBOID:
 			{
-				uint64_t bytesTransmitted = 0;
-
-				instr_time startTime;
-				INSTR_TIME_SET_CURRENT(startTime);
+				if (batchSize == 0)
+				{
+					if (!copydb_blob_worker_copy_oid(specs, src, &dst,
+													 mesg.data.lo.oid,
+													 &summary))
+					{
+						/* errors have already been logged */
+						return false;
+					}
+
+					break;
+				}
 
-				if (!pg_copy_large_object(src, &dst,
-										  dropIfExists,
-										  mesg.data.oid,
-										  &bytesTransmitted))
+				/*
+				 * Large objects that are known to be too big for a batch are
+				 * streamed right away, rather than fetched partially with the
+				 * batch first. The target connection must be idle though.
+				 */
+				if (mesg.data.lo.bytes > LARGE_OBJECT_BATCH_MAX_BYTES)
 				{
-					log_error("Failed to copy Large Object with oid %u, "
-							  "see above for details",
-							  mesg.data.oid);
-					return false;
+					if (!copydb_blob_worker_wait_batch(specs, &dst, &batches) ||
+						!copydb_blob_worker_copy_oid(specs, src, &dst,
+													 mesg.data.lo.oid,
+													 &summary))
+					{
+						/* errors have already been logged */
+						return false;
+					}
+
+					break;
 				}
 
-				instr_time duration;
+				LargeObjectBatch *batch = batches.current;
 
-				INSTR_TIME_SET_CURRENT(duration);
-				INSTR_TIME_SUBTRACT(duration, startTime);
+				batch->oids[batch->count++] = mesg.data.lo.oid;
 
-				uint64_t durationMs = INSTR_TIME_GET_MILLISEC(duration);
+				if (mesg.data.lo.bytes > 0)
+				{
+					batch->estBytes += mesg.data.lo.bytes;
+				}
 
-				if (!summary_increment_timing(sourceDB,
-											  TIMING_SECTION_LARGE_OBJECTS,
-											  1, /* count */
-											  bytesTransmitted,
-											  durationMs))
+				if (batch->count == batch->size ||
+					batch->estBytes >= LARGE_OBJECT_BATCH_MAX_TOTAL_BYTES)
 				{
-					/* errors have already been logged */
-					return false;
+					if (!copydb_blob_worker_flush_batch(specs, src, &dst,
+														&batches))
+					{
+						/* errors have already been logged */
+						return false;
+					}
 				}
 
 				break;
@@ -480,6 +576,18 @@ copydb_blob_worker(CopyDataSpec *specs)
 	(void) copydb_close_snapshot(specs);
 	(void) pgsql_finish(&dst);
 
+	if (batchSize > 0)
+	{
+		(void) pg_large_object_batch_free(&(batches.array[0]));
+		(void) pg_large_object_batch_free(&(batches.array[1]));
+	}
+
+	if (!summary_finish_lo_worker(sourceDB, &summary))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
 	if (!catalog_close(sourceDB))
 	{
 		log_error("Failed to close source catalogs, see above for details");
@@ -500,16 +608,191 @@ copydb_blob_worker(CopyDataSpec *specs)
 }
 
 
+/*
+ * copydb_blob_worker_copy_oid copies the given large object, streaming its
+ * contents in chunks.
+ */
+static bool
+copydb_blob_worker_copy_oid(CopyDataSpec *specs,
+							PGSQL *src,
+							PGSQL *dst,
+							uint32_t oid,
+							LargeObjectWorkerSummary *summary)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+	bool dropIfExists = specs->restoreOptions.dropIfExists;
+	uint64_t bytesTransmitted = 0;
+
+	instr_time startTime;
+	INSTR_TIME_SET_CURRENT(startTime);
+
+	if (!pg_copy_large_object(src, dst, dropIfExists, oid, &bytesTransmitted))
+	{
+		log_error("Failed to copy Large Object with oid %u, "
+				  "see above for details",
+				  oid);
+		return false;
+	}
+
+	instr_time duration;
+
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, startTime);
+
+	uint64_t durationMs = INSTR_TIME_GET_MILLISEC(duration);
+
+	if (!summary_increment_timing(sourceDB,
+								  TIMING_SECTION_LARGE_OBJECTS,
+								  1, /* count */
+								  bytesTransmitted,
+								  durationMs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	++(summary->count);
+	summary->bytes += bytesTransmitted;
+
+	return true;
+}
+
+
+/*
+ * copydb_blob_worker_flush_batch copies the large objects of the current
+ * batch: their contents are fetched all at once from the source database,
+ * then the large objects that are too big to be copied in a batch are
+ * streamed, and finally the contents of the small ones are sent to the
+ * target database, without waiting for the result.
+ *
+ * While the target database writes the contents of the batch, the worker
+ * goes on with receiving OIDs and fetching the next batch.
+ */
+static bool
+copydb_blob_worker_flush_batch(CopyDataSpec *specs,
+							   PGSQL *src,
+							   PGSQL *dst,
+							   BlobWorkerBatches *batches)
+{
+	LargeObjectBatch *batch = batches->current;
+	bool dropIfExists = specs->restoreOptions.dropIfExists;
+
+	if (batch->count == 0)
+	{
+		return true;
+	}
+
+	instr_time startTime;
+	INSTR_TIME_SET_CURRENT(startTime);
+
+	if (!pg_large_object_batch_fetch(src, batch))
+	{
+		log_error("Failed to fetch a batch of %d Large Objects, "
+				  "see above for details",
+				  batch->count);
+		return false;
+	}
+
+	/* the target connection must be idle before we use it again */
+	if (!copydb_blob_worker_wait_batch(specs, dst, batches))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	for (int i = 0; i < batch->largeCount; i++)
+	{
+		if (!copydb_blob_worker_copy_oid(specs, src, dst,
+										 batch->largeOids[i],
+										 batches->summary))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	if (!pg_large_object_batch_send(dst, batch, dropIfExists))
+	{
+		log_error("Failed to copy a batch of %d Large Objects, "
+				  "see above for details",
+				  batch->smallCount);
+		return false;
+	}
+
+	/* swap batches, the current one is now in-flight */
+	batches->current = batches->previous;
+	batches->previous = batch;
+	batches->previousStartTime = startTime;
+
+	return true;
+}
+
+
+/*
+ * copydb_blob_worker_wait_batch waits until the target database is done
+ * with writing the contents of the previous batch, and accounts for it.
+ */
+static bool
+copydb_blob_worker_wait_batch(CopyDataSpec *specs,
+							  PGSQL *dst,
+							  BlobWorkerBatches *batches)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+	LargeObjectBatch *batch = batches->previous;
+
+	if (!batch->sent)
+	{
+		(void) pg_large_object_batch_reset(batch);
+		return true;
+	}
+
+	if (!pg_large_object_batch_wait(dst, batch))
+	{
+		log_error("Failed to copy a batch of %d Large Objects, "
+				  "see above for details",
+				  batch->smallCount);
+		return false;
+	}
+
+	instr_time duration;
+
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, batches->previousStartTime);
+
+	uint64_t durationMs = INSTR_TIME_GET_MILLISEC(duration);
+
+	if (!summary_increment_timing(sourceDB,
+								  TIMING_SECTION_LARGE_OBJECTS,
+								  batch->smallCount,
+								  batch->bytes,
+								  durationMs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	LargeObjectWorkerSummary *summary = batches->summary;
+
+	summary->count += batch->smallCount;
+	summary->bytes += batch->bytes;
+	++(summary->batches);
+
+	(void) pg_large_object_batch_reset(batch);
+
+	return true;
+}
+
+
 /*
  * copydb_add_blob sends a message to the Large Object process queue to process
- * given blob.
+ * given blob, of the given size in bytes, or -1 when unknown.
  */
 bool
-copydb_add_blob(CopyDataSpec *specs, uint32_t oid)
+copydb_add_blob(CopyDataSpec *specs, uint32_t oid, int64_t bytes)
 {
 	QMessage mesg = {
 		.type = QMSG_TYPE_BLOBOID,
-		.data.oid = oid
+		.data.lo = { .oid = oid, .bytes = bytes }
 	};
 
 	log_debug("copydb_add_blob(%d): %u", specs->loQueue.qId, oid);
@@ -557,11 +840,97 @@ copydb_send_lo_stop(CopyDataSpec *specs)
 
 
 /*
- * copydb_fetch_largeobject_metadata fetches large object metadata.
+ * copydb_queue_largeobject_metadata fetches the large objects metadata from
+ * the source database, and then adds the large objects OIDs to the queue,
+ * the ones too big for a batch first, see catalog_iter_s_blob.
  */
 bool
 copydb_queue_largeobject_metadata(CopyDataSpec *specs, uint64_t *count)
 {
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+	bool sizeKnown = false;
+
+	if (!copydb_fetch_largeobject_metadata(specs, &sizeKnown))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	BlobQueueContext context = { .specs = specs, .count = 0, .bytes = 0 };
+
+	if (!catalog_iter_s_blob(sourceDB,
+							 sizeKnown,
+							 &context,
+							 &copydb_queue_blob_hook))
+	{
+		log_error("Failed to queue large objects, see above for details");
+		return false;
+	}
+
+	*count = context.count;
+
+	if (sizeKnown)
+	{
+		char bytesPretty[BUFSIZE] = { 0 };
+
+		(void) pretty_print_bytes(bytesPretty, BUFSIZE, context.bytes);
+
+		log_info("Added %lld large objects to the queue (%s), "
+				 "biggest first",
+				 (long long) *count,
+				 bytesPretty);
+	}
+	else
+	{
+		log_info("Added %lld large objects to the queue", (long long) *count);
+	}
+
+	return true;
+}
+
+
+/*
+ * copydb_queue_blob_hook is an iterator callback function.
+ */
+static bool
+copydb_queue_blob_hook(void *ctx, SourceBlob *blob)
+{
+	BlobQueueContext *context = (BlobQueueContext *) ctx;
+
+	if (!copydb_add_blob(context->specs, blob->oid, blob->bytes))
+	{
+		log_error("Failed to queue Large Object %u, "
+				  "see above for details",
+				  blob->oid);
+		return false;
+	}
+
+	++(context->count);
+
+	if (blob->bytes > 0)
+	{
+		context->bytes += blob->bytes;
+	}
+
+	return true;
+}
+
+
+/*
+ * copydb_fetch_largeobject_metadata fetches the large objects metadata from
+ * the source database and registers it in our catalogs.
+ *
+ * The size of each large object is estimated from its last page number in
+ * pg_largeobject, using the pg_largeobject_loid_pn_index index, which only
+ * costs an index probe per large object. Reading pg_largeobject requires
+ * more privileges than reading pg_largeobject_metadata though: when we are
+ * not granted SELECT on pg_largeobject, the sizes are unknown.
+ */
+static bool
+copydb_fetch_largeobject_metadata(CopyDataSpec *specs, bool *sizeKnown)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+
 	/* make sure that we have our own process local connection */
 	TransactionSnapshot snapshot = { 0 };
 
@@ -583,18 +952,52 @@ copydb_queue_largeobject_metadata(CopyDataSpec *specs, uint64_t *count)
 
 	PGSQL *src = &(specs->sourceSnapshot.pgsql);
 
-	BlobMetadataArrayContext context = { 0 };
-	char *sql =
+	if (!pgsql_has_table_privilege(src,
+								   "pg_catalog.pg_largeobject",
+								   "select",
+								   sizeKnown))
+	{
+		/* errors have already been logged */
+		(void) pgsql_finish(src);
+		return false;
+	}
+
+	if (!*sizeKnown)
+	{
+		log_notice("Permission denied for table pg_largeobject, "
+				   "large objects are queued in OID order");
+	}
+
+	/* large object pages are LOBLKSIZE bytes, which is BLCKSZ / 4 */
+	char *sqlBySize =
+		"DECLARE bloboid CURSOR FOR "
+		"SELECT m.oid, "
+		"       coalesce((select max(l.pageno) + 1 "
+		"                   from pg_largeobject l "
+		"                  where l.loid = m.oid), 0)::bigint "
+		"       * (current_setting('block_size')::integer / 4) "
+		"  FROM pg_largeobject_metadata m "
+		"ORDER BY 1";
+
+	char *sqlByOid =
 		"DECLARE bloboid CURSOR FOR "
-		"SELECT oid FROM pg_largeobject_metadata ORDER BY 1";
+		"SELECT oid, -1 FROM pg_largeobject_metadata ORDER BY 1";
+
+	if (!pgsql_execute(src, *sizeKnown ? sqlBySize : sqlByOid))
+	{
+		/* errors have already been logged */
+		(void) pgsql_finish(src);
+		return false;
+	}
 
-	if (!pgsql_execute(src, sql))
+	if (!catalog_delete_s_blob_all(sourceDB))
 	{
 		/* errors have already been logged */
+		(void) pgsql_finish(src);
 		return false;
 	}
 
-	*count = 0;
+	BlobMetadataArrayContext context = { 0 };
 
 	/* break out of the loop when FETCH returns 0 rows */
 	for (;;)
@@ -619,23 +1022,39 @@ copydb_queue_largeobject_metadata(CopyDataSpec *specs, uint64_t *count)
 			break;
 		}
 
-		log_debug("Queuing %d large objects", context.array.count);
+		log_debug("Registering %d large objects", context.array.count);
 
-		*count += context.array.count;
+		/* one SQLite transaction per FETCH */
+		if (!catalog_begin(sourceDB, false))
+		{
+			/* errors have already been logged */
+			(void) pgsql_finish(src);
+			return false;
+		}
 
 		for (int i = 0; i < context.array.count; i++)
 		{
-			Oid blobOid = context.array.oids[i];
+			SourceBlob blob = {
+				.oid = context.array.oids[i],
+				.bytes = context.array.bytes[i]
+			};
 
-			if (!copydb_add_blob(specs, blobOid))
+			if (!catalog_add_s_blob(sourceDB, &blob))
 			{
-				log_error("Failed to queue Large Object %u, "
+				log_error("Failed to register Large Object %u, "
 						  "see above for details",
-						  blobOid);
+						  blob.oid);
 				(void) pgsql_finish(src);
 				return false;
 			}
 		}
+
+		if (!catalog_commit(sourceDB))
+		{
+			/* errors have already been logged */
+			(void) pgsql_finish(src);
+			return false;
+		}
 	}
 
 	if (!copydb_close_snapshot(specs))
@@ -644,8 +1063,6 @@ copydb_queue_largeobject_metadata(CopyDataSpec *specs, uint64_t *count)
 		return false;
 	}
 
-	log_info("Added %lld large objects to the queue", (long long) *count);
-
 	return true;
 }
 
@@ -659,9 +1076,9 @@ parseBlobMetadataArray(void *ctx, PGresult *result)
 {
 	BlobMetadataArrayContext *context = (BlobMetadataArrayContext *) ctx;
 
-	if (PQnfields(result) != 1)
+	if (PQnfields(result) != 2)
 	{
-		log_error("Query returned %d columns, expected 1", PQnfields(result));
+		log_error("Query returned %d columns, expected 2", PQnfields(result));
 		context->parsedOk = false;
 		return;
 	}
@@ -679,5 +1096,15 @@ parseBlobMetadataArray(void *ctx, PGresult *result)
 			context->parsedOk = false;
 			return;
 		}
+
+		value = PQgetvalue(result, i, 1);
+
+		if (!stringToInt64(value, &(context->array.bytes[i])))
+		{
+			log_error("Invalid large object size \"%s\"", value);
+
+			context->parsedOk = false;
+			return;
+		}
 	}
 }
@@ -67,7 +67,7 @@ static char *sourceDBcreateDDLs[] = {
 	"  restore_list_name text, "
 	"  relpages integer, reltuples integer, "
 	"  exclude_data boolean, "
-	"  part_key text"
+	"  part_key text, parent_oid integer"
 	")",
 
 	"create unique index s_t_qname on s_table(qname)",
@@ -122,6 +122,8 @@ static char *sourceDBcreateDDLs[] = {
 	"  oid integer references s_table(oid), "
 	"  partnum integer, partcount integer, "
 	"  min integer, max integer, count integer, "
+	"  est_rows integer, est_bytes integer, "
+	"  bound integer, step integer, claimed integer, copied integer, "
 	"  primary key(oid, partnum) "
 	")",
 
@@ -134,7 +136,8 @@ static char *sourceDBcreateDDLs[] = {
 	"  oid integer primary key, "
 	"  qname text, nspname text, relname text, restore_list_name text, "
 	"  tableoid references s_table(oid), "
-	"  isprimary bool, isunique bool, columns text, sql text "
+	"  isprimary bool, isunique bool, columns text, sql text, "
+	"  bytes integer, cost integer "
 	")",
 
 	"create unique index s_i_rlname on s_index(restore_list_name)",
@@ -149,7 +152,7 @@ static char *sourceDBcreateDDLs[] = {
 	"  oid integer primary key, conname text, "
 	"  nspname text, relname text, qname text, "
 	"  condeferrable bool, condeferred bool, convalidated bool, "
-	"  constraintdef text "
+	"  constraintdef text, refqname text, relkind integer "
 	")",
 
 	"create table s_seq("
@@ -163,6 +166,8 @@ static char *sourceDBcreateDDLs[] = {
 
 	"create index s_s_rlname on s_seq(restore_list_name)",
 
+	"create table s_blob(oid integer primary key, bytes integer)",
+
 	/* internal activity tracking / completion / statistics */
 	"create table process("
 	"  pid integer primary key, "
@@ -188,6 +193,9 @@ static char *sourceDBcreateDDLs[] = {
 	"  conoid integer references s_constraint(oid), "
 	"  start_time_epoch integer, done_time_epoch integer, duration integer, "
 	"  bytes integer, "
+	"  wire_bytes integer, "
+	"  copy_format text, "
+	"  freeze bool, "
 	"  command text, "
 	"  unique(tableoid, partnum)"
 	")",
@@ -197,6 +205,8 @@ static char *sourceDBcreateDDLs[] = {
 	"  conoid integer references s_fk_constraint(oid), "
 	"  start_time_epoch integer, done_time_epoch integer, duration integer, "
 	"  not_valid bool, "
+	"  validate_start_time_epoch integer, validate_done_time_epoch integer, "
+	"  validate_duration integer, "
 	"  command text, "
 	"  unique(conoid)"
 	")",
@@ -205,6 +215,7 @@ static char *sourceDBcreateDDLs[] = {
 	"  pid integer, "
 	"  tableoid integer references s_table(oid), "
 	"  start_time_epoch integer, done_time_epoch integer, duration integer, "
+	"  action text, "
 	"  unique(tableoid)"
 	")",
 
@@ -212,8 +223,26 @@ static char *sourceDBcreateDDLs[] = {
 	" tableoid integer primary key references s_table(oid), pid integer"
 	")",
 
+	"create table s_table_indexes_early("
+	" tableoid integer primary key references s_table(oid), pid integer"
+	")",
+
+	"create table s_table_unlogged("
+	" tableoid integer primary key references s_table(oid), pid integer, "
+	" unlogged_time_epoch integer, target_start_time_epoch integer, "
+	" logged_start_time_epoch integer, logged_done_time_epoch integer, "
+	" logged_duration integer "
+	")",
+
+	"create table lo_worker_summary("
+	"  pid integer primary key, "
+	"  start_time_epoch integer, done_time_epoch integer, duration integer, "
+	"  count integer, bytes integer, batches integer "
+	")",
+
 	"create table s_table_indexes_done("
-	" tableoid integer primary key references s_table(oid), pid integer "
+	" tableoid integer primary key references s_table(oid), pid integer, "
+	" group_count integer, start_time_epoch integer, done_time_epoch integer "
 	")",
 
 	/* use SQLite more general dynamic type system: pg_lsn is text */
@@ -222,8 +251,14 @@ static char *sourceDBcreateDDLs[] = {
 	"  startpos pg_lsn, endpos pg_lsn, apply bool, "
 	" write_lsn pg_lsn, flush_lsn pg_lsn, replay_lsn pg_lsn)",
 
+	"create table sentinel_apply_worker("
+	"  id integer primary key, origin text, replay_lsn pg_lsn, "
+	"  lag integer, txn_count integer, wait_count integer)",
+
 	"create table timeline_history("
-	"  tli integer primary key, startpos pg_lsn, endpos pg_lsn)"
+	"  tli integer primary key, startpos pg_lsn, endpos pg_lsn)",
+
+	"create table txn_commit_lsn(xid integer primary key, commit_lsn pg_lsn)"
 };
 
 
@@ -287,7 +322,7 @@ static char *filterDBcreateDDLs[] = {
 	"  relpages integer, reltuples integer, "
 	"  exclude_data boolean, "
 	"  srcrowcount integer, srcsum text, dstrowcount integer, dstsum text, "
-	"  part_key text"
+	"  part_key text, parent_oid integer"
 	")",
 
 	"create unique index s_t_qname on s_table(qname)",
@@ -337,6 +372,8 @@ static char *filterDBcreateDDLs[] = {
 	"  oid integer references s_table(oid), "
 	"  partnum integer, partcount integer, "
 	"  min integer, max integer, count integer, "
+	"  est_rows integer, est_bytes integer, "
+	"  bound integer, step integer, claimed integer, copied integer, "
 	"  primary key(oid, partnum) "
 	")",
 
@@ -349,7 +386,8 @@ static char *filterDBcreateDDLs[] = {
 	"  oid integer primary key, "
 	"  qname text, nspname text, relname text, restore_list_name text, "
 	"  tableoid references s_table(oid), "
-	"  isprimary bool, isunique bool, columns text, sql text "
+	"  isprimary bool, isunique bool, columns text, sql text, "
+	"  bytes integer, cost integer "
 	")",
 
 	"create unique index s_i_rlname on s_index(restore_list_name)",
@@ -402,6 +440,8 @@ static char *filterDBcreateDDLs[] = {
 	"  conoid integer references s_constraint(oid), "
 	"  start_time_epoch integer, done_time_epoch integer, duration integer, "
 	"  bytes integer, "
+	"  wire_bytes integer, "
+	"  copy_format text, "
 	"  command text, "
 	"  unique(tableoid, partnum)"
 	")",
@@ -434,7 +474,7 @@ static char *targetDBcreateDDLs[] = {
 	"  relpages integer, reltuples integer, "
 	"  exclude_data boolean, "
 	"  srcrowcount integer, srcsum text, dstrowcount integer, dstsum text, "
-	"  part_key text"
+	"  part_key text, parent_oid integer"
 	")",
 
 	"create unique index s_t_qname on s_table(qname)",
@@ -451,7 +491,8 @@ static char *targetDBcreateDDLs[] = {
 	"  oid integer primary key, "
 	"  qname text, nspname text, relname text, restore_list_name text, "
 	"  tableoid integer references s_table(oid), "
-	"  isprimary bool, isunique bool, columns text, sql text "
+	"  isprimary bool, isunique bool, columns text, sql text, "
+	"  bytes integer, cost integer "
 	")",
 
 	"create unique index s_i_rlname on s_index(restore_list_name)",
@@ -498,6 +539,7 @@ static char *sourceDBdropDDLs[] = {
 	"drop table if exists s_index",
 	"drop table if exists s_constraint",
 	"drop table if exists s_seq",
+	"drop table if exists s_blob",
 	"drop table if exists s_depend",
 
 	"drop table if exists t_roles",
@@ -508,10 +550,15 @@ static char *sourceDBdropDDLs[] = {
 	"drop table if exists process",
 	"drop table if exists summary",
 	"drop table if exists s_table_parts_done",
+	"drop table if exists s_table_indexes_early",
+	"drop table if exists s_table_unlogged",
+	"drop table if exists lo_worker_summary",
 	"drop table if exists s_table_indexes_done",
 
 	"drop table if exists sentinel",
-	"drop table if exists timeline_history"
+	"drop table if exists sentinel_apply_worker",
+	"drop table if exists timeline_history",
+	"drop table if exists txn_commit_lsn"
 };
 
 
@@ -3169,8 +3216,9 @@ catalog_add_s_table_part(DatabaseCatalog *catalog, SourceTable *table)
 	}
 
 	char *sql =
-		"insert into s_table_part(oid, partnum, partcount, min, max, count)"
-		"values($1, $2, $3, $4, $5, $6)";
+		"insert into s_table_part(oid, partnum, partcount, min, max, count, "
+		"                         est_rows, est_bytes)"
+		"values($1, $2, $3, $4, $5, $6, $7, $8)";
 
 	SQLiteQuery query = { 0 };
 
@@ -3189,6 +3237,8 @@ catalog_add_s_table_part(DatabaseCatalog *catalog, SourceTable *table)
 		{ BIND_PARAMETER_TYPE_INT64, "min", part->min, NULL },
 		{ BIND_PARAMETER_TYPE_INT64, "max", part->max, NULL },
 		{ BIND_PARAMETER_TYPE_INT64, "count", part->count, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "est_rows", part->estRows, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "est_bytes", part->estBytes, NULL },
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -3211,49 +3261,106 @@ catalog_add_s_table_part(DatabaseCatalog *catalog, SourceTable *table)
 
 
 /*
- * catalog_add_s_table INSERTs a SourceTable to our internal catalogs database.
+ * catalog_s_table_part_execute executes a statement that returns no rows on
+ * s_table_part, to be called with the catalog semaphore held.
  */
-bool
-catalog_add_s_table_chksum(DatabaseCatalog *catalog,
-						   SourceTable *table,
-						   TableChecksum *srcChk,
-						   TableChecksum *dstChk)
+static bool
+catalog_s_table_part_execute(sqlite3 *db,
+							 char *sql,
+							 BindParam *params,
+							 int count)
 {
-	sqlite3 *db = catalog->db;
+	SQLiteQuery query = { 0 };
 
-	if (db == NULL)
+	if (!catalog_sql_prepare(db, sql, &query))
 	{
-		log_error("BUG: catalog_add_s_table_chksum: db is NULL");
+		/* errors have already been logged */
 		return false;
 	}
 
-	char *sql =
-		"insert into s_table_chksum("
-		"  oid, srcrowcount, srcsum, dstrowcount, dstsum)"
-		"values($1, $2, $3, $4, $5)";
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		return false;
+	}
 
-	if (!semaphore_lock(&(catalog->sema)))
+	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	SQLiteQuery query = { 0 };
+	return true;
+}
+
+
+/*
+ * catalog_s_table_part_progress_fetch fetches a table part progress from a
+ * SQLite ppStmt result set.
+ */
+static bool
+catalog_s_table_part_progress_fetch(SQLiteQuery *query)
+{
+	SourceTable *table = (SourceTable *) query->context;
+	SourceTableParts *part = &(table->partition);
+
+	table->oid = sqlite3_column_int64(query->ppStmt, 0);
+
+	part->partNumber = sqlite3_column_int64(query->ppStmt, 1);
+	part->min = sqlite3_column_int64(query->ppStmt, 2);
+	part->max = sqlite3_column_int64(query->ppStmt, 3);
+	part->bound = sqlite3_column_int64(query->ppStmt, 4);
+	part->step = sqlite3_column_int64(query->ppStmt, 5);
+	part->claimed = sqlite3_column_int64(query->ppStmt, 6);
+	part->copied = sqlite3_column_int64(query->ppStmt, 7);
+
+	return true;
+}
+
+
+/*
+ * catalog_s_table_part_number_fetch fetches a part number from a SQLite
+ * ppStmt result set.
+ */
+static bool
+catalog_s_table_part_number_fetch(SQLiteQuery *query)
+{
+	SourceTableParts *part = (SourceTableParts *) query->context;
+
+	part->partNumber = sqlite3_column_int64(query->ppStmt, 0);
+
+	return true;
+}
+
+
+/*
+ * catalog_s_table_part_progress fetches the current progress of the given
+ * table part, to be called with the catalog semaphore held.
+ */
+static bool
+catalog_s_table_part_progress(sqlite3 *db, SourceTable *table)
+{
+	char *sql =
+		"select oid, partnum, min, max, bound, step, coalesce(claimed, min), "
+		"       coalesce(copied, min) "
+		"  from s_table_part "
+		" where oid = $1 and partnum = $2";
+
+	SQLiteQuery query = {
+		.context = table,
+		.fetchFunction = &catalog_s_table_part_progress_fetch,
+		.errorOnZeroRows = true
+	};
 
 	if (!catalog_sql_prepare(db, sql, &query))
 	{
 		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	/* bind our parameters now */
 	BindParam params[] = {
 		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL },
-		{ BIND_PARAMETER_TYPE_INT64, "srcrowcount", srcChk->rowcount, NULL },
-		{ BIND_PARAMETER_TYPE_TEXT, "srcsum", 0, srcChk->checksum },
-		{ BIND_PARAMETER_TYPE_INT64, "dstrowcount", dstChk->rowcount, NULL },
-		{ BIND_PARAMETER_TYPE_TEXT, "dstsum", 0, dstChk->checksum }
+		{ BIND_PARAMETER_TYPE_INT64, "partnum", table->partition.partNumber, NULL }
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -3261,448 +3368,554 @@ catalog_add_s_table_chksum(DatabaseCatalog *catalog,
 	if (!catalog_sql_bind(&query, params, count))
 	{
 		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	/* now execute the query, which does not return any row */
 	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	(void) semaphore_unlock(&(catalog->sema));
-
 	return true;
 }
 
 
 /*
- * catalog_add_s_table_size inserts a SourceTableSize to our internal catalogs database.
+ * catalog_s_table_part_start registers that a COPY worker starts copying the
+ * given table part in steps of table->partition.step values. The part range
+ * upper bound is its max value, or the given table->partition.bound estimate
+ * when the part has no upper bound.
+ *
+ * Values that have been copied already in a previous run are not claimed
+ * again, and table->partition.copied is set to the first value to copy.
+ *
+ * Values that have been claimed in a previous run but not registered as
+ * copied might have been copied to the target database anyway, when the run
+ * stopped in between. table->partition.reclaimed is set to the first value
+ * that was not claimed in a previous run, so that the caller may delete the
+ * target rows of the steps below that value before copying them again.
  */
 bool
-catalog_add_s_table_size(DatabaseCatalog *catalog,
-						 SourceTableSize *tableSize)
+catalog_s_table_part_start(DatabaseCatalog *catalog, SourceTable *table)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_add_s_table_size: db is NULL");
+		log_error("BUG: catalog_s_table_part_start: db is NULL");
 		return false;
 	}
 
-	char *sql =
-		"insert into s_table_size("
-		"  oid, bytes, bytes_pretty)"
-		"values($1, $2, $3)";
+	SourceTableParts *part = &(table->partition);
 
-	if (!semaphore_lock(&(catalog->sema)))
-	{
-		/* errors have already been logged */
-		return false;
-	}
+	char *update =
+		"update s_table_part "
+		"   set bound = case when max = -1 then $1 else max end, "
+		"       step = $2, "
+		"       claimed = coalesce(copied, min) "
+		" where oid = $3 and partnum = $4";
 
-	SQLiteQuery query = { 0 };
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "bound", part->bound, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "step", part->step, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "partnum", part->partNumber, NULL }
+	};
 
-	if (!catalog_sql_prepare(db, sql, &query))
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!semaphore_lock(&(catalog->sema)))
 	{
 		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	/* bind our parameters now */
-	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", tableSize->oid, NULL },
-		{ BIND_PARAMETER_TYPE_INT64, "bytes", tableSize->bytes, NULL },
-		{ BIND_PARAMETER_TYPE_TEXT, "bytes_pretty", 0, tableSize->bytesPretty },
-	};
-
-	int count = sizeof(params) / sizeof(params[0]);
-
-	if (!catalog_sql_bind(&query, params, count))
+	if (!catalog_begin(catalog, true) ||
+		!catalog_s_table_part_progress(db, table))
 	{
 		/* errors have already been logged */
+		(void) catalog_execute(catalog, "ROLLBACK");
 		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	/* now execute the query, which does not return any row */
-	if (!catalog_sql_execute_once(&query))
+	int64_t reclaimed = part->claimed;
+
+	if (!catalog_s_table_part_execute(db, update, params, count) ||
+		!catalog_s_table_part_progress(db, table) ||
+		!catalog_commit(catalog))
 	{
 		/* errors have already been logged */
+		(void) catalog_execute(catalog, "ROLLBACK");
 		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
 	(void) semaphore_unlock(&(catalog->sema));
 
+	part->reclaimed = reclaimed;
+
 	return true;
 }
 
 
 /*
- * catalog_delete_s_table_chksum_all implements cache invalidation for pgcopydb
- * compare data.
+ * catalog_s_table_part_reset forgets about the progress of all the parts of
+ * the given table, so that they are all copied again from their min value.
  */
 bool
-catalog_delete_s_table_chksum_all(DatabaseCatalog *catalog)
+catalog_s_table_part_reset(DatabaseCatalog *catalog, SourceTable *table)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_delete_s_table_chksum_all: db is NULL");
+		log_error("BUG: catalog_s_table_part_reset: db is NULL");
 		return false;
 	}
 
-	char *sql = "delete from s_table_chksum";
+	char *sql =
+		"update s_table_part set claimed = null, copied = null "
+		" where oid = $1";
 
-	SQLiteQuery query = { 0 };
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL }
+	};
 
-	if (!catalog_sql_prepare(db, sql, &query))
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!semaphore_lock(&(catalog->sema)))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	/* now execute the query, which does not return any row */
-	if (!catalog_sql_execute_once(&query))
+	if (!catalog_s_table_part_execute(db, sql, params, count))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
+	(void) semaphore_unlock(&(catalog->sema));
+
 	return true;
 }
 
 
 /*
- * catalog_stats fetches statistics about the objects we have in our catalog.
+ * catalog_s_table_part_claim claims the next step of a table part for the
+ * current COPY worker, and sets stepMin and stepMax to the range of values to
+ * copy. The last step of a part without upper bound has stepMax set to -1.
+ *
+ * When the whole part range has been claimed already, which happens when
+ * another worker has stolen the rest of it, done is set to true.
  */
 bool
-catalog_stats(DatabaseCatalog *catalog, CatalogStats *stats)
+catalog_s_table_part_claim(DatabaseCatalog *catalog,
+						   SourceTable *table,
+						   int64_t *stepMin,
+						   int64_t *stepMax,
+						   bool *done)
 {
-	if (!catalog_s_table_stats(catalog, &(stats->table)))
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: catalog_s_table_part_claim: db is NULL");
+		return false;
+	}
+
+	SourceTableParts *part = &(table->partition);
+
+	if (!semaphore_lock(&(catalog->sema)))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	if (!catalog_count_objects(catalog, &(stats->count)))
+	if (!catalog_begin(catalog, true) ||
+		!catalog_s_table_part_progress(db, table))
+	{
+		/* errors have already been logged */
+		(void) catalog_execute(catalog, "ROLLBACK");
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	*done = part->claimed > part->bound;
+
+	if (!*done)
+	{
+		*stepMin = part->claimed;
+		*stepMax = part->claimed + part->step - 1;
+
+		/* the last step covers the rest of the part, bounded or not */
+		if (*stepMax >= part->bound)
+		{
+			*stepMax = part->max;
+			part->claimed = part->bound + 1;
+		}
+		else
+		{
+			part->claimed = *stepMax + 1;
+		}
+
+		char *update =
+			"update s_table_part set claimed = $1 "
+			" where oid = $2 and partnum = $3";
+
+		BindParam params[] = {
+			{ BIND_PARAMETER_TYPE_INT64, "claimed", part->claimed, NULL },
+			{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL },
+			{ BIND_PARAMETER_TYPE_INT64, "partnum", part->partNumber, NULL }
+		};
+
+		int count = sizeof(params) / sizeof(params[0]);
+
+		if (!catalog_s_table_part_execute(db, update, params, count))
+		{
+			/* errors have already been logged */
+			(void) catalog_execute(catalog, "ROLLBACK");
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+	}
+
+	if (!catalog_commit(catalog))
 	{
 		/* errors have already been logged */
+		(void) catalog_execute(catalog, "ROLLBACK");
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
+	(void) semaphore_unlock(&(catalog->sema));
+
 	return true;
 }
 
 
 /*
- * catalog_s_table_stats fetches statistics about the SourceTable list we have
- * in our catalog.
+ * catalog_s_table_part_copied registers that the values of a table part up to
+ * table->partition.copied (excluded) have been copied to the target database,
+ * which is where the part is resumed from in a later run.
  */
 bool
-catalog_s_table_stats(DatabaseCatalog *catalog, CatalogTableStats *stats)
+catalog_s_table_part_copied(DatabaseCatalog *catalog, SourceTable *table)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_s_table_stats: db is NULL");
+		log_error("BUG: catalog_s_table_part_copied: db is NULL");
 		return false;
 	}
 
+	SourceTableParts *part = &(table->partition);
+
 	char *sql =
-		"select count(t.oid) as count, "
-		"       count(p.oid) as countSplits, "
-		"       sum(p.partcount) as countParts, "
-		"       sum(ts.bytes) as totalBytes, "
-		"       sum(reltuples) as totalTuples "
-		"  from s_table t "
-		"       left join "
-		"         ("
-		"             select oid, count(*) as partcount "
-		"               from s_table_part "
-		"           group by oid"
-		"         ) p "
-		"        on p.oid = t.oid"
-		"       left join s_table_size ts on ts.oid = t.oid ";
+		"update s_table_part set copied = $1 "
+		" where oid = $2 and partnum = $3";
 
-	SQLiteQuery query = {
-		.context = stats,
-		.fetchFunction = &catalog_s_table_stats_fetch
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "copied", part->copied, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "partnum", part->partNumber, NULL }
 	};
 
-	if (!catalog_sql_prepare(db, sql, &query))
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!semaphore_lock(&(catalog->sema)))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	/* now execute the query, which return exactly one row */
-	if (!catalog_sql_execute_once(&query))
+	if (!catalog_s_table_part_execute(db, sql, params, count))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	return true;
-}
-
-
-/*
- * catalog_s_table_stats_fetch is a SQLiteQuery callback.
- */
-bool
-catalog_s_table_stats_fetch(SQLiteQuery *query)
-{
-	CatalogTableStats *stats = (CatalogTableStats *) query->context;
-
-	stats->count = sqlite3_column_int64(query->ppStmt, 0);
-	stats->countSplits = sqlite3_column_int64(query->ppStmt, 1);
-	stats->countParts = sqlite3_column_int64(query->ppStmt, 2);
-	stats->totalBytes = sqlite3_column_int64(query->ppStmt, 3);
-	stats->totalTuples = sqlite3_column_int64(query->ppStmt, 4);
-
-	(void) pretty_print_bytes(stats->bytesPretty, BUFSIZE, stats->totalBytes);
-	(void) pretty_print_count(stats->relTuplesPretty, BUFSIZE, stats->totalTuples);
+	(void) semaphore_unlock(&(catalog->sema));
 
 	return true;
 }
 
 
 /*
- * catalog_count_objects returns how many objects were added to the catalogs.
+ * catalog_s_table_part_steal finds the table part being copied with the
+ * largest range of values not claimed yet, and splits it in two: the running
+ * worker keeps the lower half and a new part is created for the upper half.
+ * The new part oid and part number are returned, and found is set to false
+ * when no part has at least two steps left to copy.
+ *
+ * The new part is registered with the other parts of the table, so that
+ * resuming a previous run and checking that all parts are done both account
+ * for it.
+ *
+ * Only the parts that a live COPY worker is copying are considered: a part
+ * registered by a worker of a previous run that has since died is going to
+ * be copied again by the worker it is queued for in this run.
  */
 bool
-catalog_count_objects(DatabaseCatalog *catalog, CatalogCounts *count)
+catalog_s_table_part_steal(DatabaseCatalog *catalog,
+						   uint32_t *oid,
+						   int *partNumber,
+						   bool *found)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_count_objects: db is NULL");
+		log_error("BUG: catalog_s_table_part_steal: db is NULL");
 		return false;
 	}
 
-	char *sql = NULL;
+	char *sql =
+		"  select p.oid, p.partnum, p.min, p.max, p.bound, p.step, "
+		"         p.claimed, p.copied, s.pid "
+		"    from s_table_part p "
+		"         join summary s "
+		"           on s.tableoid = p.oid "
+		"          and s.partnum = p.partnum "
+		"   where s.pid > 0 and coalesce(s.done_time_epoch, 0) = 0 "
+		"     and p.step > 0 and p.claimed is not null "
+		"     and p.bound - p.claimed + 1 >= 2 * p.step "
+		"order by p.bound - p.claimed desc";
+
+	SourceTable victim = { 0 };
 
-	switch (catalog->type)
+	SQLiteQuery query = {
+		.context = &victim,
+		.fetchFunction = &catalog_s_table_part_progress_fetch
+	};
+
+	*found = false;
+
+	if (!semaphore_lock(&(catalog->sema)))
 	{
-		case DATABASE_CATALOG_TYPE_SOURCE:
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (!catalog_begin(catalog, true))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) catalog_execute(catalog, "ROLLBACK");
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	for (;;)
+	{
+		int rc = catalog_sql_step(&query);
+
+		if (rc == SQLITE_DONE)
 		{
-			sql =
-				"select (select count(1) as rel from s_table), "
-				"       (select count(1) as idx from s_index), "
-				"       (select count(1) as con from s_constraint),"
-				"       (select count(1) as seq from s_seq),"
-				"       (select count(1) as viw from s_view),"
-				"       (select count(1) as trg from s_trigger),"
-				"       0 as rol,"
-				"       (select count(1) as dat from s_database),"
-				"       0 as nsp,"
-				"       0 as ext,"
-				"       0 as colls,"
-				"       0 as pg_depend";
 			break;
 		}
 
-		case DATABASE_CATALOG_TYPE_FILTER:
+		if (rc != SQLITE_ROW)
 		{
-			sql =
-				"select (select count(1) as rel from s_table), "
-				"       (select count(1) as idx from s_index), "
-				"       (select count(1) as con from s_constraint),"
-				"       (select count(1) as seq from s_seq),"
-				"       (select count(1) as viw from s_view),"
-				"       (select count(1) as trg from s_trigger),"
-				"       0 as rol,"
-				"       0 as dat,"
-				"       (select count(1) as nsp from s_namespace),"
-				"       (select count(1) as ext from s_extension),"
-				"       (select count(1) as col from s_coll),"
-				"       (select count(1) as dep from s_depend)";
-			break;
+			log_error("Failed to step through statement: %s", query.sql);
+			log_error("[SQLite] %s", sqlite3_errmsg(query.db));
+			(void) catalog_sql_finalize(&query);
+			(void) catalog_execute(catalog, "ROLLBACK");
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
 		}
 
-		case DATABASE_CATALOG_TYPE_TARGET:
+		/* if we can signal the pid, it is still running */
+		pid_t pid = sqlite3_column_int64(query.ppStmt, 8);
+
+		if (kill(pid, 0) == 0)
 		{
-			sql =
-				"select (select count(1) as rel from s_table), "
-				"       (select count(1) as idx from s_index), "
-				"       (select count(1) as con from s_constraint),"
-				"       0 as seq,"
-				"       (select count(1) as viw from s_view),"
-				"       (select count(1) as trg from s_trigger),"
-				"       (select count(1) as rol from s_role),"
-				"       0 as dat,"
-				"       (select count(1) as nsp from s_namespace),"
-				"       0 as ext,"
-				"       0 as colls,"
-				"       0 as pg_depend";
+			(void) catalog_s_table_part_progress_fetch(&query);
 			break;
 		}
+	}
 
-		default:
-		{
-			log_error("BUG: called catalog_count_objects for unknown type %d",
-					  catalog->type);
-			return false;
-		}
+	if (!catalog_sql_finalize(&query))
+	{
+		/* errors have already been logged */
+		(void) catalog_execute(catalog, "ROLLBACK");
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
 	}
 
-	SQLiteQuery query = {
-		.context = count,
-		.fetchFunction = &catalog_count_fetch
+	/* no part with enough work left to share */
+	if (victim.oid == 0)
+	{
+		bool success = catalog_commit(catalog);
+
+		(void) semaphore_unlock(&(catalog->sema));
+
+		return success;
+	}
+
+	SourceTableParts *part = &(victim.partition);
+
+	int64_t mid = part->claimed + (part->bound - part->claimed + 1) / 2;
+
+	/* the new part takes the upper half of the range, bounded or not */
+	char *insert =
+		"insert into s_table_part(oid, partnum, partcount, min, max, count, "
+		"                         est_rows, est_bytes, bound) "
+		"     select $1, max(partnum) + 1, count(*) + 1, $2, $3, "
+		"            case when $3 = -1 then -1 else $3 - $2 + 1 end, "
+		"            0, 0, $4 "
+		"       from s_table_part "
+		"      where oid = $1";
+
+	BindParam insertParams[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", victim.oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "min", mid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "max", part->max, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "bound", part->bound, NULL }
 	};
 
-	if (!catalog_sql_prepare(db, sql, &query))
+	/* the running part keeps the lower half of the range */
+	char *shrink =
+		"update s_table_part "
+		"   set max = $1, bound = $1, count = $1 - min + 1 "
+		" where oid = $2 and partnum = $3";
+
+	BindParam shrinkParams[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "max", mid - 1, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "oid", victim.oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "partnum", part->partNumber, NULL }
+	};
+
+	/* and all the parts of the table now count one more part */
+	char *recount =
+		"update s_table_part "
+		"   set partcount = (select count(*) from s_table_part where oid = $1) "
+		" where oid = $1";
+
+	BindParam recountParams[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", victim.oid, NULL }
+	};
+
+	int insertCount = sizeof(insertParams) / sizeof(insertParams[0]);
+	int shrinkCount = sizeof(shrinkParams) / sizeof(shrinkParams[0]);
+	int recountCount = sizeof(recountParams) / sizeof(recountParams[0]);
+
+	if (!catalog_s_table_part_execute(db, insert, insertParams, insertCount) ||
+		!catalog_s_table_part_execute(db, shrink, shrinkParams, shrinkCount) ||
+		!catalog_s_table_part_execute(db, recount, recountParams, recountCount))
 	{
 		/* errors have already been logged */
+		(void) catalog_execute(catalog, "ROLLBACK");
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	/* now execute the query, which return exactly one row */
-	if (!catalog_sql_execute_once(&query))
+	/* fetch the new part number, the highest one for this table */
+	SourceTableParts stolen = { 0 };
+
+	char *lookup =
+		"select max(partnum) from s_table_part where oid = $1";
+
+	SQLiteQuery lookupQuery = {
+		.context = &stolen,
+		.fetchFunction = &catalog_s_table_part_number_fetch
+	};
+
+	if (!catalog_sql_prepare(db, lookup, &lookupQuery) ||
+		!catalog_sql_bind(&lookupQuery, recountParams, recountCount) ||
+		!catalog_sql_execute_once(&lookupQuery) ||
+		!catalog_commit(catalog))
 	{
 		/* errors have already been logged */
+		(void) catalog_execute(catalog, "ROLLBACK");
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	return true;
-}
-
-
-/*
- * catalog_count_fetch fetches a CatalogIndexCount from a query ppStmt
- * result.
- */
-bool
-catalog_count_fetch(SQLiteQuery *query)
-{
-	CatalogCounts *count = (CatalogCounts *) query->context;
+	(void) semaphore_unlock(&(catalog->sema));
 
-	count->tables = sqlite3_column_int64(query->ppStmt, 0);
-	count->indexes = sqlite3_column_int64(query->ppStmt, 1);
-	count->constraints = sqlite3_column_int64(query->ppStmt, 2);
-	count->sequences = sqlite3_column_int64(query->ppStmt, 3);
-	count->views = sqlite3_column_int64(query->ppStmt, 4);
-	count->triggers = sqlite3_column_int64(query->ppStmt, 5);
+	log_info("Split table oid %u part %d at %lld, "
+			 "stealing its upper half as part %d",
+			 victim.oid,
+			 part->partNumber,
+			 (long long) mid,
+			 stolen.partNumber);
 
-	count->roles = sqlite3_column_int64(query->ppStmt, 6);
-	count->databases = sqlite3_column_int64(query->ppStmt, 7);
-	count->namespaces = sqlite3_column_int64(query->ppStmt, 8);
-	count->extensions = sqlite3_column_int64(query->ppStmt, 9);
-	count->colls = sqlite3_column_int64(query->ppStmt, 10);
-	count->depends = sqlite3_column_int64(query->ppStmt, 11);
+	*oid = victim.oid;
+	*partNumber = stolen.partNumber;
+	*found = true;
 
 	return true;
 }
 
 
 /*
- * catalog_lookup_s_table fetches a SourceTable entry from our catalogs.
+ * catalog_add_s_table INSERTs a SourceTable to our internal catalogs database.
  */
 bool
-catalog_lookup_s_table(DatabaseCatalog *catalog,
-					   uint32_t oid,
-					   int partNumber,
-					   SourceTable *table)
+catalog_add_s_table_chksum(DatabaseCatalog *catalog,
+						   SourceTable *table,
+						   TableChecksum *srcChk,
+						   TableChecksum *dstChk)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_lookup_s_table: db is NULL");
+		log_error("BUG: catalog_add_s_table_chksum: db is NULL");
 		return false;
 	}
 
+	char *sql =
+		"insert into s_table_chksum("
+		"  oid, srcrowcount, srcsum, dstrowcount, dstsum)"
+		"values($1, $2, $3, $4, $5)";
+
 	if (!semaphore_lock(&(catalog->sema)))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	SQLiteQuery query = {
-		.context = table,
-		.fetchFunction = &catalog_s_table_fetch
-	};
+	SQLiteQuery query = { 0 };
 
-	if (partNumber > 0)
+	if (!catalog_sql_prepare(db, sql, &query))
 	{
-		char *sql =
-			"  select t.oid, qname, nspname, relname, amname, restore_list_name, "
-			"         relpages, reltuples, ts.bytes, ts.bytes_pretty, "
-			"         exclude_data, part_key, "
-			"         p.partcount as partcount, p.partnum, p.min, p.max "
-			"    from s_table t "
-			"         join s_table_part p "
-			"           on t.oid = p.oid "
-			"          and p.partnum = $1"
-			"       left join s_table_size ts on ts.oid = t.oid "
-			"   where t.oid = $2 ";
-
-		if (!catalog_sql_prepare(db, sql, &query))
-		{
-			/* errors have already been logged */
-			(void) semaphore_unlock(&(catalog->sema));
-			return false;
-		}
-
-		/* bind our parameters now */
-		BindParam params[] = {
-			{ BIND_PARAMETER_TYPE_INT64, "partnum", partNumber, NULL },
-			{ BIND_PARAMETER_TYPE_INT64, "oid", oid, NULL }
-		};
-
-		int count = sizeof(params) / sizeof(params[0]);
-
-		if (!catalog_sql_bind(&query, params, count))
-		{
-			/* errors have already been logged */
-			(void) semaphore_unlock(&(catalog->sema));
-			return false;
-		}
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
 	}
-	else
-	{
-		char *sql =
-			"  select t.oid, qname, nspname, relname, amname, restore_list_name, "
-			"         relpages, reltuples, ts.bytes, ts.bytes_pretty, "
-			"         exclude_data, part_key, "
-			"         count(p.oid) as partcount "
-			"    from s_table t left join s_table_part p on t.oid = p.oid"
-			"       left join s_table_size ts on ts.oid = t.oid "
-			"   where t.oid = $1 ";
-
-		if (!catalog_sql_prepare(db, sql, &query))
-		{
-			/* errors have already been logged */
-			(void) semaphore_unlock(&(catalog->sema));
-			return false;
-		}
 
-		/* bind our parameters now */
-		BindParam params[] = {
-			{ BIND_PARAMETER_TYPE_INT64, "oid", oid, NULL }
-		};
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "srcrowcount", srcChk->rowcount, NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "srcsum", 0, srcChk->checksum },
+		{ BIND_PARAMETER_TYPE_INT64, "dstrowcount", dstChk->rowcount, NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "dstsum", 0, dstChk->checksum }
+	};
 
-		int count = sizeof(params) / sizeof(params[0]);
+	int count = sizeof(params) / sizeof(params[0]);
 
-		if (!catalog_sql_bind(&query, params, count))
-		{
-			/* errors have already been logged */
-			(void) semaphore_unlock(&(catalog->sema));
-			return false;
-		}
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
 	}
 
-	/* now execute the query, which return exactly one row */
+	/* now execute the query, which does not return any row */
 	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
@@ -3717,53 +3930,45 @@ catalog_lookup_s_table(DatabaseCatalog *catalog,
 
 
 /*
- * catalog_lookup_s_table_by_name fetches a SourceTable from our catalogs.
+ * catalog_add_s_table_size inserts a SourceTableSize to our internal catalogs database.
  */
 bool
-catalog_lookup_s_table_by_name(DatabaseCatalog *catalog,
-							   const char *nspname,
-							   const char *relname,
-							   SourceTable *table)
+catalog_add_s_table_size(DatabaseCatalog *catalog,
+						 SourceTableSize *tableSize)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_s_table_stats: db is NULL");
+		log_error("BUG: catalog_add_s_table_size: db is NULL");
 		return false;
 	}
 
 	char *sql =
-		"  select t.oid, qname, nspname, relname, amname, restore_list_name, "
-		"         relpages, reltuples, ts.bytes, ts.bytes_pretty, "
-		"         exclude_data, part_key, "
-		"         p.partcount, 0 as partnum, 0 as min, 0 as max "
-		"    from s_table t "
-		"         left join "
-		"         ("
-		"             select oid, count(*) as partcount "
-		"               from s_table_part "
-		"           group by oid"
-		"         ) p "
-		"        on p.oid = t.oid"
-		"       left join s_table_size ts on ts.oid = t.oid "
-		"   where nspname = $1 and relname = $2 ";
+		"insert into s_table_size("
+		"  oid, bytes, bytes_pretty)"
+		"values($1, $2, $3)";
 
-	SQLiteQuery query = {
-		.context = table,
-		.fetchFunction = &catalog_s_table_fetch
-	};
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
 
 	if (!catalog_sql_prepare(db, sql, &query))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
 	/* bind our parameters now */
 	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, (char *) nspname },
-		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, (char *) relname },
+		{ BIND_PARAMETER_TYPE_INT64, "oid", tableSize->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "bytes", tableSize->bytes, NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "bytes_pretty", 0, tableSize->bytesPretty },
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -3771,46 +3976,42 @@ catalog_lookup_s_table_by_name(DatabaseCatalog *catalog,
 	if (!catalog_sql_bind(&query, params, count))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	/* now execute the query, which return exactly one row */
+	/* now execute the query, which does not return any row */
 	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
+	(void) semaphore_unlock(&(catalog->sema));
+
 	return true;
 }
 
 
 /*
- * catalog_lookup_s_attr_by_name fetches a SourceTable from our catalogs.
+ * catalog_delete_s_table_chksum_all implements cache invalidation for pgcopydb
+ * compare data.
  */
 bool
-catalog_lookup_s_attr_by_name(DatabaseCatalog *catalog,
-							  uint32_t reloid,
-							  const char *attname,
-							  SourceTableAttribute *attribute)
+catalog_delete_s_table_chksum_all(DatabaseCatalog *catalog)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_lookup_s_attr_by_name: db is NULL");
+		log_error("BUG: catalog_delete_s_table_chksum_all: db is NULL");
 		return false;
 	}
 
-	char *sql =
-		"  select attnum, attypid, attname, attisprimary, attisgenerated "
-		"    from s_attr "
-		"   where oid = $1 and attname = $2";
+	char *sql = "delete from s_table_chksum";
 
-	SQLiteQuery query = {
-		.context = attribute,
-		.fetchFunction = &catalog_s_attr_fetch
-	};
+	SQLiteQuery query = { 0 };
 
 	if (!catalog_sql_prepare(db, sql, &query))
 	{
@@ -3818,21 +4019,7 @@ catalog_lookup_s_attr_by_name(DatabaseCatalog *catalog,
 		return false;
 	}
 
-	/* bind our parameters now */
-	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", reloid, NULL },
-		{ BIND_PARAMETER_TYPE_TEXT, "attname", 0, (char *) attname },
-	};
-
-	int count = sizeof(params) / sizeof(params[0]);
-
-	if (!catalog_sql_bind(&query, params, count))
-	{
-		/* errors have already been logged */
-		return false;
-	}
-
-	/* now execute the query, which return exactly one row */
+	/* now execute the query, which does not return any row */
 	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
@@ -3844,189 +4031,656 @@ catalog_lookup_s_attr_by_name(DatabaseCatalog *catalog,
 
 
 /*
- * catalog_iter_s_table iterates over the list of tables in our catalogs.
+ * catalog_stats fetches statistics about the objects we have in our catalog.
  */
 bool
-catalog_iter_s_table(DatabaseCatalog *catalog,
-					 void *context,
-					 SourceTableIterFun *callback)
+catalog_stats(DatabaseCatalog *catalog, CatalogStats *stats)
 {
-	SourceTableIterator *iter =
-		(SourceTableIterator *) calloc(1, sizeof(SourceTableIterator));
-
-	iter->catalog = catalog;
-
-	if (!catalog_iter_s_table_init(iter))
+	if (!catalog_s_table_stats(catalog, &(stats->table)))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	for (;;)
+	if (!catalog_count_objects(catalog, &(stats->count)))
 	{
-		if (!catalog_iter_s_table_next(iter))
-		{
-			/* errors have already been logged */
-			return false;
-		}
-
-		SourceTable *table = iter->table;
-
-		if (table == NULL)
-		{
-			if (!catalog_iter_s_table_finish(iter))
-			{
-				/* errors have already been logged */
-				return false;
-			}
-
-			break;
-		}
-
-		/* now call the provided callback */
-		if (!(*callback)(context, table))
-		{
-			log_error("Failed to iterate over list of tables, "
-					  "see above for details");
-			return false;
-		}
+		/* errors have already been logged */
+		return false;
 	}
 
-
 	return true;
 }
 
 
 /*
- * catalog_iter_s_table_nopk iterates over the list of tables that don't have a
- * Primary Key in our catalogs.
+ * catalog_s_table_stats fetches statistics about the SourceTable list we have
+ * in our catalog.
  */
 bool
-catalog_iter_s_table_nopk(DatabaseCatalog *catalog,
-						  void *context,
-						  SourceTableIterFun *callback)
+catalog_s_table_stats(DatabaseCatalog *catalog, CatalogTableStats *stats)
 {
-	SourceTableIterator *iter =
-		(SourceTableIterator *) calloc(1, sizeof(SourceTableIterator));
-
-	iter->catalog = catalog;
+	sqlite3 *db = catalog->db;
 
-	if (!catalog_iter_s_table_nopk_init(iter))
+	if (db == NULL)
 	{
-		/* errors have already been logged */
+		log_error("BUG: catalog_s_table_stats: db is NULL");
 		return false;
 	}
 
-	for (;;)
-	{
-		if (!catalog_iter_s_table_next(iter))
-		{
-			/* errors have already been logged */
-			return false;
-		}
-
-		SourceTable *table = iter->table;
-
-		if (table == NULL)
-		{
-			if (!catalog_iter_s_table_finish(iter))
-			{
-				/* errors have already been logged */
-				return false;
-			}
+	char *sql =
+		"select count(t.oid) as count, "
+		"       count(p.oid) as countSplits, "
+		"       sum(p.partcount) as countParts, "
+		"       sum(ts.bytes) as totalBytes, "
+		"       sum(reltuples) as totalTuples "
+		"  from s_table t "
+		"       left join "
+		"         ("
+		"             select oid, count(*) as partcount "
+		"               from s_table_part "
+		"           group by oid"
+		"         ) p "
+		"        on p.oid = t.oid"
+		"       left join s_table_size ts on ts.oid = t.oid ";
 
-			break;
-		}
+	SQLiteQuery query = {
+		.context = stats,
+		.fetchFunction = &catalog_s_table_stats_fetch
+	};
 
-		/* now call the provided callback */
-		if (!(*callback)(context, table))
-		{
-			log_error("Failed to iterate over list of tables, "
-					  "see above for details");
-			return false;
-		}
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		return false;
 	}
 
+	/* now execute the query, which return exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
 
 	return true;
 }
 
 
 /*
- * catalog_iter_s_table_init initializes an Interator over our catalog of
- * SourceTable entries.
+ * catalog_s_table_stats_fetch is a SQLiteQuery callback.
  */
 bool
-catalog_iter_s_table_init(SourceTableIterator *iter)
+catalog_s_table_stats_fetch(SQLiteQuery *query)
 {
-	sqlite3 *db = iter->catalog->db;
-
-	if (db == NULL)
-	{
-		log_error("BUG: Failed to initialize s_table iterator: db is NULL");
-		return false;
-	}
-
-	iter->table = (SourceTable *) calloc(1, sizeof(SourceTable));
-
-	if (iter->table == NULL)
-	{
-		log_error(ALLOCATION_FAILED_ERROR);
-		return false;
-	}
-
-	char *sql =
-		"  select t.oid, qname, nspname, relname, amname, restore_list_name, "
-		"         relpages, reltuples, ts.bytes, ts.bytes_pretty, "
-		"         exclude_data, part_key, "
-		"         coalesce(p.partcount, 0) as partcount, "
-		"         coalesce(p.partnum, 0) as partnum, "
-		"         coalesce(p.min, 0) as min, coalesce(p.max, 0) as max, "
-		"         c.srcrowcount, c.srcsum, c.dstrowcount, c.dstsum, "
-		"         sum(s.duration), sum(s.bytes) "
-		"    from s_table t "
-		"         left join s_table_part p on p.oid = t.oid "
-		"         left join s_table_chksum c on c.oid = t.oid "
-		"         left join summary s on s.tableoid = t.oid "
-		"         left join s_table_size ts on ts.oid = t.oid "
-		"group by t.oid "
-		"order by ts.bytes desc";
-
-	SQLiteQuery *query = &(iter->query);
+	CatalogTableStats *stats = (CatalogTableStats *) query->context;
 
-	query->context = iter->table;
-	query->fetchFunction = &catalog_s_table_fetch;
+	stats->count = sqlite3_column_int64(query->ppStmt, 0);
+	stats->countSplits = sqlite3_column_int64(query->ppStmt, 1);
+	stats->countParts = sqlite3_column_int64(query->ppStmt, 2);
+	stats->totalBytes = sqlite3_column_int64(query->ppStmt, 3);
+	stats->totalTuples = sqlite3_column_int64(query->ppStmt, 4);
 
-	if (!catalog_sql_prepare(db, sql, query))
-	{
-		/* errors have already been logged */
-		return false;
-	}
+	(void) pretty_print_bytes(stats->bytesPretty, BUFSIZE, stats->totalBytes);
+	(void) pretty_print_count(stats->relTuplesPretty, BUFSIZE, stats->totalTuples);
 
 	return true;
 }
 
 
 /*
- * catalog_iter_s_table_init initializes an Interator over our catalog of
- * SourceTable entries.
+ * catalog_count_objects returns how many objects were added to the catalogs.
  */
 bool
-catalog_iter_s_table_nopk_init(SourceTableIterator *iter)
+catalog_count_objects(DatabaseCatalog *catalog, CatalogCounts *count)
 {
-	sqlite3 *db = iter->catalog->db;
+	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: Failed to initialize s_table iterator: db is NULL");
+		log_error("BUG: catalog_count_objects: db is NULL");
 		return false;
 	}
 
-	iter->table = (SourceTable *) calloc(1, sizeof(SourceTable));
+	char *sql = NULL;
 
-	if (iter->table == NULL)
+	switch (catalog->type)
 	{
-		log_error(ALLOCATION_FAILED_ERROR);
+		case DATABASE_CATALOG_TYPE_SOURCE:
+		{
+			sql =
+				"select (select count(1) as rel from s_table), "
+				"       (select count(1) as idx from s_index), "
+				"       (select count(1) as con from s_constraint),"
+				"       (select count(1) as seq from s_seq),"
+				"       (select count(1) as viw from s_view),"
+				"       (select count(1) as trg from s_trigger),"
+				"       0 as rol,"
+				"       (select count(1) as dat from s_database),"
+				"       0 as nsp,"
+				"       0 as ext,"
+				"       0 as colls,"
+				"       0 as pg_depend";
+			break;
+		}
+
+		case DATABASE_CATALOG_TYPE_FILTER:
+		{
+			sql =
+				"select (select count(1) as rel from s_table), "
+				"       (select count(1) as idx from s_index), "
+				"       (select count(1) as con from s_constraint),"
+				"       (select count(1) as seq from s_seq),"
+				"       (select count(1) as viw from s_view),"
+				"       (select count(1) as trg from s_trigger),"
+				"       0 as rol,"
+				"       0 as dat,"
+				"       (select count(1) as nsp from s_namespace),"
+				"       (select count(1) as ext from s_extension),"
+				"       (select count(1) as col from s_coll),"
+				"       (select count(1) as dep from s_depend)";
+			break;
+		}
+
+		case DATABASE_CATALOG_TYPE_TARGET:
+		{
+			sql =
+				"select (select count(1) as rel from s_table), "
+				"       (select count(1) as idx from s_index), "
+				"       (select count(1) as con from s_constraint),"
+				"       0 as seq,"
+				"       (select count(1) as viw from s_view),"
+				"       (select count(1) as trg from s_trigger),"
+				"       (select count(1) as rol from s_role),"
+				"       0 as dat,"
+				"       (select count(1) as nsp from s_namespace),"
+				"       0 as ext,"
+				"       0 as colls,"
+				"       0 as pg_depend";
+			break;
+		}
+
+		default:
+		{
+			log_error("BUG: called catalog_count_objects for unknown type %d",
+					  catalog->type);
+			return false;
+		}
+	}
+
+	SQLiteQuery query = {
+		.context = count,
+		.fetchFunction = &catalog_count_fetch
+	};
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* now execute the query, which return exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * catalog_count_fetch fetches a CatalogIndexCount from a query ppStmt
+ * result.
+ */
+bool
+catalog_count_fetch(SQLiteQuery *query)
+{
+	CatalogCounts *count = (CatalogCounts *) query->context;
+
+	count->tables = sqlite3_column_int64(query->ppStmt, 0);
+	count->indexes = sqlite3_column_int64(query->ppStmt, 1);
+	count->constraints = sqlite3_column_int64(query->ppStmt, 2);
+	count->sequences = sqlite3_column_int64(query->ppStmt, 3);
+	count->views = sqlite3_column_int64(query->ppStmt, 4);
+	count->triggers = sqlite3_column_int64(query->ppStmt, 5);
+
+	count->roles = sqlite3_column_int64(query->ppStmt, 6);
+	count->databases = sqlite3_column_int64(query->ppStmt, 7);
+	count->namespaces = sqlite3_column_int64(query->ppStmt, 8);
+	count->extensions = sqlite3_column_int64(query->ppStmt, 9);
+	count->colls = sqlite3_column_int64(query->ppStmt, 10);
+	count->depends = sqlite3_column_int64(query->ppStmt, 11);
+
+	return true;
+}
+
+
+/*
+ * catalog_lookup_s_table fetches a SourceTable entry from our catalogs.
+ */
+bool
+catalog_lookup_s_table(DatabaseCatalog *catalog,
+					   uint32_t oid,
+					   int partNumber,
+					   SourceTable *table)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: catalog_lookup_s_table: db is NULL");
+		return false;
+	}
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = {
+		.context = table,
+		.fetchFunction = &catalog_s_table_fetch
+	};
+
+	if (partNumber > 0)
+	{
+		char *sql =
+			"  select t.oid, qname, nspname, relname, amname, restore_list_name, "
+			"         relpages, reltuples, ts.bytes, ts.bytes_pretty, "
+			"         exclude_data, part_key, "
+			"         p.partcount as partcount, p.partnum, p.min, p.max "
+			"    from s_table t "
+			"         join s_table_part p "
+			"           on t.oid = p.oid "
+			"          and p.partnum = $1"
+			"       left join s_table_size ts on ts.oid = t.oid "
+			"   where t.oid = $2 ";
+
+		if (!catalog_sql_prepare(db, sql, &query))
+		{
+			/* errors have already been logged */
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+
+		/* bind our parameters now */
+		BindParam params[] = {
+			{ BIND_PARAMETER_TYPE_INT64, "partnum", partNumber, NULL },
+			{ BIND_PARAMETER_TYPE_INT64, "oid", oid, NULL }
+		};
+
+		int count = sizeof(params) / sizeof(params[0]);
+
+		if (!catalog_sql_bind(&query, params, count))
+		{
+			/* errors have already been logged */
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+	}
+	else
+	{
+		char *sql =
+			"  select t.oid, qname, nspname, relname, amname, restore_list_name, "
+			"         relpages, reltuples, ts.bytes, ts.bytes_pretty, "
+			"         exclude_data, part_key, "
+			"         count(p.oid) as partcount "
+			"    from s_table t left join s_table_part p on t.oid = p.oid"
+			"       left join s_table_size ts on ts.oid = t.oid "
+			"   where t.oid = $1 ";
+
+		if (!catalog_sql_prepare(db, sql, &query))
+		{
+			/* errors have already been logged */
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+
+		/* bind our parameters now */
+		BindParam params[] = {
+			{ BIND_PARAMETER_TYPE_INT64, "oid", oid, NULL }
+		};
+
+		int count = sizeof(params) / sizeof(params[0]);
+
+		if (!catalog_sql_bind(&query, params, count))
+		{
+			/* errors have already been logged */
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+	}
+
+	/* now execute the query, which return exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * catalog_lookup_s_table_by_name fetches a SourceTable from our catalogs.
+ */
+bool
+catalog_lookup_s_table_by_name(DatabaseCatalog *catalog,
+							   const char *nspname,
+							   const char *relname,
+							   SourceTable *table)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: catalog_s_table_stats: db is NULL");
+		return false;
+	}
+
+	char *sql =
+		"  select t.oid, qname, nspname, relname, amname, restore_list_name, "
+		"         relpages, reltuples, ts.bytes, ts.bytes_pretty, "
+		"         exclude_data, part_key, "
+		"         p.partcount, 0 as partnum, 0 as min, 0 as max "
+		"    from s_table t "
+		"         left join "
+		"         ("
+		"             select oid, count(*) as partcount "
+		"               from s_table_part "
+		"           group by oid"
+		"         ) p "
+		"        on p.oid = t.oid"
+		"       left join s_table_size ts on ts.oid = t.oid "
+		"   where nspname = $1 and relname = $2 ";
+
+	SQLiteQuery query = {
+		.context = table,
+		.fetchFunction = &catalog_s_table_fetch
+	};
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, (char *) nspname },
+		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, (char *) relname },
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* now execute the query, which return exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * catalog_lookup_s_attr_by_name fetches a SourceTable from our catalogs.
+ */
+bool
+catalog_lookup_s_attr_by_name(DatabaseCatalog *catalog,
+							  uint32_t reloid,
+							  const char *attname,
+							  SourceTableAttribute *attribute)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: catalog_lookup_s_attr_by_name: db is NULL");
+		return false;
+	}
+
+	char *sql =
+		"  select attnum, attypid, attname, attisprimary, attisgenerated "
+		"    from s_attr "
+		"   where oid = $1 and attname = $2";
+
+	SQLiteQuery query = {
+		.context = attribute,
+		.fetchFunction = &catalog_s_attr_fetch
+	};
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", reloid, NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "attname", 0, (char *) attname },
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* now execute the query, which return exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * catalog_iter_s_table iterates over the list of tables in our catalogs.
+ */
+bool
+catalog_iter_s_table(DatabaseCatalog *catalog,
+					 void *context,
+					 SourceTableIterFun *callback)
+{
+	SourceTableIterator *iter =
+		(SourceTableIterator *) calloc(1, sizeof(SourceTableIterator));
+
+	iter->catalog = catalog;
+
+	if (!catalog_iter_s_table_init(iter))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	for (;;)
+	{
+		if (!catalog_iter_s_table_next(iter))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		SourceTable *table = iter->table;
+
+		if (table == NULL)
+		{
+			if (!catalog_iter_s_table_finish(iter))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+
+			break;
+		}
+
+		/* now call the provided callback */
+		if (!(*callback)(context, table))
+		{
+			log_error("Failed to iterate over list of tables, "
+					  "see above for details");
+			return false;
+		}
+	}
+
+
+	return true;
+}
+
+
+/*
+ * catalog_iter_s_table_nopk iterates over the list of tables that don't have a
+ * Primary Key in our catalogs.
+ */
+bool
+catalog_iter_s_table_nopk(DatabaseCatalog *catalog,
+						  void *context,
+						  SourceTableIterFun *callback)
+{
+	SourceTableIterator *iter =
+		(SourceTableIterator *) calloc(1, sizeof(SourceTableIterator));
+
+	iter->catalog = catalog;
+
+	if (!catalog_iter_s_table_nopk_init(iter))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	for (;;)
+	{
+		if (!catalog_iter_s_table_next(iter))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		SourceTable *table = iter->table;
+
+		if (table == NULL)
+		{
+			if (!catalog_iter_s_table_finish(iter))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+
+			break;
+		}
+
+		/* now call the provided callback */
+		if (!(*callback)(context, table))
+		{
+			log_error("Failed to iterate over list of tables, "
+					  "see above for details");
+			return false;
+		}
+	}
+
+
+	return true;
+}
+
+
+/*
+ * catalog_iter_s_table_init initializes an Interator over our catalog of
+ * SourceTable entries.
+ */
+bool
+catalog_iter_s_table_init(SourceTableIterator *iter)
+{
+	sqlite3 *db = iter->catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: Failed to initialize s_table iterator: db is NULL");
+		return false;
+	}
+
+	iter->table = (SourceTable *) calloc(1, sizeof(SourceTable));
+
+	if (iter->table == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	char *sql =
+		"  select t.oid, qname, nspname, relname, amname, restore_list_name, "
+		"         relpages, reltuples, ts.bytes, ts.bytes_pretty, "
+		"         exclude_data, part_key, "
+		"         coalesce(p.partcount, 0) as partcount, "
+		"         coalesce(p.partnum, 0) as partnum, "
+		"         coalesce(p.min, 0) as min, coalesce(p.max, 0) as max, "
+		"         c.srcrowcount, c.srcsum, c.dstrowcount, c.dstsum, "
+		"         sum(s.duration), sum(s.bytes), "
+		"         coalesce(t.parent_oid, 0), "
+		"         (select coalesce(sum(i.bytes), 0) "
+		"            from s_index i where i.tableoid = t.oid), "
+		"         sum(s.wire_bytes) "
+		"    from s_table t "
+		"         left join s_table_part p on p.oid = t.oid "
+		"         left join s_table_chksum c on c.oid = t.oid "
+		"         left join summary s on s.tableoid = t.oid "
+		"         left join s_table_size ts on ts.oid = t.oid "
+		"group by t.oid "
+		"order by ts.bytes desc";
+
+	SQLiteQuery *query = &(iter->query);
+
+	query->context = iter->table;
+	query->fetchFunction = &catalog_s_table_fetch;
+
+	if (!catalog_sql_prepare(db, sql, query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * catalog_iter_s_table_init initializes an Interator over our catalog of
+ * SourceTable entries.
+ */
+bool
+catalog_iter_s_table_nopk_init(SourceTableIterator *iter)
+{
+	sqlite3 *db = iter->catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: Failed to initialize s_table iterator: db is NULL");
+		return false;
+	}
+
+	iter->table = (SourceTable *) calloc(1, sizeof(SourceTable));
+
+	if (iter->table == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
 		return false;
 	}
 
@@ -4195,12 +4849,30 @@ catalog_s_table_fetch(SQLiteQuery *query)
 	}
 
 	/* summary information from s_table_parts_done */
-	if (cols == 22)
+	if (cols >= 22)
 	{
 		table->durationMs = sqlite3_column_int64(query->ppStmt, 20);
 		table->bytesTransmitted = sqlite3_column_int64(query->ppStmt, 21);
 	}
 
+	/* partitioned table hierarchy */
+	if (cols >= 23)
+	{
+		table->parentOid = sqlite3_column_int64(query->ppStmt, 22);
+	}
+
+	/* estimated on-disk size of the table indexes */
+	if (cols >= 24)
+	{
+		table->indexBytes = sqlite3_column_int64(query->ppStmt, 23);
+	}
+
+	/* COPY protocol bytes from the summary */
+	if (cols >= 25)
+	{
+		table->wireBytes = sqlite3_column_int64(query->ppStmt, 24);
+	}
+
 	return true;
 }
 
@@ -4264,29 +4936,291 @@ catalog_iter_s_table_parts(DatabaseCatalog *catalog,
 				return false;
 			}
 
-			break;
-		}
+			break;
+		}
+
+		/* now call the provided callback */
+		if (!(*callback)(context, part))
+		{
+			log_error("Failed to iterate over list of tables, "
+					  "see above for details");
+			return false;
+		}
+	}
+
+
+	return true;
+}
+
+
+/*
+ * catalog_iter_s_table_part_init initializes an Interator over our catalog of
+ * SourceTable entries.
+ */
+bool
+catalog_iter_s_table_part_init(SourceTablePartsIterator *iter)
+{
+	sqlite3 *db = iter->catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: Failed to initialize s_table iterator: db is NULL");
+		return false;
+	}
+
+	iter->part = (SourceTableParts *) calloc(1, sizeof(SourceTableParts));
+
+	if (iter->part == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	char *sql =
+		"  select partnum, partcount, min, max, count, "
+		"         coalesce(est_rows, 0), coalesce(est_bytes, 0) "
+		"    from s_table_part "
+		"   where oid = $1 "
+		"order by partnum";
+
+	SQLiteQuery *query = &(iter->query);
+
+	query->context = iter->part;
+	query->fetchFunction = &catalog_s_table_part_fetch;
+
+	if (!catalog_sql_prepare(db, sql, query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	BindParam params[1] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", iter->oid, NULL }
+	};
+
+	if (!catalog_sql_bind(query, params, 1))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * catalog_iter_s_table_part_next fetches the next SourceTable entry in our catalogs.
+ */
+bool
+catalog_iter_s_table_part_next(SourceTablePartsIterator *iter)
+{
+	SQLiteQuery *query = &(iter->query);
+
+	int rc = catalog_sql_step(query);
+
+	if (rc == SQLITE_DONE)
+	{
+		iter->part = NULL;
+
+		return true;
+	}
+
+	if (rc != SQLITE_ROW)
+	{
+		log_error("Failed to step through statement: %s", query->sql);
+		log_error("[SQLite] %s", sqlite3_errmsg(query->db));
+		return false;
+	}
+
+	return catalog_s_table_part_fetch(query);
+}
+
+
+/*
+ * catalog_s_table_part_fetch fetches a SourceTableParts entry from a SQLite
+ * ppStmt result set.
+ */
+bool
+catalog_s_table_part_fetch(SQLiteQuery *query)
+{
+	SourceTableParts *part = (SourceTableParts *) query->context;
+
+	/* cleanup the memory area before re-use */
+	bzero(part, sizeof(SourceTableParts));
+
+	part->partNumber = sqlite3_column_int64(query->ppStmt, 0);
+	part->partCount = sqlite3_column_int64(query->ppStmt, 1);
+	part->min = sqlite3_column_int64(query->ppStmt, 2);
+	part->max = sqlite3_column_int64(query->ppStmt, 3);
+	part->count = sqlite3_column_int64(query->ppStmt, 4);
+	part->estRows = sqlite3_column_int64(query->ppStmt, 5);
+	part->estBytes = sqlite3_column_int64(query->ppStmt, 6);
+
+	return true;
+}
+
+
+/*
+ * catalog_iter_s_table_part_finish cleans-up the internal memory used for the
+ * iteration.
+ */
+bool
+catalog_iter_s_table_part_finish(SourceTablePartsIterator *iter)
+{
+	SQLiteQuery *query = &(iter->query);
+
+	if (!catalog_sql_finalize(query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * catalog_s_table_attrlist fetches the attributes of a table as a single
+ * C-string, using ', ' as a separator.
+ */
+bool
+catalog_s_table_attrlist(DatabaseCatalog *catalog, SourceTable *table)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: catalog_s_table_attrlist: db is NULL");
+		return false;
+	}
+
+	char *sql =
+		" select group_concat(attname order by attnum, ', ') "
+		"       filter (where not attisgenerated) "
+		"  from s_attr "
+		" where oid = $1";
+
+	SQLiteQuery query = {
+		.context = table,
+		.fetchFunction = &catalog_s_table_fetch_attrlist
+	};
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[1] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* now execute the query, which return exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * catalog_s_table_fetch_attrlist fetches a SourceTable attrlist from a SQLite
+ * query result.
+ */
+bool
+catalog_s_table_fetch_attrlist(SQLiteQuery *query)
+{
+	SourceTable *table = (SourceTable *) query->context;
+
+	/* the default empty attribute list is an empty string */
+	table->attrList = "";
+
+	if (sqlite3_column_type(query->ppStmt, 0) != SQLITE_NULL)
+	{
+		int len = sqlite3_column_bytes(query->ppStmt, 0);
+		int bytes = len + 1;
+
+		table->attrList = (char *) calloc(bytes, sizeof(char));
+
+		if (table->attrList == NULL)
+		{
+			log_fatal(ALLOCATION_FAILED_ERROR);
+			return false;
+		}
+
+		strlcpy(table->attrList,
+				(char *) sqlite3_column_text(query->ppStmt, 0),
+				bytes);
+	}
+
+	return true;
+}
+
+
+/*
+ * catalog_s_table_fetch_attrs fetches the table SourceTableAttribute array
+ * from our s_attr catalog.
+ */
+bool
+catalog_s_table_fetch_attrs(DatabaseCatalog *catalog, SourceTable *table)
+{
+	SourceTableAttrsIterator *iter =
+		(SourceTableAttrsIterator *) calloc(1,
+											sizeof(SourceTableAttrsIterator));
+
+	if (iter == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	iter->catalog = catalog;
+	iter->table = table;
+
+	if (!catalog_iter_s_table_attrs_init(iter))
+	{
+		/* errors have already been logged */
+		return false;
+	}
 
-		/* now call the provided callback */
-		if (!(*callback)(context, part))
+	while (!iter->done)
+	{
+		if (!catalog_iter_s_table_attrs_next(iter))
 		{
-			log_error("Failed to iterate over list of tables, "
-					  "see above for details");
+			/* errors have already been logged */
 			return false;
 		}
 	}
 
+	if (!catalog_iter_s_table_attrs_finish(iter))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
 
 	return true;
 }
 
 
 /*
- * catalog_iter_s_table_part_init initializes an Interator over our catalog of
- * SourceTable entries.
+ * catalog_iter_s_table_attrs_init initializes an Interator over our catalog of
+ * SourceTableAttributes entries.
  */
 bool
-catalog_iter_s_table_part_init(SourceTablePartsIterator *iter)
+catalog_iter_s_table_attrs_init(SourceTableAttrsIterator *iter)
 {
 	sqlite3 *db = iter->catalog->db;
 
@@ -4296,24 +5230,26 @@ catalog_iter_s_table_part_init(SourceTablePartsIterator *iter)
 		return false;
 	}
 
-	iter->part = (SourceTableParts *) calloc(1, sizeof(SourceTableParts));
+	SourceTable *table = iter->table;
 
-	if (iter->part == NULL)
+	if (iter->table == NULL)
 	{
-		log_error(ALLOCATION_FAILED_ERROR);
+		log_error("BUG: Failed to initialize s_table iterator: table is NULL");
 		return false;
 	}
 
 	char *sql =
-		"  select partnum, partcount, min, max, count "
-		"    from s_table_part "
+		"  select count(*) over(order by attnum) as num, "
+		"         count(*) over() as count, "
+		"         attnum, attypid, attname, attisprimary, attisgenerated "
+		"    from s_attr "
 		"   where oid = $1 "
-		"order by partnum";
+		"order by attnum";
 
 	SQLiteQuery *query = &(iter->query);
 
-	query->context = iter->part;
-	query->fetchFunction = &catalog_s_table_part_fetch;
+	query->context = iter->table;
+	query->fetchFunction = &catalog_s_table_attrs_fetch;
 
 	if (!catalog_sql_prepare(db, sql, query))
 	{
@@ -4321,8 +5257,9 @@ catalog_iter_s_table_part_init(SourceTablePartsIterator *iter)
 		return false;
 	}
 
+	/* bind our parameters now */
 	BindParam params[1] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", iter->oid, NULL }
+		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL }
 	};
 
 	if (!catalog_sql_bind(query, params, 1))
@@ -4336,10 +5273,11 @@ catalog_iter_s_table_part_init(SourceTablePartsIterator *iter)
 
 
 /*
- * catalog_iter_s_table_part_next fetches the next SourceTable entry in our catalogs.
+ * catalog_iter_s_table_attrs_next fetches the next SourceTable entry in our
+ * catalogs.
  */
 bool
-catalog_iter_s_table_part_next(SourceTablePartsIterator *iter)
+catalog_iter_s_table_attrs_next(SourceTableAttrsIterator *iter)
 {
 	SQLiteQuery *query = &(iter->query);
 
@@ -4347,8 +5285,7 @@ catalog_iter_s_table_part_next(SourceTablePartsIterator *iter)
 
 	if (rc == SQLITE_DONE)
 	{
-		iter->part = NULL;
-
+		iter->done = true;
 		return true;
 	}
 
@@ -4359,76 +5296,113 @@ catalog_iter_s_table_part_next(SourceTablePartsIterator *iter)
 		return false;
 	}
 
-	return catalog_s_table_part_fetch(query);
+	return catalog_s_table_attrs_fetch(query);
 }
 
 
 /*
- * catalog_s_table_part_fetch fetches a SourceTableParts entry from a SQLite
- * ppStmt result set.
+ * catalog_iter_s_table_attrs_finish cleans-up the internal memory used for the
+ * iteration.
  */
 bool
-catalog_s_table_part_fetch(SQLiteQuery *query)
+catalog_iter_s_table_attrs_finish(SourceTableAttrsIterator *iter)
 {
-	SourceTableParts *part = (SourceTableParts *) query->context;
-
-	/* cleanup the memory area before re-use */
-	bzero(part, sizeof(SourceTableParts));
+	SQLiteQuery *query = &(iter->query);
 
-	part->partNumber = sqlite3_column_int64(query->ppStmt, 0);
-	part->partCount = sqlite3_column_int64(query->ppStmt, 1);
-	part->min = sqlite3_column_int64(query->ppStmt, 2);
-	part->max = sqlite3_column_int64(query->ppStmt, 3);
-	part->count = sqlite3_column_int64(query->ppStmt, 4);
+	if (!catalog_sql_finalize(query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
 
 	return true;
 }
 
 
 /*
- * catalog_iter_s_table_part_finish cleans-up the internal memory used for the
- * iteration.
+ * catalog_s_table_attrs_fetch  is a SQLiteQuery callback.
  */
 bool
-catalog_iter_s_table_part_finish(SourceTablePartsIterator *iter)
+catalog_s_table_attrs_fetch(SQLiteQuery *query)
 {
-	SQLiteQuery *query = &(iter->query);
+	SourceTable *table = (SourceTable *) query->context;
 
-	if (!catalog_sql_finalize(query))
+	int num = sqlite3_column_int(query->ppStmt, 0);
+	int count = sqlite3_column_int(query->ppStmt, 1);
+
+	if (num == 1)
 	{
-		/* errors have already been logged */
-		return false;
+		table->attributes.count = count;
+		table->attributes.array =
+			(SourceTableAttribute *) calloc(count,
+											sizeof(SourceTableAttribute));
+
+		if (table->attributes.array == NULL)
+		{
+			log_error(ALLOCATION_FAILED_ERROR);
+			return false;
+		}
 	}
 
+	SourceTableAttribute *attr = &(table->attributes.array[num - 1]);
+
+	attr->attnum = sqlite3_column_int(query->ppStmt, 2);
+	attr->atttypid = sqlite3_column_int64(query->ppStmt, 3);
+
+	strlcpy(attr->attname,
+			(char *) sqlite3_column_text(query->ppStmt, 4),
+			sizeof(attr->attname));
+
+	attr->attisprimary = sqlite3_column_int(query->ppStmt, 5) == 1;
+	attr->attisgenerated = sqlite3_column_int(query->ppStmt, 6) == 1;
+
 	return true;
 }
 
 
 /*
- * catalog_s_table_attrlist fetches the attributes of a table as a single
- * C-string, using ', ' as a separator.
+ * catalog_s_attr_fetch  is a SQLiteQuery callback.
  */
 bool
-catalog_s_table_attrlist(DatabaseCatalog *catalog, SourceTable *table)
+catalog_s_attr_fetch(SQLiteQuery *query)
+{
+	SourceTableAttribute *attr = (SourceTableAttribute *) query->context;
+
+	attr->attnum = sqlite3_column_int64(query->ppStmt, 0);
+	attr->atttypid = sqlite3_column_int64(query->ppStmt, 1);
+
+	strlcpy(attr->attname,
+			(char *) sqlite3_column_text(query->ppStmt, 2),
+			sizeof(attr->attname));
+
+	attr->attisprimary = sqlite3_column_int(query->ppStmt, 3) == 1;
+	attr->attisgenerated = sqlite3_column_int(query->ppStmt, 4) == 1;
+
+	return true;
+}
+
+
+/*
+ * catalog_add_s_index INSERTs a SourceIndex to our internal catalogs database.
+ */
+bool
+catalog_add_s_index(DatabaseCatalog *catalog, SourceIndex *index)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_s_table_attrlist: db is NULL");
+		log_error("BUG: catalog_add_s_index: db is NULL");
 		return false;
 	}
 
 	char *sql =
-		" select group_concat(attname order by attnum, ', ') "
-		"       filter (where not attisgenerated) "
-		"  from s_attr "
-		" where oid = $1";
+		"insert into s_index("
+		"  oid, qname, nspname, relname, restore_list_name, tableoid, "
+		"  isprimary, isunique, columns, sql) "
+		"values($1, $2, $3, $4, $5, $6, $7, $8, $9, $10)";
 
-	SQLiteQuery query = {
-		.context = table,
-		.fetchFunction = &catalog_s_table_fetch_attrlist
-	};
+	SQLiteQuery query = { 0 };
 
 	if (!catalog_sql_prepare(db, sql, &query))
 	{
@@ -4437,8 +5411,22 @@ catalog_s_table_attrlist(DatabaseCatalog *catalog, SourceTable *table)
 	}
 
 	/* bind our parameters now */
-	BindParam params[1] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL }
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", index->indexOid, NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "qname", 0, index->indexQname },
+		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, index->indexNamespace },
+		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, index->indexRelname },
+
+		{ BIND_PARAMETER_TYPE_TEXT, "restore_list_name", 0,
+		  index->indexRestoreListName },
+
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", index->tableOid, NULL },
+
+		{ BIND_PARAMETER_TYPE_INT, "isprimary", index->isPrimary ? 1 : 0, NULL },
+		{ BIND_PARAMETER_TYPE_INT, "isunique", index->isUnique ? 1 : 0, NULL },
+
+		{ BIND_PARAMETER_TYPE_TEXT, "columns", 0, index->indexColumns },
+		{ BIND_PARAMETER_TYPE_TEXT, "sql", 0, index->indexDef }
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -4449,7 +5437,7 @@ catalog_s_table_attrlist(DatabaseCatalog *catalog, SourceTable *table)
 		return false;
 	}
 
-	/* now execute the query, which return exactly one row */
+	/* now execute the query, which does not return any row */
 	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
@@ -4461,133 +5449,126 @@ catalog_s_table_attrlist(DatabaseCatalog *catalog, SourceTable *table)
 
 
 /*
- * catalog_s_table_fetch_attrlist fetches a SourceTable attrlist from a SQLite
- * query result.
+ * catalog_add_s_constraint INSERTs a SourceIndex constraint to our internal
+ * catalogs database.
  */
 bool
-catalog_s_table_fetch_attrlist(SQLiteQuery *query)
+catalog_add_s_constraint(DatabaseCatalog *catalog, SourceIndex *index)
 {
-	SourceTable *table = (SourceTable *) query->context;
-
-	/* the default empty attribute list is an empty string */
-	table->attrList = "";
+	sqlite3 *db = catalog->db;
 
-	if (sqlite3_column_type(query->ppStmt, 0) != SQLITE_NULL)
+	if (db == NULL)
 	{
-		int len = sqlite3_column_bytes(query->ppStmt, 0);
-		int bytes = len + 1;
-
-		table->attrList = (char *) calloc(bytes, sizeof(char));
-
-		if (table->attrList == NULL)
-		{
-			log_fatal(ALLOCATION_FAILED_ERROR);
-			return false;
-		}
-
-		strlcpy(table->attrList,
-				(char *) sqlite3_column_text(query->ppStmt, 0),
-				bytes);
+		log_error("BUG: catalog_add_s_index: db is NULL");
+		return false;
 	}
 
-	return true;
-}
-
+	char *sql =
+		"insert into s_constraint("
+		"  oid, conname, indexoid, condeferrable, condeferred, sql)"
+		"values($1, $2, $3, $4, $5, $6)";
 
-/*
- * catalog_s_table_fetch_attrs fetches the table SourceTableAttribute array
- * from our s_attr catalog.
- */
-bool
-catalog_s_table_fetch_attrs(DatabaseCatalog *catalog, SourceTable *table)
-{
-	SourceTableAttrsIterator *iter =
-		(SourceTableAttrsIterator *) calloc(1,
-											sizeof(SourceTableAttrsIterator));
+	SQLiteQuery query = { 0 };
 
-	if (iter == NULL)
+	if (!catalog_sql_prepare(db, sql, &query))
 	{
-		log_error(ALLOCATION_FAILED_ERROR);
+		/* errors have already been logged */
 		return false;
 	}
 
-	iter->catalog = catalog;
-	iter->table = table;
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", index->constraintOid, NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "conname", 0, index->constraintName },
+		{ BIND_PARAMETER_TYPE_INT64, "indexoid", index->indexOid, NULL },
 
-	if (!catalog_iter_s_table_attrs_init(iter))
-	{
-		/* errors have already been logged */
-		return false;
-	}
+		{ BIND_PARAMETER_TYPE_INT, "condeferable",
+		  index->condeferrable ? 1 : 0, NULL },
+		{ BIND_PARAMETER_TYPE_INT, "condeffered",
+		  index->condeferred ? 1 : 0, NULL },
 
-	while (!iter->done)
-	{
-		if (!catalog_iter_s_table_attrs_next(iter))
-		{
-			/* errors have already been logged */
-			return false;
-		}
-	}
+		{ BIND_PARAMETER_TYPE_TEXT, "sql", 0, index->constraintDef }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
 
-	if (!catalog_iter_s_table_attrs_finish(iter))
+	if (!catalog_sql_bind(&query, params, count))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
 
 	return true;
 }
 
 
 /*
- * catalog_iter_s_table_attrs_init initializes an Interator over our catalog of
- * SourceTableAttributes entries.
+ * catalog_add_s_fk_constraint adds a foreign key constraint to the source
+ * catalog. FK constraints are tracked separately from index-backed constraints.
  */
 bool
-catalog_iter_s_table_attrs_init(SourceTableAttrsIterator *iter)
+catalog_add_s_fk_constraint(DatabaseCatalog *catalog, SourceFKConstraint *fk)
 {
-	sqlite3 *db = iter->catalog->db;
+	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: Failed to initialize s_table iterator: db is NULL");
+		log_error("BUG: catalog_add_s_fk_constraint: db is NULL");
 		return false;
 	}
 
-	SourceTable *table = iter->table;
+	char *sql =
+		"insert into s_fk_constraint("
+		"  oid, conname, nspname, relname, qname, "
+		"  condeferrable, condeferred, convalidated, constraintdef, refqname, "
+		"  relkind) "
+		"values($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11)";
 
-	if (iter->table == NULL)
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
 	{
-		log_error("BUG: Failed to initialize s_table iterator: table is NULL");
+		/* errors have already been logged */
 		return false;
 	}
 
-	char *sql =
-		"  select count(*) over(order by attnum) as num, "
-		"         count(*) over() as count, "
-		"         attnum, attypid, attname, attisprimary, attisgenerated "
-		"    from s_attr "
-		"   where oid = $1 "
-		"order by attnum";
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", fk->oid, NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "conname", 0, fk->conname },
+		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, fk->nspname },
+		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, fk->relname },
+		{ BIND_PARAMETER_TYPE_TEXT, "qname", 0, fk->tableQname },
 
-	SQLiteQuery *query = &(iter->query);
+		{ BIND_PARAMETER_TYPE_INT, "condeferrable",
+		  fk->condeferrable ? 1 : 0, NULL },
+		{ BIND_PARAMETER_TYPE_INT, "condeferred",
+		  fk->condeferred ? 1 : 0, NULL },
+		{ BIND_PARAMETER_TYPE_INT, "convalidated",
+		  fk->convalidated ? 1 : 0, NULL },
 
-	query->context = iter->table;
-	query->fetchFunction = &catalog_s_table_attrs_fetch;
+		{ BIND_PARAMETER_TYPE_TEXT, "constraintdef", 0, fk->constraintDef },
+		{ BIND_PARAMETER_TYPE_TEXT, "refqname", 0, fk->refQname },
+		{ BIND_PARAMETER_TYPE_INT, "relkind", (int) fk->relkind, NULL }
+	};
 
-	if (!catalog_sql_prepare(db, sql, query))
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	/* bind our parameters now */
-	BindParam params[1] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL }
-	};
-
-	if (!catalog_sql_bind(query, params, 1))
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
 		return false;
@@ -4598,172 +5579,234 @@ catalog_iter_s_table_attrs_init(SourceTableAttrsIterator *iter)
 
 
 /*
- * catalog_iter_s_table_attrs_next fetches the next SourceTable entry in our
- * catalogs.
+ * catalog_s_fk_constraint_fetch populates a SourceFKConstraint from a SQLite
+ * query result row.
  */
 bool
-catalog_iter_s_table_attrs_next(SourceTableAttrsIterator *iter)
+catalog_s_fk_constraint_fetch(SQLiteQuery *query)
 {
-	SQLiteQuery *query = &(iter->query);
+	SourceFKConstraint *fk = (SourceFKConstraint *) query->context;
 
-	int rc = catalog_sql_step(query);
+	/* cleanup the memory area before re-use */
+	bzero(fk, sizeof(SourceFKConstraint));
 
-	if (rc == SQLITE_DONE)
+	fk->oid = sqlite3_column_int64(query->ppStmt, 0);
+
+	strlcpy(fk->conname,
+			(char *) sqlite3_column_text(query->ppStmt, 1),
+			sizeof(fk->conname));
+
+	strlcpy(fk->nspname,
+			(char *) sqlite3_column_text(query->ppStmt, 2),
+			sizeof(fk->nspname));
+
+	strlcpy(fk->relname,
+			(char *) sqlite3_column_text(query->ppStmt, 3),
+			sizeof(fk->relname));
+
+	strlcpy(fk->tableQname,
+			(char *) sqlite3_column_text(query->ppStmt, 4),
+			sizeof(fk->tableQname));
+
+	fk->condeferrable = sqlite3_column_int(query->ppStmt, 5) == 1;
+	fk->condeferred = sqlite3_column_int(query->ppStmt, 6) == 1;
+	fk->convalidated = sqlite3_column_int(query->ppStmt, 7) == 1;
+
+	if (sqlite3_column_type(query->ppStmt, 8) != SQLITE_NULL)
 	{
-		iter->done = true;
-		return true;
+		int len = sqlite3_column_bytes(query->ppStmt, 8);
+		int bytes = len + 1;
+
+		fk->constraintDef = (char *) calloc(bytes, sizeof(char));
+
+		if (fk->constraintDef == NULL)
+		{
+			log_fatal(ALLOCATION_FAILED_ERROR);
+			return false;
+		}
+
+		strlcpy(fk->constraintDef,
+				(char *) sqlite3_column_text(query->ppStmt, 8),
+				bytes);
 	}
 
-	if (rc != SQLITE_ROW)
+	if (sqlite3_column_type(query->ppStmt, 9) != SQLITE_NULL)
 	{
-		log_error("Failed to step through statement: %s", query->sql);
-		log_error("[SQLite] %s", sqlite3_errmsg(query->db));
-		return false;
+		strlcpy(fk->refQname,
+				(char *) sqlite3_column_text(query->ppStmt, 9),
+				sizeof(fk->refQname));
 	}
 
-	return catalog_s_table_attrs_fetch(query);
+	fk->relkind = (char) sqlite3_column_int(query->ppStmt, 10);
+
+	return true;
 }
 
 
 /*
- * catalog_iter_s_table_attrs_finish cleans-up the internal memory used for the
- * iteration.
+ * catalog_iter_s_fk_constraint iterates over all FK constraints in the source
+ * catalog, calling the provided callback for each one.
  */
 bool
-catalog_iter_s_table_attrs_finish(SourceTableAttrsIterator *iter)
+catalog_iter_s_fk_constraint(DatabaseCatalog *catalog,
+							 void *context,
+							 SourceFKConstraintIterFun *callback)
 {
-	SQLiteQuery *query = &(iter->query);
+	SourceFKConstraintIterator *iter =
+		(SourceFKConstraintIterator *) calloc(1,
+											  sizeof(SourceFKConstraintIterator));
 
-	if (!catalog_sql_finalize(query))
+	if (iter == NULL)
 	{
-		/* errors have already been logged */
+		log_error(ALLOCATION_FAILED_ERROR);
 		return false;
 	}
 
-	return true;
-}
-
-
-/*
- * catalog_s_table_attrs_fetch  is a SQLiteQuery callback.
- */
-bool
-catalog_s_table_attrs_fetch(SQLiteQuery *query)
-{
-	SourceTable *table = (SourceTable *) query->context;
+	iter->catalog = catalog;
 
-	int num = sqlite3_column_int(query->ppStmt, 0);
-	int count = sqlite3_column_int(query->ppStmt, 1);
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		free(iter);
+		return false;
+	}
 
-	if (num == 1)
+	if (!catalog_iter_s_fk_constraint_init(iter))
 	{
-		table->attributes.count = count;
-		table->attributes.array =
-			(SourceTableAttribute *) calloc(count,
-											sizeof(SourceTableAttribute));
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		free(iter);
+		return false;
+	}
 
-		if (table->attributes.array == NULL)
+	for (;;)
+	{
+		if (!catalog_iter_s_fk_constraint_next(iter))
 		{
-			log_error(ALLOCATION_FAILED_ERROR);
+			/* errors have already been logged */
+			(void) semaphore_unlock(&(catalog->sema));
 			return false;
 		}
-	}
-
-	SourceTableAttribute *attr = &(table->attributes.array[num - 1]);
-
-	attr->attnum = sqlite3_column_int(query->ppStmt, 2);
-	attr->atttypid = sqlite3_column_int64(query->ppStmt, 3);
-
-	strlcpy(attr->attname,
-			(char *) sqlite3_column_text(query->ppStmt, 4),
-			sizeof(attr->attname));
-
-	attr->attisprimary = sqlite3_column_int(query->ppStmt, 5) == 1;
-	attr->attisgenerated = sqlite3_column_int(query->ppStmt, 6) == 1;
-
-	return true;
-}
 
+		SourceFKConstraint *fk = iter->fk;
 
-/*
- * catalog_s_attr_fetch  is a SQLiteQuery callback.
- */
-bool
-catalog_s_attr_fetch(SQLiteQuery *query)
-{
-	SourceTableAttribute *attr = (SourceTableAttribute *) query->context;
+		if (fk == NULL)
+		{
+			if (!catalog_iter_s_fk_constraint_finish(iter))
+			{
+				/* errors have already been logged */
+				(void) semaphore_unlock(&(catalog->sema));
+				return false;
+			}
 
-	attr->attnum = sqlite3_column_int64(query->ppStmt, 0);
-	attr->atttypid = sqlite3_column_int64(query->ppStmt, 1);
+			break;
+		}
 
-	strlcpy(attr->attname,
-			(char *) sqlite3_column_text(query->ppStmt, 2),
-			sizeof(attr->attname));
+		/* now call the provided callback */
+		if (!(*callback)(context, fk))
+		{
+			log_error("Failed to iterate over list of FK constraints, "
+					  "see above for details");
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+	}
 
-	attr->attisprimary = sqlite3_column_int(query->ppStmt, 3) == 1;
-	attr->attisgenerated = sqlite3_column_int(query->ppStmt, 4) == 1;
+	(void) semaphore_unlock(&(catalog->sema));
 
 	return true;
 }
 
 
 /*
- * catalog_add_s_index INSERTs a SourceIndex to our internal catalogs database.
+ * catalog_iter_s_fk_constraint_init prepares the SQLite query for iterating
+ * over FK constraints.
  */
 bool
-catalog_add_s_index(DatabaseCatalog *catalog, SourceIndex *index)
+catalog_iter_s_fk_constraint_init(SourceFKConstraintIterator *iter)
 {
-	sqlite3 *db = catalog->db;
+	sqlite3 *db = iter->catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_add_s_index: db is NULL");
+		log_error("BUG: Failed to initialize s_fk_constraint iterator: "
+				  "db is NULL");
+		return false;
+	}
+
+	iter->fk = (SourceFKConstraint *) calloc(1, sizeof(SourceFKConstraint));
+
+	if (iter->fk == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
 		return false;
 	}
 
 	char *sql =
-		"insert into s_index("
-		"  oid, qname, nspname, relname, restore_list_name, tableoid, "
-		"  isprimary, isunique, columns, sql) "
-		"values($1, $2, $3, $4, $5, $6, $7, $8, $9, $10)";
+		"  select oid, conname, nspname, relname, qname, "
+		"         condeferrable, condeferred, convalidated, constraintdef, "
+		"         refqname, relkind "
+		"    from s_fk_constraint "
+		"order by nspname, relname, conname";
+
+	SQLiteQuery *query = &(iter->query);
 
-	SQLiteQuery query = { 0 };
+	query->context = iter->fk;
+	query->fetchFunction = &catalog_s_fk_constraint_fetch;
 
-	if (!catalog_sql_prepare(db, sql, &query))
+	if (!catalog_sql_prepare(db, sql, query))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	/* bind our parameters now */
-	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", index->indexOid, NULL },
-		{ BIND_PARAMETER_TYPE_TEXT, "qname", 0, index->indexQname },
-		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, index->indexNamespace },
-		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, index->indexRelname },
+	return true;
+}
 
-		{ BIND_PARAMETER_TYPE_TEXT, "restore_list_name", 0,
-		  index->indexRestoreListName },
 
-		{ BIND_PARAMETER_TYPE_INT64, "tableoid", index->tableOid, NULL },
+/*
+ * catalog_iter_s_fk_constraint_next steps to the next FK constraint row.
+ */
+bool
+catalog_iter_s_fk_constraint_next(SourceFKConstraintIterator *iter)
+{
+	SQLiteQuery *query = &(iter->query);
 
-		{ BIND_PARAMETER_TYPE_INT, "isprimary", index->isPrimary ? 1 : 0, NULL },
-		{ BIND_PARAMETER_TYPE_INT, "isunique", index->isUnique ? 1 : 0, NULL },
+	int rc = catalog_sql_step(query);
 
-		{ BIND_PARAMETER_TYPE_TEXT, "columns", 0, index->indexColumns },
-		{ BIND_PARAMETER_TYPE_TEXT, "sql", 0, index->indexDef }
-	};
+	if (rc == SQLITE_DONE)
+	{
+		iter->fk = NULL;
 
-	int count = sizeof(params) / sizeof(params[0]);
+		return true;
+	}
 
-	if (!catalog_sql_bind(&query, params, count))
+	if (rc != SQLITE_ROW)
 	{
-		/* errors have already been logged */
+		log_error("Failed to step through statement: %s", query->sql);
+		log_error("[SQLite] %s", sqlite3_errmsg(query->db));
 		return false;
 	}
 
-	/* now execute the query, which does not return any row */
-	if (!catalog_sql_execute_once(&query))
+	return catalog_s_fk_constraint_fetch(query);
+}
+
+
+/*
+ * catalog_iter_s_fk_constraint_finish cleans up the iterator.
+ */
+bool
+catalog_iter_s_fk_constraint_finish(SourceFKConstraintIterator *iter)
+{
+	SQLiteQuery *query = &(iter->query);
+
+	/* in case we finish before reaching the DONE step */
+	if (iter->fk != NULL)
+	{
+		iter->fk = NULL;
+	}
+
+	if (!catalog_sql_finalize(query))
 	{
 		/* errors have already been logged */
 		return false;
@@ -4774,111 +5817,126 @@ catalog_add_s_index(DatabaseCatalog *catalog, SourceIndex *index)
 
 
 /*
- * catalog_add_s_constraint INSERTs a SourceIndex constraint to our internal
- * catalogs database.
+ * catalog_lookup_s_index fetches a SourceIndex entry from our catalogs.
  */
 bool
-catalog_add_s_constraint(DatabaseCatalog *catalog, SourceIndex *index)
+catalog_lookup_s_index(DatabaseCatalog *catalog, uint32_t oid, SourceIndex *index)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_add_s_index: db is NULL");
+		log_error("BUG: catalog_lookup_s_index: db is NULL");
 		return false;
 	}
 
 	char *sql =
-		"insert into s_constraint("
-		"  oid, conname, indexoid, condeferrable, condeferred, sql)"
-		"values($1, $2, $3, $4, $5, $6)";
+		"  select i.oid, i.qname, i.nspname, i.relname, i.restore_list_name, "
+		"         i.tableoid, t.qname, t.nspname, t.relname, "
+		"         isprimary, isunique, columns, i.sql, "
+		"         c.oid as constraintoid, conname, "
+		"         condeferrable, condeferred, c.sql as condef, "
+		"         coalesce(i.bytes, 0) as bytes, coalesce(i.cost, 0) as cost"
+		"    from s_index i "
+		"         join s_table t on t.oid = i.tableoid "
+		"         left join s_constraint c on c.indexoid = i.oid"
+		"   where i.oid = $1 ";
 
-	SQLiteQuery query = { 0 };
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = {
+		.context = index,
+		.fetchFunction = &catalog_s_index_fetch
+	};
 
 	if (!catalog_sql_prepare(db, sql, &query))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
 	/* bind our parameters now */
-	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", index->constraintOid, NULL },
-		{ BIND_PARAMETER_TYPE_TEXT, "conname", 0, index->constraintName },
-		{ BIND_PARAMETER_TYPE_INT64, "indexoid", index->indexOid, NULL },
-
-		{ BIND_PARAMETER_TYPE_INT, "condeferable",
-		  index->condeferrable ? 1 : 0, NULL },
-		{ BIND_PARAMETER_TYPE_INT, "condeffered",
-		  index->condeferred ? 1 : 0, NULL },
-
-		{ BIND_PARAMETER_TYPE_TEXT, "sql", 0, index->constraintDef }
+	BindParam params[1] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", oid, NULL },
 	};
 
-	int count = sizeof(params) / sizeof(params[0]);
-
-	if (!catalog_sql_bind(&query, params, count))
+	if (!catalog_sql_bind(&query, params, 1))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	/* now execute the query, which does not return any row */
+	/* now execute the query, which return exactly one row */
 	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
+	(void) semaphore_unlock(&(catalog->sema));
+
 	return true;
 }
 
 
 /*
- * catalog_add_s_fk_constraint adds a foreign key constraint to the source
- * catalog. FK constraints are tracked separately from index-backed constraints.
+ * catalog_lookup_s_index_by_name fetches a SourceIndex entry from our catalogs.
  */
 bool
-catalog_add_s_fk_constraint(DatabaseCatalog *catalog, SourceFKConstraint *fk)
+catalog_lookup_s_index_by_name(DatabaseCatalog *catalog,
+							   const char *nspname,
+							   const char *relname,
+							   SourceIndex *index)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_add_s_fk_constraint: db is NULL");
+		log_error("BUG: catalog_lookup_s_index_by_name: db is NULL");
 		return false;
 	}
 
 	char *sql =
-		"insert into s_fk_constraint("
-		"  oid, conname, nspname, relname, qname, "
-		"  condeferrable, condeferred, convalidated, constraintdef) "
-		"values($1, $2, $3, $4, $5, $6, $7, $8, $9)";
+		"  select i.oid, i.qname, i.nspname, i.relname, i.restore_list_name, "
+		"         i.tableoid, t.qname, t.nspname, t.relname, "
+		"         isprimary, isunique, columns, i.sql, "
+		"         c.oid as constraintoid, conname, "
+		"         condeferrable, condeferred, c.sql as condef, "
+		"         coalesce(i.bytes, 0) as bytes, coalesce(i.cost, 0) as cost"
+		"    from s_index i "
+		"         join s_table t on t.oid = i.tableoid "
+		"         left join s_constraint c on c.indexoid = i.oid"
+		"   where i.nspname = $1 and i.relname = $2 ";
 
-	SQLiteQuery query = { 0 };
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = {
+		.context = index,
+		.fetchFunction = &catalog_s_index_fetch
+	};
 
 	if (!catalog_sql_prepare(db, sql, &query))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
 	/* bind our parameters now */
 	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", fk->oid, NULL },
-		{ BIND_PARAMETER_TYPE_TEXT, "conname", 0, fk->conname },
-		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, fk->nspname },
-		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, fk->relname },
-		{ BIND_PARAMETER_TYPE_TEXT, "qname", 0, fk->tableQname },
-
-		{ BIND_PARAMETER_TYPE_INT, "condeferrable",
-		  fk->condeferrable ? 1 : 0, NULL },
-		{ BIND_PARAMETER_TYPE_INT, "condeferred",
-		  fk->condeferred ? 1 : 0, NULL },
-		{ BIND_PARAMETER_TYPE_INT, "convalidated",
-		  fk->convalidated ? 1 : 0, NULL },
-
-		{ BIND_PARAMETER_TYPE_TEXT, "constraintdef", 0, fk->constraintDef }
+		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, (char *) nspname },
+		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, (char *) relname }
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -4886,70 +5944,144 @@ catalog_add_s_fk_constraint(DatabaseCatalog *catalog, SourceFKConstraint *fk)
 	if (!catalog_sql_bind(&query, params, count))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	/* now execute the query, which does not return any row */
+	/* now execute the query, which return exactly one row */
 	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
+	(void) semaphore_unlock(&(catalog->sema));
+
 	return true;
 }
 
 
 /*
- * catalog_s_fk_constraint_fetch populates a SourceFKConstraint from a SQLite
- * query result row.
+ * catalog_s_index_fetch fetches a SourceIndex entry from a SQLite ppStmt
+ * result set.
  */
 bool
-catalog_s_fk_constraint_fetch(SQLiteQuery *query)
+catalog_s_index_fetch(SQLiteQuery *query)
 {
-	SourceFKConstraint *fk = (SourceFKConstraint *) query->context;
+	SourceIndex *index = (SourceIndex *) query->context;
 
 	/* cleanup the memory area before re-use */
-	bzero(fk, sizeof(SourceFKConstraint));
+	bzero(index, sizeof(SourceIndex));
 
-	fk->oid = sqlite3_column_int64(query->ppStmt, 0);
+	index->indexOid = sqlite3_column_int64(query->ppStmt, 0);
 
-	strlcpy(fk->conname,
+	strlcpy(index->indexQname,
 			(char *) sqlite3_column_text(query->ppStmt, 1),
-			sizeof(fk->conname));
+			sizeof(index->indexQname));
 
-	strlcpy(fk->nspname,
+	strlcpy(index->indexNamespace,
 			(char *) sqlite3_column_text(query->ppStmt, 2),
-			sizeof(fk->nspname));
+			sizeof(index->indexNamespace));
+
+	strlcpy(index->indexRelname,
+			(char *) sqlite3_column_text(query->ppStmt, 3),
+			sizeof(index->indexRelname));
+
+	strlcpy(index->indexRestoreListName,
+			(char *) sqlite3_column_text(query->ppStmt, 4),
+			sizeof(index->indexRestoreListName));
+
+	index->tableOid = sqlite3_column_int64(query->ppStmt, 5);
+
+	strlcpy(index->tableQname,
+			(char *) sqlite3_column_text(query->ppStmt, 6),
+			sizeof(index->tableQname));
+
+	strlcpy(index->tableNamespace,
+			(char *) sqlite3_column_text(query->ppStmt, 7),
+			sizeof(index->tableNamespace));
+
+	strlcpy(index->tableRelname,
+			(char *) sqlite3_column_text(query->ppStmt, 8),
+			sizeof(index->tableRelname));
+
+	index->isPrimary = sqlite3_column_int(query->ppStmt, 9) == 1;
+	index->isUnique = sqlite3_column_int(query->ppStmt, 10) == 1;
+
+	if (sqlite3_column_type(query->ppStmt, 11) != SQLITE_NULL)
+	{
+		int len = sqlite3_column_bytes(query->ppStmt, 11);
+		int bytes = len + 1;
+
+		index->indexColumns = (char *) calloc(bytes, sizeof(char));
+
+		if (index->indexColumns == NULL)
+		{
+			log_fatal(ALLOCATION_FAILED_ERROR);
+			return false;
+		}
+
+		strlcpy(index->indexColumns,
+				(char *) sqlite3_column_text(query->ppStmt, 11),
+				bytes);
+	}
+
+	if (sqlite3_column_type(query->ppStmt, 12) != SQLITE_NULL)
+	{
+		int len = sqlite3_column_bytes(query->ppStmt, 12);
+		int bytes = len + 1;
+
+		index->indexDef = (char *) calloc(bytes, sizeof(char));
+
+		if (index->indexDef == NULL)
+		{
+			log_fatal(ALLOCATION_FAILED_ERROR);
+			return false;
+		}
+
+		strlcpy(index->indexDef,
+				(char *) sqlite3_column_text(query->ppStmt, 12),
+				bytes);
+	}
+
+	/* constraint */
+	if (sqlite3_column_type(query->ppStmt, 13) != SQLITE_NULL)
+	{
+		index->constraintOid = sqlite3_column_int64(query->ppStmt, 13);
+
+		strlcpy(index->constraintName,
+				(char *) sqlite3_column_text(query->ppStmt, 14),
+				sizeof(index->constraintName));
 
-	strlcpy(fk->relname,
-			(char *) sqlite3_column_text(query->ppStmt, 3),
-			sizeof(fk->relname));
+		index->condeferrable = sqlite3_column_int(query->ppStmt, 15) == 1;
+		index->condeferred = sqlite3_column_int(query->ppStmt, 16) == 1;
 
-	strlcpy(fk->tableQname,
-			(char *) sqlite3_column_text(query->ppStmt, 4),
-			sizeof(fk->tableQname));
 
-	fk->condeferrable = sqlite3_column_int(query->ppStmt, 5) == 1;
-	fk->condeferred = sqlite3_column_int(query->ppStmt, 6) == 1;
-	fk->convalidated = sqlite3_column_int(query->ppStmt, 7) == 1;
+		if (sqlite3_column_type(query->ppStmt, 17) != SQLITE_NULL)
+		{
+			int len = sqlite3_column_bytes(query->ppStmt, 17);
+			int bytes = len + 1;
 
-	if (sqlite3_column_type(query->ppStmt, 8) != SQLITE_NULL)
-	{
-		int len = sqlite3_column_bytes(query->ppStmt, 8);
-		int bytes = len + 1;
+			index->constraintDef = (char *) calloc(bytes, sizeof(char));
 
-		fk->constraintDef = (char *) calloc(bytes, sizeof(char));
+			if (index->constraintDef == NULL)
+			{
+				log_fatal(ALLOCATION_FAILED_ERROR);
+				return false;
+			}
 
-		if (fk->constraintDef == NULL)
-		{
-			log_fatal(ALLOCATION_FAILED_ERROR);
-			return false;
+			strlcpy(index->constraintDef,
+					(char *) sqlite3_column_text(query->ppStmt, 17),
+					bytes);
 		}
+	}
 
-		strlcpy(fk->constraintDef,
-				(char *) sqlite3_column_text(query->ppStmt, 8),
-				bytes);
+	/* estimated on-disk size and build cost of the index */
+	if (sqlite3_column_count(query->ppStmt) >= 20)
+	{
+		index->bytes = sqlite3_column_int64(query->ppStmt, 18);
+		index->cost = sqlite3_column_int64(query->ppStmt, 19);
 	}
 
 	return true;
@@ -4957,17 +6089,15 @@ catalog_s_fk_constraint_fetch(SQLiteQuery *query)
 
 
 /*
- * catalog_iter_s_fk_constraint iterates over all FK constraints in the source
- * catalog, calling the provided callback for each one.
+ * catalog_iter_s_index iterates over the list of indexes in our catalogs.
  */
 bool
-catalog_iter_s_fk_constraint(DatabaseCatalog *catalog,
-							 void *context,
-							 SourceFKConstraintIterFun *callback)
+catalog_iter_s_index(DatabaseCatalog *catalog,
+					 void *context,
+					 SourceIndexIterFun *callback)
 {
-	SourceFKConstraintIterator *iter =
-		(SourceFKConstraintIterator *) calloc(1,
-											  sizeof(SourceFKConstraintIterator));
+	SourceIndexIterator *iter =
+		(SourceIndexIterator *) calloc(1, sizeof(SourceIndexIterator));
 
 	if (iter == NULL)
 	{
@@ -4977,38 +6107,27 @@ catalog_iter_s_fk_constraint(DatabaseCatalog *catalog,
 
 	iter->catalog = catalog;
 
-	if (!semaphore_lock(&(catalog->sema)))
-	{
-		/* errors have already been logged */
-		free(iter);
-		return false;
-	}
-
-	if (!catalog_iter_s_fk_constraint_init(iter))
+	if (!catalog_iter_s_index_init(iter))
 	{
 		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
-		free(iter);
 		return false;
 	}
 
 	for (;;)
 	{
-		if (!catalog_iter_s_fk_constraint_next(iter))
+		if (!catalog_iter_s_index_next(iter))
 		{
 			/* errors have already been logged */
-			(void) semaphore_unlock(&(catalog->sema));
 			return false;
 		}
 
-		SourceFKConstraint *fk = iter->fk;
+		SourceIndex *index = iter->index;
 
-		if (fk == NULL)
+		if (index == NULL)
 		{
-			if (!catalog_iter_s_fk_constraint_finish(iter))
+			if (!catalog_iter_s_index_finish(iter))
 			{
 				/* errors have already been logged */
-				(void) semaphore_unlock(&(catalog->sema));
 				return false;
 			}
 
@@ -5016,129 +6135,108 @@ catalog_iter_s_fk_constraint(DatabaseCatalog *catalog,
 		}
 
 		/* now call the provided callback */
-		if (!(*callback)(context, fk))
+		if (!(*callback)(context, index))
 		{
-			log_error("Failed to iterate over list of FK constraints, "
+			log_error("Failed to iterate over list of indexes, "
 					  "see above for details");
-			(void) semaphore_unlock(&(catalog->sema));
 			return false;
 		}
 	}
 
-	(void) semaphore_unlock(&(catalog->sema));
 
 	return true;
 }
 
 
 /*
- * catalog_iter_s_fk_constraint_init prepares the SQLite query for iterating
- * over FK constraints.
+ * catalog_iter_s_index iterates over the list of indexes in our catalogs.
  */
 bool
-catalog_iter_s_fk_constraint_init(SourceFKConstraintIterator *iter)
+catalog_iter_s_index_table(DatabaseCatalog *catalog,
+						   const char *nspname,
+						   const char *relname,
+						   void *context,
+						   SourceIndexIterFun *callback)
 {
-	sqlite3 *db = iter->catalog->db;
-
-	if (db == NULL)
-	{
-		log_error("BUG: Failed to initialize s_fk_constraint iterator: "
-				  "db is NULL");
-		return false;
-	}
+	SourceIndexIterator *iter =
+		(SourceIndexIterator *) calloc(1, sizeof(SourceIndexIterator));
 
-	iter->fk = (SourceFKConstraint *) calloc(1, sizeof(SourceFKConstraint));
+	iter->catalog = catalog;
+	iter->nspname = nspname;
+	iter->relname = relname;
 
-	if (iter->fk == NULL)
+	if (!semaphore_lock(&(catalog->sema)))
 	{
-		log_error(ALLOCATION_FAILED_ERROR);
+		/* errors have already been logged */
 		return false;
 	}
 
-	char *sql =
-		"  select oid, conname, nspname, relname, qname, "
-		"         condeferrable, condeferred, convalidated, constraintdef "
-		"    from s_fk_constraint "
-		"order by nspname, relname, conname";
-
-	SQLiteQuery *query = &(iter->query);
-
-	query->context = iter->fk;
-	query->fetchFunction = &catalog_s_fk_constraint_fetch;
-
-	if (!catalog_sql_prepare(db, sql, query))
+	if (!catalog_iter_s_index_table_init(iter))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	return true;
-}
-
+	for (;;)
+	{
+		if (!catalog_iter_s_index_next(iter))
+		{
+			/* errors have already been logged */
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
 
-/*
- * catalog_iter_s_fk_constraint_next steps to the next FK constraint row.
- */
-bool
-catalog_iter_s_fk_constraint_next(SourceFKConstraintIterator *iter)
-{
-	SQLiteQuery *query = &(iter->query);
+		SourceIndex *index = iter->index;
 
-	int rc = catalog_sql_step(query);
+		if (index == NULL)
+		{
+			if (!catalog_iter_s_index_finish(iter))
+			{
+				/* errors have already been logged */
+				(void) semaphore_unlock(&(catalog->sema));
+				return false;
+			}
 
-	if (rc == SQLITE_DONE)
-	{
-		iter->fk = NULL;
+			break;
+		}
 
-		return true;
+		/* now call the provided callback */
+		if (!(*callback)(context, index))
+		{
+			log_error("Failed to iterate over list of indexes, "
+					  "see above for details");
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
 	}
 
-	if (rc != SQLITE_ROW)
-	{
-		log_error("Failed to step through statement: %s", query->sql);
-		log_error("[SQLite] %s", sqlite3_errmsg(query->db));
-		return false;
-	}
+	(void) semaphore_unlock(&(catalog->sema));
 
-	return catalog_s_fk_constraint_fetch(query);
+	return true;
 }
 
 
 /*
- * catalog_iter_s_fk_constraint_finish cleans up the iterator.
+ * catalog_iter_s_index_init initializes an Interator over our catalog of
+ * SourceIndex entries.
  */
 bool
-catalog_iter_s_fk_constraint_finish(SourceFKConstraintIterator *iter)
+catalog_iter_s_index_init(SourceIndexIterator *iter)
 {
-	SQLiteQuery *query = &(iter->query);
-
-	/* in case we finish before reaching the DONE step */
-	if (iter->fk != NULL)
-	{
-		iter->fk = NULL;
-	}
+	sqlite3 *db = iter->catalog->db;
 
-	if (!catalog_sql_finalize(query))
+	if (db == NULL)
 	{
-		/* errors have already been logged */
+		log_error("BUG: Failed to initialize s_index iterator: db is NULL");
 		return false;
 	}
 
-	return true;
-}
-
-
-/*
- * catalog_lookup_s_index fetches a SourceIndex entry from our catalogs.
- */
-bool
-catalog_lookup_s_index(DatabaseCatalog *catalog, uint32_t oid, SourceIndex *index)
-{
-	sqlite3 *db = catalog->db;
+	iter->index = (SourceIndex *) calloc(1, sizeof(SourceIndex));
 
-	if (db == NULL)
+	if (iter->index == NULL)
 	{
-		log_error("BUG: catalog_lookup_s_index: db is NULL");
+		log_error(ALLOCATION_FAILED_ERROR);
 		return false;
 	}
 
@@ -5147,70 +6245,49 @@ catalog_lookup_s_index(DatabaseCatalog *catalog, uint32_t oid, SourceIndex *inde
 		"         i.tableoid, t.qname, t.nspname, t.relname, "
 		"         isprimary, isunique, columns, i.sql, "
 		"         c.oid as constraintoid, conname, "
-		"         condeferrable, condeferred, c.sql as condef"
+		"         condeferrable, condeferred, c.sql as condef, "
+		"         coalesce(i.bytes, 0) as bytes, coalesce(i.cost, 0) as cost"
 		"    from s_index i "
 		"         join s_table t on t.oid = i.tableoid "
-		"         left join s_constraint c on c.indexoid = i.oid"
-		"   where i.oid = $1 ";
-
-	if (!semaphore_lock(&(catalog->sema)))
-	{
-		/* errors have already been logged */
-		return false;
-	}
-
-	SQLiteQuery query = {
-		.context = index,
-		.fetchFunction = &catalog_s_index_fetch
-	};
-
-	if (!catalog_sql_prepare(db, sql, &query))
-	{
-		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
-		return false;
-	}
+		"		  left join s_table_size ts on ts.oid = i.tableoid"
+		"         left join s_constraint c on c.indexoid = i.oid "
+		"order by ts.bytes desc, t.oid";
 
-	/* bind our parameters now */
-	BindParam params[1] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", oid, NULL },
-	};
+	SQLiteQuery *query = &(iter->query);
 
-	if (!catalog_sql_bind(&query, params, 1))
-	{
-		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
-		return false;
-	}
+	query->context = iter->index;
+	query->fetchFunction = &catalog_s_index_fetch;
 
-	/* now execute the query, which return exactly one row */
-	if (!catalog_sql_execute_once(&query))
+	if (!catalog_sql_prepare(db, sql, query))
 	{
 		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	(void) semaphore_unlock(&(catalog->sema));
-
 	return true;
 }
 
 
 /*
- * catalog_lookup_s_index_by_name fetches a SourceIndex entry from our catalogs.
+ * catalog_iter_s_index_init initializes an Interator over our catalog of
+ * SourceIndex entries.
  */
 bool
-catalog_lookup_s_index_by_name(DatabaseCatalog *catalog,
-							   const char *nspname,
-							   const char *relname,
-							   SourceIndex *index)
+catalog_iter_s_index_table_init(SourceIndexIterator *iter)
 {
-	sqlite3 *db = catalog->db;
+	sqlite3 *db = iter->catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_lookup_s_index_by_name: db is NULL");
+		log_error("BUG: Failed to initialize s_index iterator: db is NULL");
+		return false;
+	}
+
+	iter->index = (SourceIndex *) calloc(1, sizeof(SourceIndex));
+
+	if (iter->index == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
 		return false;
 	}
 
@@ -5219,172 +6296,88 @@ catalog_lookup_s_index_by_name(DatabaseCatalog *catalog,
 		"         i.tableoid, t.qname, t.nspname, t.relname, "
 		"         isprimary, isunique, columns, i.sql, "
 		"         c.oid as constraintoid, conname, "
-		"         condeferrable, condeferred, c.sql as condef"
+		"         condeferrable, condeferred, c.sql as condef, "
+		"         coalesce(i.bytes, 0) as bytes, coalesce(i.cost, 0) as cost"
 		"    from s_index i "
 		"         join s_table t on t.oid = i.tableoid "
-		"         left join s_constraint c on c.indexoid = i.oid"
-		"   where i.nspname = $1 and i.relname = $2 ";
+		"         left join s_constraint c on c.indexoid = i.oid "
+		"   where t.nspname = $1 and t.relname = $2";
 
-	if (!semaphore_lock(&(catalog->sema)))
-	{
-		/* errors have already been logged */
-		return false;
-	}
+	SQLiteQuery *query = &(iter->query);
 
-	SQLiteQuery query = {
-		.context = index,
-		.fetchFunction = &catalog_s_index_fetch
-	};
+	query->context = iter->index;
+	query->fetchFunction = &catalog_s_index_fetch;
 
-	if (!catalog_sql_prepare(db, sql, &query))
+	if (!catalog_sql_prepare(db, sql, query))
 	{
 		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	/* bind our parameters now */
 	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, (char *) nspname },
-		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, (char *) relname }
+		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, (char *) iter->nspname },
+		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, (char *) iter->relname }
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
 
-	if (!catalog_sql_bind(&query, params, count))
-	{
-		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
-		return false;
-	}
-
-	/* now execute the query, which return exactly one row */
-	if (!catalog_sql_execute_once(&query))
+	if (!catalog_sql_bind(query, params, count))
 	{
 		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	(void) semaphore_unlock(&(catalog->sema));
-
 	return true;
 }
 
 
 /*
- * catalog_s_index_fetch fetches a SourceIndex entry from a SQLite ppStmt
- * result set.
+ * catalog_iter_s_index_next fetches the next SourceIndex entry in our catalogs.
  */
 bool
-catalog_s_index_fetch(SQLiteQuery *query)
+catalog_iter_s_index_next(SourceIndexIterator *iter)
 {
-	SourceIndex *index = (SourceIndex *) query->context;
-
-	/* cleanup the memory area before re-use */
-	bzero(index, sizeof(SourceIndex));
-
-	index->indexOid = sqlite3_column_int64(query->ppStmt, 0);
-
-	strlcpy(index->indexQname,
-			(char *) sqlite3_column_text(query->ppStmt, 1),
-			sizeof(index->indexQname));
-
-	strlcpy(index->indexNamespace,
-			(char *) sqlite3_column_text(query->ppStmt, 2),
-			sizeof(index->indexNamespace));
-
-	strlcpy(index->indexRelname,
-			(char *) sqlite3_column_text(query->ppStmt, 3),
-			sizeof(index->indexRelname));
-
-	strlcpy(index->indexRestoreListName,
-			(char *) sqlite3_column_text(query->ppStmt, 4),
-			sizeof(index->indexRestoreListName));
-
-	index->tableOid = sqlite3_column_int64(query->ppStmt, 5);
-
-	strlcpy(index->tableQname,
-			(char *) sqlite3_column_text(query->ppStmt, 6),
-			sizeof(index->tableQname));
-
-	strlcpy(index->tableNamespace,
-			(char *) sqlite3_column_text(query->ppStmt, 7),
-			sizeof(index->tableNamespace));
-
-	strlcpy(index->tableRelname,
-			(char *) sqlite3_column_text(query->ppStmt, 8),
-			sizeof(index->tableRelname));
+	SQLiteQuery *query = &(iter->query);
 
-	index->isPrimary = sqlite3_column_int(query->ppStmt, 9) == 1;
-	index->isUnique = sqlite3_column_int(query->ppStmt, 10) == 1;
+	int rc = catalog_sql_step(query);
 
-	if (sqlite3_column_type(query->ppStmt, 11) != SQLITE_NULL)
+	if (rc == SQLITE_DONE)
 	{
-		int len = sqlite3_column_bytes(query->ppStmt, 11);
-		int bytes = len + 1;
-
-		index->indexColumns = (char *) calloc(bytes, sizeof(char));
-
-		if (index->indexColumns == NULL)
-		{
-			log_fatal(ALLOCATION_FAILED_ERROR);
-			return false;
-		}
+		iter->index = NULL;
 
-		strlcpy(index->indexColumns,
-				(char *) sqlite3_column_text(query->ppStmt, 11),
-				bytes);
+		return true;
 	}
 
-	if (sqlite3_column_type(query->ppStmt, 12) != SQLITE_NULL)
+	if (rc != SQLITE_ROW)
 	{
-		int len = sqlite3_column_bytes(query->ppStmt, 12);
-		int bytes = len + 1;
-
-		index->indexDef = (char *) calloc(bytes, sizeof(char));
-
-		if (index->indexDef == NULL)
-		{
-			log_fatal(ALLOCATION_FAILED_ERROR);
-			return false;
-		}
-
-		strlcpy(index->indexDef,
-				(char *) sqlite3_column_text(query->ppStmt, 12),
-				bytes);
+		log_error("Failed to step through statement: %s", query->sql);
+		log_error("[SQLite] %s", sqlite3_errmsg(query->db));
+		return false;
 	}
 
-	/* constraint */
-	if (sqlite3_column_type(query->ppStmt, 13) != SQLITE_NULL)
-	{
-		index->constraintOid = sqlite3_column_int64(query->ppStmt, 13);
-
-		strlcpy(index->constraintName,
-				(char *) sqlite3_column_text(query->ppStmt, 14),
-				sizeof(index->constraintName));
-
-		index->condeferrable = sqlite3_column_int(query->ppStmt, 15) == 1;
-		index->condeferred = sqlite3_column_int(query->ppStmt, 16) == 1;
-
+	return catalog_s_index_fetch(query);
+}
 
-		if (sqlite3_column_type(query->ppStmt, 17) != SQLITE_NULL)
-		{
-			int len = sqlite3_column_bytes(query->ppStmt, 17);
-			int bytes = len + 1;
 
-			index->constraintDef = (char *) calloc(bytes, sizeof(char));
+/*
+ * catalog_iter_s_index_finish cleans-up the internal memory used for the
+ * iteration.
+ */
+bool
+catalog_iter_s_index_finish(SourceIndexIterator *iter)
+{
+	SQLiteQuery *query = &(iter->query);
 
-			if (index->constraintDef == NULL)
-			{
-				log_fatal(ALLOCATION_FAILED_ERROR);
-				return false;
-			}
+	/* in case we finish before reaching the DONE step */
+	if (iter->index != NULL)
+	{
+		iter->index = NULL;
+	}
 
-			strlcpy(index->constraintDef,
-					(char *) sqlite3_column_text(query->ppStmt, 17),
-					bytes);
-		}
+	if (!catalog_sql_finalize(query))
+	{
+		/* errors have already been logged */
+		return false;
 	}
 
 	return true;
@@ -5392,175 +6385,113 @@ catalog_s_index_fetch(SQLiteQuery *query)
 
 
 /*
- * catalog_iter_s_index iterates over the list of indexes in our catalogs.
+ * catalog_s_table_fetch_attrs fetches the table SourceTableAttribute array
+ * from our s_attr catalog.
  */
 bool
-catalog_iter_s_index(DatabaseCatalog *catalog,
-					 void *context,
-					 SourceIndexIterFun *callback)
+catalog_s_table_count_indexes(DatabaseCatalog *catalog, SourceTable *table)
 {
-	SourceIndexIterator *iter =
-		(SourceIndexIterator *) calloc(1, sizeof(SourceIndexIterator));
+	sqlite3 *db = catalog->db;
 
-	if (iter == NULL)
+	if (db == NULL)
 	{
-		log_error(ALLOCATION_FAILED_ERROR);
+		log_error("BUG: catalog_s_table_count_indexes: db is NULL");
 		return false;
 	}
 
-	iter->catalog = catalog;
+	char *sql =
+		"select count(1) as indexes, "
+		"       count(c.oid) as constraints "
+		"  from s_index i "
+		"       left join s_constraint c on c.indexoid = i.oid "
+		" where tableoid = $1";
 
-	if (!catalog_iter_s_index_init(iter))
+	if (!semaphore_lock(&(catalog->sema)))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	for (;;)
-	{
-		if (!catalog_iter_s_index_next(iter))
-		{
-			/* errors have already been logged */
-			return false;
-		}
-
-		SourceIndex *index = iter->index;
-
-		if (index == NULL)
-		{
-			if (!catalog_iter_s_index_finish(iter))
-			{
-				/* errors have already been logged */
-				return false;
-			}
-
-			break;
-		}
+	SQLiteQuery query = {
+		.context = table,
+		.fetchFunction = &catalog_s_table_count_indexes_fetch
+	};
 
-		/* now call the provided callback */
-		if (!(*callback)(context, index))
-		{
-			log_error("Failed to iterate over list of indexes, "
-					  "see above for details");
-			return false;
-		}
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
 	}
 
+	/* bind our parameters now */
+	BindParam params[1] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL }
+	};
 
-	return true;
-}
-
-
-/*
- * catalog_iter_s_index iterates over the list of indexes in our catalogs.
- */
-bool
-catalog_iter_s_index_table(DatabaseCatalog *catalog,
-						   const char *nspname,
-						   const char *relname,
-						   void *context,
-						   SourceIndexIterFun *callback)
-{
-	SourceIndexIterator *iter =
-		(SourceIndexIterator *) calloc(1, sizeof(SourceIndexIterator));
-
-	iter->catalog = catalog;
-	iter->nspname = nspname;
-	iter->relname = relname;
-
-	if (!semaphore_lock(&(catalog->sema)))
+	if (!catalog_sql_bind(&query, params, 1))
 	{
 		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	if (!catalog_iter_s_index_table_init(iter))
+	/* now execute the query, which return exactly one row */
+	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
 		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	for (;;)
-	{
-		if (!catalog_iter_s_index_next(iter))
-		{
-			/* errors have already been logged */
-			(void) semaphore_unlock(&(catalog->sema));
-			return false;
-		}
-
-		SourceIndex *index = iter->index;
+	(void) semaphore_unlock(&(catalog->sema));
 
-		if (index == NULL)
-		{
-			if (!catalog_iter_s_index_finish(iter))
-			{
-				/* errors have already been logged */
-				(void) semaphore_unlock(&(catalog->sema));
-				return false;
-			}
+	return true;
+}
 
-			break;
-		}
 
-		/* now call the provided callback */
-		if (!(*callback)(context, index))
-		{
-			log_error("Failed to iterate over list of indexes, "
-					  "see above for details");
-			(void) semaphore_unlock(&(catalog->sema));
-			return false;
-		}
-	}
+/*
+ * catalog_s_table_count_indexes_fetch  is a SQLiteQuery callback.
+ */
+bool
+catalog_s_table_count_indexes_fetch(SQLiteQuery *query)
+{
+	SourceTable *table = (SourceTable *) query->context;
 
-	(void) semaphore_unlock(&(catalog->sema));
+	table->indexCount = sqlite3_column_int64(query->ppStmt, 0);
+	table->constraintCount = sqlite3_column_int64(query->ppStmt, 1);
 
 	return true;
 }
 
 
 /*
- * catalog_iter_s_index_init initializes an Interator over our catalog of
- * SourceIndex entries.
+ * catalog_delete_s_index_all DELETE all the indexes registered in the given
+ * database catalog.
  */
 bool
-catalog_iter_s_index_init(SourceIndexIterator *iter)
+catalog_delete_s_index_all(DatabaseCatalog *catalog)
 {
-	sqlite3 *db = iter->catalog->db;
+	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: Failed to initialize s_index iterator: db is NULL");
+		log_error("BUG: catalog_delete_s_index_all: db is NULL");
 		return false;
 	}
 
-	iter->index = (SourceIndex *) calloc(1, sizeof(SourceIndex));
+	char *sql = "delete from s_index";
 
-	if (iter->index == NULL)
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
 	{
-		log_error(ALLOCATION_FAILED_ERROR);
+		/* errors have already been logged */
 		return false;
 	}
 
-	char *sql =
-		"  select i.oid, i.qname, i.nspname, i.relname, i.restore_list_name, "
-		"         i.tableoid, t.qname, t.nspname, t.relname, "
-		"         isprimary, isunique, columns, i.sql, "
-		"         c.oid as constraintoid, conname, "
-		"         condeferrable, condeferred, c.sql as condef"
-		"    from s_index i "
-		"         join s_table t on t.oid = i.tableoid "
-		"		  left join s_table_size ts on ts.oid = i.tableoid"
-		"         left join s_constraint c on c.indexoid = i.oid "
-		"order by ts.bytes desc, t.oid";
-
-	SQLiteQuery *query = &(iter->query);
-
-	query->context = iter->index;
-	query->fetchFunction = &catalog_s_index_fetch;
-
-	if (!catalog_sql_prepare(db, sql, query))
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
 		return false;
@@ -5571,58 +6502,58 @@ catalog_iter_s_index_init(SourceIndexIterator *iter)
 
 
 /*
- * catalog_iter_s_index_init initializes an Interator over our catalog of
- * SourceIndex entries.
+ * catalog_add_s_seq INSERTs a SourceSequence to our internal catalogs database.
  */
 bool
-catalog_iter_s_index_table_init(SourceIndexIterator *iter)
+catalog_add_s_seq(DatabaseCatalog *catalog, SourceSequence *seq)
 {
-	sqlite3 *db = iter->catalog->db;
+	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: Failed to initialize s_index iterator: db is NULL");
-		return false;
-	}
-
-	iter->index = (SourceIndex *) calloc(1, sizeof(SourceIndex));
-
-	if (iter->index == NULL)
-	{
-		log_error(ALLOCATION_FAILED_ERROR);
+		log_error("BUG: catalog_add_s_seq: db is NULL");
 		return false;
 	}
 
 	char *sql =
-		"  select i.oid, i.qname, i.nspname, i.relname, i.restore_list_name, "
-		"         i.tableoid, t.qname, t.nspname, t.relname, "
-		"         isprimary, isunique, columns, i.sql, "
-		"         c.oid as constraintoid, conname, "
-		"         condeferrable, condeferred, c.sql as condef"
-		"    from s_index i "
-		"         join s_table t on t.oid = i.tableoid "
-		"         left join s_constraint c on c.indexoid = i.oid "
-		"   where t.nspname = $1 and t.relname = $2";
-
-	SQLiteQuery *query = &(iter->query);
+		"insert into s_seq("
+		"  oid, ownedby, attrelid, attroid, "
+		"  qname, nspname, relname, restore_list_name)"
+		"values($1, $2, $3, $4, $5, $6, $7, $8)";
 
-	query->context = iter->index;
-	query->fetchFunction = &catalog_s_index_fetch;
+	SQLiteQuery query = { 0 };
 
-	if (!catalog_sql_prepare(db, sql, query))
+	if (!catalog_sql_prepare(db, sql, &query))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
+	/* bind our parameters now */
 	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, (char *) iter->nspname },
-		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, (char *) iter->relname }
+		{ BIND_PARAMETER_TYPE_INT64, "oid", seq->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "ownedby", seq->ownedby, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "attrelid", seq->attrelid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "attroid", seq->attroid, NULL },
+
+		{ BIND_PARAMETER_TYPE_TEXT, "qname", 0, seq->qname },
+		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, seq->nspname },
+		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, seq->relname },
+
+		{ BIND_PARAMETER_TYPE_TEXT, "restore_list_name", 0,
+		  seq->restoreListName }
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
 
-	if (!catalog_sql_bind(query, params, count))
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
 		return false;
@@ -5633,49 +6564,84 @@ catalog_iter_s_index_table_init(SourceIndexIterator *iter)
 
 
 /*
- * catalog_iter_s_index_next fetches the next SourceIndex entry in our catalogs.
+ * catalog_add_s_blob INSERTs a SourceBlob to our internal catalogs database.
  */
 bool
-catalog_iter_s_index_next(SourceIndexIterator *iter)
+catalog_add_s_blob(DatabaseCatalog *catalog, SourceBlob *blob)
 {
-	SQLiteQuery *query = &(iter->query);
+	sqlite3 *db = catalog->db;
 
-	int rc = catalog_sql_step(query);
+	if (db == NULL)
+	{
+		log_error("BUG: catalog_add_s_blob: db is NULL");
+		return false;
+	}
 
-	if (rc == SQLITE_DONE)
+	/* unknown sizes are registered as NULL */
+	char *sql =
+		"insert or replace into s_blob(oid, bytes) "
+		"values($1, nullif($2, -1))";
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
 	{
-		iter->index = NULL;
+		/* errors have already been logged */
+		return false;
+	}
 
-		return true;
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "oid", blob->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "bytes", blob->bytes, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		return false;
 	}
 
-	if (rc != SQLITE_ROW)
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
 	{
-		log_error("Failed to step through statement: %s", query->sql);
-		log_error("[SQLite] %s", sqlite3_errmsg(query->db));
+		/* errors have already been logged */
 		return false;
 	}
 
-	return catalog_s_index_fetch(query);
+	return true;
 }
 
 
 /*
- * catalog_iter_s_index_finish cleans-up the internal memory used for the
- * iteration.
+ * catalog_delete_s_blob_all DELETE all the large objects registered in the
+ * given database catalog.
  */
 bool
-catalog_iter_s_index_finish(SourceIndexIterator *iter)
+catalog_delete_s_blob_all(DatabaseCatalog *catalog)
 {
-	SQLiteQuery *query = &(iter->query);
+	sqlite3 *db = catalog->db;
 
-	/* in case we finish before reaching the DONE step */
-	if (iter->index != NULL)
+	if (db == NULL)
 	{
-		iter->index = NULL;
+		log_error("BUG: catalog_delete_s_blob_all: db is NULL");
+		return false;
 	}
 
-	if (!catalog_sql_finalize(query))
+	char *sql = "delete from s_blob";
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
 		return false;
@@ -5686,102 +6652,145 @@ catalog_iter_s_index_finish(SourceIndexIterator *iter)
 
 
 /*
- * catalog_s_table_fetch_attrs fetches the table SourceTableAttribute array
- * from our s_attr catalog.
+ * catalog_iter_s_blob iterates over the large objects in our catalogs.
+ *
+ * When bySize is true, the large objects that are too big to be copied in a
+ * batch come first, the biggest interleaved with the smallest of them: the
+ * biggest, the smallest, the second biggest, the second smallest, and so on.
+ * That way the workers that copy the biggest large objects start early, while
+ * the other workers keep busy with smaller ones, rather than a single worker
+ * copying the biggest ones at the end.
+ *
+ * The large objects that fit in a batch come next, in OID order, so that the
+ * batches are made of small large objects only, and read neighbouring pages
+ * of pg_largeobject. Otherwise all the large objects are sorted by OID.
  */
 bool
-catalog_s_table_count_indexes(DatabaseCatalog *catalog, SourceTable *table)
+catalog_iter_s_blob(DatabaseCatalog *catalog,
+					bool bySize,
+					void *context,
+					SourceBlobIterFun *callback)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_s_table_count_indexes: db is NULL");
-		return false;
-	}
-
-	char *sql =
-		"select count(1) as indexes, "
-		"       count(c.oid) as constraints "
-		"  from s_index i "
-		"       left join s_constraint c on c.indexoid = i.oid "
-		" where tableoid = $1";
+		log_error("BUG: catalog_iter_s_blob: db is NULL");
+		return false;
+	}
+
+	char *sqlByOid = "select oid, bytes from s_blob order by oid";
+
+	char *sqlBySize =
+		"with sized as "
+		" ( "
+		"   select oid, bytes, coalesce(bytes, -1) > $1 as big "
+		"     from s_blob "
+		" ), "
+		" ranked as "
+		" ( "
+		"   select oid, bytes, big, "
+		"          row_number() over(partition by big "
+		"                            order by bytes desc, oid) as r, "
+		"          count(*) over(partition by big) as n "
+		"     from sized "
+		" ) "
+		"  select oid, bytes "
+		"    from ranked "
+		"order by big desc, "
+		"         case when not big then oid "
+		"              when r <= (n + 1) / 2 then 2 * r - 1 "
+		"              else 2 * (n - r + 1) "
+		"          end";
+
+	SourceBlob blob = { 0 };
+	SQLiteQuery query = { 0 };
 
-	if (!semaphore_lock(&(catalog->sema)))
+	if (!catalog_sql_prepare(db, bySize ? sqlBySize : sqlByOid, &query))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	SQLiteQuery query = {
-		.context = table,
-		.fetchFunction = &catalog_s_table_count_indexes_fetch
-	};
-
-	if (!catalog_sql_prepare(db, sql, &query))
+	if (bySize)
 	{
-		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
-		return false;
+		BindParam params[] = {
+			{ BIND_PARAMETER_TYPE_INT64, "bytes",
+			  LARGE_OBJECT_BATCH_MAX_BYTES, NULL }
+		};
+
+		int count = sizeof(params) / sizeof(params[0]);
+
+		if (!catalog_sql_bind(&query, params, count))
+		{
+			/* errors have already been logged */
+			(void) catalog_sql_finalize(&query);
+			return false;
+		}
 	}
 
-	/* bind our parameters now */
-	BindParam params[1] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", table->oid, NULL }
-	};
+	for (;;)
+	{
+		int rc = catalog_sql_step(&query);
+
+		if (rc == SQLITE_DONE)
+		{
+			break;
+		}
+
+		if (rc != SQLITE_ROW)
+		{
+			log_error("Failed to step through statement: %s", query.sql);
+			log_error("[SQLite] %s", sqlite3_errmsg(query.db));
+			(void) catalog_sql_finalize(&query);
+			return false;
+		}
+
+		blob.oid = sqlite3_column_int64(query.ppStmt, 0);
+		blob.bytes =
+			sqlite3_column_type(query.ppStmt, 1) == SQLITE_NULL
+			? -1
+			: sqlite3_column_int64(query.ppStmt, 1);
 
-	if (!catalog_sql_bind(&query, params, 1))
-	{
-		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
-		return false;
+		/* now call the provided callback */
+		if (!(*callback)(context, &blob))
+		{
+			log_error("Failed to iterate over list of large objects, "
+					  "see above for details");
+			(void) catalog_sql_finalize(&query);
+			return false;
+		}
 	}
 
-	/* now execute the query, which return exactly one row */
-	if (!catalog_sql_execute_once(&query))
+	if (!catalog_sql_finalize(&query))
 	{
 		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
 		return false;
 	}
 
-	(void) semaphore_unlock(&(catalog->sema));
-
-	return true;
-}
-
-
-/*
- * catalog_s_table_count_indexes_fetch  is a SQLiteQuery callback.
- */
-bool
-catalog_s_table_count_indexes_fetch(SQLiteQuery *query)
-{
-	SourceTable *table = (SourceTable *) query->context;
-
-	table->indexCount = sqlite3_column_int64(query->ppStmt, 0);
-	table->constraintCount = sqlite3_column_int64(query->ppStmt, 1);
-
 	return true;
 }
 
 
 /*
- * catalog_delete_s_index_all DELETE all the indexes registered in the given
- * database catalog.
+ * catalog_update_sequence_values UPDATEs a SourceSequence lastValue and
+ * isCalled parameters in our catalogs.
  */
 bool
-catalog_delete_s_index_all(DatabaseCatalog *catalog)
+catalog_update_sequence_values(DatabaseCatalog *catalog, SourceSequence *seq)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_delete_s_index_all: db is NULL");
+		log_error("BUG: catalog_update_sequence_values: db is NULL");
 		return false;
 	}
 
-	char *sql = "delete from s_index";
+	char *sql =
+		"update s_seq "
+		"   set last_value = $1, isCalled = $2 "
+		" where nspname = $3 and relname = $4";
 
 	SQLiteQuery query = { 0 };
 
@@ -5791,6 +6800,22 @@ catalog_delete_s_index_all(DatabaseCatalog *catalog)
 		return false;
 	}
 
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "last_alue", seq->lastValue, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "isCalled", seq->isCalled ? 1 : 0, NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, seq->nspname },
+		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, seq->relname }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
 	/* now execute the query, which does not return any row */
 	if (!catalog_sql_execute_once(&query))
 	{
@@ -5803,24 +6828,23 @@ catalog_delete_s_index_all(DatabaseCatalog *catalog)
 
 
 /*
- * catalog_add_s_seq INSERTs a SourceSequence to our internal catalogs database.
+ * Updates the 'relpages' field of the 's_table' table in the database catalog with the given values.
  */
 bool
-catalog_add_s_seq(DatabaseCatalog *catalog, SourceSequence *seq)
+catalog_update_s_table_relpages(DatabaseCatalog *catalog, SourceTable *sourceTable)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_add_s_seq: db is NULL");
+		log_error("BUG: catalog_update_s_table_relpages: db is NULL");
 		return false;
 	}
 
 	char *sql =
-		"insert into s_seq("
-		"  oid, ownedby, attrelid, attroid, "
-		"  qname, nspname, relname, restore_list_name)"
-		"values($1, $2, $3, $4, $5, $6, $7, $8)";
+		"update s_table "
+		"   set relpages = $1 "
+		" where oid = $2";
 
 	SQLiteQuery query = { 0 };
 
@@ -5832,17 +6856,8 @@ catalog_add_s_seq(DatabaseCatalog *catalog, SourceSequence *seq)
 
 	/* bind our parameters now */
 	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "oid", seq->oid, NULL },
-		{ BIND_PARAMETER_TYPE_INT64, "ownedby", seq->ownedby, NULL },
-		{ BIND_PARAMETER_TYPE_INT64, "attrelid", seq->attrelid, NULL },
-		{ BIND_PARAMETER_TYPE_INT64, "attroid", seq->attroid, NULL },
-
-		{ BIND_PARAMETER_TYPE_TEXT, "qname", 0, seq->qname },
-		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, seq->nspname },
-		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, seq->relname },
-
-		{ BIND_PARAMETER_TYPE_TEXT, "restore_list_name", 0,
-		  seq->restoreListName }
+		{ BIND_PARAMETER_TYPE_INT64, "relpages", sourceTable->relpages, NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "oid", sourceTable->oid, NULL },
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -5865,24 +6880,26 @@ catalog_add_s_seq(DatabaseCatalog *catalog, SourceSequence *seq)
 
 
 /*
- * catalog_update_sequence_values UPDATEs a SourceSequence lastValue and
- * isCalled parameters in our catalogs.
+ * catalog_update_s_table_parent registers the root of the partitioned table
+ * that the given table is a leaf partition of.
  */
 bool
-catalog_update_sequence_values(DatabaseCatalog *catalog, SourceSequence *seq)
+catalog_update_s_table_parent(DatabaseCatalog *catalog,
+							  uint32_t oid,
+							  uint32_t parentOid)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_update_sequence_values: db is NULL");
+		log_error("BUG: catalog_update_s_table_parent: db is NULL");
 		return false;
 	}
 
 	char *sql =
-		"update s_seq "
-		"   set last_value = $1, isCalled = $2 "
-		" where nspname = $3 and relname = $4";
+		"update s_table "
+		"   set parent_oid = $1 "
+		" where oid = $2";
 
 	SQLiteQuery query = { 0 };
 
@@ -5894,10 +6911,8 @@ catalog_update_sequence_values(DatabaseCatalog *catalog, SourceSequence *seq)
 
 	/* bind our parameters now */
 	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "last_alue", seq->lastValue, NULL },
-		{ BIND_PARAMETER_TYPE_INT64, "isCalled", seq->isCalled ? 1 : 0, NULL },
-		{ BIND_PARAMETER_TYPE_TEXT, "nspname", 0, seq->nspname },
-		{ BIND_PARAMETER_TYPE_TEXT, "relname", 0, seq->relname }
+		{ BIND_PARAMETER_TYPE_INT64, "parent_oid", parentOid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "oid", oid, NULL },
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -5920,23 +6935,27 @@ catalog_update_sequence_values(DatabaseCatalog *catalog, SourceSequence *seq)
 
 
 /*
- * Updates the 'relpages' field of the 's_table' table in the database catalog with the given values.
+ * catalog_update_s_index_estimates registers the estimated on-disk size of an
+ * index, and the estimated cost of building it.
  */
 bool
-catalog_update_s_table_relpages(DatabaseCatalog *catalog, SourceTable *sourceTable)
+catalog_update_s_index_estimates(DatabaseCatalog *catalog,
+								 uint32_t oid,
+								 int64_t bytes,
+								 int64_t cost)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: catalog_update_s_table_relpages: db is NULL");
+		log_error("BUG: catalog_update_s_index_estimates: db is NULL");
 		return false;
 	}
 
 	char *sql =
-		"update s_table "
-		"   set relpages = $1 "
-		" where oid = $2";
+		"update s_index "
+		"   set bytes = $1, cost = $2 "
+		" where oid = $3";
 
 	SQLiteQuery query = { 0 };
 
@@ -5948,8 +6967,9 @@ catalog_update_s_table_relpages(DatabaseCatalog *catalog, SourceTable *sourceTab
 
 	/* bind our parameters now */
 	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "relpages", sourceTable->relpages, NULL },
-		{ BIND_PARAMETER_TYPE_TEXT, "oid", sourceTable->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "bytes", bytes, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "cost", cost, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "oid", oid, NULL },
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -9167,7 +10187,8 @@ catalog_iter_s_index_in_progress_init(SourceIndexIterator *iter)
 		"         i.tableoid, t.qname, t.nspname, t.relname, "
 		"         isprimary, isunique, columns, i.sql, "
 		"         c.oid as constraintoid, conname, "
-		"         condeferrable, condeferred, c.sql as condef"
+		"         condeferrable, condeferred, c.sql as condef, "
+		"         coalesce(i.bytes, 0) as bytes, coalesce(i.cost, 0) as cost"
 		"    from process p "
 		"         join s_index i on p.indexoid = i.oid "
 		"         join s_table t on t.oid = i.tableoid "
@@ -9189,6 +10210,113 @@ catalog_iter_s_index_in_progress_init(SourceIndexIterator *iter)
 }
 
 
+/*
+ * catalog_iter_s_index_pending iterates over the indexes that are not built
+ * yet, in the order the CREATE INDEX workers pick them from their queue:
+ * highest estimated build cost first.
+ */
+bool
+catalog_iter_s_index_pending(DatabaseCatalog *catalog,
+							 void *context,
+							 SourceIndexIterFun *callback)
+{
+	SourceIndexIterator *iter =
+		(SourceIndexIterator *) calloc(1, sizeof(SourceIndexIterator));
+
+	iter->catalog = catalog;
+
+	if (!catalog_iter_s_index_pending_init(iter))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	for (;;)
+	{
+		if (!catalog_iter_s_index_next(iter))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		SourceIndex *index = iter->index;
+
+		if (index == NULL)
+		{
+			if (!catalog_iter_s_index_finish(iter))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+
+			break;
+		}
+
+		/* now call the provided callback */
+		if (!(*callback)(context, index))
+		{
+			log_error("Failed to iterate over list of indexs, "
+					  "see above for details");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ * catalog_iter_s_index_pending_init initializes an Interator over our catalog
+ * of SourceIndex entries that have not been started yet.
+ */
+bool
+catalog_iter_s_index_pending_init(SourceIndexIterator *iter)
+{
+	sqlite3 *db = iter->catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: Failed to initialize s_index iterator: db is NULL");
+		return false;
+	}
+
+	iter->index = (SourceIndex *) calloc(1, sizeof(SourceIndex));
+
+	if (iter->index == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	char *sql =
+		"  select i.oid, i.qname, i.nspname, i.relname, i.restore_list_name, "
+		"         i.tableoid, t.qname, t.nspname, t.relname, "
+		"         isprimary, isunique, columns, i.sql, "
+		"         c.oid as constraintoid, conname, "
+		"         condeferrable, condeferred, c.sql as condef, "
+		"         coalesce(i.bytes, 0) as bytes, coalesce(i.cost, 0) as cost"
+		"    from s_index i "
+		"         join s_table t on t.oid = i.tableoid "
+		"         left join s_constraint c on c.indexoid = i.oid"
+		"   where not exists "
+		"         (select 1 from summary s where s.indexoid = i.oid) "
+		"order by coalesce(i.cost, 0) desc, i.oid";
+
+	SQLiteQuery *query = &(iter->query);
+
+	query->context = iter->index;
+	query->fetchFunction = &catalog_s_index_fetch;
+
+	if (!catalog_sql_prepare(db, sql, query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
 /*
  * catalog_count_summary_done counts the number of tables and indexes that have
  * already been processed from the summary table.
@@ -9269,6 +10397,96 @@ catalog_count_summary_done_fetch(SQLiteQuery *query)
 }
 
 
+/*
+ * catalog_progress_bytes computes how many bytes of table data and indexes
+ * are done, out of the total, and when the first COPY and CREATE INDEX
+ * commands started. Table parts count for their share of the table bytes.
+ */
+bool
+catalog_progress_bytes(DatabaseCatalog *catalog, CatalogProgressBytes *bytes)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: catalog_progress_bytes: db is NULL");
+		return false;
+	}
+
+	char *sql =
+		"select "
+		"  (select coalesce(sum(bytes), 0) from s_table_size) as tbltotal, "
+		"  ("
+		"    select coalesce(sum(ts.bytes / coalesce(p.partcount, 1)), 0) "
+		"      from summary s "
+		"           join s_table_size ts on ts.oid = s.tableoid "
+		"           left join s_table_part p "
+		"                  on p.oid = s.tableoid and p.partnum = s.partnum "
+		"     where s.tableoid is not null "
+		"       and s.done_time_epoch is not null"
+		"  ) as tbldone, "
+		"  ("
+		"    select coalesce(min(start_time_epoch), 0) "
+		"      from summary "
+		"     where tableoid is not null"
+		"  ) as tblstart, "
+		"  (select coalesce(sum(bytes), 0) from s_index) as idxtotal, "
+		"  ("
+		"    select coalesce(sum(i.bytes), 0) "
+		"      from summary s join s_index i on i.oid = s.indexoid "
+		"     where s.done_time_epoch is not null"
+		"  ) as idxdone, "
+		"  ("
+		"    select coalesce(min(start_time_epoch), 0) "
+		"      from summary "
+		"     where indexoid is not null"
+		"  ) as idxstart";
+
+	SQLiteQuery query = {
+		.context = bytes,
+		.fetchFunction = &catalog_progress_bytes_fetch
+	};
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* now execute the query, which return exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * catalog_progress_bytes_fetch fetches a CatalogProgressBytes from a query
+ * ppStmt result.
+ */
+bool
+catalog_progress_bytes_fetch(SQLiteQuery *query)
+{
+	CatalogProgressBytes *bytes = (CatalogProgressBytes *) query->context;
+
+	/* cleanup the memory area before re-use */
+	bzero(bytes, sizeof(CatalogProgressBytes));
+
+	bytes->tableBytes = sqlite3_column_int64(query->ppStmt, 0);
+	bytes->tableBytesDone = sqlite3_column_int64(query->ppStmt, 1);
+	bytes->tableStartTime = sqlite3_column_int64(query->ppStmt, 2);
+	bytes->indexBytes = sqlite3_column_int64(query->ppStmt, 3);
+	bytes->indexBytesDone = sqlite3_column_int64(query->ppStmt, 4);
+	bytes->indexStartTime = sqlite3_column_int64(query->ppStmt, 5);
+
+	return true;
+}
+
+
 /*
  * catalog_add_timeline_history inserts a timeline history entry to our
  * internal catalogs database.
@@ -275,6 +275,19 @@ bool catalog_add_s_table(DatabaseCatalog *catalog, SourceTable *table);
 bool catalog_add_attributes(DatabaseCatalog *catalog, SourceTable *table);
 bool catalog_add_s_table_part(DatabaseCatalog *catalog, SourceTable *table);
 
+bool catalog_s_table_part_start(DatabaseCatalog *catalog, SourceTable *table);
+bool catalog_s_table_part_reset(DatabaseCatalog *catalog, SourceTable *table);
+bool catalog_s_table_part_claim(DatabaseCatalog *catalog,
+								SourceTable *table,
+								int64_t *stepMin,
+								int64_t *stepMax,
+								bool *done);
+bool catalog_s_table_part_copied(DatabaseCatalog *catalog, SourceTable *table);
+bool catalog_s_table_part_steal(DatabaseCatalog *catalog,
+								uint32_t *oid,
+								int *partNumber,
+								bool *found);
+
 bool catalog_add_s_table_chksum(DatabaseCatalog *catalog,
 								SourceTable *table,
 								TableChecksum *srcChk,
@@ -466,6 +479,13 @@ bool catalog_s_fk_constraint_fetch(SQLiteQuery *query);
 bool catalog_add_s_seq(DatabaseCatalog *catalog, SourceSequence *index);
 bool catalog_update_sequence_values(DatabaseCatalog *catalog, SourceSequence *seq);
 bool catalog_update_s_table_relpages(DatabaseCatalog *catalog, SourceTable *sourceTable);
+bool catalog_update_s_table_parent(DatabaseCatalog *catalog,
+								   uint32_t oid,
+								   uint32_t parentOid);
+bool catalog_update_s_index_estimates(DatabaseCatalog *catalog,
+									  uint32_t oid,
+									  int64_t bytes,
+									  int64_t cost);
 
 typedef bool (SourceSequenceIterFun)(void *context, SourceSequence *seq);
 
@@ -491,6 +511,19 @@ bool catalog_iter_s_seq_finish(SourceSeqIterator *iter);
 
 bool catalog_s_seq_fetch(SQLiteQuery *query);
 
+/*
+ * Large Objects
+ */
+bool catalog_add_s_blob(DatabaseCatalog *catalog, SourceBlob *blob);
+bool catalog_delete_s_blob_all(DatabaseCatalog *catalog);
+
+typedef bool (SourceBlobIterFun)(void *context, SourceBlob *blob);
+
+bool catalog_iter_s_blob(DatabaseCatalog *catalog,
+						 bool bySize,
+						 void *context,
+						 SourceBlobIterFun *callback);
+
 /*
  * Filtering is done through a single table that concatenates the Oid and
  * pg_restore archives TOC list names (restore_list_name) in such a way that we
@@ -713,6 +746,12 @@ bool catalog_iter_s_index_in_progress(DatabaseCatalog *catalog,
 
 bool catalog_iter_s_index_in_progress_init(SourceIndexIterator *iter);
 
+bool catalog_iter_s_index_pending(DatabaseCatalog *catalog,
+								  void *context,
+								  SourceIndexIterFun *callback);
+
+bool catalog_iter_s_index_pending_init(SourceIndexIterator *iter);
+
 
 typedef struct CatalogProgressCount
 {
@@ -724,6 +763,21 @@ bool catalog_count_summary_done(DatabaseCatalog *catalog,
 								CatalogProgressCount *count);
 bool catalog_count_summary_done_fetch(SQLiteQuery *query);
 
+typedef struct CatalogProgressBytes
+{
+	int64_t tableBytes;
+	int64_t tableBytesDone;
+	uint64_t tableStartTime;    /* first COPY start time, epoch */
+
+	int64_t indexBytes;
+	int64_t indexBytesDone;
+	uint64_t indexStartTime;    /* first CREATE INDEX start time, epoch */
+} CatalogProgressBytes;
+
+bool catalog_progress_bytes(DatabaseCatalog *catalog,
+							CatalogProgressBytes *bytes);
+bool catalog_progress_bytes_fetch(SQLiteQuery *query);
+
 
 /*
  * Logical decoding
@@ -34,6 +34,7 @@
 	"  --restore-jobs                Number of concurrent jobs for pg_restore\n" \
 	"  --restore-tolerance           Max pg_restore errors to tolerate (default 10)\n" \
 	"  --large-objects-jobs          Number of concurrent Large Objects jobs to run\n" \
+	"  --large-objects-batch-size    Copy small Large Objects in batches of that size\n" \
 	"  --split-tables-larger-than    Same-table concurrency size threshold\n" \
 	"  --split-max-parts             Maximum number of jobs for Same-table concurrency \n" \
 	"  --estimate-table-sizes        Allow using estimates for relation sizes\n" \
@@ -68,9 +69,17 @@
 	"  --create-slot                 Create the replication slot\n" \
 	"  --origin                      Use this Postgres replication origin node name\n" \
 	"  --endpos                      Stop replaying changes when reaching this LSN\n" \
+	"  --apply-jobs                  Number of concurrent connections to apply changes\n" \
+	"  --transform-format            Format of the transformed files: sql or binary\n" \
 	"  --defer-indexes               Defer index building until after all table data is copied\n" \
 	"  --defer-analyze               Defer ANALYZE until after post-data restore\n" \
 	"  --use-copy-binary             Use the COPY BINARY format for COPY operations\n" \
+	"  --copy-buffer-size            Size of the chunks COPY rows are packed into\n" \
+	"  --copy-format                 COPY format: text, binary, or auto\n" \
+	"  --index-memory-budget         Memory shared by concurrent CREATE INDEX jobs\n" \
+	"  --shared-index-scan           Build all indexes of a table at the same time\n" \
+	"  --freeze                      Make sure all copied rows end up frozen\n" \
+	"  --unlogged                    COPY into UNLOGGED tables, then SET LOGGED\n" \
 
 CommandLine clone_command =
 	make_command(
@@ -109,7 +118,9 @@ CommandLine follow_command =
 		"  --slot-name                   Use this Postgres replication slot name\n"
 		"  --create-slot                 Create the replication slot\n"
 		"  --origin                      Use this Postgres replication origin node name\n"
-		"  --endpos                      Stop replaying changes when reaching this LSN\n",
+		"  --endpos                      Stop replaying changes when reaching this LSN\n"
+		"  --apply-jobs                  Number of concurrent connections to apply changes\n"
+		"  --transform-format            Format of the transformed files: sql or binary\n",
 		cli_copy_db_getopts,
 		cli_follow);
 
@@ -230,6 +241,9 @@ clone_and_follow(CopyDataSpec *copySpecs)
 		exit(EXIT_CODE_INTERNAL_ERROR);
 	}
 
+	streamSpecs.applyJobs = copyDBoptions.applyJobs;
+	streamSpecs.transformFormat = copyDBoptions.transformFormat;
+
 	/*
 	 * When using pgcopydb clone --follow --restart we first cleanup the
 	 * previous setup, and that includes dropping the replication slot.
@@ -566,6 +580,9 @@ cli_follow(int argc, char **argv)
 		exit(EXIT_CODE_INTERNAL_ERROR);
 	}
 
+	specs.applyJobs = copyDBoptions.applyJobs;
+	specs.transformFormat = copyDBoptions.transformFormat;
+
 	/*
 	 * First create/export a snapshot for the whole clone --follow operations.
 	 */
@@ -203,6 +203,72 @@ cli_copydb_getenv_split(SplitTableLargerThan *splitTablesLargerThan)
 }
 
 
+/*
+ * cli_copydb_getenv_copy_buffer_size reads the PGCOPYDB_COPY_BUFFER_SIZE
+ * environment variable and fills in the given bytes value.
+ */
+bool
+cli_copydb_getenv_copy_buffer_size(uint64_t *copyBufferSize)
+{
+	if (env_exists(PGCOPYDB_COPY_BUFFER_SIZE))
+	{
+		char bytes[BUFSIZE] = { 0 };
+		char bytesPretty[BUFSIZE] = { 0 };
+
+		if (!get_env_copy(PGCOPYDB_COPY_BUFFER_SIZE, bytes, sizeof(bytes)))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (!cli_parse_copy_buffer_size(bytes,
+										copyBufferSize,
+										bytesPretty,
+										sizeof(bytesPretty)))
+		{
+			log_fatal("Failed to parse PGCOPYDB_COPY_BUFFER_SIZE: \"%s\"",
+					  bytes);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ * cli_copydb_getenv_index_memory_budget reads the PGCOPYDB_INDEX_MEMORY_BUDGET
+ * environment variable and fills in the given bytes value.
+ */
+bool
+cli_copydb_getenv_index_memory_budget(uint64_t *indexMemoryBudget)
+{
+	if (env_exists(PGCOPYDB_INDEX_MEMORY_BUDGET))
+	{
+		char bytes[BUFSIZE] = { 0 };
+		char bytesPretty[BUFSIZE] = { 0 };
+
+		if (!get_env_copy(PGCOPYDB_INDEX_MEMORY_BUDGET, bytes, sizeof(bytes)))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (!cli_parse_index_memory_budget(bytes,
+										   indexMemoryBudget,
+										   bytesPretty,
+										   sizeof(bytesPretty)))
+		{
+			log_fatal("Failed to parse PGCOPYDB_INDEX_MEMORY_BUDGET: \"%s\"",
+					  bytes);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
 /*
  * cli_copydb_getenv reads from the environment variables and fills-in the
  * command line options.
@@ -219,6 +285,10 @@ cli_copydb_getenv(CopyDBOptions *options)
 	options->lObjectJobs = DEFAULT_LARGE_OBJECTS_JOBS;
 	options->splitTablesLargerThan.bytes = DEFAULT_SPLIT_TABLES_LARGER_THAN;
 	options->restoreOptions.restoreTolerance = DEFAULT_RESTORE_TOLERANCE;
+	options->copyBufferSize = DEFAULT_COPY_BUFFER_SIZE;
+	options->copyFormat = COPY_FORMAT_TEXT;
+	options->applyJobs = DEFAULT_APPLY_JOBS;
+	options->transformFormat = STREAM_FORMAT_SQL;
 
 	EnvParser parsers[] = {
 		{ PGCOPYDB_TABLE_JOBS, ENV_TYPE_INT,
@@ -229,6 +299,8 @@ cli_copydb_getenv(CopyDBOptions *options)
 		  &(options->restoreOptions.jobs), 0, true, 1, true, 128 },
 		{ PGCOPYDB_LARGE_OBJECTS_JOBS, ENV_TYPE_INT,
 		  &(options->lObjectJobs), 0, true, 1, true, 128 },
+		{ PGCOPYDB_LARGE_OBJECTS_BATCH_SIZE, ENV_TYPE_INT,
+		  &(options->lObjectBatchSize), 0, true, 0, true, MAX_BLOB_BATCH_SIZE },
 		{ PGCOPYDB_SPLIT_MAX_PARTS, ENV_TYPE_INT,
 		  &(options->splitMaxParts), 0, true, 1 },
 		{ PGCOPYDB_ESTIMATE_TABLE_SIZES, ENV_TYPE_BOOL,
@@ -260,7 +332,15 @@ cli_copydb_getenv(CopyDBOptions *options)
 		{ PGCOPYDB_DEFER_INDEXES, ENV_TYPE_BOOL,
 		  &(options->deferIndexes) },
 		{ PGCOPYDB_DEFER_ANALYZE, ENV_TYPE_BOOL,
-		  &(options->deferAnalyze) }
+		  &(options->deferAnalyze) },
+		{ PGCOPYDB_SHARED_INDEX_SCAN, ENV_TYPE_BOOL,
+		  &(options->sharedIndexScan) },
+		{ PGCOPYDB_FREEZE, ENV_TYPE_BOOL,
+		  &(options->freeze) },
+		{ PGCOPYDB_UNLOGGED, ENV_TYPE_BOOL,
+		  &(options->unlogged) },
+		{ PGCOPYDB_APPLY_JOBS, ENV_TYPE_INT,
+		  &(options->applyJobs), 0, true, 1, true, 128 }
 	};
 
 	int parserCount = sizeof(parsers) / sizeof(parsers[0]);
@@ -295,6 +375,68 @@ cli_copydb_getenv(CopyDBOptions *options)
 		++errors;
 	}
 
+	if (!cli_copydb_getenv_copy_buffer_size(&(options->copyBufferSize)))
+	{
+		/* errors have already been logged */
+		++errors;
+	}
+
+	if (!cli_copydb_getenv_index_memory_budget(&(options->indexMemoryBudget)))
+	{
+		/* errors have already been logged */
+		++errors;
+	}
+
+	/* check --copy-format environment variable */
+	if (env_exists(PGCOPYDB_COPY_FORMAT))
+	{
+		char format[BUFSIZE] = { 0 };
+
+		if (!get_env_copy(PGCOPYDB_COPY_FORMAT, format, BUFSIZE))
+		{
+			/* errors have already been logged */
+			++errors;
+		}
+
+		options->copyFormat = CopyDataFormatFromString(format);
+
+		if (options->copyFormat == COPY_FORMAT_UNKNOWN)
+		{
+			log_fatal("Unknown COPY format \"%s\", please use either "
+					  "text (the default), binary, or auto",
+					  format);
+			++errors;
+		}
+	}
+
+	/* PGCOPYDB_USE_COPY_BINARY is the same as PGCOPYDB_COPY_FORMAT=binary */
+	if (options->useCopyBinary)
+	{
+		options->copyFormat = COPY_FORMAT_BINARY;
+	}
+
+	/* check --transform-format environment variable */
+	if (env_exists(PGCOPYDB_TRANSFORM_FORMAT))
+	{
+		char format[BUFSIZE] = { 0 };
+
+		if (!get_env_copy(PGCOPYDB_TRANSFORM_FORMAT, format, BUFSIZE))
+		{
+			/* errors have already been logged */
+			++errors;
+		}
+
+		options->transformFormat = TransformFormatFromString(format);
+
+		if (options->transformFormat == STREAM_FORMAT_UNKNOWN)
+		{
+			log_fatal("Unknown transform format \"%s\", please use either "
+					  "sql (the default) or binary",
+					  format);
+			++errors;
+		}
+	}
+
 	/* check --plugin environment variable */
 	if (env_exists(PGCOPYDB_OUTPUT_PLUGIN))
 	{
@@ -654,6 +796,15 @@ cli_copy_db_getopts(int argc, char **argv)
 		{ "restore-tolerance", required_argument, NULL, 256 },
 		{ "defer-indexes", no_argument, NULL, 257 },
 		{ "defer-analyze", no_argument, NULL, 258 },
+		{ "copy-buffer-size", required_argument, NULL, 259 },
+		{ "copy-format", required_argument, NULL, 260 },
+		{ "index-memory-budget", required_argument, NULL, 261 },
+		{ "shared-index-scan", no_argument, NULL, 262 },
+		{ "freeze", no_argument, NULL, 263 },
+		{ "unlogged", no_argument, NULL, 264 },
+		{ "large-objects-batch-size", required_argument, NULL, 265 },
+		{ "apply-jobs", required_argument, NULL, 266 },
+		{ "transform-format", required_argument, NULL, 267 },
 		{ "help", no_argument, NULL, 'h' },
 		{ NULL, 0, NULL, 0 }
 	};
@@ -1118,6 +1269,7 @@ cli_copy_db_getopts(int argc, char **argv)
 			case 'n':
 			{
 				options.useCopyBinary = true;
+				options.copyFormat = COPY_FORMAT_BINARY;
 				log_trace("--use-copy-binary");
 				break;
 			}
@@ -1149,6 +1301,122 @@ cli_copy_db_getopts(int argc, char **argv)
 				break;
 			}
 
+			case 259:
+			{
+				char bytesPretty[BUFSIZE] = { 0 };
+
+				if (!cli_parse_copy_buffer_size(optarg,
+												&(options.copyBufferSize),
+												bytesPretty,
+												sizeof(bytesPretty)))
+				{
+					log_fatal("Failed to parse --copy-buffer-size: \"%s\"",
+							  optarg);
+					++errors;
+				}
+
+				log_trace("--copy-buffer-size %s", bytesPretty);
+				break;
+			}
+
+			case 260:
+			{
+				options.copyFormat = CopyDataFormatFromString(optarg);
+
+				if (options.copyFormat == COPY_FORMAT_UNKNOWN)
+				{
+					log_fatal("Unknown COPY format \"%s\", please use either "
+							  "text (the default), binary, or auto",
+							  optarg);
+					++errors;
+				}
+
+				log_trace("--copy-format %s", optarg);
+				break;
+			}
+
+			case 261:
+			{
+				char bytesPretty[BUFSIZE] = { 0 };
+
+				if (!cli_parse_index_memory_budget(optarg,
+												   &(options.indexMemoryBudget),
+												   bytesPretty,
+												   sizeof(bytesPretty)))
+				{
+					log_fatal("Failed to parse --index-memory-budget: \"%s\"",
+							  optarg);
+					++errors;
+				}
+
+				log_trace("--index-memory-budget %s", bytesPretty);
+				break;
+			}
+
+			case 262:
+			{
+				options.sharedIndexScan = true;
+				log_trace("--shared-index-scan");
+				break;
+			}
+
+			case 263:
+			{
+				options.freeze = true;
+				log_trace("--freeze");
+				break;
+			}
+
+			case 264:
+			{
+				options.unlogged = true;
+				log_trace("--unlogged");
+				break;
+			}
+
+			case 265:
+			{
+				if (!stringToInt(optarg, &options.lObjectBatchSize) ||
+					options.lObjectBatchSize < 0 ||
+					options.lObjectBatchSize > MAX_BLOB_BATCH_SIZE)
+				{
+					log_fatal("Failed to parse --large-objects-batch-size: \"%s\"",
+							  optarg);
+					++errors;
+				}
+				log_trace("--large-objects-batch-size %d", options.lObjectBatchSize);
+				break;
+			}
+
+			case 266:
+			{
+				if (!stringToInt(optarg, &options.applyJobs) ||
+					options.applyJobs < 1 ||
+					options.applyJobs > 128)
+				{
+					log_fatal("Failed to parse --apply-jobs: \"%s\"", optarg);
+					++errors;
+				}
+				log_trace("--apply-jobs %d", options.applyJobs);
+				break;
+			}
+
+			case 267:
+			{
+				options.transformFormat = TransformFormatFromString(optarg);
+
+				if (options.transformFormat == STREAM_FORMAT_UNKNOWN)
+				{
+					log_fatal("Unknown transform format \"%s\", please use "
+							  "either sql (the default) or binary",
+							  optarg);
+					++errors;
+				}
+
+				log_trace("--transform-format %s", optarg);
+				break;
+			}
+
 			case '?':
 			default:
 			{
@@ -1173,6 +1441,13 @@ cli_copy_db_getopts(int argc, char **argv)
 		options.deferAnalyze = false;
 	}
 
+	if (options.freeze && (options.skipVacuum || options.deferAnalyze))
+	{
+		log_warn("--freeze relies on the VACUUM jobs for tables that can't "
+				 "use COPY FREEZE, which are skipped with %s",
+				 options.skipVacuum ? "--skip-vacuum" : "--defer-analyze");
+	}
+
 	if (options.connStrings.source_pguri == NULL ||
 		options.connStrings.target_pguri == NULL)
 	{
@@ -1240,6 +1515,83 @@ cli_parse_bytes_pretty(const char *byteString,
 }
 
 
+/*
+ * cli_parse_copy_buffer_size parses the --copy-buffer-size value and checks
+ * that it is within the supported range.
+ */
+bool
+cli_parse_copy_buffer_size(const char *byteString,
+						   uint64_t *bytes,
+						   char *bytesPretty,
+						   size_t bytesPrettySize)
+{
+	if (!cli_parse_bytes_pretty(byteString, bytes, bytesPretty, bytesPrettySize))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (*bytes < MIN_COPY_BUFFER_SIZE || *bytes > MAX_COPY_BUFFER_SIZE)
+	{
+		char minPretty[BUFSIZE] = { 0 };
+		char maxPretty[BUFSIZE] = { 0 };
+
+		(void) pretty_print_bytes(minPretty, sizeof(minPretty),
+								  MIN_COPY_BUFFER_SIZE);
+		(void) pretty_print_bytes(maxPretty, sizeof(maxPretty),
+								  MAX_COPY_BUFFER_SIZE);
+
+		log_error("COPY buffer size %s is out of range, "
+				  "expected a value between %s and %s",
+				  bytesPretty,
+				  minPretty,
+				  maxPretty);
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * cli_parse_index_memory_budget parses the --index-memory-budget value and
+ * checks that it allows for at least one CREATE INDEX memory unit.
+ */
+bool
+cli_parse_index_memory_budget(const char *byteString,
+							  uint64_t *bytes,
+							  char *bytesPretty,
+							  size_t bytesPrettySize)
+{
+	if (!cli_parse_bytes_pretty(byteString, bytes, bytesPretty, bytesPrettySize))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	uint64_t maxBudget = (uint64_t) INDEX_MEMORY_MAX_UNITS * INDEX_MEMORY_UNIT;
+
+	if (*bytes < INDEX_MEMORY_UNIT || *bytes > maxBudget)
+	{
+		char minPretty[BUFSIZE] = { 0 };
+		char maxPretty[BUFSIZE] = { 0 };
+
+		(void) pretty_print_bytes(minPretty, sizeof(minPretty),
+								  INDEX_MEMORY_UNIT);
+		(void) pretty_print_bytes(maxPretty, sizeof(maxPretty), maxBudget);
+
+		log_error("Index memory budget %s is out of range, "
+				  "expected a value between %s and %s",
+				  bytesPretty,
+				  minPretty,
+				  maxPretty);
+		return false;
+	}
+
+	return true;
+}
+
+
 /*
  * copydb_prepare_pguris prepares version of Postgres connections strings to
  * source and target without security sensible information (password is
@@ -53,6 +53,7 @@ typedef struct CopyDBOptions
 	int tableJobs;
 	int indexJobs;
 	int lObjectJobs;
+	int lObjectBatchSize;
 
 	SplitTableLargerThan splitTablesLargerThan;
 	int splitMaxParts;
@@ -73,9 +74,15 @@ typedef struct CopyDBOptions
 	bool skipXidCheck;
 	bool deferIndexes;
 	bool deferAnalyze;
+	bool sharedIndexScan;
+	bool freeze;
+	bool unlogged;
 	bool noRolesPasswords;
 	bool failFast;
 	bool useCopyBinary;
+	CopyDataFormat copyFormat;
+	uint64_t copyBufferSize;
+	uint64_t indexMemoryBudget;
 
 	bool restart;
 	bool resume;
@@ -84,6 +91,8 @@ typedef struct CopyDBOptions
 	ReplicationSlot slot;
 	char snapshot[BUFSIZE];
 	char origin[BUFSIZE];
+	int applyJobs;
+	StreamTransformFormat transformFormat;
 
 	bool stdIn;
 	bool stdOut;
@@ -114,6 +123,8 @@ char * logLevelToString(int logLevel);
 
 bool cli_copydb_getenv_source_pguri(char **pguri);
 bool cli_copydb_getenv_split(SplitTableLargerThan *splitTablesLargerThan);
+bool cli_copydb_getenv_copy_buffer_size(uint64_t *copyBufferSize);
+bool cli_copydb_getenv_index_memory_budget(uint64_t *indexMemoryBudget);
 
 bool cli_copydb_getenv(CopyDBOptions *options);
 bool cli_copydb_is_consistent(CopyDBOptions *options);
@@ -131,6 +142,16 @@ bool cli_parse_bytes_pretty(const char *byteString,
 							char *bytesPretty,
 							size_t bytesPrettySize);
 
+bool cli_parse_copy_buffer_size(const char *byteString,
+								uint64_t *bytes,
+								char *bytesPretty,
+								size_t bytesPrettySize);
+
+bool cli_parse_index_memory_budget(const char *byteString,
+								   uint64_t *bytes,
+								   char *bytesPretty,
+								   size_t bytesPrettySize);
+
 bool cli_prepare_pguris(ConnStrings *connStrings);
 
 #endif  /* CLI_COMMON_H */
@@ -34,26 +34,33 @@ static CommandLine copy_db_command =
 		"db",
 		"Copy an entire database from source to target",
 		" --source ... --target ... [ --table-jobs ... --index-jobs ... ] ",
-		"  --source              Postgres URI to the source database\n"
-		"  --target              Postgres URI to the target database\n"
-		"  --dir                 Work directory to use\n"
-		"  --table-jobs          Number of concurrent COPY jobs to run\n"
-		"  --index-jobs          Number of concurrent CREATE INDEX jobs to run\n"
-		"  --restore-jobs        Number of concurrent jobs for pg_restore\n"
-		"  --drop-if-exists      On the target database, clean-up from a previous run first\n"
-		"  --roles               Also copy roles found on source to target\n"
-		"  --no-owner            Do not set ownership of objects to match the original database\n"
-		"  --no-acl              Prevent restoration of access privileges (grant/revoke commands).\n"
-		"  --no-comments         Do not output commands to restore comments\n"
-		"  --no-tablespaces      Do not output commands to select tablespaces\n"
-		"  --skip-large-objects  Skip copying large objects (blobs)\n"
-		"  --filters <filename>  Use the filters defined in <filename>\n"
-		"  --fail-fast           Abort early in case of error\n"
-		"  --restart             Allow restarting when temp files exist already\n"
-		"  --resume              Allow resuming operations after a failure\n"
-		"  --not-consistent      Allow taking a new snapshot on the source database\n"
-		"  --snapshot            Use snapshot obtained with pg_export_snapshot\n"
-		"  --use-copy-binary     Use the COPY BINARY format for COPY operations\n",
+		"  --source                   Postgres URI to the source database\n"
+		"  --target                   Postgres URI to the target database\n"
+		"  --dir                      Work directory to use\n"
+		"  --table-jobs               Number of concurrent COPY jobs to run\n"
+		"  --index-jobs               Number of concurrent CREATE INDEX jobs to run\n"
+		"  --restore-jobs             Number of concurrent jobs for pg_restore\n"
+		"  --drop-if-exists           On the target database, clean-up from a previous run first\n"
+		"  --roles                    Also copy roles found on source to target\n"
+		"  --no-owner                 Do not set ownership of objects to match the original database\n"
+		"  --no-acl                   Prevent restoration of access privileges (grant/revoke commands).\n"
+		"  --no-comments              Do not output commands to restore comments\n"
+		"  --no-tablespaces           Do not output commands to select tablespaces\n"
+		"  --skip-large-objects       Skip copying large objects (blobs)\n"
+		"  --filters <filename>       Use the filters defined in <filename>\n"
+		"  --fail-fast                Abort early in case of error\n"
+		"  --restart                  Allow restarting when temp files exist already\n"
+		"  --resume                   Allow resuming operations after a failure\n"
+		"  --not-consistent           Allow taking a new snapshot on the source database\n"
+		"  --snapshot                 Use snapshot obtained with pg_export_snapshot\n"
+		"  --use-copy-binary          Use the COPY BINARY format for COPY operations\n"
+		"  --copy-buffer-size         Size of the chunks COPY rows are packed into\n"
+		"  --copy-format              COPY format: text, binary, or auto\n"
+		"  --index-memory-budget      Memory shared by concurrent CREATE INDEX jobs\n"
+		"  --shared-index-scan        Build all indexes of a table at the same time\n"
+		"  --freeze                   Make sure all copied rows end up frozen\n"
+		"  --unlogged                 COPY into UNLOGGED tables, then SET LOGGED\n"
+		"  --large-objects-batch-size Copy small Large Objects in batches of that size\n",
 		cli_copy_db_getopts,
 		cli_clone);
 
@@ -143,15 +150,16 @@ static CommandLine copy_blobs_command =
 		"blobs",
 		"Copy the blob data from the source database to the target",
 		" --source ... --target ... [ --table-jobs ... --index-jobs ... ] ",
-		"  --source             Postgres URI to the source database\n"
-		"  --target             Postgres URI to the target database\n"
-		"  --dir                Work directory to use\n"
-		"  --large-objects-jobs Number of concurrent Large Objects jobs to run\n"
-		"  --drop-if-exists     On the target database, drop and create large objects\n"
-		"  --restart            Allow restarting when temp files exist already\n"
-		"  --resume             Allow resuming operations after a failure\n"
-		"  --not-consistent     Allow taking a new snapshot on the source database\n"
-		"  --snapshot           Use snapshot obtained with pg_export_snapshot\n",
+		"  --source                   Postgres URI to the source database\n"
+		"  --target                   Postgres URI to the target database\n"
+		"  --dir                      Work directory to use\n"
+		"  --large-objects-jobs       Number of concurrent Large Objects jobs to run\n"
+		"  --large-objects-batch-size Copy small Large Objects in batches of that size\n"
+		"  --drop-if-exists           On the target database, drop and create large objects\n"
+		"  --restart                  Allow restarting when temp files exist already\n"
+		"  --resume                   Allow resuming operations after a failure\n"
+		"  --not-consistent           Allow taking a new snapshot on the source database\n"
+		"  --snapshot                 Use snapshot obtained with pg_export_snapshot\n",
 		cli_copy_db_getopts,
 		cli_copy_blobs);
 
@@ -176,15 +184,17 @@ static CommandLine copy_indexes_command =
 		"indexes",
 		"Create all the indexes found in the source database in the target",
 		" --source ... --target ... [ --table-jobs ... --index-jobs ... ] ",
-		"  --source             Postgres URI to the source database\n"
-		"  --target             Postgres URI to the target database\n"
-		"  --dir                Work directory to use\n"
-		"  --index-jobs         Number of concurrent CREATE INDEX jobs to run\n"
-		"  --restore-jobs       Number of concurrent jobs for pg_restore\n"
-		"  --filters <filename> Use the filters defined in <filename>\n"
-		"  --restart            Allow restarting when temp files exist already\n"
-		"  --resume             Allow resuming operations after a failure\n"
-		"  --not-consistent     Allow taking a new snapshot on the source database\n",
+		"  --source              Postgres URI to the source database\n"
+		"  --target              Postgres URI to the target database\n"
+		"  --dir                 Work directory to use\n"
+		"  --index-jobs          Number of concurrent CREATE INDEX jobs to run\n"
+		"  --restore-jobs        Number of concurrent jobs for pg_restore\n"
+		"  --filters <filename>  Use the filters defined in <filename>\n"
+		"  --restart             Allow restarting when temp files exist already\n"
+		"  --resume              Allow resuming operations after a failure\n"
+		"  --not-consistent      Allow taking a new snapshot on the source database\n"
+		"  --index-memory-budget Memory shared by concurrent CREATE INDEX jobs\n"
+		"  --shared-index-scan   Build all indexes of a table at the same time\n",
 		cli_copy_db_getopts,
 		cli_copy_indexes);
 
@@ -2202,6 +2202,56 @@ cli_list_progress(int argc, char **argv)
 				progress.indexCount,
 				progress.indexInProgress.count,
 				progress.indexDoneCount);
+
+		fformat(stdout, "\n");
+
+		char eta[BUFSIZE] = { 0 };
+		char tableRate[BUFSIZE] = { 0 };
+		char indexRate[BUFSIZE] = { 0 };
+
+		if (progress.tableEtaKnown || progress.indexEtaKnown)
+		{
+			(void) IntervalToString(progress.etaMs, eta, sizeof(eta));
+		}
+		else
+		{
+			strlcpy(eta, "unknown", sizeof(eta));
+		}
+
+		(void) pretty_print_bytes_per_second(tableRate, sizeof(tableRate),
+											 progress.bytes.tableBytesDone,
+											 progress.tableElapsedMs);
+
+		(void) pretty_print_bytes_per_second(indexRate, sizeof(indexRate),
+											 progress.bytes.indexBytesDone,
+											 progress.indexElapsedMs);
+
+		if (progress.indexPending.count > 0)
+		{
+			fformat(stdout, "Next indexes to build, by estimated cost:\n");
+
+			for (int i = 0; i < progress.indexPending.count; i++)
+			{
+				SourceIndex *index = &(progress.indexPending.array[i]);
+				char bytesPretty[BUFSIZE] = { 0 };
+
+				(void) pretty_print_bytes(bytesPretty,
+										  sizeof(bytesPretty),
+										  index->bytes);
+
+				fformat(stdout, "  %2d. %s on %s (%s)\n",
+						i + 1,
+						index->indexQname,
+						index->tableQname,
+						bytesPretty);
+			}
+
+			fformat(stdout, "\n");
+		}
+
+		fformat(stdout, "Table data throughput: %s\n", tableRate);
+		fformat(stdout, "Index build throughput: %s\n", indexRate);
+		fformat(stdout, "Estimated time remaining: %s\n", eta);
 	}
 }
 
@@ -621,6 +621,15 @@ cli_sentinel_get(int argc, char **argv)
 		exit(EXIT_CODE_SOURCE);
 	}
 
+	/* with --apply-jobs, also show the progress of each apply connection */
+	CopyDBSentinelApplyWorkerArray workers = { 0, NULL };
+
+	if (!sentinel_apply_worker_array(sourceDB, &workers))
+	{
+		/* errors have already been logged */
+		exit(EXIT_CODE_SOURCE);
+	}
+
 	if (sentinelDBoptions.sentinelOptions.startpos)
 	{
 		fformat(stdout, "%X/%X\n", LSN_FORMAT_ARGS(sentinel.startpos));
@@ -674,6 +683,39 @@ cli_sentinel_get(int argc, char **argv)
 		json_object_set_string(jsobj, "flush_lsn", flush_lsn);
 		json_object_set_string(jsobj, "replay_lsn", replay_lsn);
 
+		if (workers.count > 0)
+		{
+			JSON_Value *jsWorkers = json_value_init_array();
+			JSON_Array *jsWorkersArray = json_value_get_array(jsWorkers);
+
+			for (int i = 0; i < workers.count; i++)
+			{
+				CopyDBSentinelApplyWorker *worker = &(workers.array[i]);
+
+				JSON_Value *jsWorker = json_value_init_object();
+				JSON_Object *jsWorkerObj = json_value_get_object(jsWorker);
+
+				char worker_lsn[PG_LSN_MAXLENGTH] = { 0 };
+
+				sformat(worker_lsn, PG_LSN_MAXLENGTH, "%X/%X",
+						LSN_FORMAT_ARGS(worker->replay_lsn));
+
+				json_object_set_number(jsWorkerObj, "id", worker->id);
+				json_object_set_string(jsWorkerObj, "origin", worker->origin);
+				json_object_set_string(jsWorkerObj, "replay_lsn", worker_lsn);
+				json_object_set_number(jsWorkerObj, "lag",
+									   (double) worker->lag);
+				json_object_set_number(jsWorkerObj, "transactions",
+									   (double) worker->txnCount);
+				json_object_set_number(jsWorkerObj, "waits",
+									   (double) worker->waitCount);
+
+				json_array_append_value(jsWorkersArray, jsWorker);
+			}
+
+			json_object_set_value(jsobj, "apply_workers", jsWorkers);
+		}
+
 		char *serialized_string = json_serialize_to_string_pretty(js);
 
 		fformat(stdout, "%s\n", serialized_string);
@@ -694,7 +736,26 @@ cli_sentinel_get(int argc, char **argv)
 				LSN_FORMAT_ARGS(sentinel.flush_lsn));
 		fformat(stdout, "%-10s %X/%X\n", "replay_lsn",
 				LSN_FORMAT_ARGS(sentinel.replay_lsn));
+
+		for (int i = 0; i < workers.count; i++)
+		{
+			CopyDBSentinelApplyWorker *worker = &(workers.array[i]);
+
+			char lag[BUFSIZE] = { 0 };
+			(void) pretty_print_bytes(lag, sizeof(lag), worker->lag);
+
+			fformat(stdout,
+					"%-10s %X/%X lag %s, %lld transactions, %lld waits (%s)\n",
+					"apply",
+					LSN_FORMAT_ARGS(worker->replay_lsn),
+					lag,
+					(long long) worker->txnCount,
+					(long long) worker->waitCount,
+					worker->origin);
+		}
 	}
+
+	free(workers.array);
 }
 
 
@@ -90,7 +90,8 @@ static CommandLine stream_prefetch_command =
 		"  --resume         Allow resuming operations after a failure\n"
 		"  --not-consistent Allow taking a new snapshot on the source database\n"
 		"  --slot-name      Stream changes recorded by this slot\n"
-		"  --endpos         LSN position where to stop receiving changes",
+		"  --endpos         LSN position where to stop receiving changes\n"
+		"  --transform-format  Format of the transformed files: sql or binary\n",
 		cli_stream_getopts,
 		cli_stream_prefetch);
 
@@ -107,7 +108,8 @@ static CommandLine stream_catchup_command =
 		"  --not-consistent Allow taking a new snapshot on the source database\n"
 		"  --slot-name      Stream changes recorded by this slot\n"
 		"  --endpos         LSN position where to stop receiving changes\n"
-		"  --origin         Name of the Postgres replication origin\n",
+		"  --origin         Name of the Postgres replication origin\n"
+		"  --apply-jobs     Number of concurrent apply connections\n",
 		cli_stream_getopts,
 		cli_stream_catchup);
 
@@ -124,7 +126,9 @@ static CommandLine stream_replay_command =
 		"  --not-consistent Allow taking a new snapshot on the source database\n"
 		"  --slot-name      Stream changes recorded by this slot\n"
 		"  --endpos         LSN position where to stop receiving changes\n"
-		"  --origin         Name of the Postgres replication origin\n",
+		"  --origin         Name of the Postgres replication origin\n"
+		"  --apply-jobs     Number of concurrent apply connections\n"
+		"  --transform-format  Format of the transformed files: sql or binary\n",
 		cli_stream_getopts,
 		cli_stream_replay);
 
@@ -153,7 +157,8 @@ static CommandLine stream_transform_command =
 		"  --dir            Work directory to use\n"
 		"  --restart        Allow restarting when temp files exist already\n"
 		"  --resume         Allow resuming operations after a failure\n"
-		"  --not-consistent Allow taking a new snapshot on the source database\n",
+		"  --not-consistent Allow taking a new snapshot on the source database\n"
+		"  --transform-format  Format of the transformed files: sql or binary\n",
 		cli_stream_getopts,
 		cli_stream_transform);
 
@@ -167,7 +172,8 @@ static CommandLine stream_apply_command =
 		"  --restart        Allow restarting when temp files exist already\n"
 		"  --resume         Allow resuming operations after a failure\n"
 		"  --not-consistent Allow taking a new snapshot on the source database\n"
-		"  --origin         Name of the Postgres replication origin\n",
+		"  --origin         Name of the Postgres replication origin\n"
+		"  --apply-jobs     Number of concurrent apply connections\n",
 		cli_stream_getopts,
 		cli_stream_apply);
 
@@ -216,6 +222,8 @@ cli_stream_getopts(int argc, char **argv)
 		{ "not-consistent", no_argument, NULL, 'C' },
 		{ "to-stdout", no_argument, NULL, 'O' },
 		{ "from-stdin", no_argument, NULL, 'I' },
+		{ "apply-jobs", required_argument, NULL, 266 },
+		{ "transform-format", required_argument, NULL, 267 },
 		{ "version", no_argument, NULL, 'V' },
 		{ "verbose", no_argument, NULL, 'v' },
 		{ "notice", no_argument, NULL, 'v' },
@@ -368,6 +376,35 @@ cli_stream_getopts(int argc, char **argv)
 				break;
 			}
 
+			case 266:
+			{
+				if (!stringToInt(optarg, &options.applyJobs) ||
+					options.applyJobs < 1 ||
+					options.applyJobs > 128)
+				{
+					log_fatal("Failed to parse --apply-jobs: \"%s\"", optarg);
+					++errors;
+				}
+				log_trace("--apply-jobs %d", options.applyJobs);
+				break;
+			}
+
+			case 267:
+			{
+				options.transformFormat = TransformFormatFromString(optarg);
+
+				if (options.transformFormat == STREAM_FORMAT_UNKNOWN)
+				{
+					log_fatal("Unknown transform format \"%s\", please use "
+							  "either sql (the default) or binary",
+							  optarg);
+					++errors;
+				}
+
+				log_trace("--transform-format %s", optarg);
+				break;
+			}
+
 			case 'V':
 			{
 				/* keeper_cli_print_version prints version and exits. */
@@ -735,6 +772,8 @@ cli_stream_catchup(int argc, char **argv)
 		exit(EXIT_CODE_INTERNAL_ERROR);
 	}
 
+	specs.applyJobs = streamDBoptions.applyJobs;
+
 	/*
 	 * First, we need to know enough about the source database system to be
 	 * able to generate WAL file names. That's means the current timeline and
@@ -819,6 +858,9 @@ cli_stream_replay(int argc, char **argv)
 		exit(EXIT_CODE_INTERNAL_ERROR);
 	}
 
+	specs.applyJobs = streamDBoptions.applyJobs;
+	specs.transformFormat = streamDBoptions.transformFormat;
+
 	/*
 	 * Remove the possibly still existing stream context files from
 	 * previous round of operations (--resume, etc). We want to make sure
@@ -945,6 +987,8 @@ cli_stream_transform(int argc, char **argv)
 		exit(EXIT_CODE_INTERNAL_ERROR);
 	}
 
+	specs.transformFormat = streamDBoptions.transformFormat;
+
 	if (!stream_init_context(&specs))
 	{
 		/* errors have already been logged */
@@ -1108,6 +1152,8 @@ cli_stream_apply(int argc, char **argv)
 			exit(EXIT_CODE_INTERNAL_ERROR);
 		}
 
+		specs.applyJobs = streamDBoptions.applyJobs;
+
 		specs.in = stdin;
 
 		if (!stream_apply_replay(&specs))
@@ -1134,6 +1180,7 @@ cli_stream_apply(int argc, char **argv)
 		}
 
 		context.apply = true;
+		context.applyJobs = streamDBoptions.applyJobs;
 		strlcpy(context.sqlFileName, sqlfilename, sizeof(context.sqlFileName));
 
 		if (!setupReplicationOrigin(&context))
@@ -1221,6 +1268,8 @@ stream_start_in_mode(LogicalStreamMode mode)
 		exit(EXIT_CODE_INTERNAL_ERROR);
 	}
 
+	specs.transformFormat = streamDBoptions.transformFormat;
+
 	switch (specs.mode)
 	{
 		case STREAM_MODE_RECEIVE:
@@ -518,10 +518,15 @@ copydb_init_specs(CopyDataSpec *specs,
 		.skipCtidSplit = options->skipCtidSplit,
 		.skipXidCheck = options->skipXidCheck,
 		.deferIndexes = options->deferIndexes,
+		.sharedIndexScan = options->sharedIndexScan,
+		.freeze = options->freeze,
+		.unlogged = options->unlogged,
 		.deferAnalyze = options->deferAnalyze,
 		.noRolesPasswords = options->noRolesPasswords,
 		.failFast = options->failFast,
-		.useCopyBinary = options->useCopyBinary,
+		.copyFormat = options->copyFormat,
+		.copyBufferSize = options->copyBufferSize,
+		.indexMemoryBudget = options->indexMemoryBudget,
 
 		.restart = options->restart,
 		.resume = options->resume,
@@ -535,6 +540,7 @@ copydb_init_specs(CopyDataSpec *specs,
 		.tableJobs = options->tableJobs,
 		.indexJobs = options->indexJobs,
 		.lObjectJobs = options->lObjectJobs,
+		.lObjectBatchSize = options->lObjectBatchSize,
 
 		/* at the moment we don't have --vacuumJobs separately */
 		.vacuumJobs = options->tableJobs,
@@ -606,6 +612,19 @@ copydb_init_specs(CopyDataSpec *specs,
 			log_error("Failed to create the INDEX process queue");
 			return false;
 		}
+
+		/* create the CREATE INDEX memory budget semaphore */
+		if (specs->indexMemoryBudget > 0)
+		{
+			specs->indexMemorySema.initValue =
+				specs->indexMemoryBudget / INDEX_MEMORY_UNIT;
+
+			if (!semaphore_create(&(specs->indexMemorySema)))
+			{
+				log_error("Failed to create the INDEX memory budget semaphore");
+				return false;
+			}
+		}
 	}
 
 	/* we only respect the --skip-blobs option in pgcopydb clone command */
@@ -144,9 +144,13 @@ typedef struct CopyTableDataSpec
 	/* same-table concurrency with COPY WHERE clause partitioning */
 	CopyTableDataPartSpec part;
 
+	/* with --freeze, the first part copies the whole table */
+	bool copiedByFirstPart;
+
 	/* summary/activity tracking */
 	uint32_t countPartsDone;
 	pid_t partsDonePid;
+	pid_t indexesEarlyPid;
 	bool allPartsAreDone;
 
 	uint32_t countIndexesLeft;
@@ -189,6 +193,49 @@ typedef struct CopyDBSentinel
 } CopyDBSentinel;
 
 
+/*
+ * When using --apply-jobs, the apply process also registers the progress of
+ * each of its connections to the target database.
+ */
+typedef struct CopyDBSentinelApplyWorker
+{
+	int id;
+	char origin[BUFSIZE];
+	uint64_t replay_lsn;
+	uint64_t lag;               /* bytes behind the apply process position */
+	uint64_t txnCount;
+	uint64_t waitCount;
+} CopyDBSentinelApplyWorker;
+
+
+typedef struct CopyDBSentinelApplyWorkerArray
+{
+	int count;
+	CopyDBSentinelApplyWorker *array;  /* malloc'ed area */
+} CopyDBSentinelApplyWorkerArray;
+
+
+/*
+ * The COMMIT LSN of transactions that have been split over several parts
+ * (SWITCH, KEEPALIVE, ENDPOS) is registered in our catalogs by the transform
+ * process, in batches, so that the apply process can find it at BEGIN time.
+ */
+#define TXN_COMMIT_LSN_BATCH_SIZE 128
+
+typedef struct TxnCommitLSN
+{
+	uint32_t xid;
+	uint64_t commitLSN;
+} TxnCommitLSN;
+
+
+typedef struct TxnCommitLSNBatch
+{
+	int count;
+	TxnCommitLSN array[TXN_COMMIT_LSN_BATCH_SIZE];
+} TxnCommitLSNBatch;
+
+
 /* we can inspect the source catalogs and discover previous run state */
 typedef struct PreviousRunState
 {
@@ -235,8 +282,13 @@ typedef struct CopyDataSpec
 	bool skipXidCheck;
 	bool deferIndexes;
 	bool deferAnalyze;
+	bool sharedIndexScan;
+	bool freeze;
+	bool unlogged;
 	bool noRolesPasswords;
-	bool useCopyBinary;
+	CopyDataFormat copyFormat;
+	uint64_t copyBufferSize;
+	uint64_t indexMemoryBudget;
 
 	bool restart;
 	bool resume;
@@ -252,6 +304,7 @@ typedef struct CopyDataSpec
 	int indexJobs;
 	int vacuumJobs;
 	int lObjectJobs;
+	int lObjectBatchSize;
 
 	SplitTableLargerThan splitTablesLargerThan;
 	int splitMaxParts;
@@ -262,6 +315,9 @@ typedef struct CopyDataSpec
 	Queue vacuumQueue;
 	Queue loQueue;
 
+	/* CREATE INDEX memory units, see --index-memory-budget */
+	Semaphore indexMemorySema;
+
 	DumpPaths dumpPaths;
 
 	/* results from calling has_database_privilege() on the source */
@@ -371,13 +427,28 @@ bool copydb_table_indexes_are_done(CopyDataSpec *specs,
 								   bool *indexesAreDone,
 								   bool *constraintsAreBeingBuilt);
 
+bool copydb_finish_table_indexes(CopyDataSpec *specs,
+								 PGSQL *dst,
+								 SourceTable *table);
+
+bool copydb_table_has_concurrent_indexes(SourceFilters *filters,
+										 SourceTable *table);
+
+bool copydb_add_table_indexes_early(CopyDataSpec *specs,
+									CopyTableDataSpec *tableSpecs);
+
+bool copydb_table_indexes_were_added_early(CopyDataSpec *specs,
+										   CopyTableDataSpec *tableSpecs,
+										   bool *addedEarly);
+
 bool copydb_copy_all_indexes(CopyDataSpec *specs);
 bool copydb_queue_all_deferred_indexes(CopyDataSpec *specs);
 
 bool copydb_create_index(CopyDataSpec *specs,
 						 PGSQL *dst,
 						 SourceIndex *index,
-						 bool ifNotExists);
+						 bool ifNotExists,
+						 bool concurrently);
 
 bool copydb_index_is_being_processed(CopyDataSpec *specs,
 									 CopyIndexSpec *indexSpecs,
@@ -386,7 +457,8 @@ bool copydb_index_is_being_processed(CopyDataSpec *specs,
 bool copydb_mark_index_as_done(CopyDataSpec *specs, CopyIndexSpec *indexSpecs);
 
 bool copydb_prepare_create_index_command(CopyIndexSpec *indexSpecs,
-										 bool ifNotExists);
+										 bool ifNotExists,
+										 bool concurrently);
 
 bool copydb_prepare_create_constraint_command(CopyIndexSpec *indexSpecs);
 
@@ -463,6 +535,10 @@ bool copydb_table_parts_are_all_done(CopyDataSpec *specs,
 
 bool copydb_prepare_copy_query(CopyTableDataSpec *tableSpecs, CopyArgs *args);
 
+bool copydb_table_use_copy_binary(CopyDataSpec *specs,
+								  CopyTableDataSpec *tableSpecs,
+								  bool *useCopyBinary);
+
 bool copydb_prepare_summary_command(CopyTableDataSpec *tableSpecs);
 
 bool copydb_check_table_exists(PGSQL *pgsql, SourceTable *table, bool *exists);
@@ -476,15 +552,23 @@ bool copydb_blob_supervisor(CopyDataSpec *specs);
 bool copydb_start_blob_workers(CopyDataSpec *specs);
 bool copydb_blob_worker(CopyDataSpec *specs);
 bool copydb_queue_largeobject_metadata(CopyDataSpec *specs, uint64_t *count);
-bool copydb_add_blob(CopyDataSpec *specs, uint32_t oid);
+bool copydb_add_blob(CopyDataSpec *specs, uint32_t oid, int64_t bytes);
 bool copydb_send_lo_stop(CopyDataSpec *specs);
 
+/* unlogged.c */
+bool copydb_target_set_tables_unlogged(CopyDataSpec *specs);
+bool copydb_set_table_logged(CopyDataSpec *specs, PGSQL *dst, SourceTable *table);
+bool copydb_set_tables_logged(CopyDataSpec *specs);
+bool copydb_unlogged_tables_resume(CopyDataSpec *specs);
+
 /* vacuum.c */
 bool vacuum_start_supervisor(CopyDataSpec *specs);
 bool vacuum_supervisor(CopyDataSpec *specs);
 bool vacuum_start_workers(CopyDataSpec *specs);
 bool vacuum_worker(CopyDataSpec *specs);
 bool vacuum_analyze_table_by_oid(CopyDataSpec *specs, uint32_t oid);
+bool vacuum_choose_action(CopyDataSpec *specs, PGSQL *dst,
+						  CopyTableDataSpec *tableSpecs);
 bool vacuum_add_table(CopyDataSpec *specs, uint32_t oid);
 bool vacuum_send_stop(CopyDataSpec *specs);
 
@@ -514,6 +598,20 @@ bool sentinel_sync_apply(DatabaseCatalog *catalog,
 						 uint64_t replay_lsn,
 						 CopyDBSentinel *sentinel);
 
+bool sentinel_reset_apply_workers(DatabaseCatalog *catalog);
+bool sentinel_update_apply_worker(DatabaseCatalog *catalog,
+								  CopyDBSentinelApplyWorker *worker);
+bool sentinel_apply_worker_array(DatabaseCatalog *catalog,
+								 CopyDBSentinelApplyWorkerArray *workers);
+
+bool sentinel_add_txn_commit_lsn_batch(DatabaseCatalog *catalog,
+									   TxnCommitLSNBatch *batch);
+bool sentinel_lookup_txn_commit_lsn(DatabaseCatalog *catalog,
+									uint32_t xid,
+									uint64_t *commitLSN,
+									bool *found);
+bool sentinel_txn_commit_lsn_fetch(SQLiteQuery *query);
+
 
 /* summary.c */
 bool print_summary(CopyDataSpec *specs);
@@ -537,6 +635,9 @@ bool summary_finish_table(DatabaseCatalog *catalog,
 bool summary_update_table_copy_stats(DatabaseCatalog *catalog,
 									 CopyTableDataSpec *tableSpecs);
 
+bool summary_update_table_copy_format(DatabaseCatalog *catalog,
+									  CopyTableDataSpec *tableSpecs);
+
 bool summary_delete_table(DatabaseCatalog *catalog,
 						  CopyTableDataSpec *tableSpecs);
 
@@ -545,6 +646,14 @@ bool summary_table_count_parts_done(DatabaseCatalog *catalog,
 
 bool summary_table_fetch_count_parts_done(SQLiteQuery *query);
 
+bool summary_table_count_parts_started(DatabaseCatalog *catalog,
+									   SourceTable *table,
+									   TablePartsCount *count);
+
+bool summary_delete_table_parts(DatabaseCatalog *catalog, SourceTable *table);
+
+bool summary_table_fetch_count_parts_started(SQLiteQuery *query);
+
 bool summary_add_table_parts_done(DatabaseCatalog *catalog,
 								  CopyTableDataSpec *tableSpecs);
 
@@ -553,6 +662,51 @@ bool summary_lookup_table_parts_done(DatabaseCatalog *catalog,
 
 bool summary_table_parts_done_fetch(SQLiteQuery *query);
 
+bool summary_add_table_indexes_early(DatabaseCatalog *catalog,
+									 CopyTableDataSpec *tableSpecs);
+
+bool summary_lookup_table_indexes_early(DatabaseCatalog *catalog,
+										CopyTableDataSpec *tableSpecs);
+
+bool summary_table_indexes_early_fetch(SQLiteQuery *query);
+
+bool summary_lookup_table_frozen(DatabaseCatalog *catalog,
+								 CopyTableDataSpec *tableSpecs);
+
+bool summary_table_frozen_fetch(SQLiteQuery *query);
+
+bool summary_add_table_unlogged(DatabaseCatalog *catalog, SourceTable *table,
+								uint64_t targetStartTime);
+bool summary_delete_table_unlogged(DatabaseCatalog *catalog, SourceTable *table);
+bool summary_start_table_logged(DatabaseCatalog *catalog, SourceTable *table);
+bool summary_finish_table_logged(DatabaseCatalog *catalog,
+								 SourceTable *table,
+								 uint64_t durationMs);
+bool summary_reset_table_copy(DatabaseCatalog *catalog, SourceTable *table);
+
+bool summary_lookup_table_unlogged(DatabaseCatalog *catalog,
+								   SourceTable *table,
+								   bool *pending);
+
+bool summary_table_unlogged_fetch(SQLiteQuery *query);
+
+bool summary_table_unlogged_pending(DatabaseCatalog *catalog,
+									TableUnloggedArray *tables);
+
+bool summary_add_lo_worker(DatabaseCatalog *catalog,
+						   LargeObjectWorkerSummary *summary);
+
+bool summary_finish_lo_worker(DatabaseCatalog *catalog,
+							  LargeObjectWorkerSummary *summary);
+
+bool summary_lo_worker_array(DatabaseCatalog *catalog,
+							 LargeObjectWorkerSummaryArray *workers);
+
+bool summary_blob_size_histogram(DatabaseCatalog *catalog,
+								 BlobSizeHistogram *histogram);
+
+bool summary_blob_size_histogram_fetch(SQLiteQuery *query);
+
 bool summary_add_vacuum(DatabaseCatalog *catalog,
 						CopyTableDataSpec *tableSpecs);
 
@@ -586,12 +740,17 @@ bool summary_finish_constraint(DatabaseCatalog *catalog,
 							   CopyIndexSpec *indexSpecs);
 
 bool summary_lookup_fk_constraint(DatabaseCatalog *catalog, uint32_t conoid,
-								  bool *done);
+								  bool *done, bool *validatePending);
 bool summary_add_fk_constraint(DatabaseCatalog *catalog,
 							   SourceFKConstraint *fk, const char *command);
 bool summary_finish_fk_constraint(DatabaseCatalog *catalog,
 								  SourceFKConstraint *fk,
 								  uint64_t durationMs, bool notValid);
+bool summary_start_fk_validation(DatabaseCatalog *catalog,
+								 SourceFKConstraint *fk);
+bool summary_finish_fk_validation(DatabaseCatalog *catalog,
+								  SourceFKConstraint *fk,
+								  uint64_t durationMs, bool notValid);
 
 bool summary_table_count_indexes_left(DatabaseCatalog *catalog,
 									  CopyTableDataSpec *tableSpecs);
@@ -606,6 +765,18 @@ bool summary_lookup_table_indexes_done(DatabaseCatalog *catalog,
 
 bool summary_table_indexes_done_fetch(SQLiteQuery *query);
 
+bool summary_start_table_index_group(DatabaseCatalog *catalog,
+									 CopyTableDataSpec *tableSpecs,
+									 int groupCount);
+
+bool summary_steal_table_index_group(DatabaseCatalog *catalog,
+									 CopyTableDataSpec *tableSpecs,
+									 int groupCount,
+									 pid_t stalePid);
+
+bool summary_finish_table_index_group(DatabaseCatalog *catalog,
+									  CopyTableDataSpec *tableSpecs);
+
 bool summary_prepare_index_entry(DatabaseCatalog *catalog,
 								 SourceIndex *index,
 								 bool constraint,
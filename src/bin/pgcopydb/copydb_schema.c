@@ -752,6 +752,14 @@ copydb_prepare_table_specs(CopyDataSpec *specs, PGSQL *pgsql)
 		return false;
 	}
 
+	/* register leaf partitions of partitioned tables with their root */
+	if (!schema_list_partition_roots(pgsql, sourceDB))
+	{
+		log_error("Failed to fetch partitioned tables hierarchy, "
+				  "see above for details");
+		return false;
+	}
+
 	/*
 	 * if we did not enable estimates, update table sizes in our internal
 	 * catalogue with exact values
@@ -988,6 +996,12 @@ copydb_prepare_index_specs(CopyDataSpec *specs, PGSQL *pgsql)
 		return false;
 	}
 
+	if (!schema_list_index_sizes(pgsql, sourceDB))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
 	/*
 	 * Fetch FK constraints separately from indexes. FK constraints are not
 	 * attached to indexes via pg_depend, so they are not captured by
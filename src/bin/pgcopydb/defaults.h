@@ -52,6 +52,7 @@
 #define PGCOPYDB_INDEX_JOBS "PGCOPYDB_INDEX_JOBS"
 #define PGCOPYDB_RESTORE_JOBS "PGCOPYDB_RESTORE_JOBS"
 #define PGCOPYDB_LARGE_OBJECTS_JOBS "PGCOPYDB_LARGE_OBJECTS_JOBS"
+#define PGCOPYDB_LARGE_OBJECTS_BATCH_SIZE "PGCOPYDB_LARGE_OBJECTS_BATCH_SIZE"
 #define PGCOPYDB_SPLIT_TABLES_LARGER_THAN "PGCOPYDB_SPLIT_TABLES_LARGER_THAN"
 #define PGCOPYDB_SPLIT_MAX_PARTS "PGCOPYDB_SPLIT_MAX_PARTS"
 #define PGCOPYDB_ESTIMATE_TABLE_SIZES "PGCOPYDB_ESTIMATE_TABLE_SIZES"
@@ -74,14 +75,51 @@
 #define PGCOPYDB_RESTORE_TOLERANCE "PGCOPYDB_RESTORE_TOLERANCE"
 #define PGCOPYDB_DEFER_INDEXES "PGCOPYDB_DEFER_INDEXES"
 #define PGCOPYDB_DEFER_ANALYZE "PGCOPYDB_DEFER_ANALYZE"
+#define PGCOPYDB_COPY_BUFFER_SIZE "PGCOPYDB_COPY_BUFFER_SIZE"
+#define PGCOPYDB_COPY_FORMAT "PGCOPYDB_COPY_FORMAT"
+#define PGCOPYDB_INDEX_MEMORY_BUDGET "PGCOPYDB_INDEX_MEMORY_BUDGET"
+#define PGCOPYDB_SHARED_INDEX_SCAN "PGCOPYDB_SHARED_INDEX_SCAN"
+#define PGCOPYDB_FREEZE "PGCOPYDB_FREEZE"
+#define PGCOPYDB_UNLOGGED "PGCOPYDB_UNLOGGED"
+#define PGCOPYDB_APPLY_JOBS "PGCOPYDB_APPLY_JOBS"
+#define PGCOPYDB_TRANSFORM_FORMAT "PGCOPYDB_TRANSFORM_FORMAT"
 
 /* default values for the command line options */
 #define DEFAULT_TABLE_JOBS 4
 #define DEFAULT_INDEX_JOBS 4
 #define DEFAULT_RESTORE_JOBS 0
 #define DEFAULT_LARGE_OBJECTS_JOBS 4
+#define MAX_BLOB_BATCH_SIZE 10000
 #define DEFAULT_SPLIT_TABLES_LARGER_THAN 0 /* no COPY partitioning by default */
 #define DEFAULT_RESTORE_TOLERANCE 10
+#define DEFAULT_APPLY_JOBS 1
+
+/* COPY rows are packed into chunks of this size before being sent */
+#define DEFAULT_COPY_BUFFER_SIZE (1024 * 1024)           /* 1 MB */
+#define MIN_COPY_BUFFER_SIZE (64 * 1024)                 /* 64 kB */
+#define MAX_COPY_BUFFER_SIZE (64 * 1024 * 1024)          /* 64 MB */
+
+/* sampling used to plan same-table COPY parts by ctid */
+#define SPLIT_CTID_SAMPLE_PAGES 10000
+#define SPLIT_CTID_BUCKETS_PER_PART 16
+#define SPLIT_CTID_MAX_SKEW 1.25    /* largest part vs. average part */
+
+/* same-table COPY parts are copied in steps that idle workers may steal */
+#define COPY_PART_STEPS 8
+
+/*
+ * The --index-memory-budget is shared between CREATE INDEX workers in units
+ * of 64 MB, each index build gets as many units as its estimated size, and
+ * Postgres needs 32 MB of maintenance_work_mem per parallel participant.
+ */
+#define INDEX_MEMORY_UNIT (64 * 1024 * 1024)                /* 64 MB */
+#define INDEX_MEMORY_MAX_UNITS 32767                        /* SEMVMX */
+#define INDEX_PARALLEL_WORKER_MEMORY (32 * 1024 * 1024)     /* 32 MB */
+#define INDEX_BYTES_PER_PARALLEL_WORKER (1024 * 1024 * 1024) /* 1 GB */
+#define INDEX_MAX_PARALLEL_WORKERS 8
+
+/* how many of the next indexes to build are listed in pgcopydb list progress */
+#define PROGRESS_PENDING_INDEX_COUNT 10
 
 #define POSTGRES_CONNECT_TIMEOUT "10"
 
@@ -230,6 +230,15 @@ copydb_target_prepare_schema(CopyDataSpec *specs)
 		return false;
 	}
 
+	/*
+	 * With --unlogged, COPY into UNLOGGED tables to avoid writing WAL.
+	 */
+	if (!copydb_target_set_tables_unlogged(specs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
 	if (!summary_stop_timing(sourceDB, TIMING_SECTION_PREPARE_SCHEMA))
 	{
 		/* errors have already been logged */
@@ -555,6 +564,16 @@ copydb_target_finalize_schema(CopyDataSpec *specs)
 		return false;
 	}
 
+	/*
+	 * Tables set UNLOGGED for COPY are set LOGGED again by the COPY workers,
+	 * make sure none is left over before building indexes and FK constraints.
+	 */
+	if (!copydb_set_tables_logged(specs))
+	{
+		log_error("Failed to set tables LOGGED again, see above for details");
+		return false;
+	}
+
 	/*
 	 * When --defer-indexes --follow was used, STEP 6 was skipped in the
 	 * clone subprocess. Build indexes now using pgcopydb's parallel workers
@@ -469,6 +469,9 @@ write_to_stream(FILE *stream, const char *buffer, size_t size)
  * read_from_stream reads lines from an input stream, such as a Unix Pipe, and
  * for each line read calls the provided context->callback function with its
  * own private context as an argument.
+ *
+ * When the input stream has no data available for 100ms, the optional
+ * context->idleCallback function is called.
  */
 bool
 read_from_stream(FILE *stream, ReadFromStreamContext *context)
@@ -556,6 +559,14 @@ read_from_stream(FILE *stream, ReadFromStreamContext *context)
 				doneReading = true;
 				log_notice("read_from_stream was asked to quit");
 			}
+			else if (context->idleCallback != NULL)
+			{
+				if (!(context->idleCallback)(context->ctx))
+				{
+					/* errors have already been logged */
+					return false;
+				}
+			}
 
 			continue;
 		}
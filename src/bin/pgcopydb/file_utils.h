@@ -33,6 +33,7 @@ typedef struct SearchPath
 } SearchPath;
 
 typedef bool (*ReadFromStream) (void *ctx, const char *line, bool *stop);
+typedef bool (*ReadFromStreamIdle) (void *ctx);
 
 typedef struct ReadFromStreamContext
 {
@@ -40,6 +41,7 @@ typedef struct ReadFromStreamContext
 	uint64_t lineno;
 	bool earlyExit;
 	ReadFromStream callback;
+	ReadFromStreamIdle idleCallback; /* optional, when no data is available */
 	void *ctx;                  /* user-defined context */
 } ReadFromStreamContext;
 
@@ -215,6 +215,11 @@ parse_filters(const char *filename, SourceFilters *filters)
 		{ "exclude-extension", SOURCE_FILTER_EXCLUDE_EXTENSION, NULL },
 		{ "include-only-extension", SOURCE_FILTER_INCLUDE_ONLY_EXTENSION, NULL },
 		{ "exclude-event-trigger", SOURCE_FILTER_EXCLUDE_EVENT_TRIGGER, NULL },
+		{
+			"concurrent-index-table",
+			SOURCE_FILTER_CONCURRENT_INDEX_TABLE,
+			&(filters->concurrentIndexTableList)
+		},
 		{ "", SOURCE_FILTER_UNKNOWN, NULL },
 	};
 
@@ -310,6 +315,7 @@ parse_filters(const char *filename, SourceFilters *filters)
 			case SOURCE_FILTER_EXCLUDE_TABLE_DATA:
 			case SOURCE_FILTER_EXCLUDE_INDEX:
 			case SOURCE_FILTER_INCLUDE_ONLY_TABLE:
+			case SOURCE_FILTER_CONCURRENT_INDEX_TABLE:
 			{
 				SourceFilterTableList *list = sections[i].list;
 
@@ -752,6 +758,7 @@ filters_as_json(SourceFilters *filters, JSON_Value *jsFilter)
 		{ "exclude-table-data", &(filters->excludeTableDataList) },
 		{ "exclude-index", &(filters->excludeIndexList) },
 		{ "include-only-table", &(filters->includeOnlyTableList) },
+		{ "concurrent-index-table", &(filters->concurrentIndexTableList) },
 		{ "", NULL },
 	};
 
@@ -821,6 +828,8 @@ filters_from_json(const char *jsonString, SourceFilters *filters)
 	filters->excludeExtensionList.array = NULL;
 	filters->excludeEventTriggerList.count = 0;
 	filters->excludeEventTriggerList.array = NULL;
+	filters->concurrentIndexTableList.count = 0;
+	filters->concurrentIndexTableList.array = NULL;
 	filters->ctePreamble = NULL;
 
 	/* Parse JSON string */
@@ -1084,6 +1093,7 @@ filters_from_json(const char *jsonString, SourceFilters *filters)
 		{ "exclude-table-data", &(filters->excludeTableDataList) },
 		{ "exclude-index", &(filters->excludeIndexList) },
 		{ "include-only-table", &(filters->includeOnlyTableList) },
+		{ "concurrent-index-table", &(filters->concurrentIndexTableList) },
 		{ NULL, NULL },
 	};
 
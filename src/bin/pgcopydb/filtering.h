@@ -25,7 +25,8 @@ typedef enum
 	SOURCE_FILTER_INCLUDE_ONLY_TABLE,
 	SOURCE_FILTER_EXCLUDE_EXTENSION,
 	SOURCE_FILTER_INCLUDE_ONLY_EXTENSION,
-	SOURCE_FILTER_EXCLUDE_EVENT_TRIGGER
+	SOURCE_FILTER_EXCLUDE_EVENT_TRIGGER,
+	SOURCE_FILTER_CONCURRENT_INDEX_TABLE
 } SourceFilterSection;
 
 typedef struct SourceFilterSchema
@@ -129,6 +130,7 @@ typedef struct SourceFilters
 	SourceFilterExtensionList includeOnlyExtensionList;
 	SourceFilterExtensionList excludeExtensionList;
 	SourceFilterEventTriggerList excludeEventTriggerList;
+	SourceFilterTableList concurrentIndexTableList;
 	char *ctePreamble;
 } SourceFilters;
 
@@ -26,6 +26,46 @@ static bool copydb_add_table_indexes_hook(void *context, SourceIndex *index);
 static bool copydb_collect_constraint_indexes_hook(void *ctx, SourceIndex *index);
 static bool copydb_copy_all_indexes_hook(void *ctx, SourceIndex *index);
 static bool copydb_queue_deferred_index_hook(void *ctx, SourceIndex *index);
+static bool copydb_index_queue_send(CopyDataSpec *specs,
+									uint32_t indexOid,
+									int64_t cost);
+
+static void copydb_index_memory_plan(CopyDataSpec *specs,
+									 SourceIndex *index,
+									 int *units,
+									 int *workers);
+static bool copydb_index_memory_acquire(CopyDataSpec *specs,
+										PGSQL *dst,
+										SourceIndex *index,
+										int *units);
+static bool copydb_index_memory_set_gucs(PGSQL *dst,
+										 SourceIndex *index,
+										 int units,
+										 int workers);
+
+static bool copydb_drop_invalid_index(PGSQL *dst,
+									  SourceIndex *index,
+									  bool concurrently);
+static bool copydb_create_index_group(CopyDataSpec *specs,
+									  SourceTable *table,
+									  bool ifNotExists,
+									  bool *skipped);
+static bool copydb_collect_table_indexes_hook(void *ctx, SourceIndex *index);
+static bool copydb_table_count_parts_left(CopyDataSpec *specs,
+										  SourceTable *table,
+										  int *partsLeft);
+
+typedef struct FKValidation FKValidation;
+
+static bool copydb_validate_fk_constraints(CopyDataSpec *specs,
+										   SourceFKConstraintArray *fkArray,
+										   bool *validate,
+										   int validateCount,
+										   int *notValidCount);
+static int copydb_fk_validation_next(SourceFKConstraintArray *fkArray,
+									 bool *validate,
+									 FKValidation *slots,
+									 int jobs);
 
 
 /*
@@ -276,7 +316,7 @@ copydb_index_worker(CopyDataSpec *specs)
 	while (!stop)
 	{
 		QMessage mesg = { 0 };
-		bool recv_ok = queue_receive(&(specs->indexQueue), &mesg);
+		bool recv_ok = queue_receive_priority(&(specs->indexQueue), &mesg);
 
 		if (asked_to_stop || asked_to_stop_fast || asked_to_quit)
 		{
@@ -415,18 +455,106 @@ copydb_create_index_by_oid(CopyDataSpec *specs, PGSQL *dst, uint32_t indexOid)
 	bool ifNotExists =
 		specs->resume || specs->section == DATA_SECTION_INDEXES;
 
-	if (!copydb_create_index(specs, dst, index, ifNotExists))
+	/*
+	 * Tables listed in the [concurrent-index-table] filtering section have
+	 * their indexes built while their other parts are still being copied,
+	 * which requires CREATE INDEX CONCURRENTLY.
+	 */
+	bool concurrently = false;
+
+	if (copydb_table_has_concurrent_indexes(&(specs->filters), table))
+	{
+		int partsLeft = 0;
+
+		if (!copydb_table_count_parts_left(specs, table, &partsLeft))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		concurrently = partsLeft > 0;
+	}
+
+	/*
+	 * With --shared-index-scan all the indexes of a table are built at the
+	 * same time, so that the table is read once from disk. Each concurrent
+	 * build needs its own share of the --index-memory-budget, so we only do
+	 * that when the budget allows for it.
+	 */
+	bool groupBuild = false;
+
+	if (specs->sharedIndexScan && !concurrently)
+	{
+		if (!catalog_s_table_count_indexes(sourceDB, table))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		groupBuild = table->indexCount > 1 &&
+					 (specs->indexMemoryBudget == 0 ||
+					  table->indexCount <= specs->indexMemorySema.initValue);
+	}
+
+	if (groupBuild)
+	{
+		bool skipped = false;
+
+		if (!copydb_create_index_group(specs, table, ifNotExists, &skipped))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		/* another process builds the indexes and constraints of this table */
+		if (skipped)
+		{
+			return true;
+		}
+	}
+	else if (!copydb_create_index(specs, dst, index, ifNotExists, concurrently))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
 	/*
-	 * Now if that was the last index built for a given table, it's time to
-	 * also create the constraints associated with the indexes. We wait until
-	 * all the indexes are done because constraints are built with ALTER TABLE,
-	 * which takes an exclusive lock on the table.
+	 * When the index has been built while some parts of the table are still
+	 * being copied, the constraints have to wait until the COPY is done. The
+	 * COPY process that finishes the last part then takes care of them.
 	 */
+	if (concurrently)
+	{
+		int partsLeft = 0;
+
+		if (!copydb_table_count_parts_left(specs, table, &partsLeft))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (partsLeft > 0)
+		{
+			return true;
+		}
+	}
+
+	return copydb_finish_table_indexes(specs, dst, table);
+}
+
+
+/*
+ * copydb_finish_table_indexes checks if all the indexes of the given table
+ * have been built, and then creates the constraints associated with the
+ * indexes. We wait until all the indexes are done because constraints are
+ * built with ALTER TABLE, which takes an exclusive lock on the table.
+ *
+ * Only the first process that sees all the indexes done builds the
+ * constraints, see copydb_table_indexes_are_done.
+ */
+bool
+copydb_finish_table_indexes(CopyDataSpec *specs, PGSQL *dst, SourceTable *table)
+{
 	bool builtAllIndexes = false;
 	bool constraintsAreBeingBuilt = false;
 
@@ -467,6 +595,147 @@ copydb_create_index_by_oid(CopyDataSpec *specs, PGSQL *dst, uint32_t indexOid)
 		}
 	}
 
+	return true;
+}
+
+
+/*
+ * copydb_table_has_concurrent_indexes returns true when the given table is
+ * listed in the [concurrent-index-table] section of the filtering setup.
+ */
+bool
+copydb_table_has_concurrent_indexes(SourceFilters *filters, SourceTable *table)
+{
+	SourceFilterTableList *list = &(filters->concurrentIndexTableList);
+
+	for (int i = 0; i < list->count; i++)
+	{
+		SourceFilterTable *entry = &(list->array[i]);
+
+		if (streq(entry->nspname, table->nspname) &&
+			streq(entry->relname, table->relname))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/*
+ * copydb_table_count_parts_left counts how many parts of the given table are
+ * not done copying yet. Tables that are not split in parts have none left
+ * once their indexes are being processed.
+ */
+static bool
+copydb_table_count_parts_left(CopyDataSpec *specs,
+							  SourceTable *table,
+							  int *partsLeft)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+	CopyTableDataSpec tableSpecs = { 0 };
+
+	*partsLeft = 0;
+
+	if (table->partition.partCount <= 1)
+	{
+		return true;
+	}
+
+	if (!copydb_init_table_specs(&tableSpecs, specs, table, 0))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (!summary_table_count_parts_done(sourceDB, &tableSpecs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	*partsLeft = table->partition.partCount - tableSpecs.countPartsDone;
+
+	return true;
+}
+
+
+/*
+ * copydb_add_table_indexes_early sends the indexes of a table listed in the
+ * [concurrent-index-table] filtering section to the CREATE INDEX queue as
+ * soon as one of its parts is done, rather than when all of them are done.
+ * Only the first process to finish a part of the table sends the indexes.
+ *
+ * The indexes are then built with CREATE INDEX CONCURRENTLY, which does not
+ * block the COPY of the other parts of the table.
+ */
+bool
+copydb_add_table_indexes_early(CopyDataSpec *specs,
+							   CopyTableDataSpec *tableSpecs)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+
+	tableSpecs->indexesEarlyPid = 0;
+
+	if (!summary_add_table_indexes_early(sourceDB, tableSpecs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (!summary_lookup_table_indexes_early(sourceDB, tableSpecs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (tableSpecs->indexesEarlyPid != getpid())
+	{
+		return true;
+	}
+
+	log_info("Creating indexes for table %s while its other parts "
+			 "are being copied",
+			 tableSpecs->sourceTable->qname);
+
+	return copydb_add_table_indexes(specs, tableSpecs);
+}
+
+
+/*
+ * copydb_table_indexes_were_added_early sets addedEarly to true when the
+ * indexes of the given table have been sent to the CREATE INDEX queue by a
+ * process of the current run, see copydb_add_table_indexes_early. Entries left
+ * behind by a previous run are ignored, so that the indexes are sent again.
+ */
+bool
+copydb_table_indexes_were_added_early(CopyDataSpec *specs,
+									  CopyTableDataSpec *tableSpecs,
+									  bool *addedEarly)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+
+	*addedEarly = false;
+
+	if (!copydb_table_has_concurrent_indexes(&(specs->filters),
+											 tableSpecs->sourceTable))
+	{
+		return true;
+	}
+
+	tableSpecs->indexesEarlyPid = 0;
+
+	if (!summary_lookup_table_indexes_early(sourceDB, tableSpecs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	pid_t pid = tableSpecs->indexesEarlyPid;
+
+	/* if we can signal the pid, it is still running */
+	*addedEarly = pid == getpid() || (pid > 0 && kill(pid, 0) == 0);
 
 	return true;
 }
@@ -534,10 +803,16 @@ copydb_table_indexes_are_done(CopyDataSpec *specs,
 }
 
 
+typedef struct IndexOID
+{
+	uint32_t oid;
+	int64_t cost;
+} IndexOID;
+
 typedef struct IndexOIDArray
 {
 	int count;
-	uint32_t *array;            /* malloc'ed area */
+	IndexOID *array;            /* malloc'ed area */
 } IndexOIDArray;
 
 typedef struct QueueTableIndexesContext
@@ -581,7 +856,7 @@ copydb_add_table_indexes(CopyDataSpec *specs, CopyTableDataSpec *tableSpecs)
 	 */
 	int indexCount = tableSpecs->sourceTable->indexCount;
 	indexArray.count = 0;
-	indexArray.array = (uint32_t *) calloc(indexCount, sizeof(uint32_t));
+	indexArray.array = (IndexOID *) calloc(indexCount, sizeof(IndexOID));
 
 	if (indexArray.array == NULL)
 	{
@@ -615,17 +890,14 @@ copydb_add_table_indexes(CopyDataSpec *specs, CopyTableDataSpec *tableSpecs)
 	 */
 	for (int i = 0; i < indexArray.count; i++)
 	{
-		QMessage mesg = {
-			.type = QMSG_TYPE_INDEXOID,
-			.data.oid = indexArray.array[i]
-		};
+		IndexOID *index = &(indexArray.array[i]);
 
 		log_trace("Queueing index [%u] for table %s [%u]",
-				  mesg.data.oid,
+				  index->oid,
 				  tableSpecs->sourceTable->qname,
 				  tableSpecs->sourceTable->oid);
 
-		if (!queue_send(&(specs->indexQueue), &mesg))
+		if (!copydb_index_queue_send(specs, index->oid, index->cost))
 		{
 			/* errors have already been logged */
 			return false;
@@ -645,7 +917,10 @@ copydb_add_table_indexes_hook(void *ctx, SourceIndex *index)
 	QueueTableIndexesContext *context = (QueueTableIndexesContext *) ctx;
 	IndexOIDArray *indexArray = context->indexArray;
 
-	indexArray->array[(indexArray->count)++] = index->indexOid;
+	IndexOID *entry = &(indexArray->array[(indexArray->count)++]);
+
+	entry->oid = index->indexOid;
+	entry->cost = index->cost;
 
 	return true;
 }
@@ -668,7 +943,9 @@ copydb_index_workers_send_stop(CopyDataSpec *specs)
 		log_debug("Send STOP message to CREATE INDEX queue %d",
 				  specs->indexQueue.qId);
 
-		if (!queue_send(&(specs->indexQueue), &stop))
+		if (!queue_send_priority(&(specs->indexQueue),
+								 &stop,
+								 QUEUE_PRIORITY_LOWEST))
 		{
 			/* errors have already been logged */
 			continue;
@@ -780,14 +1057,9 @@ copydb_copy_all_indexes_hook(void *ctx, SourceIndex *index)
 {
 	CopyDataSpec *specs = (CopyDataSpec *) ctx;
 
-	QMessage mesg = {
-		.type = QMSG_TYPE_INDEXOID,
-		.data.oid = index->indexOid
-	};
-
 	log_trace("Queueing index %s [%u]", index->indexQname, index->indexOid);
 
-	if (!queue_send(&(specs->indexQueue), &mesg))
+	if (!copydb_index_queue_send(specs, index->indexOid, index->cost))
 	{
 		/* errors have already been logged */
 		return false;
@@ -806,15 +1078,10 @@ copydb_queue_deferred_index_hook(void *ctx, SourceIndex *index)
 {
 	CopyDataSpec *specs = (CopyDataSpec *) ctx;
 
-	QMessage mesg = {
-		.type = QMSG_TYPE_INDEXOID,
-		.data.oid = index->indexOid
-	};
-
 	log_trace("Queueing deferred index %s [%u]",
 			  index->indexQname, index->indexOid);
 
-	if (!queue_send(&(specs->indexQueue), &mesg))
+	if (!copydb_index_queue_send(specs, index->indexOid, index->cost))
 	{
 		return false;
 	}
@@ -823,6 +1090,40 @@ copydb_queue_deferred_index_hook(void *ctx, SourceIndex *index)
 }
 
 
+/*
+ * copydb_index_queue_send sends an index to the CREATE INDEX queue. The queue
+ * is a priority queue where the indexes with the highest estimated build cost
+ * are received first, so that the longest builds start as soon as possible
+ * and the smaller ones fill-in the gaps. The STOP messages are sent with the
+ * lowest priority, after all the indexes.
+ */
+static bool
+copydb_index_queue_send(CopyDataSpec *specs, uint32_t indexOid, int64_t cost)
+{
+	QMessage mesg = {
+		.type = QMSG_TYPE_INDEXOID,
+		.data.oid = indexOid
+	};
+
+	/* keep QUEUE_PRIORITY_LOWEST for the STOP messages */
+	int64_t maxCost = QUEUE_PRIORITY_LOWEST - QUEUE_PRIORITY_HIGHEST - 1;
+
+	if (cost < 0)
+	{
+		cost = 0;
+	}
+
+	if (cost > maxCost)
+	{
+		cost = maxCost;
+	}
+
+	long priority = QUEUE_PRIORITY_LOWEST - 1 - cost;
+
+	return queue_send_priority(&(specs->indexQueue), &mesg, priority);
+}
+
+
 /*
  * copydb_queue_all_deferred_indexes queues all indexes for building after
  * the COPY phase has completed. Used when --defer-indexes is set.
@@ -861,7 +1162,8 @@ bool
 copydb_create_index(CopyDataSpec *specs,
 					PGSQL *dst,
 					SourceIndex *index,
-					bool ifNotExists)
+					bool ifNotExists,
+					bool concurrently)
 {
 	CopyIndexSpec indexSpecs = { .sourceIndex = index };
 	CopyIndexSummary *indexSummary = &(indexSpecs.summary);
@@ -890,48 +1192,770 @@ copydb_create_index(CopyDataSpec *specs,
 				   index->tableQname);
 	}
 
-	bool isDone = false;
+	bool isDone = false;
+
+	if (!copydb_index_is_being_processed(specs, &indexSpecs, &isDone))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (isDone)
+	{
+		log_debug("Skipping index %s which is being created by another process",
+				  index->indexQname);
+		return true;
+	}
+
+	if (!skipCreateIndex)
+	{
+		/*
+		 * Prepare the CREATE INDEX command based on the index definition and
+		 * ifNotExists flag.
+		 */
+		if (!copydb_prepare_create_index_command(&indexSpecs,
+												 ifNotExists,
+												 concurrently))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		/*
+		 * A failed CREATE INDEX CONCURRENTLY leaves an invalid index behind,
+		 * which the IF NOT EXISTS clause would then skip, and which would
+		 * make the CREATE INDEX command fail otherwise.
+		 */
+		if ((concurrently || ifNotExists) &&
+			!copydb_drop_invalid_index(dst, index, concurrently))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		/*
+		 * With --index-memory-budget, wait until enough memory is available
+		 * for this index build, and size the build settings accordingly.
+		 */
+		int units = 0;
+
+		if (specs->indexMemoryBudget > 0)
+		{
+			if (!copydb_index_memory_acquire(specs, dst, index, &units))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+		}
+
+		log_notice("%s", indexSummary->command);
+
+		bool success = pgsql_execute(dst, indexSummary->command);
+
+		if (units > 0 &&
+			!semaphore_unlock_units(&(specs->indexMemorySema), units))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (!success)
+		{
+			/* do not leave an invalid index behind us */
+			if (concurrently)
+			{
+				(void) copydb_drop_invalid_index(dst, index, concurrently);
+			}
+
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	if (!copydb_mark_index_as_done(specs, &indexSpecs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * copydb_drop_invalid_index drops the given index on the target database when
+ * it exists there and is marked invalid, as a failed CREATE INDEX
+ * CONCURRENTLY command leaves it. While the table is still being copied, the
+ * index is dropped concurrently too, so that we don't wait for the COPY.
+ */
+static bool
+copydb_drop_invalid_index(PGSQL *dst, SourceIndex *index, bool concurrently)
+{
+	bool invalid = false;
+
+	if (!pgsql_index_is_invalid(dst, index->indexQname, &invalid))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (invalid)
+	{
+		char sql[BUFSIZE] = { 0 };
+
+		sformat(sql, sizeof(sql), "DROP INDEX %sIF EXISTS %s",
+				concurrently ? "CONCURRENTLY " : "",
+				index->indexQname);
+
+		log_notice("%s", sql);
+
+		if (!pgsql_execute(dst, sql))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ * IndexGroupBuild tracks one of the CREATE INDEX commands that
+ * copydb_create_index_group runs concurrently on the same table.
+ */
+typedef struct IndexGroupBuild
+{
+	CopyIndexSpec indexSpecs;
+	PGSQL dst;
+	int units;
+	int workers;
+	bool done;
+} IndexGroupBuild;
+
+static bool copydb_index_group_start_build(CopyDataSpec *specs,
+										   IndexGroupBuild *build);
+
+
+/*
+ * copydb_create_index_group builds all the indexes of the given table at the
+ * same time, each on its own target connection, so that Postgres can share a
+ * single sequential scan of the table between the builds thanks to
+ * synchronize_seqscans.
+ *
+ * Only one process builds the indexes of a given table: the first process to
+ * register its pid in s_table_indexes_done. When another process that is
+ * still running owns the group, skipped is set to true and the caller has
+ * nothing to do. The owner of the group also builds the table constraints,
+ * see copydb_table_indexes_are_done.
+ */
+static bool
+copydb_create_index_group(CopyDataSpec *specs,
+						  SourceTable *table,
+						  bool ifNotExists,
+						  bool *skipped)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+	CopyTableDataSpec tableSpecs = { 0 };
+
+	*skipped = false;
+
+	if (!copydb_init_table_specs(&tableSpecs, specs, table, 0))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	tableSpecs.indexesDonePid = 0;
+
+	if (!summary_start_table_index_group(sourceDB,
+										 &tableSpecs,
+										 table->indexCount))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (!summary_lookup_table_indexes_done(sourceDB, &tableSpecs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	pid_t ownerPid = tableSpecs.indexesDonePid;
+
+	if (ownerPid != getpid())
+	{
+		/* if we can signal the pid, it is still running */
+		if (ownerPid != 0 && kill(ownerPid, 0) == 0)
+		{
+			log_debug("Skipping indexes of table %s which are being created "
+					  "by pid %d",
+					  table->qname,
+					  ownerPid);
+
+			*skipped = true;
+			return true;
+		}
+
+		log_notice("Found stale pid %d, taking over the indexes of table %s",
+				   ownerPid,
+				   table->qname);
+
+		if (!summary_steal_table_index_group(sourceDB,
+											 &tableSpecs,
+											 table->indexCount,
+											 ownerPid))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (!summary_lookup_table_indexes_done(sourceDB, &tableSpecs))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		/* another process might have taken over before us */
+		if (tableSpecs.indexesDonePid != getpid())
+		{
+			*skipped = true;
+			return true;
+		}
+	}
+
+	/*
+	 * Fetch the table indexes in memory first, we can't hold the catalog
+	 * semaphore while registering the index builds in the summary.
+	 */
+	SourceIndexArray indexArray = { 0 };
+
+	if (!catalog_iter_s_index_table(sourceDB,
+									table->nspname,
+									table->relname,
+									&indexArray,
+									&copydb_collect_table_indexes_hook))
+	{
+		log_error("Failed to list indexes of table %s, "
+				  "see above for details",
+				  table->qname);
+		free(indexArray.array);
+		return false;
+	}
+
+	IndexGroupBuild *builds =
+		(IndexGroupBuild *) calloc(indexArray.count + 1,
+								   sizeof(IndexGroupBuild));
+
+	if (builds == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		free(indexArray.array);
+		return false;
+	}
+
+	int count = 0;
+
+	for (int i = 0; i < indexArray.count; i++)
+	{
+		SourceIndex *index = &(indexArray.array[i]);
+
+		/*
+		 * Indexes for constraints that are neither UNIQUE nor PRIMARY KEY are
+		 * built later with ALTER TABLE, copydb_create_index only registers
+		 * them as done and does not use the target connection.
+		 */
+		if (index->constraintOid != 0 && !index->isPrimary && !index->isUnique)
+		{
+			if (!copydb_create_index(specs, NULL, index, ifNotExists, false))
+			{
+				/* errors have already been logged */
+				free(builds);
+				free(indexArray.array);
+				return false;
+			}
+
+			continue;
+		}
+
+		IndexGroupBuild *build = &(builds[count]);
+		bool isDone = false;
+
+		build->indexSpecs.sourceIndex = index;
+
+		if (!copydb_index_is_being_processed(specs,
+											 &(build->indexSpecs),
+											 &isDone))
+		{
+			/* errors have already been logged */
+			free(builds);
+			free(indexArray.array);
+			return false;
+		}
+
+		if (isDone)
+		{
+			continue;
+		}
+
+		if (!copydb_prepare_create_index_command(&(build->indexSpecs),
+												 ifNotExists,
+												 false))
+		{
+			/* errors have already been logged */
+			free(builds);
+			free(indexArray.array);
+			return false;
+		}
+
+		++count;
+	}
+
+	/*
+	 * With --index-memory-budget, each build of the group gets its own share
+	 * of the budget. When the group needs more than the whole budget, share
+	 * it in proportion to each index size, giving at least one unit to each
+	 * index.
+	 */
+	int totalUnits = 0;
+
+	if (specs->indexMemoryBudget > 0 && count > 0)
+	{
+		int budgetUnits = specs->indexMemorySema.initValue;
+		int64_t plannedUnits = 0;
+
+		for (int i = 0; i < count; i++)
+		{
+			IndexGroupBuild *build = &(builds[i]);
+
+			(void) copydb_index_memory_plan(specs,
+											build->indexSpecs.sourceIndex,
+											&(build->units),
+											&(build->workers));
+
+			plannedUnits += build->units;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			IndexGroupBuild *build = &(builds[i]);
+
+			if (plannedUnits > budgetUnits)
+			{
+				build->units = (int) (build->units * budgetUnits / plannedUnits);
+
+				if (build->units < 1)
+				{
+					build->units = 1;
+				}
+			}
+
+			totalUnits += build->units;
+		}
+
+		/* rounding up to one unit may have taken us over the budget */
+		while (totalUnits > budgetUnits)
+		{
+			IndexGroupBuild *largest = &(builds[0]);
+
+			for (int i = 1; i < count; i++)
+			{
+				if (builds[i].units > largest->units)
+				{
+					largest = &(builds[i]);
+				}
+			}
+
+			--(largest->units);
+			--totalUnits;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			IndexGroupBuild *build = &(builds[i]);
+			int64_t memory = (int64_t) build->units * INDEX_MEMORY_UNIT;
+			int maxWorkers = memory / INDEX_PARALLEL_WORKER_MEMORY - 1;
+
+			if (build->workers > maxWorkers)
+			{
+				build->workers = maxWorkers;
+			}
+		}
+
+		log_debug("Waiting for %d MB of maintenance_work_mem to build "
+				  "%d indexes of table %s",
+				  totalUnits * (INDEX_MEMORY_UNIT / (1024 * 1024)),
+				  count,
+				  table->qname);
+
+		if (!semaphore_lock_units(&(specs->indexMemorySema), totalUnits))
+		{
+			/* errors have already been logged */
+			free(builds);
+			free(indexArray.array);
+			return false;
+		}
+	}
+
+	if (count > 0)
+	{
+		log_info("Creating %d indexes of table %s using a shared table scan",
+				 count,
+				 table->qname);
+	}
+
+	/*
+	 * Each concurrent build uses its own connection to the target database,
+	 * and we run at most --index-jobs of them at a time: the next build of
+	 * the group starts when one of the running builds is done, and still
+	 * benefits from the synchronized scan of the table.
+	 */
+	int maxPending = specs->indexJobs > 0 ? specs->indexJobs : count;
+
+	int errors = 0;
+	int pending = 0;
+	int started = 0;
+
+	while (started < count || pending > 0)
+	{
+		while (started < count && pending < maxPending)
+		{
+			IndexGroupBuild *build = &(builds[started++]);
+
+			if (!copydb_index_group_start_build(specs, build))
+			{
+				/* errors have already been logged */
+				build->done = true;
+				++errors;
+				(void) pgsql_finish(&(build->dst));
+				continue;
+			}
+
+			++pending;
+		}
+
+		if (pending == 0)
+		{
+			break;
+		}
+
+		if (asked_to_stop || asked_to_stop_fast || asked_to_quit)
+		{
+			log_error("Interrupted while creating indexes of table %s",
+					  table->qname);
+			++errors;
+			break;
+		}
+
+		for (int i = 0; i < started; i++)
+		{
+			IndexGroupBuild *build = &(builds[i]);
+			bool done = false;
+
+			if (build->done)
+			{
+				continue;
+			}
+
+			if (!pgsql_fetch_results(&(build->dst), &done, NULL, NULL))
+			{
+				/* errors have already been logged */
+				build->done = true;
+				--pending;
+				++errors;
+				(void) pgsql_finish(&(build->dst));
+				continue;
+			}
+
+			if (done)
+			{
+				build->done = true;
+				--pending;
+
+				/* release the connection for the next build */
+				(void) pgsql_finish(&(build->dst));
+
+				if (!copydb_mark_index_as_done(specs, &(build->indexSpecs)))
+				{
+					/* errors have already been logged */
+					++errors;
+				}
+			}
+		}
+
+		if (pending > 0)
+		{
+			pg_usleep(10 * 1000); /* 10 ms */
+		}
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		(void) pgsql_finish(&(builds[i].dst));
+	}
+
+	if (totalUnits > 0 &&
+		!semaphore_unlock_units(&(specs->indexMemorySema), totalUnits))
+	{
+		/* errors have already been logged */
+		++errors;
+	}
+
+	free(builds);
+	free(indexArray.array);
+
+	if (errors > 0)
+	{
+		log_error("Failed to create %d indexes of table %s, "
+				  "see above for details",
+				  errors,
+				  table->qname);
+		return false;
+	}
+
+	if (!summary_finish_table_index_group(sourceDB, &tableSpecs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * copydb_index_group_start_build opens a new connection to the target
+ * database for the given build of an index group, and sends its CREATE INDEX
+ * command there.
+ */
+static bool
+copydb_index_group_start_build(CopyDataSpec *specs, IndexGroupBuild *build)
+{
+	SourceIndex *index = build->indexSpecs.sourceIndex;
+	char *command = build->indexSpecs.summary.command;
+
+	GUC syncScan[] = {
+		{ "synchronize_seqscans", "on" },
+		{ NULL, NULL },
+	};
+
+	if (!pgsql_init(&(build->dst),
+					specs->connStrings.target_pguri,
+					PGSQL_CONN_TARGET))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (!pgsql_set_gucs(&(build->dst), dstSettings) ||
+		!pgsql_set_gucs(&(build->dst), syncScan))
+	{
+		log_error("Failed to set our GUC settings on the target "
+				  "connection, see above for details");
+		return false;
+	}
+
+	if (build->units > 0 &&
+		!copydb_index_memory_set_gucs(&(build->dst),
+									  index,
+									  build->units,
+									  build->workers))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	log_notice("%s", command);
+
+	if (!pgsql_send_with_params(&(build->dst), command, 0, NULL, NULL))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * copydb_collect_table_indexes_hook is an iterator callback function that
+ * collects all the indexes of a table into a SourceIndexArray.
+ */
+static bool
+copydb_collect_table_indexes_hook(void *ctx, SourceIndex *index)
+{
+	SourceIndexArray *indexArray = (SourceIndexArray *) ctx;
+
+	/* grow the array if needed */
+	if (indexArray->count >= indexArray->capacity)
+	{
+		int newCap = indexArray->capacity == 0 ? 8 : indexArray->capacity * 2;
+		SourceIndex *newArray =
+			(SourceIndex *) realloc(indexArray->array,
+									newCap * sizeof(SourceIndex));
+
+		if (newArray == NULL)
+		{
+			log_error(ALLOCATION_FAILED_ERROR);
+			return false;
+		}
+
+		indexArray->array = newArray;
+		indexArray->capacity = newCap;
+	}
+
+	indexArray->array[indexArray->count] = *index;
+	indexArray->count++;
+
+	return true;
+}
+
+
+/*
+ * copydb_index_memory_plan computes how many units of the --index-memory-budget
+ * an index build uses, and how many parallel maintenance workers it may use.
+ *
+ * Sorting the index entries needs about as much memory as the index on-disk
+ * size on the source database, so big indexes get more memory, up to the whole
+ * budget, which leaves fewer units for concurrent builds. Small indexes, and
+ * indexes which size is unknown, get a single unit.
+ */
+static void
+copydb_index_memory_plan(CopyDataSpec *specs,
+						 SourceIndex *index,
+						 int *units,
+						 int *workers)
+{
+	int budgetUnits = specs->indexMemorySema.initValue;
+	int64_t indexUnits =
+		(index->bytes + INDEX_MEMORY_UNIT - 1) / INDEX_MEMORY_UNIT;
+
+	if (indexUnits < 1)
+	{
+		indexUnits = 1;
+	}
+
+	if (indexUnits > budgetUnits)
+	{
+		indexUnits = budgetUnits;
+	}
+
+	*units = (int) indexUnits;
+
+	/* each parallel participant needs its own share of the memory */
+	int64_t memory = indexUnits * INDEX_MEMORY_UNIT;
+	int64_t maxWorkers = memory / INDEX_PARALLEL_WORKER_MEMORY - 1;
+	int64_t sizeWorkers = index->bytes / INDEX_BYTES_PER_PARALLEL_WORKER;
+
+	*workers = sizeWorkers;
+
+	if (*workers > maxWorkers)
+	{
+		*workers = maxWorkers;
+	}
+
+	if (*workers > INDEX_MAX_PARALLEL_WORKERS)
+	{
+		*workers = INDEX_MAX_PARALLEL_WORKERS;
+	}
+}
+
+
+/*
+ * copydb_index_memory_acquire waits until enough units of the index memory
+ * budget are available for the given index build, then sets the
+ * maintenance_work_mem and max_parallel_maintenance_workers accordingly on the
+ * target connection. The caller must release the units when the build is
+ * done, using semaphore_unlock_units().
+ */
+static bool
+copydb_index_memory_acquire(CopyDataSpec *specs,
+							PGSQL *dst,
+							SourceIndex *index,
+							int *units)
+{
+	int workers = 0;
+	int planUnits = 0;
+
+	(void) copydb_index_memory_plan(specs, index, &planUnits, &workers);
+
+	log_debug("Waiting for %d MB of maintenance_work_mem to build index %s",
+			  planUnits * (INDEX_MEMORY_UNIT / (1024 * 1024)),
+			  index->indexQname);
+
+	if (!semaphore_lock_units(&(specs->indexMemorySema), planUnits))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	*units = planUnits;
 
-	if (!copydb_index_is_being_processed(specs, &indexSpecs, &isDone))
+	if (!copydb_index_memory_set_gucs(dst, index, planUnits, workers))
 	{
-		/* errors have already been logged */
+		(void) semaphore_unlock_units(&(specs->indexMemorySema), planUnits);
+		*units = 0;
+
 		return false;
 	}
 
-	if (isDone)
+	return true;
+}
+
+
+/*
+ * copydb_index_memory_set_gucs sets maintenance_work_mem and
+ * max_parallel_maintenance_workers on the target connection, to build the
+ * given index with the given units of the --index-memory-budget.
+ */
+static bool
+copydb_index_memory_set_gucs(PGSQL *dst,
+							 SourceIndex *index,
+							 int units,
+							 int workers)
+{
+	if (!pgsql_server_version(dst))
 	{
-		log_debug("Skipping index %s which is being created by another process",
-				  index->indexQname);
-		return true;
+		/* errors have already been logged */
+		return false;
 	}
 
-	if (!skipCreateIndex)
-	{
-		/*
-		 * Prepare the CREATE INDEX command based on the index definition and
-		 * ifNotExists flag.
-		 */
-		if (!copydb_prepare_create_index_command(&indexSpecs, ifNotExists))
-		{
-			/* errors have already been logged */
-			return false;
-		}
+	char mwm[BUFSIZE] = { 0 };
+	char pmw[BUFSIZE] = { 0 };
 
-		log_notice("%s", indexSummary->command);
+	sformat(mwm, sizeof(mwm), "'%d MB'",
+			units * (INDEX_MEMORY_UNIT / (1024 * 1024)));
 
-		if (!pgsql_execute(dst, indexSummary->command))
-		{
-			/* errors have already been logged */
-			return false;
-		}
+	sformat(pmw, sizeof(pmw), "%d", workers);
+
+	GUC settings[] = {
+		{ "maintenance_work_mem", mwm },
+		{ "max_parallel_maintenance_workers", pmw },
+		{ NULL, NULL },
+	};
+
+	/* max_parallel_maintenance_workers appeared in Postgres 11 */
+	if (dst->pgversion_num < 110000)
+	{
+		settings[1].name = NULL;
 	}
 
-	if (!copydb_mark_index_as_done(specs, &indexSpecs))
+	if (!pgsql_set_gucs(dst, settings))
 	{
-		/* errors have already been logged */
+		log_error("Failed to set maintenance_work_mem to %s "
+				  "to build index %s",
+				  mwm,
+				  index->indexQname);
 		return false;
 	}
 
+	log_debug("Building index %s with maintenance_work_mem %s "
+			  "and %d parallel maintenance workers",
+			  index->indexQname,
+			  mwm,
+			  workers);
+
 	return true;
 }
 
@@ -1038,28 +2062,37 @@ copydb_mark_index_as_done(CopyDataSpec *specs, CopyIndexSpec *indexSpecs)
  * are added to the command, necessary to resume operations in some cases.
  */
 bool
-copydb_prepare_create_index_command(CopyIndexSpec *indexSpecs, bool ifNotExists)
+copydb_prepare_create_index_command(CopyIndexSpec *indexSpecs,
+									bool ifNotExists,
+									bool concurrently)
 {
 	PQExpBuffer cmd = createPQExpBuffer();
 
 	SourceIndex *index = indexSpecs->sourceIndex;
 
 	/* prepare the create index command, maybe adding IF NOT EXISTS */
-	if (ifNotExists)
+	if (ifNotExists || concurrently)
 	{
 		int ci_len = strlen("CREATE INDEX ");
 		int cu_len = strlen("CREATE UNIQUE INDEX ");
 
+		char *options = concurrently ? "CONCURRENTLY " : "";
+		char *ine = ifNotExists ? "IF NOT EXISTS " : "";
+
 		if (strncmp(index->indexDef, "CREATE INDEX ", ci_len) == 0)
 		{
 			appendPQExpBuffer(cmd,
-							  "CREATE INDEX IF NOT EXISTS %s;",
+							  "CREATE INDEX %s%s%s;",
+							  options,
+							  ine,
 							  index->indexDef + ci_len);
 		}
 		else if (strncmp(index->indexDef, "CREATE UNIQUE INDEX ", cu_len) == 0)
 		{
 			appendPQExpBuffer(cmd,
-							  "CREATE UNIQUE INDEX IF NOT EXISTS %s;",
+							  "CREATE UNIQUE INDEX %s%s%s;",
+							  options,
+							  ine,
 							  index->indexDef + cu_len);
 		}
 		else
@@ -1432,14 +2465,23 @@ copydb_collect_fk_constraints_hook(void *ctx, SourceFKConstraint *fk)
 
 /*
  * copydb_create_fk_constraints creates all FK constraints that were fetched
- * from the source catalog. For each constraint:
+ * from the source catalog, in two phases:
+ *
+ *  1. ALTER TABLE <table> ADD CONSTRAINT <name> <def> NOT VALID, which only
+ *     takes a short lock and does not scan the tables.
  *
- *  1. Try: ALTER TABLE <table> ADD CONSTRAINT <name> <def>
- *  2. On SQLSTATE 23503: retry with NOT VALID appended.
- *  3. Record result in summary catalog.
+ *  2. ALTER TABLE <table> VALIDATE CONSTRAINT <name>, run concurrently on as
+ *     many connections as --index-jobs, see copydb_validate_fk_constraints.
+ *     On SQLSTATE 23503 the constraint is left NOT VALID.
+ *
+ * Postgres versions before 18 do not accept NOT VALID foreign keys on
+ * partitioned tables. There, those are added in a single valid ALTER TABLE
+ * command, retried with NOT VALID on SQLSTATE 23503 as well.
+ *
+ * Results are recorded in the fk_constraint_summary catalog table.
  *
  * FK constraints are handled separately from pg_restore to allow per-constraint
- * error handling and automatic NOT VALID retry.
+ * error handling and keeping constraints NOT VALID on data violations.
  */
 bool
 copydb_create_fk_constraints(CopyDataSpec *specs)
@@ -1468,19 +2510,42 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 
 	log_info("Creating %d FK constraints", fkArray.count);
 
+	/* FK constraints added NOT VALID that need a VALIDATE CONSTRAINT */
+	bool *validate = (bool *) calloc(fkArray.count, sizeof(bool));
+
+	if (validate == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		free(fkArray.array);
+		return false;
+	}
+
 	/*
-	 * Phase 2: Create FK constraints on the target.
+	 * Phase 2: Create FK constraints on the target, as NOT VALID.
 	 */
 	PGSQL dst = { 0 };
 
 	if (!pgsql_init(&dst, specs->connStrings.target_pguri, PGSQL_CONN_TARGET))
 	{
 		log_error("Failed to initialize connection to target database");
+		free(validate);
+		free(fkArray.array);
+		return false;
+	}
+
+	/* our connection is closed after each statement, keep the version */
+	if (!pgsql_server_version(&dst))
+	{
+		/* errors have already been logged */
+		free(validate);
 		free(fkArray.array);
 		return false;
 	}
 
+	int targetVersionNum = dst.pgversion_num;
+
 	bool success = true;
+	int validateCount = 0;
 	int notValidCount = 0;
 	int sourceNotValidCount = 0;
 
@@ -1490,11 +2555,15 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 
 		/*
 		 * Resume support: check if this FK constraint has already been
-		 * processed in a previous run.
+		 * processed in a previous run, maybe only the first phase of it.
 		 */
 		bool alreadyDone = false;
+		bool validatePending = false;
 
-		if (!summary_lookup_fk_constraint(sourceDB, fk->oid, &alreadyDone))
+		if (!summary_lookup_fk_constraint(sourceDB,
+										  fk->oid,
+										  &alreadyDone,
+										  &validatePending))
 		{
 			/* errors have already been logged */
 			success = false;
@@ -1503,17 +2572,24 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 
 		if (alreadyDone)
 		{
-			log_notice("Skipping already processed FK constraint \"%s\" on %s",
-					   fk->conname, fk->tableQname);
+			if (validatePending && fk->convalidated)
+			{
+				validate[i] = true;
+				++validateCount;
+			}
+			else
+			{
+				log_notice("Skipping already processed FK constraint "
+						   "\"%s\" on %s",
+						   fk->conname, fk->tableQname);
+			}
 			continue;
 		}
 
 		/*
 		 * If the constraint is already NOT VALID on the source, create it
-		 * as NOT VALID directly — no need to try normal creation first.
-		 * pg_get_constraintdef() already includes NOT VALID in the output
-		 * for such constraints, so the constraintDef handles this, but we
-		 * log it explicitly for clarity.
+		 * as NOT VALID and skip the validation. pg_get_constraintdef()
+		 * already includes NOT VALID in the output for such constraints.
 		 */
 		if (!fk->convalidated)
 		{
@@ -1523,6 +2599,14 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 			sourceNotValidCount++;
 		}
 
+		/*
+		 * Add the constraint NOT VALID and VALIDATE it later, unless the
+		 * target Postgres version does not support it for the table.
+		 */
+		bool twoPhases =
+			fk->convalidated &&
+			(fk->relkind != 'p' || targetVersionNum >= 180000);
+
 		/*
 		 * Build the ALTER TABLE ADD CONSTRAINT command.
 		 */
@@ -1544,6 +2628,11 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 			}
 		}
 
+		if (twoPhases)
+		{
+			appendPQExpBufferStr(cmd, " NOT VALID");
+		}
+
 		if (PQExpBufferBroken(cmd))
 		{
 			log_error("Failed to create query for FK constraint \"%s\": "
@@ -1567,40 +2656,22 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 
 		log_notice("Creating FK constraint: %s", cmd->data);
 
-		bool notValid = false;
+		bool added = true;
+		bool violationNotValid = false;
+		bool existingNotValid = false;
 
 		if (!pgsql_execute(&dst, cmd->data))
 		{
-			/*
-			 * Check if the failure is due to a foreign key violation
-			 * (SQLSTATE 23503). If so, retry with NOT VALID.
-			 */
-			if (strcmp(dst.sqlstate,
+			added = false;
+
+			if (fk->convalidated && !twoPhases &&
+				strcmp(dst.sqlstate,
 					   STR_ERRCODE_FOREIGN_KEY_VIOLATION) == 0)
 			{
 				log_warn("FK constraint \"%s\" on %s has pre-existing data "
 						 "violations, retrying with NOT VALID",
 						 fk->conname, fk->tableQname);
 
-				/* rebuild the command with NOT VALID */
-				resetPQExpBuffer(cmd);
-
-				appendPQExpBuffer(cmd,
-								  "ALTER TABLE %s ADD CONSTRAINT %s %s",
-								  fk->tableQname,
-								  fk->conname,
-								  fk->constraintDef);
-
-				if (fk->condeferrable)
-				{
-					appendPQExpBufferStr(cmd, " DEFERRABLE");
-
-					if (fk->condeferred)
-					{
-						appendPQExpBufferStr(cmd, " INITIALLY DEFERRED");
-					}
-				}
-
 				appendPQExpBufferStr(cmd, " NOT VALID");
 
 				/* clear the error state for retry */
@@ -1616,8 +2687,8 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 					break;
 				}
 
-				notValid = true;
-				notValidCount++;
+				++notValidCount;
+				violationNotValid = true;
 
 				log_warn("FK constraint \"%s\" on %s created as NOT VALID "
 						 "due to pre-existing data violations",
@@ -1631,10 +2702,37 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 				 * because it was defined inline in CREATE TABLE and
 				 * created during the pre-data pg_restore phase.
 				 */
-				log_notice("FK constraint \"%s\" on %s already exists "
-						   "on target, skipping",
-						   fk->conname, fk->tableQname);
 				memset(dst.sqlstate, 0, sizeof(dst.sqlstate));
+
+				/*
+				 * When resuming after a crash between the ADD CONSTRAINT
+				 * NOT VALID and its registration in our catalogs, the
+				 * constraint still needs its VALIDATE CONSTRAINT.
+				 */
+				if (fk->convalidated &&
+					!pgsql_fk_constraint_is_not_valid(&dst,
+													  fk->tableQname,
+													  fk->conname,
+													  &existingNotValid))
+				{
+					/* errors have already been logged */
+					destroyPQExpBuffer(cmd);
+					success = false;
+					break;
+				}
+
+				if (existingNotValid)
+				{
+					log_notice("FK constraint \"%s\" on %s already exists "
+							   "on target as NOT VALID, validating it",
+							   fk->conname, fk->tableQname);
+				}
+				else
+				{
+					log_notice("FK constraint \"%s\" on %s already exists "
+							   "on target, skipping",
+							   fk->conname, fk->tableQname);
+				}
 			}
 			else if (strcmp(dst.sqlstate,
 							STR_ERRCODE_INVALID_SCHEMA_NAME) == 0 ||
@@ -1670,7 +2768,23 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 		INSTR_TIME_SUBTRACT(duration, startTime);
 		uint64_t durationMs = INSTR_TIME_GET_MILLISEC(duration);
 
-		if (!summary_finish_fk_constraint(sourceDB, fk, durationMs, notValid))
+		/* only constraints added NOT VALID by us are waiting for VALIDATE */
+		bool addedNotValid = (added && twoPhases) || existingNotValid;
+		bool notValid = addedNotValid || violationNotValid;
+
+		if (!summary_finish_fk_constraint(sourceDB,
+										  fk,
+										  durationMs,
+										  notValid))
+		{
+			/* errors have already been logged */
+			success = false;
+			break;
+		}
+
+		/* a constraint with data violations would fail its VALIDATE */
+		if (violationNotValid &&
+			!summary_finish_fk_validation(sourceDB, fk, 0, violationNotValid))
 		{
 			/* errors have already been logged */
 			success = false;
@@ -1687,6 +2801,26 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 			success = false;
 			break;
 		}
+
+		if (addedNotValid)
+		{
+			validate[i] = true;
+			++validateCount;
+		}
+	}
+
+	(void) pgsql_finish(&dst);
+
+	/*
+	 * Phase 3: VALIDATE the FK constraints concurrently.
+	 */
+	if (success && validateCount > 0)
+	{
+		success = copydb_validate_fk_constraints(specs,
+												 &fkArray,
+												 validate,
+												 validateCount,
+												 &notValidCount);
 	}
 
 	if (sourceNotValidCount > 0)
@@ -1698,7 +2832,7 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 
 	if (notValidCount > 0)
 	{
-		log_warn("%d FK constraint(s) created as NOT VALID due to "
+		log_warn("%d FK constraint(s) left NOT VALID due to "
 				 "pre-existing data violations on the source database",
 				 notValidCount);
 	}
@@ -1712,8 +2846,276 @@ copydb_create_fk_constraints(CopyDataSpec *specs)
 		}
 	}
 
+	free(validate);
 	free(fkArray.array);
-	(void) pgsql_finish(&dst);
 
 	return success;
 }
+
+
+/*
+ * FKValidation tracks a VALIDATE CONSTRAINT command running on one of the
+ * target connections of copydb_validate_fk_constraints.
+ */
+typedef struct FKValidation
+{
+	PGSQL dst;
+	SourceFKConstraint *fk;     /* NULL when the connection is idle */
+	instr_time startTime;
+} FKValidation;
+
+
+/*
+ * copydb_validate_fk_constraints runs ALTER TABLE ... VALIDATE CONSTRAINT for
+ * the FK constraints marked in the validate array, using up to --index-jobs
+ * concurrent connections to the target database.
+ *
+ * VALIDATE CONSTRAINT scans both the referencing and the referenced tables.
+ * To limit lock and IO contention, two validations never run at the same
+ * time on the same referenced table, nor on the same referencing table,
+ * where they would only wait on one another's lock.
+ */
+static bool
+copydb_validate_fk_constraints(CopyDataSpec *specs,
+							   SourceFKConstraintArray *fkArray,
+							   bool *validate,
+							   int validateCount,
+							   int *notValidCount)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+
+	int jobs = specs->indexJobs < validateCount ? specs->indexJobs : validateCount;
+
+	if (jobs < 1)
+	{
+		jobs = 1;
+	}
+
+	FKValidation *slots = (FKValidation *) calloc(jobs, sizeof(FKValidation));
+
+	if (slots == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	log_info("Validating %d FK constraints using %d connections",
+			 validateCount,
+			 jobs);
+
+	int errors = 0;
+	int running = 0;
+	int pending = validateCount;
+
+	while (pending > 0 || running > 0)
+	{
+		if (asked_to_stop || asked_to_stop_fast || asked_to_quit)
+		{
+			log_error("Interrupted while validating FK constraints");
+			++errors;
+			break;
+		}
+
+		/* start new validations on idle connections, unless we failed */
+		for (int s = 0; s < jobs && pending > 0 && errors == 0; s++)
+		{
+			FKValidation *slot = &(slots[s]);
+
+			if (slot->fk != NULL)
+			{
+				continue;
+			}
+
+			int next = copydb_fk_validation_next(fkArray, validate, slots, jobs);
+
+			/* remaining validations wait for a running one on their tables */
+			if (next == -1)
+			{
+				break;
+			}
+
+			SourceFKConstraint *fk = &(fkArray->array[next]);
+
+			validate[next] = false;
+			--pending;
+
+			if (slot->dst.connection == NULL)
+			{
+				if (!pgsql_init(&(slot->dst),
+								specs->connStrings.target_pguri,
+								PGSQL_CONN_TARGET) ||
+					!pgsql_set_gucs(&(slot->dst), dstSettings))
+				{
+					/* errors have already been logged */
+					++errors;
+					break;
+				}
+			}
+
+			char sql[BUFSIZE] = { 0 };
+
+			sformat(sql, sizeof(sql), "ALTER TABLE %s VALIDATE CONSTRAINT %s",
+					fk->tableQname,
+					fk->conname);
+
+			if (!summary_start_fk_validation(sourceDB, fk))
+			{
+				/* errors have already been logged */
+				++errors;
+				break;
+			}
+
+			log_notice("%s", sql);
+
+			INSTR_TIME_SET_CURRENT(slot->startTime);
+
+			if (!pgsql_send_with_params(&(slot->dst), sql, 0, NULL, NULL))
+			{
+				/* errors have already been logged */
+				(void) pgsql_finish(&(slot->dst));
+				++errors;
+				break;
+			}
+
+			slot->fk = fk;
+			++running;
+		}
+
+		/* when we failed, stop waiting when nothing is running anymore */
+		if (running == 0 && errors > 0)
+		{
+			break;
+		}
+
+		/* now check the running validations for completion */
+		for (int s = 0; s < jobs; s++)
+		{
+			FKValidation *slot = &(slots[s]);
+			SourceFKConstraint *fk = slot->fk;
+			bool done = false;
+			bool notValid = false;
+
+			if (fk == NULL)
+			{
+				continue;
+			}
+
+			if (!pgsql_fetch_results(&(slot->dst), &done, NULL, NULL))
+			{
+				if (strcmp(slot->dst.sqlstate,
+						   STR_ERRCODE_FOREIGN_KEY_VIOLATION) != 0)
+				{
+					log_error("Failed to validate FK constraint \"%s\" on %s",
+							  fk->conname, fk->tableQname);
+
+					(void) pgsql_finish(&(slot->dst));
+					slot->fk = NULL;
+					--running;
+					++errors;
+					continue;
+				}
+
+				log_warn("FK constraint \"%s\" on %s has pre-existing data "
+						 "violations, leaving it NOT VALID",
+						 fk->conname, fk->tableQname);
+
+				/* get a clean connection for the next validation */
+				(void) pgsql_finish(&(slot->dst));
+
+				done = true;
+				notValid = true;
+				++(*notValidCount);
+			}
+
+			if (!done)
+			{
+				continue;
+			}
+
+			instr_time duration;
+			INSTR_TIME_SET_CURRENT(duration);
+			INSTR_TIME_SUBTRACT(duration, slot->startTime);
+			uint64_t durationMs = INSTR_TIME_GET_MILLISEC(duration);
+
+			slot->fk = NULL;
+			--running;
+
+			if (!summary_finish_fk_validation(sourceDB, fk, durationMs, notValid))
+			{
+				/* errors have already been logged */
+				++errors;
+				continue;
+			}
+
+			if (!summary_increment_timing(sourceDB,
+										  TIMING_SECTION_ALTER_TABLE,
+										  0, /* count */
+										  0, /* bytes */
+										  durationMs))
+			{
+				/* errors have already been logged */
+				++errors;
+			}
+		}
+
+		if (running > 0)
+		{
+			pg_usleep(10 * 1000); /* 10 ms */
+		}
+	}
+
+	for (int s = 0; s < jobs; s++)
+	{
+		(void) pgsql_finish(&(slots[s].dst));
+	}
+
+	free(slots);
+
+	return errors == 0;
+}
+
+
+/*
+ * copydb_fk_validation_next returns the index in fkArray of the next FK
+ * constraint to validate, skipping constraints that reference a table, or
+ * belong to a table, that a running validation is already using. Returns -1
+ * when no constraint can be started now.
+ */
+static int
+copydb_fk_validation_next(SourceFKConstraintArray *fkArray,
+						  bool *validate,
+						  FKValidation *slots,
+						  int jobs)
+{
+	for (int i = 0; i < fkArray->count; i++)
+	{
+		SourceFKConstraint *fk = &(fkArray->array[i]);
+		bool busy = false;
+
+		if (!validate[i])
+		{
+			continue;
+		}
+
+		for (int s = 0; s < jobs && !busy; s++)
+		{
+			SourceFKConstraint *running = slots[s].fk;
+
+			if (running == NULL)
+			{
+				continue;
+			}
+
+			busy = streq(running->tableQname, fk->tableQname) ||
+				   (!IS_EMPTY_STRING_BUFFER(fk->refQname) &&
+					streq(running->refQname, fk->refQname));
+		}
+
+		if (!busy)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
@@ -41,6 +41,28 @@
  */
 #define PIPELINE_BYTES_SYNC_THRESHOLD (512ULL * 1024 * 1024)
 
+/*
+ * When applying changes from a file, a run of INSERT statements into the same
+ * table within a transaction that adds at least this many rows is applied
+ * with COPY rather than with one EXECUTE per statement.
+ */
+#define STREAM_APPLY_COPY_MIN_ROWS 1000
+
+/* the transform process writes INSERT statements with this VALUES clause */
+#define INSERT_VALUES " overriding system value VALUES "
+
+/*
+ * A run of consecutive INSERT statements into the same table and columns.
+ */
+typedef struct StreamApplyCopyRun
+{
+	const char *stmt;           /* first INSERT statement of the run */
+	int targetLen;              /* length of "INSERT INTO qname (columns)" */
+	int cols;                   /* number of values per row */
+	uint64_t rows;              /* number of rows in the run */
+	uint64_t end;               /* index of the first message after the run */
+} StreamApplyCopyRun;
+
 GUC applySettingsSync[] = {
 	COMMON_GUC_SETTINGS,
 	{ "synchronous_commit", "on" },
@@ -55,15 +77,39 @@ GUC applySettings[] = {
 	{ NULL, NULL },
 };
 
-static bool readTxnCommitLSN(LogicalMessageMetadata *metadata, const char *dir,
+static bool readTxnCommitLSN(LogicalMessageMetadata *metadata,
+							 DatabaseCatalog *sourceDB,
 							 bool *txnCommitLSNFound);
-static bool parseTxnMetadataFile(const char *filename, LogicalMessageMetadata *metadata);
 
-static bool computeTxnMetadataFilename(uint32_t xid, const char *dir, char *filename);
+static bool writeTxnCommitLSN(LogicalMessageMetadata *metadata,
+							  DatabaseCatalog *sourceDB);
 
-static bool writeTxnCommitMetadata(LogicalMessageMetadata *mesg, const char *dir);
+static bool stream_apply_prepare(StreamApplyContext *context,
+								 LogicalMessageMetadata *metadata,
+								 PGSQL *applyPgConn,
+								 PreparedStmt **preparedStmt,
+								 PreparedStmt **result);
 
-static bool setupConnection(PGSQL *pgsql, StreamApplyContext *context);
+static bool stream_apply_get_params(LogicalMessageMetadata *metadata,
+									int *count,
+									const char ***paramValues);
+
+static bool stream_apply_copy_run(StreamApplyContext *context,
+								  LogicalMessageMetadata *mArray,
+								  uint64_t count,
+								  uint64_t start,
+								  uint64_t *end,
+								  bool *copied);
+
+static bool stream_apply_copy_scan(LogicalMessageMetadata *mArray,
+								   uint64_t count,
+								   uint64_t start,
+								   StreamApplyCopyRun *run);
+
+static bool stream_apply_copy_parse_insert(const char *stmt,
+										   int *targetLen,
+										   int *rows,
+										   int *cols);
 
 static bool extractTableNameFromPrepare(const char *stmt,
 										char *nspname, size_t nspnameSize,
@@ -243,6 +289,7 @@ stream_apply_setup(StreamSpecs *specs, StreamApplyContext *context)
 	}
 
 	context->logSQL = specs->logSQL;
+	context->applyJobs = specs->applyJobs;
 
 	/* wait until the sentinel enables the apply process */
 	if (!stream_apply_wait_for_sentinel(specs, context))
@@ -324,6 +371,11 @@ stream_apply_cleanup(StreamApplyContext *context)
 
 	(void) pgsql_finish(&(context->applyPgConn));
 
+	if (context->parallel != NULL)
+	{
+		(void) stream_apply_parallel_cleanup(context);
+	}
+
 	return true;
 }
 
@@ -462,6 +514,15 @@ stream_apply_sync_sentinel(StreamApplyContext *context, bool findDurableLSN)
 		return true;
 	}
 
+	if (context->parallel != NULL)
+	{
+		if (!stream_apply_parallel_sync_sentinel(context))
+		{
+			log_warn("Failed to sync apply workers progress "
+					 "with the pgcopydb sentinel");
+		}
+	}
+
 	context->apply = sentinel.apply;
 	context->endpos = sentinel.endpos;
 	context->startpos = sentinel.startpos;
@@ -501,57 +562,103 @@ stream_apply_file(StreamApplyContext *context)
 		return false;
 	}
 
-	if (!splitLines(&(content.lbuf), contents))
+	LogicalMessageMetadata *mArray = NULL;
+	uint64_t count = 0;
+
+	/* files written with --transform-format binary begin with a signature */
+	bool binary = stream_binary_has_signature(contents, size);
+
+	if (binary)
 	{
-		/* errors have already been logged */
-		return false;
-	}
+		if (!stream_binary_parse_buffer(contents,
+										size,
+										context->filters,
+										&mArray,
+										&count))
+		{
+			log_error("Failed to parse binary file \"%s\"", content.filename);
+			free(contents);
+			return false;
+		}
 
-	log_info("Replaying changes from file \"%s\"", context->sqlFileName);
+		log_info("Replaying changes from file \"%s\"", context->sqlFileName);
 
-	log_debug("Read %lld lines in file \"%s\"",
-			  (long long) content.lbuf.count,
-			  content.filename);
+		log_debug("Read %lld messages in binary file \"%s\"",
+				  (long long) count,
+				  content.filename);
 
-	/*
-	 * If the file contains zero lines, we're done already, Also malloc(zero)
-	 * leads to "corrupted size vs. prev_size" run-time errors.
-	 */
-	if (content.lbuf.count == 0)
-	{
-		return true;
+		if (count == 0)
+		{
+			free(contents);
+			return true;
+		}
 	}
+	else
+	{
+		if (!splitLines(&(content.lbuf), contents))
+		{
+			/* errors have already been logged */
+			return false;
+		}
 
-	LogicalMessageMetadata *mArray =
-		(LogicalMessageMetadata *) calloc(content.lbuf.count,
-										  sizeof(LogicalMessageMetadata));
+		log_info("Replaying changes from file \"%s\"", context->sqlFileName);
 
-	LogicalMessageMetadata *lastCommit = NULL;
+		log_debug("Read %lld lines in file \"%s\"",
+				  (long long) content.lbuf.count,
+				  content.filename);
 
-	/* parse the SQL commands metadata from the SQL file */
-	for (uint64_t i = 0; i < content.lbuf.count && !context->reachedEndPos; i++)
-	{
-		const char *sql = content.lbuf.lines[i];
-		LogicalMessageMetadata *metadata = &(mArray[i]);
+		/*
+		 * If the file contains zero lines, we're done already, Also
+		 * malloc(zero) leads to "corrupted size vs. prev_size" run-time
+		 * errors.
+		 */
+		if (content.lbuf.count == 0)
+		{
+			return true;
+		}
 
-		if (!parseSQLAction(sql, metadata, context->filters))
+		count = content.lbuf.count;
+		mArray = (LogicalMessageMetadata *) calloc(count,
+												   sizeof(LogicalMessageMetadata));
+
+		if (mArray == NULL)
 		{
-			/* errors have already been logged */
+			log_error(ALLOCATION_FAILED_ERROR);
 			return false;
 		}
 
+		/* parse the SQL commands metadata from the SQL file */
+		for (uint64_t i = 0; i < count; i++)
+		{
+			const char *sql = content.lbuf.lines[i];
+			LogicalMessageMetadata *metadata = &(mArray[i]);
+
+			if (!parseSQLAction(sql, metadata, context->filters))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+		}
+	}
+
+	LogicalMessageMetadata *lastCommit = NULL;
+
+	for (uint64_t i = 0; i < count; i++)
+	{
+		LogicalMessageMetadata *metadata = &(mArray[i]);
+
 		/*
 		 * The SWITCH WAL command should always be the last line of the file.
 		 */
 		if (metadata->action == STREAM_ACTION_SWITCH &&
-			i != (content.lbuf.count - 1))
+			i != (count - 1))
 		{
 			log_error("SWITCH command for LSN %X/%X found in \"%s\" line %lld, "
 					  "before last line %lld",
 					  LSN_FORMAT_ARGS(metadata->lsn),
 					  content.filename,
 					  (long long) i + 1,
-					  (long long) content.lbuf.count);
+					  (long long) count);
 
 			return false;
 		}
@@ -563,14 +670,47 @@ stream_apply_file(StreamApplyContext *context)
 	}
 
 	/* replay the SQL commands from the SQL file */
-	for (uint64_t i = 0; i < content.lbuf.count && !context->reachedEndPos; i++)
+	uint64_t copyScanFrom = 0;
+
+	for (uint64_t i = 0; i < count && !context->reachedEndPos; i++)
 	{
-		const char *sql = content.lbuf.lines[i];
 		LogicalMessageMetadata *metadata = &(mArray[i]);
 
+		/* binary messages only carry the statement they apply, if any */
+		const char *sql =
+			binary
+			? (metadata->stmt != NULL ? metadata->stmt : "")
+			: content.lbuf.lines[i];
+
 		/* last commit of a file requires synchronous_commit on */
 		context->reachedEOF = metadata == lastCommit;
 
+		/* long runs of INSERT statements are applied using COPY */
+		if (copyScanFrom <= i)
+		{
+			uint64_t runEnd = i;
+			bool copied = false;
+
+			if (!stream_apply_copy_run(context, mArray, count, i,
+									   &runEnd, &copied))
+			{
+				log_error("Failed to apply SQL from file \"%s\", "
+						  "see above for details",
+						  content.filename);
+
+				return false;
+			}
+
+			if (copied)
+			{
+				i = runEnd - 1;
+				continue;
+			}
+
+			/* a run that is too short is applied one message at a time */
+			copyScanFrom = runEnd;
+		}
+
 		if (!stream_apply_sql(context, metadata, sql))
 		{
 			log_error("Failed to apply SQL from file \"%s\", "
@@ -604,26 +744,29 @@ stream_apply_file(StreamApplyContext *context)
 			if (timeToSync || bufferNearFull)
 			{
 				/* fetch results until done */
-				if (!pgsql_sync_pipeline(&(context->applyPgConn)))
+				if (!stream_apply_sync_pipeline(context))
 				{
 					log_error("Failed to sync the pipeline, "
 							  "see previous error for details");
 					return false;
 				}
-
-				context->pipelineBytes = 0;
 			}
 		}
 	}
 
 	/* Always sync pipline at the end of file */
-	if (!pgsql_sync_pipeline(&(context->applyPgConn)))
+	if (!stream_apply_sync_pipeline(context))
 	{
 		log_error("Failed to sync the pipeline, see previous error for "
 				  "details");
 		return false;
 	}
-	context->pipelineBytes = 0;
+
+	if (binary)
+	{
+		(void) stream_binary_free_messages(mArray, count);
+		free(contents);
+	}
 
 	/*
 	 * Each time we are done applying a file, we update our progress and
@@ -643,6 +786,37 @@ stream_apply_file(StreamApplyContext *context)
 }
 
 
+/*
+ * stream_apply_sync_pipeline syncs the apply connection pipeline. With
+ * --apply-jobs, it also commits all the transactions that have been sent to
+ * the apply workers, so that the previousLSN has been applied on the target
+ * database when we return.
+ */
+bool
+stream_apply_sync_pipeline(StreamApplyContext *context)
+{
+	if (context->parallel != NULL)
+	{
+		if (!stream_apply_parallel_drain(context))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	if (!pgsql_sync_pipeline(&(context->applyPgConn)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	context->pipelineBytes = 0;
+	context->syncedLSN = context->previousLSN;
+
+	return true;
+}
+
+
 /*
  * stream_apply_sql connects to the target database system and applies the
  * given SQL command as prepared by the stream_transform_file or
@@ -654,6 +828,21 @@ stream_apply_sql(StreamApplyContext *context,
 				 const char *sql)
 {
 	PGSQL *applyPgConn = &(context->applyPgConn);
+	PreparedStmt **preparedStmt = &(context->preparedStmt);
+	uint64_t *pipelineBytes = &(context->pipelineBytes);
+
+	/*
+	 * With --apply-jobs, the statements of a transaction are sent to the
+	 * apply worker connection the transaction has been dispatched to.
+	 */
+	if (context->parallel != NULL && context->parallel->current != NULL)
+	{
+		ApplyWorker *worker = context->parallel->current;
+
+		applyPgConn = &(worker->pgsql);
+		preparedStmt = &(worker->preparedStmt);
+		pipelineBytes = &(worker->pipelineBytes);
+	}
 
 	switch (metadata->action)
 	{
@@ -684,10 +873,12 @@ stream_apply_sql(StreamApplyContext *context,
 			bool txnCommitLSNFound = false;
 
 			if (!readTxnCommitLSN(metadata,
-								  context->paths.dir,
+								  context->sourceDB,
 								  &txnCommitLSNFound))
 			{
-				log_error("Failed to read transaction metadata file");
+				log_error("Failed to read transaction %u COMMIT LSN, "
+						  "see above for details",
+						  metadata->xid);
 				return false;
 			}
 
@@ -756,6 +947,21 @@ stream_apply_sql(StreamApplyContext *context,
 				return true;
 			}
 
+			/*
+			 * With --apply-jobs, dispatch the transaction to an idle apply
+			 * worker connection.
+			 */
+			if (context->parallel != NULL)
+			{
+				if (!stream_apply_parallel_begin(context, metadata))
+				{
+					/* errors have already been logged */
+					return false;
+				}
+
+				applyPgConn = &(context->parallel->current->pgsql);
+			}
+
 			/*
 			 * We're all good to replay that transaction, let's BEGIN and
 			 * register our origin tracking on the target database.
@@ -813,7 +1019,7 @@ stream_apply_sql(StreamApplyContext *context,
 			}
 
 			/* Clean up prepared statements (see COMMIT for explanation) */
-			if (context->preparedStmt != NULL)
+			if (*preparedStmt != NULL)
 			{
 				if (!pgsql_execute(applyPgConn, "DEALLOCATE ALL"))
 				{
@@ -822,13 +1028,18 @@ stream_apply_sql(StreamApplyContext *context,
 
 				PreparedStmt *current, *tmp;
 
-				HASH_ITER(hh, context->preparedStmt, current, tmp)
+				HASH_ITER(hh, *preparedStmt, current, tmp)
 				{
-					HASH_DEL(context->preparedStmt, current);
+					HASH_DEL(*preparedStmt, current);
 					free(current);
 				}
 
-				context->preparedStmt = NULL;
+				*preparedStmt = NULL;
+			}
+
+			if (context->parallel != NULL)
+			{
+				(void) stream_apply_parallel_release(context);
 			}
 
 			/* Reset the transactionInProgress after abort */
@@ -847,18 +1058,21 @@ stream_apply_sql(StreamApplyContext *context,
 			if (context->continuedTxn)
 			{
 				/*
-				 * Write the transaction metadata file for continuedTxn.
-				 * This file will be used for the resumed transaction
-				 * to determine whether allow the transaction to be
-				 * replayed or not.
+				 * Register the COMMIT LSN of the continuedTxn. It is used
+				 * for the resumed transaction to determine whether to allow
+				 * the transaction to be replayed or not. The transform
+				 * process registers it too, in batches, but might not have
+				 * done so yet when streaming to a Unix PIPE.
+				 *
 				 * Without this, executing the same continuedTxn twice
 				 * will result in duplicate key errors if the table has
 				 * unique constraints.
 				 */
-				if (!writeTxnCommitMetadata(metadata, context->paths.dir))
+				if (!writeTxnCommitLSN(metadata, context->sourceDB))
 				{
-					log_error("Failed to write transaction metadata file, "
-							  "see above for details");
+					log_error("Failed to register transaction %u COMMIT LSN, "
+							  "see above for details",
+							  metadata->xid);
 					return false;
 				}
 			}
@@ -885,6 +1099,11 @@ stream_apply_sql(StreamApplyContext *context,
 						return false;
 					}
 
+					if (context->parallel != NULL)
+					{
+						(void) stream_apply_parallel_release(context);
+					}
+
 					/* Reset the transactionInProgress after abort */
 					context->transactionInProgress = false;
 					context->continuedTxn = false;
@@ -893,6 +1112,34 @@ stream_apply_sql(StreamApplyContext *context,
 				return true;
 			}
 
+			/*
+			 * With --apply-jobs, the COMMIT is sent later, in the source
+			 * commit order, see stream_apply_parallel_commit().
+			 */
+			if (context->parallel != NULL)
+			{
+				if (!stream_apply_parallel_commit(context, metadata))
+				{
+					/* errors have already been logged */
+					return false;
+				}
+
+				context->transactionInProgress = false;
+				context->previousLSN = metadata->lsn;
+
+				if (context->endpos != InvalidXLogRecPtr &&
+					context->endpos <= context->previousLSN)
+				{
+					context->reachedEndPos = true;
+
+					log_notice("Apply reached end position %X/%X at COMMIT %X/%X",
+							   LSN_FORMAT_ARGS(context->endpos),
+							   LSN_FORMAT_ARGS(context->previousLSN));
+				}
+
+				return true;
+			}
+
 			/*
 			 * update replication progress with metadata->lsn, that is,
 			 * transaction COMMIT LSN
@@ -933,7 +1180,7 @@ stream_apply_sql(StreamApplyContext *context,
 			 * its hash collides with a previously prepared statement
 			 * that has a different parameter count.
 			 */
-			if (context->preparedStmt != NULL)
+			if (*preparedStmt != NULL)
 			{
 				if (!pgsql_execute(applyPgConn, "DEALLOCATE ALL"))
 				{
@@ -942,13 +1189,13 @@ stream_apply_sql(StreamApplyContext *context,
 
 				PreparedStmt *current, *tmp;
 
-				HASH_ITER(hh, context->preparedStmt, current, tmp)
+				HASH_ITER(hh, *preparedStmt, current, tmp)
 				{
-					HASH_DEL(context->preparedStmt, current);
+					HASH_DEL(*preparedStmt, current);
 					free(current);
 				}
 
-				context->preparedStmt = NULL;
+				*preparedStmt = NULL;
 			}
 
 			context->transactionInProgress = false;
@@ -1007,6 +1254,11 @@ stream_apply_sql(StreamApplyContext *context,
 						return false;
 					}
 
+					if (context->parallel != NULL)
+					{
+						(void) stream_apply_parallel_release(context);
+					}
+
 					context->transactionInProgress = false;
 				}
 
@@ -1080,6 +1332,20 @@ stream_apply_sql(StreamApplyContext *context,
 				return true;
 			}
 
+			/*
+			 * With --apply-jobs, the transactions that have been sent to the
+			 * apply workers must be committed before we advance our main
+			 * replication origin.
+			 */
+			if (context->parallel != NULL)
+			{
+				if (!stream_apply_parallel_drain(context))
+				{
+					/* errors have already been logged */
+					return false;
+				}
+			}
+
 			if (!pgsql_begin(applyPgConn))
 			{
 				/* errors have already been logged */
@@ -1162,62 +1428,13 @@ stream_apply_sql(StreamApplyContext *context,
 				return true;
 			}
 
-			uint32_t hash = metadata->hash;
-			PreparedStmt *stmtHashTable = context->preparedStmt;
 			PreparedStmt *stmt = NULL;
 
-			HASH_FIND(hh, stmtHashTable, &hash, sizeof(hash), stmt);
-
-			if (stmt == NULL)
-			{
-				/* Add to hash table even if filtered, so EXECUTE can find it */
-				stmt = (PreparedStmt *) calloc(1, sizeof(PreparedStmt));
-				stmt->hash = hash;
-				stmt->filterOut = metadata->filterOut;
-				stmt->prepared = false;
-
-				/* Extract and store schema.table name for logging and tracking */
-				char nspname[PG_NAMEDATALEN] = { 0 };
-				char relname[PG_NAMEDATALEN] = { 0 };
-
-				if (extractTableNameFromPrepare(metadata->stmt,
-												nspname, sizeof(nspname),
-												relname, sizeof(relname)))
-				{
-					strlcpy(stmt->nspname, nspname, sizeof(stmt->nspname));
-					strlcpy(stmt->relname, relname, sizeof(stmt->relname));
-				}
-
-				HASH_ADD(hh, stmtHashTable, hash, sizeof(hash), stmt);
-
-				/* HASH_ADD can change the pointer in place, update */
-				context->preparedStmt = stmtHashTable;
-			}
-
-			/* Skip filtered statements - don't prepare or execute them */
-			if (stmt != NULL && stmt->filterOut)
-			{
-				log_trace("Skipping filtered %s statement",
-						  metadata->action == STREAM_ACTION_INSERT ? "INSERT" :
-						  metadata->action == STREAM_ACTION_UPDATE ? "UPDATE" :
-						  "DELETE");
-				return true;
-			}
-
-			/* Only prepare if we haven't already */
-			if (stmt != NULL && !stmt->prepared)
+			if (!stream_apply_prepare(context, metadata,
+									  applyPgConn, preparedStmt, &stmt))
 			{
-				/* Prepare the statement for later execution */
-				char name[NAMEDATALEN] = { 0 };
-				sformat(name, sizeof(name), "%x", metadata->hash);
-
-				if (!pgsql_prepare(applyPgConn, name, metadata->stmt, 0, NULL))
-				{
-					/* errors have already been logged */
-					return false;
-				}
-
-				stmt->prepared = true;
+				/* errors have already been logged */
+				return false;
 			}
 
 			break;
@@ -1235,10 +1452,26 @@ stream_apply_sql(StreamApplyContext *context,
 			}
 
 			uint32_t hash = metadata->hash;
-			PreparedStmt *stmtHashTable = context->preparedStmt;
+			PreparedStmt *stmtHashTable = *preparedStmt;
 			PreparedStmt *stmt = NULL;
 
-			HASH_FIND(hh, stmtHashTable, &hash, sizeof(hash), stmt);
+			/*
+			 * The binary format does not have PREPARE messages, each EXECUTE
+			 * message carries its statement instead.
+			 */
+			if (metadata->stmt != NULL)
+			{
+				if (!stream_apply_prepare(context, metadata,
+										  applyPgConn, preparedStmt, &stmt))
+				{
+					/* errors have already been logged */
+					return false;
+				}
+			}
+			else
+			{
+				HASH_FIND(hh, stmtHashTable, &hash, sizeof(hash), stmt);
+			}
 
 			if (stmt == NULL)
 			{
@@ -1257,36 +1490,28 @@ stream_apply_sql(StreamApplyContext *context,
 			char name[NAMEDATALEN] = { 0 };
 			sformat(name, sizeof(name), "%x", metadata->hash);
 
-			JSON_Value *js = json_parse_string(metadata->jsonBuffer);
+			int count = 0;
+			const char **paramValues = NULL;
 
-			if (json_value_get_type(js) != JSONArray)
+			if (!stream_apply_get_params(metadata, &count, &paramValues))
 			{
-				log_error("Failed to parse EXECUTE array: %s",
-						  metadata->jsonBuffer);
+				/* errors have already been logged */
 				return false;
 			}
 
-			JSON_Array *jsArray = json_value_get_array(js);
-
-			int count = json_array_get_count(jsArray);
-
-			if (0 < count)
+			/* a statement without parameters is executed all the same */
+			if (count == 0)
 			{
-				const char **paramValues =
-					(const char **) calloc(count, sizeof(char *));
-
-				if (paramValues == NULL)
+				if (!pgsql_execute_prepared(applyPgConn, name,
+											0, NULL,
+											NULL, NULL))
 				{
-					log_error(ALLOCATION_FAILED_ERROR);
+					/* errors have already been logged */
 					return false;
 				}
-
-				for (int i = 0; i < count; i++)
-				{
-					const char *value = json_array_get_string(jsArray, i);
-					paramValues[i] = value;
-				}
-
+			}
+			else
+			{
 				if (!pgsql_execute_prepared(applyPgConn, name,
 											count, paramValues,
 											NULL, NULL))
@@ -1304,7 +1529,7 @@ stream_apply_sql(StreamApplyContext *context,
 				{
 					if (paramValues[j] != NULL)
 					{
-						context->pipelineBytes += strlen(paramValues[j]);
+						*pipelineBytes += strlen(paramValues[j]);
 					}
 				}
 
@@ -1317,7 +1542,7 @@ stream_apply_sql(StreamApplyContext *context,
 				 * sync only flushes pending results without affecting
 				 * the transaction.
 				 */
-				if (context->pipelineBytes >= PIPELINE_BYTES_SYNC_THRESHOLD)
+				if (*pipelineBytes >= PIPELINE_BYTES_SYNC_THRESHOLD)
 				{
 					if (!pgsql_sync_pipeline(applyPgConn))
 					{
@@ -1326,7 +1551,7 @@ stream_apply_sql(StreamApplyContext *context,
 						return false;
 					}
 
-					context->pipelineBytes = 0;
+					*pipelineBytes = 0;
 				}
 			}
 
@@ -1352,6 +1577,20 @@ stream_apply_sql(StreamApplyContext *context,
 				return true;
 			}
 
+			/*
+			 * With --apply-jobs, a TRUNCATE waits until all the previous
+			 * transactions have been committed, and the next transactions
+			 * wait until this one has been committed.
+			 */
+			if (context->parallel != NULL)
+			{
+				if (!stream_apply_parallel_barrier(context))
+				{
+					/* errors have already been logged */
+					return false;
+				}
+			}
+
 			/* chomp the final semi-colon that we added */
 			int len = strlen(sql);
 
@@ -1384,46 +1623,485 @@ stream_apply_sql(StreamApplyContext *context,
 
 
 /*
- * setupConnection sets up a connection to the target database.
+ * stream_apply_get_params returns the parameter values of an EXECUTE message,
+ * either from the binary format where they have been parsed already, or from
+ * the JSON array of the SQL format.
  */
 static bool
-setupConnection(PGSQL *pgsql, StreamApplyContext *context)
+stream_apply_get_params(LogicalMessageMetadata *metadata,
+						int *count,
+						const char ***paramValues)
 {
-	if (!pgsql_init(pgsql,
-					context->connStrings->target_pguri,
-					PGSQL_CONN_TARGET))
+	/* the binary format provides the parameters values already, if any */
+	if (metadata->binaryParams)
 	{
-		/* errors have already been logged */
+		*count = metadata->paramCount;
+		*paramValues = metadata->paramValues;
+
+		return true;
+	}
+
+	JSON_Value *js = json_parse_string(metadata->jsonBuffer);
+
+	if (json_value_get_type(js) != JSONArray)
+	{
+		log_error("Failed to parse EXECUTE array: %s", metadata->jsonBuffer);
 		return false;
 	}
 
-	/* we're going to send several replication origin commands */
-	pgsql->connectionStatementType = PGSQL_CONNECTION_MULTI_STATEMENT;
+	JSON_Array *jsArray = json_value_get_array(js);
 
-	/* we also might want to skip logging any SQL query that we apply */
-	pgsql->logSQL = context->logSQL;
+	*count = json_array_get_count(jsArray);
+	*paramValues = NULL;
 
-	/*
-	 * Grab the Postgres server version on the target, we need to know that for
-	 * being able to call pgsql_current_wal_insert_lsn using the right Postgres
-	 * function name.
-	 */
-	if (!pgsql_server_version(pgsql))
+	if (*count == 0)
 	{
-		/* errors have already been logged */
+		return true;
+	}
+
+	const char **values = (const char **) calloc(*count, sizeof(char *));
+
+	if (values == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
 		return false;
 	}
 
+	for (int i = 0; i < *count; i++)
+	{
+		values[i] = json_array_get_string(jsArray, i);
+	}
+
+	*paramValues = values;
+
 	return true;
 }
 
 
 /*
- * setupReplicationOrigin ensures that a replication origin has been created on
- * the target database, and if it has been created previously then fetches the
- * previous LSN position it was at.
+ * stream_apply_copy_run applies the run of INSERT statements that begins at
+ * the given message using COPY, when the run adds enough rows to the same
+ * table. The index of the first message after the run is set in *end, and
+ * *copied is set to false when the messages must be applied one at a time.
  *
- * Also setupReplicationOrigin calls pg_replication_origin_setup() in the
+ * COPY is not allowed in pipeline mode: the pipeline is synced and left
+ * while the COPY runs, within the current transaction.
+ */
+static bool
+stream_apply_copy_run(StreamApplyContext *context,
+					  LogicalMessageMetadata *mArray,
+					  uint64_t count,
+					  uint64_t start,
+					  uint64_t *end,
+					  bool *copied)
+{
+	*end = start;
+	*copied = false;
+
+	/* skipped transactions are handled by stream_apply_sql */
+	if (!context->reachedStartPos && !context->continuedTxn)
+	{
+		return true;
+	}
+
+	StreamApplyCopyRun run = { 0 };
+
+	if (!stream_apply_copy_scan(mArray, count, start, &run))
+	{
+		return true;
+	}
+
+	if (run.rows < STREAM_APPLY_COPY_MIN_ROWS)
+	{
+		*end = run.end;
+		return true;
+	}
+
+	PGSQL *pgsql = &(context->applyPgConn);
+	uint64_t *pipelineBytes = &(context->pipelineBytes);
+
+	if (context->parallel != NULL && context->parallel->current != NULL)
+	{
+		ApplyWorker *worker = context->parallel->current;
+
+		pgsql = &(worker->pgsql);
+		pipelineBytes = &(worker->pipelineBytes);
+	}
+
+	/* skip "INSERT INTO " to get the qname and columns list */
+	size_t insertLen = strlen("INSERT INTO ");
+	PQExpBuffer target = createPQExpBuffer();
+
+	appendBinaryPQExpBuffer(target,
+							run.stmt + insertLen,
+							run.targetLen - insertLen);
+
+	if (PQExpBufferBroken(target))
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		destroyPQExpBuffer(target);
+		return false;
+	}
+
+	/*
+	 * With --apply-jobs, wait until the transactions that touched the same
+	 * table have been committed.
+	 */
+	if (context->parallel != NULL)
+	{
+		char nspname[PG_NAMEDATALEN] = { 0 };
+		char relname[PG_NAMEDATALEN] = { 0 };
+
+		if (!extractTableNameFromPrepare(run.stmt,
+										 nspname, sizeof(nspname),
+										 relname, sizeof(relname)) ||
+			!stream_apply_parallel_track_table(context, nspname, relname))
+		{
+			log_error("Failed to track table for COPY %s", target->data);
+			destroyPQExpBuffer(target);
+			return false;
+		}
+	}
+
+	log_debug("Applying %lld rows with COPY %s",
+			  (long long) run.rows,
+			  target->data);
+
+	if (!pgsql_sync_pipeline(pgsql) ||
+		!pgsql_disable_pipeline_mode(pgsql))
+	{
+		/* errors have already been logged */
+		destroyPQExpBuffer(target);
+		return false;
+	}
+
+	*pipelineBytes = 0;
+
+	if (!pg_copy_from_stdin(pgsql, target->data))
+	{
+		/* errors have already been logged */
+		destroyPQExpBuffer(target);
+		return false;
+	}
+
+	destroyPQExpBuffer(target);
+
+	for (uint64_t i = start; i < run.end; i++)
+	{
+		LogicalMessageMetadata *metadata = &(mArray[i]);
+
+		/* skip the PREPARE messages of the SQL format */
+		if (metadata->action != STREAM_ACTION_EXECUTE)
+		{
+			continue;
+		}
+
+		int paramCount = 0;
+		const char **paramValues = NULL;
+
+		if (!stream_apply_get_params(metadata, &paramCount, &paramValues))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (paramCount % run.cols != 0)
+		{
+			log_error("BUG: EXECUTE %x has %d parameters, "
+					  "expected a multiple of %d",
+					  metadata->hash,
+					  paramCount,
+					  run.cols);
+			return false;
+		}
+
+		for (int p = 0; p < paramCount; p += run.cols)
+		{
+			if (!pg_copy_values_from_stdin(pgsql, run.cols, paramValues + p))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+		}
+	}
+
+	if (!pg_copy_end(pgsql) ||
+		!pgsql_enable_pipeline_mode(pgsql))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	*end = run.end;
+	*copied = true;
+
+	return true;
+}
+
+
+/*
+ * stream_apply_copy_scan finds the run of INSERT statements into the same
+ * table and columns that begins at the given message. In the SQL format each
+ * EXECUTE message follows the PREPARE message of its statement, in the binary
+ * format the EXECUTE messages carry their statement.
+ *
+ * Returns false when the message at start does not begin such a run.
+ */
+static bool
+stream_apply_copy_scan(LogicalMessageMetadata *mArray,
+					   uint64_t count,
+					   uint64_t start,
+					   StreamApplyCopyRun *run)
+{
+	const char *prepared = NULL;
+	uint32_t preparedHash = 0;
+
+	for (uint64_t i = start; i < count; i++)
+	{
+		LogicalMessageMetadata *metadata = &(mArray[i]);
+		const char *stmt = NULL;
+
+		if (metadata->action == STREAM_ACTION_INSERT)
+		{
+			stmt = metadata->stmt;
+		}
+		else if (metadata->action == STREAM_ACTION_EXECUTE)
+		{
+			stmt = metadata->stmt;
+
+			if (stmt == NULL && prepared != NULL &&
+				preparedHash == metadata->hash)
+			{
+				stmt = prepared;
+			}
+		}
+
+		/* filtered-out statements are skipped by stream_apply_sql */
+		if (stmt == NULL || metadata->filterOut)
+		{
+			break;
+		}
+
+		int targetLen = 0;
+		int rows = 0;
+		int cols = 0;
+
+		if (!stream_apply_copy_parse_insert(stmt, &targetLen, &rows, &cols))
+		{
+			break;
+		}
+
+		if (run->stmt == NULL)
+		{
+			run->stmt = stmt;
+			run->targetLen = targetLen;
+			run->cols = cols;
+		}
+		else if (targetLen != run->targetLen ||
+				 cols != run->cols ||
+				 strncmp(stmt, run->stmt, targetLen) != 0)
+		{
+			break;
+		}
+
+		if (metadata->action == STREAM_ACTION_INSERT)
+		{
+			prepared = stmt;
+			preparedHash = metadata->hash;
+		}
+		else
+		{
+			run->rows += rows;
+			run->end = i + 1;
+		}
+	}
+
+	return run->end > start;
+}
+
+
+/*
+ * stream_apply_copy_parse_insert parses an INSERT statement as written by the
+ * transform process: INSERT INTO qname (columns) overriding system value
+ * VALUES ($1, $2), ($3, $4). The VALUES clause only contains parameters, so
+ * we count its rows and parameters.
+ */
+static bool
+stream_apply_copy_parse_insert(const char *stmt,
+							   int *targetLen,
+							   int *rows,
+							   int *cols)
+{
+	if (strncmp(stmt, "INSERT INTO ", strlen("INSERT INTO ")) != 0)
+	{
+		return false;
+	}
+
+	const char *values = strstr(stmt, INSERT_VALUES);
+
+	if (values == NULL)
+	{
+		return false;
+	}
+
+	int params = 0;
+
+	*rows = 0;
+
+	for (const char *ptr = values + strlen(INSERT_VALUES); *ptr != '\0'; ptr++)
+	{
+		if (*ptr == '(')
+		{
+			++(*rows);
+		}
+		else if (*ptr == '$')
+		{
+			++params;
+		}
+	}
+
+	if (*rows == 0 || params == 0 || params % *rows != 0)
+	{
+		return false;
+	}
+
+	*targetLen = values - stmt;
+	*cols = params / *rows;
+
+	return true;
+}
+
+
+/*
+ * stream_apply_prepare registers the statement of an INSERT, UPDATE, or DELETE
+ * message in our hash table, and prepares it on the given connection unless
+ * it's been filtered out.
+ */
+static bool
+stream_apply_prepare(StreamApplyContext *context,
+					 LogicalMessageMetadata *metadata,
+					 PGSQL *applyPgConn,
+					 PreparedStmt **preparedStmt,
+					 PreparedStmt **result)
+{
+	uint32_t hash = metadata->hash;
+	PreparedStmt *stmtHashTable = *preparedStmt;
+	PreparedStmt *stmt = NULL;
+
+	HASH_FIND(hh, stmtHashTable, &hash, sizeof(hash), stmt);
+
+	if (stmt == NULL)
+	{
+		/* Add to hash table even if filtered, so EXECUTE can find it */
+		stmt = (PreparedStmt *) calloc(1, sizeof(PreparedStmt));
+		stmt->hash = hash;
+		stmt->filterOut = metadata->filterOut;
+		stmt->prepared = false;
+
+		/* Extract and store schema.table name for logging and tracking */
+		char nspname[PG_NAMEDATALEN] = { 0 };
+		char relname[PG_NAMEDATALEN] = { 0 };
+
+		if (extractTableNameFromPrepare(metadata->stmt,
+										nspname, sizeof(nspname),
+										relname, sizeof(relname)))
+		{
+			strlcpy(stmt->nspname, nspname, sizeof(stmt->nspname));
+			strlcpy(stmt->relname, relname, sizeof(stmt->relname));
+		}
+
+		HASH_ADD(hh, stmtHashTable, hash, sizeof(hash), stmt);
+
+		/* HASH_ADD can change the pointer in place, update */
+		*preparedStmt = stmtHashTable;
+	}
+
+	*result = stmt;
+
+	/* Skip filtered statements - don't prepare or execute them */
+	if (stmt != NULL && stmt->filterOut)
+	{
+		log_trace("Skipping filtered statement for %s.%s",
+				  stmt->nspname, stmt->relname);
+		return true;
+	}
+
+	/*
+	 * With --apply-jobs, wait until the transactions that touched
+	 * the same table have been committed.
+	 */
+	if (context->parallel != NULL)
+	{
+		if (!stream_apply_parallel_track_table(context,
+											   stmt->nspname,
+											   stmt->relname))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	/* Only prepare if we haven't already */
+	if (stmt != NULL && !stmt->prepared)
+	{
+		/* Prepare the statement for later execution */
+		char name[NAMEDATALEN] = { 0 };
+		sformat(name, sizeof(name), "%x", metadata->hash);
+
+		if (!pgsql_prepare(applyPgConn, name, metadata->stmt, 0, NULL))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		stmt->prepared = true;
+	}
+
+	return true;
+}
+
+
+/*
+ * setupConnection sets up a connection to the target database.
+ */
+bool
+setupConnection(PGSQL *pgsql, StreamApplyContext *context)
+{
+	if (!pgsql_init(pgsql,
+					context->connStrings->target_pguri,
+					PGSQL_CONN_TARGET))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* we're going to send several replication origin commands */
+	pgsql->connectionStatementType = PGSQL_CONNECTION_MULTI_STATEMENT;
+
+	/* we also might want to skip logging any SQL query that we apply */
+	pgsql->logSQL = context->logSQL;
+
+	/*
+	 * Grab the Postgres server version on the target, we need to know that for
+	 * being able to call pgsql_current_wal_insert_lsn using the right Postgres
+	 * function name.
+	 */
+	if (!pgsql_server_version(pgsql))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * setupReplicationOrigin ensures that a replication origin has been created on
+ * the target database, and if it has been created previously then fetches the
+ * previous LSN position it was at.
+ *
+ * Also setupReplicationOrigin calls pg_replication_origin_setup() in the
  * current connection.
  */
 bool
@@ -1481,7 +2159,19 @@ setupReplicationOrigin(StreamApplyContext *context)
 	 */
 	uint64_t originLSN = InvalidXLogRecPtr;
 
-	if (!pgsql_replication_origin_progress(applyPgConn, nodeName, true, &originLSN))
+	/*
+	 * A previous run might have used --apply-jobs, in which case the apply
+	 * workers replication origins might be ahead of our main one.
+	 */
+	char prefix[BUFSIZE] = { 0 };
+
+	sformat(prefix, sizeof(prefix), "%s%s", nodeName, APPLY_WORKER_ORIGIN_SUFFIX);
+
+	if (!pgsql_replication_origin_max_progress(applyPgConn,
+											   nodeName,
+											   prefix,
+											   true,
+											   &originLSN))
 	{
 		/* errors have already been logged */
 		return false;
@@ -1545,6 +2235,17 @@ setupReplicationOrigin(StreamApplyContext *context)
 		return false;
 	}
 
+	if (context->applyJobs > 1)
+	{
+		if (!stream_apply_parallel_setup(context))
+		{
+			log_error("Failed to setup %d apply workers, "
+					  "see above for details",
+					  context->applyJobs);
+			return false;
+		}
+	}
+
 	return true;
 }
 
@@ -1893,6 +2594,34 @@ shouldFilterOutTable(const char *nspname, const char *relname,
 }
 
 
+/*
+ * shouldFilterOutStatement checks if the table that the given INSERT, UPDATE,
+ * or DELETE statement targets should be filtered out.
+ */
+bool
+shouldFilterOutStatement(const char *stmt, SourceFilters *filters)
+{
+	char nspname[PG_NAMEDATALEN] = { 0 };
+	char relname[PG_NAMEDATALEN] = { 0 };
+
+	if (!extractTableNameFromPrepare(stmt,
+									 nspname, sizeof(nspname),
+									 relname, sizeof(relname)))
+	{
+		return false;
+	}
+
+	if (shouldFilterOutTable(nspname, relname, filters))
+	{
+		log_debug("Filtering out statement for table \"%s\".\"%s\"",
+				  nspname, relname);
+		return true;
+	}
+
+	return false;
+}
+
+
 /*
  * parseSQLAction returns the action that is implemented in the given SQL
  * query.
@@ -2140,23 +2869,8 @@ parseSQLAction(const char *query, LogicalMessageMetadata *metadata,
 		/* Extract table name and check filters for DML operations */
 		if (metadata->stmt != NULL)
 		{
-			char nspname[PG_NAMEDATALEN] = { 0 };
-			char relname[PG_NAMEDATALEN] = { 0 };
-
-			if (extractTableNameFromPrepare(metadata->stmt,
-											nspname, sizeof(nspname),
-											relname, sizeof(relname)))
-			{
-				if (shouldFilterOutTable(nspname, relname, filters))
-				{
-					metadata->filterOut = true;
-					log_debug("Filtering out %s for table \"%s\".\"%s\"",
-							  metadata->action == STREAM_ACTION_INSERT ? "INSERT" :
-							  metadata->action == STREAM_ACTION_UPDATE ? "UPDATE" :
-							  "DELETE",
-							  nspname, relname);
-				}
-			}
+			metadata->filterOut =
+				shouldFilterOutStatement(metadata->stmt, filters);
 		}
 	}
 	else if (strncmp(query, EXECUTE, eLen) == 0)
@@ -2223,10 +2937,22 @@ stream_apply_find_durable_lsn(StreamApplyContext *context, uint64_t *durableLSN)
 
 	bool flush = true;
 
-	if (!pgsql_replication_origin_progress(&(context->controlPgConn),
-										   context->origin,
-										   flush,
-										   &flushLSN))
+	/*
+	 * With --apply-jobs, transactions are committed in the source commit
+	 * order and each apply worker has its own replication origin, so the
+	 * most advanced origin is the durable position.
+	 */
+	char prefix[BUFSIZE] = { 0 };
+
+	sformat(prefix, sizeof(prefix), "%s%s",
+			context->origin,
+			APPLY_WORKER_ORIGIN_SUFFIX);
+
+	if (!pgsql_replication_origin_max_progress(&(context->controlPgConn),
+											   context->origin,
+											   prefix,
+											   flush,
+											   &flushLSN))
 	{
 		/* errors have already been logged */
 		log_error("Failed to retrieve origin progress, "
@@ -2242,97 +2968,45 @@ stream_apply_find_durable_lsn(StreamApplyContext *context, uint64_t *durableLSN)
 
 /*
  * readTxnCommitLSN ensures metadata has transaction COMMIT LSN by fetching it
- * from metadata file if it is not present
+ * from our catalogs if it is not present
  */
 static bool
 readTxnCommitLSN(LogicalMessageMetadata *metadata,
-				 const char *dir,
+				 DatabaseCatalog *sourceDB,
 				 bool *txnCommitLSNFound)
 {
-	/* if txnCommitLSN is invalid, then fetch it from txn metadata file */
+	/* if txnCommitLSN is invalid, then fetch it from our catalogs */
 	if (metadata->txnCommitLSN != InvalidXLogRecPtr)
 	{
 		*txnCommitLSNFound = true;
 		return true;
 	}
 
-	char txnfilename[MAXPGPATH] = { 0 };
-
-	if (!computeTxnMetadataFilename(metadata->xid,
-									dir,
-									txnfilename))
-	{
-		/* errors have already been logged */
-		return false;
-	}
-
-	if (!file_exists(txnfilename))
+	if (sourceDB == NULL || sourceDB->db == NULL)
 	{
 		*txnCommitLSNFound = false;
 		return true;
 	}
 
-	log_debug("stream_apply_sql: BEGIN message without a commit LSN, "
-			  "fetching commit LSN from transaction metadata file \"%s\"",
-			  txnfilename);
-
-	LogicalMessageMetadata txnMetadata = { .xid = metadata->xid };
-
-	if (!parseTxnMetadataFile(txnfilename, &txnMetadata))
-	{
-		/* errors have already been logged */
-		return false;
-	}
-
-	*txnCommitLSNFound = true;
-	metadata->txnCommitLSN = txnMetadata.txnCommitLSN;
-
-	return true;
-}
-
-
-/*
- * parseTxnMetadataFile returns the transaction metadata content for the given
- * metadata filename.
- */
-static bool
-parseTxnMetadataFile(const char *filename, LogicalMessageMetadata *metadata)
-{
-	/* store xid as it will be overwritten while parsing metadata */
-	uint32_t xid = metadata->xid;
-
-	if (xid == 0)
-	{
-		log_error("BUG: parseTxnMetadataFile is called with "
-				  "transaction xid: %lld", (long long) xid);
-		return false;
-	}
-
-	char *txnMetadataContent = NULL;
-	long size = 0L;
+	uint64_t commitLSN = InvalidXLogRecPtr;
 
-	if (!read_file(filename, &txnMetadataContent, &size))
+	if (!sentinel_lookup_txn_commit_lsn(sourceDB,
+										metadata->xid,
+										&commitLSN,
+										txnCommitLSNFound))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
-	JSON_Value *json = json_parse_string(txnMetadataContent);
-
-	if (!parseMessageMetadata(metadata, txnMetadataContent, json, true))
+	if (*txnCommitLSNFound)
 	{
-		/* errors have already been logged */
-		return false;
-	}
-
+		log_debug("stream_apply_sql: BEGIN message without a commit LSN, "
+				  "found commit LSN %X/%X for transaction %u",
+				  LSN_FORMAT_ARGS(commitLSN),
+				  metadata->xid);
 
-	if (metadata->txnCommitLSN == InvalidXLogRecPtr ||
-		metadata->xid != xid ||
-		IS_EMPTY_STRING_BUFFER(metadata->timestamp))
-	{
-		log_error("Failed to parse metadata for transaction metadata file "
-				  "\"%s\": %s", filename, txnMetadataContent);
-		return false;
+		metadata->txnCommitLSN = commitLSN;
 	}
 
 	return true;
@@ -2340,73 +3014,32 @@ parseTxnMetadataFile(const char *filename, LogicalMessageMetadata *metadata)
 
 
 /*
- *  computeTxnMetadataFilename computes the file path for transaction metadata
- *  based on its transaction id
+ * writeTxnCommitLSN registers the COMMIT LSN of the given transaction in our
+ * catalogs.
  */
 static bool
-computeTxnMetadataFilename(uint32_t xid, const char *dir, char *filename)
+writeTxnCommitLSN(LogicalMessageMetadata *metadata, DatabaseCatalog *sourceDB)
 {
-	if (dir == NULL)
+	if (metadata->action != STREAM_ACTION_COMMIT)
 	{
-		log_error("BUG: computeTxnMetadataFilename is called with "
-				  "directory: NULL");
+		log_error("BUG: writeTxnCommitLSN is called with "
+				  "action: %s", StreamActionToString(metadata->action));
 		return false;
 	}
 
-	if (xid == 0)
+	if (sourceDB == NULL || sourceDB->db == NULL)
 	{
-		log_error("BUG: computeTxnMetadataFilename is called with "
-				  "transaction xid: %lld", (long long) xid);
-		return false;
-	}
-
-	sformat(filename, MAXPGPATH, "%s/%lld.json", dir, (long long) xid);
-
-	return true;
-}
-
-
-/*
- * writeTxnCommitMetadata writes the transaction metadata to a file in the given
- * directory
- */
-static bool
-writeTxnCommitMetadata(LogicalMessageMetadata *mesg, const char *dir)
-{
-	char txnfilename[MAXPGPATH] = { 0 };
-
-	if (mesg->action != STREAM_ACTION_COMMIT)
-	{
-		log_error("BUG: writeTxnCommitMetadata is called with "
-				  "action: %s", StreamActionToString(mesg->action));
-		return false;
-	}
-
-	if (!computeTxnMetadataFilename(mesg->xid, dir, txnfilename))
-	{
-		/* errors have already been logged */
-		return false;
+		return true;
 	}
 
-	log_debug("stream_write_commit_metadata_file: writing transaction "
-			  "metadata file \"%s\" with commit lsn %X/%X",
-			  txnfilename,
-			  LSN_FORMAT_ARGS(mesg->lsn));
-
-	char contents[BUFSIZE] = { 0 };
+	TxnCommitLSNBatch batch = {
+		.count = 1,
+		.array = { { .xid = metadata->xid, .commitLSN = metadata->lsn } }
+	};
 
-	sformat(contents, BUFSIZE,
-			"{\"xid\":%lld,\"commit_lsn\":\"%X/%X\",\"timestamp\":\"%s\"}\n",
-			(long long) mesg->xid,
-			LSN_FORMAT_ARGS(mesg->lsn),
-			mesg->timestamp);
+	log_debug("writeTxnCommitLSN: transaction %u commit lsn %X/%X",
+			  metadata->xid,
+			  LSN_FORMAT_ARGS(metadata->lsn));
 
-	/* write the metadata to txnfilename */
-	if (!write_file(contents, strlen(contents), txnfilename))
-	{
-		log_error("Failed to write file \"%s\"", txnfilename);
-		return false;
-	}
-
-	return true;
+	return sentinel_add_txn_commit_lsn_batch(sourceDB, &batch);
 }
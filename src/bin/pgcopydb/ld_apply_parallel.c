@@ -0,0 +1,818 @@
+/*
+ * src/bin/pgcopydb/ld_apply_parallel.c
+ *     Apply changes to the target database using several connections
+ *
+ * With --apply-jobs N, the apply process dispatches each transaction it reads
+ * to one of N apply worker connections to the target database, so that the
+ * target database executes several transactions concurrently.
+ *
+ * The transactions are still committed in the source commit order: when a
+ * COMMIT message is read, the transaction is only marked ready, and its
+ * COMMIT is sent later, after the COMMIT of all the previous transactions has
+ * been acknowledged. This way the set of committed transactions on the target
+ * database is always the same as with a single connection, and the most
+ * advanced replication origin is our exact progress.
+ *
+ * Each apply worker uses its own replication origin "<origin>_apply_<n>",
+ * because a replication origin can only be used by one session at a time.
+ *
+ * Conflicts are tracked at the table level: a transaction that touches a
+ * table which has been touched by a transaction that is not committed yet
+ * first waits until that transaction has been committed. Tables that are
+ * linked by a foreign key on the target database are tracked as a single
+ * table, so that a row is never inserted before the row it references has
+ * been committed. A TRUNCATE is a barrier: all previous transactions are
+ * committed first, and the next transactions wait until the TRUNCATE
+ * transaction has been committed.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include "postgres.h"
+#include "postgres_fe.h"
+#include "access/xlogdefs.h"
+
+#include "copydb.h"
+#include "ld_stream.h"
+#include "log.h"
+#include "pg_utils.h"
+#include "pgsql.h"
+#include "string_utils.h"
+
+
+static ApplyWorker * stream_apply_parallel_idle_worker(StreamApplyParallel *parallel);
+static ApplyWorker * stream_apply_parallel_next_ready(StreamApplyParallel *parallel);
+
+static bool stream_apply_parallel_commit_until(StreamApplyParallel *parallel,
+											   uint64_t seq);
+
+static bool stream_apply_parallel_commit_worker(StreamApplyParallel *parallel,
+												ApplyWorker *worker);
+
+static bool stream_apply_parallel_fetch_fkeys(StreamApplyParallel *parallel,
+											  PGSQL *pgsql);
+
+static ApplyTableGroup * stream_apply_parallel_find_group(StreamApplyParallel *parallel,
+														  const char *qname,
+														  bool create);
+
+
+/*
+ * stream_apply_parallel_setup opens the apply worker connections to the
+ * target database, each with its own replication origin session, and in
+ * pipeline mode.
+ */
+bool
+stream_apply_parallel_setup(StreamApplyContext *context)
+{
+	StreamApplyParallel *parallel =
+		(StreamApplyParallel *) calloc(1, sizeof(StreamApplyParallel));
+
+	if (parallel == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	parallel->count = context->applyJobs;
+	parallel->workers =
+		(ApplyWorker *) calloc(parallel->count, sizeof(ApplyWorker));
+
+	if (parallel->workers == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		free(parallel);
+		return false;
+	}
+
+	/* make sure stream_apply_cleanup() closes our connections */
+	context->parallel = parallel;
+
+	for (int i = 0; i < parallel->count; i++)
+	{
+		ApplyWorker *worker = &(parallel->workers[i]);
+
+		worker->id = i + 1;
+
+		sformat(worker->origin, sizeof(worker->origin), "%s%s%d",
+				context->origin,
+				APPLY_WORKER_ORIGIN_SUFFIX,
+				worker->id);
+
+		PGSQL *pgsql = &(worker->pgsql);
+
+		if (!setupConnection(pgsql, context))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		uint32_t oid = 0;
+
+		if (!pgsql_replication_origin_oid(pgsql, worker->origin, &oid))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (oid == 0)
+		{
+			if (!pgsql_replication_origin_create(pgsql, worker->origin))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+
+			log_notice("Created logical replication origin \"%s\"",
+					   worker->origin);
+		}
+
+		/* fetch the foreign keys before entering pipeline mode */
+		if (i == 0 && !stream_apply_parallel_fetch_fkeys(parallel, pgsql))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (!pgsql_replication_origin_session_setup(pgsql, worker->origin))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (!pgsql_enable_pipeline_mode(pgsql))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	log_info("Applying changes using %d concurrent connections",
+			 parallel->count);
+
+	return true;
+}
+
+
+/*
+ * stream_apply_parallel_cleanup closes the apply worker connections and
+ * releases the memory we use to track them.
+ */
+void
+stream_apply_parallel_cleanup(StreamApplyContext *context)
+{
+	StreamApplyParallel *parallel = context->parallel;
+
+	for (int i = 0; i < parallel->count; i++)
+	{
+		ApplyWorker *worker = &(parallel->workers[i]);
+
+		(void) pgsql_finish(&(worker->pgsql));
+
+		PreparedStmt *stmt, *tmp;
+
+		HASH_ITER(hh, worker->preparedStmt, stmt, tmp)
+		{
+			HASH_DEL(worker->preparedStmt, stmt);
+			free(stmt);
+		}
+	}
+
+	ApplyTableTracking *table, *tmp;
+
+	HASH_ITER(hh, parallel->tables, table, tmp)
+	{
+		HASH_DEL(parallel->tables, table);
+		free(table);
+	}
+
+	ApplyTableGroup *group, *tmpGroup;
+
+	HASH_ITER(hh, parallel->groups, group, tmpGroup)
+	{
+		HASH_DEL(parallel->groups, group);
+		free(group);
+	}
+
+	free(parallel->workers);
+	free(parallel);
+
+	context->parallel = NULL;
+}
+
+
+/*
+ * stream_apply_parallel_begin dispatches the transaction that begins to an
+ * idle apply worker. When all the apply workers are busy, we commit the
+ * oldest transaction first.
+ */
+bool
+stream_apply_parallel_begin(StreamApplyContext *context,
+							LogicalMessageMetadata *metadata)
+{
+	StreamApplyParallel *parallel = context->parallel;
+
+	if (parallel->current != NULL)
+	{
+		log_error("BUG: stream_apply_parallel_begin called with transaction "
+				  "%u still in progress on apply worker %d",
+				  parallel->current->xid,
+				  parallel->current->id);
+		return false;
+	}
+
+	/* a transaction with a TRUNCATE must be committed alone */
+	if (parallel->committedSeq < parallel->barrierSeq)
+	{
+		if (!stream_apply_parallel_commit_until(parallel, parallel->barrierSeq))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	ApplyWorker *worker = stream_apply_parallel_idle_worker(parallel);
+
+	if (worker == NULL)
+	{
+		ApplyWorker *next = stream_apply_parallel_next_ready(parallel);
+
+		if (next == NULL)
+		{
+			log_error("BUG: stream_apply_parallel_begin failed to find "
+					  "an apply worker");
+			return false;
+		}
+
+		if (!stream_apply_parallel_commit_worker(parallel, next))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		worker = next;
+	}
+
+	worker->state = APPLY_WORKER_OPEN;
+	worker->seq = ++(parallel->lastSeq);
+	worker->xid = metadata->xid;
+	worker->commitLSN = InvalidXLogRecPtr;
+	worker->pipelineBytes = 0;
+
+	parallel->current = worker;
+
+	log_trace("BEGIN %lld dispatched to apply worker %d",
+			  (long long) metadata->xid,
+			  worker->id);
+
+	return true;
+}
+
+
+/*
+ * stream_apply_parallel_commit marks the current transaction ready to be
+ * committed, and sends its statements to the target database. The COMMIT
+ * itself is sent later, in the source commit order.
+ */
+bool
+stream_apply_parallel_commit(StreamApplyContext *context,
+							 LogicalMessageMetadata *metadata)
+{
+	StreamApplyParallel *parallel = context->parallel;
+	ApplyWorker *worker = parallel->current;
+
+	if (worker == NULL)
+	{
+		log_warn("Skipping COMMIT %lld LSN %X/%X: transaction not found",
+				 (long long) metadata->xid,
+				 LSN_FORMAT_ARGS(metadata->lsn));
+		return true;
+	}
+
+	worker->state = APPLY_WORKER_READY;
+	worker->commitLSN = metadata->lsn;
+
+	strlcpy(worker->timestamp, metadata->timestamp, sizeof(worker->timestamp));
+
+	parallel->current = NULL;
+
+	/* have the target database execute the transaction now */
+	if (!pgsql_flush_pipeline(&(worker->pgsql)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * stream_apply_parallel_release releases the apply worker of the current
+ * transaction after it has been rolled-back.
+ */
+void
+stream_apply_parallel_release(StreamApplyContext *context)
+{
+	StreamApplyParallel *parallel = context->parallel;
+	ApplyWorker *worker = parallel->current;
+
+	if (worker == NULL)
+	{
+		return;
+	}
+
+	if (parallel->barrierSeq == worker->seq)
+	{
+		parallel->barrierSeq = 0;
+	}
+
+	worker->state = APPLY_WORKER_IDLE;
+	parallel->current = NULL;
+}
+
+
+/*
+ * stream_apply_parallel_track_table registers that the current transaction
+ * touches the given table. When a previous transaction that is not committed
+ * yet touched the same table, it is committed first, along with all the
+ * transactions before it.
+ *
+ * Row level tracking is not possible here: an INSERT statement does not
+ * carry the replica identity of the row, and the target table might have
+ * unique constraints that are not part of the replica identity.
+ *
+ * Tables that are linked by a foreign key are tracked using the qname of
+ * their group, see stream_apply_parallel_fetch_fkeys().
+ */
+bool
+stream_apply_parallel_track_table(StreamApplyContext *context,
+								  const char *nspname,
+								  const char *relname)
+{
+	StreamApplyParallel *parallel = context->parallel;
+	ApplyWorker *worker = parallel->current;
+
+	if (worker == NULL)
+	{
+		log_error("BUG: stream_apply_parallel_track_table called "
+				  "without a transaction in progress");
+		return false;
+	}
+
+	/* when we don't know which table is used, commit this one alone */
+	if (IS_EMPTY_STRING_BUFFER(relname))
+	{
+		return stream_apply_parallel_barrier(context);
+	}
+
+	char qname[PG_NAMEDATALEN_FQ] = { 0 };
+
+	sformat(qname, sizeof(qname), "%s.%s", nspname, relname);
+
+	ApplyTableGroup *group =
+		stream_apply_parallel_find_group(parallel, qname, false);
+
+	if (group != NULL)
+	{
+		strlcpy(qname, group->qname, sizeof(qname));
+	}
+
+	ApplyTableTracking *table = NULL;
+
+	HASH_FIND_STR(parallel->tables, qname, table);
+
+	if (table == NULL)
+	{
+		table = (ApplyTableTracking *) calloc(1, sizeof(ApplyTableTracking));
+
+		if (table == NULL)
+		{
+			log_error(ALLOCATION_FAILED_ERROR);
+			return false;
+		}
+
+		strlcpy(table->qname, qname, sizeof(table->qname));
+
+		HASH_ADD_STR(parallel->tables, qname, table);
+	}
+	else if (table->seq != worker->seq && parallel->committedSeq < table->seq)
+	{
+		log_trace("Transaction %lld on apply worker %d waits for the COMMIT "
+				  "of a previous transaction on table %s",
+				  (long long) worker->xid,
+				  worker->id,
+				  qname);
+
+		++(worker->waitCount);
+
+		if (!stream_apply_parallel_commit_until(parallel, table->seq))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	table->seq = worker->seq;
+
+	return true;
+}
+
+
+/*
+ * stream_apply_parallel_barrier commits all the previous transactions, and
+ * makes the next transactions wait until the current one has been committed.
+ */
+bool
+stream_apply_parallel_barrier(StreamApplyContext *context)
+{
+	StreamApplyParallel *parallel = context->parallel;
+	ApplyWorker *worker = parallel->current;
+
+	if (worker == NULL)
+	{
+		log_error("BUG: stream_apply_parallel_barrier called "
+				  "without a transaction in progress");
+		return false;
+	}
+
+	if (parallel->barrierSeq == worker->seq)
+	{
+		return true;
+	}
+
+	if (!stream_apply_parallel_commit_until(parallel, worker->seq))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	parallel->barrierSeq = worker->seq;
+
+	return true;
+}
+
+
+/*
+ * stream_apply_parallel_drain commits all the transactions that are ready to
+ * be committed. The transaction in progress, if any, is left as-is.
+ */
+bool
+stream_apply_parallel_drain(StreamApplyContext *context)
+{
+	StreamApplyParallel *parallel = context->parallel;
+
+	return stream_apply_parallel_commit_until(parallel, parallel->lastSeq);
+}
+
+
+/*
+ * stream_apply_parallel_sync_sentinel registers the progress of each apply
+ * worker in our catalogs, see pgcopydb stream sentinel get.
+ */
+bool
+stream_apply_parallel_sync_sentinel(StreamApplyContext *context)
+{
+	StreamApplyParallel *parallel = context->parallel;
+
+	/* forget about the apply workers of a previous run */
+	if (!parallel->sentinelReset)
+	{
+		if (!sentinel_reset_apply_workers(context->sourceDB))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		parallel->sentinelReset = true;
+	}
+
+	for (int i = 0; i < parallel->count; i++)
+	{
+		ApplyWorker *worker = &(parallel->workers[i]);
+
+		CopyDBSentinelApplyWorker sentinel = {
+			.id = worker->id,
+			.replay_lsn = worker->replayLSN,
+			.txnCount = worker->txnCount,
+			.waitCount = worker->waitCount
+		};
+
+		strlcpy(sentinel.origin, worker->origin, sizeof(sentinel.origin));
+
+		if (worker->replayLSN != InvalidXLogRecPtr &&
+			worker->replayLSN < context->previousLSN)
+		{
+			sentinel.lag = context->previousLSN - worker->replayLSN;
+		}
+
+		if (!sentinel_update_apply_worker(context->sourceDB, &sentinel))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ * stream_apply_parallel_idle_worker returns the first idle apply worker, or
+ * NULL when all the apply workers are busy.
+ */
+static ApplyWorker *
+stream_apply_parallel_idle_worker(StreamApplyParallel *parallel)
+{
+	for (int i = 0; i < parallel->count; i++)
+	{
+		ApplyWorker *worker = &(parallel->workers[i]);
+
+		if (worker->state == APPLY_WORKER_IDLE)
+		{
+			return worker;
+		}
+	}
+
+	return NULL;
+}
+
+
+/*
+ * stream_apply_parallel_next_ready returns the apply worker with the oldest
+ * transaction that is ready to be committed, or NULL when there is none.
+ */
+static ApplyWorker *
+stream_apply_parallel_next_ready(StreamApplyParallel *parallel)
+{
+	ApplyWorker *next = NULL;
+
+	for (int i = 0; i < parallel->count; i++)
+	{
+		ApplyWorker *worker = &(parallel->workers[i]);
+
+		if (worker->state == APPLY_WORKER_READY &&
+			(next == NULL || worker->seq < next->seq))
+		{
+			next = worker;
+		}
+	}
+
+	return next;
+}
+
+
+/*
+ * stream_apply_parallel_commit_until commits, in order, all the transactions
+ * that are ready to be committed up to the given one.
+ */
+static bool
+stream_apply_parallel_commit_until(StreamApplyParallel *parallel, uint64_t seq)
+{
+	ApplyWorker *next = NULL;
+
+	while ((next = stream_apply_parallel_next_ready(parallel)) != NULL &&
+		   next->seq <= seq)
+	{
+		if (!stream_apply_parallel_commit_worker(parallel, next))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ * stream_apply_parallel_commit_worker sends the COMMIT of the transaction
+ * that is ready on the given apply worker, along with the replication origin
+ * tracking, and waits until it's done.
+ */
+static bool
+stream_apply_parallel_commit_worker(StreamApplyParallel *parallel,
+									ApplyWorker *worker)
+{
+	PGSQL *pgsql = &(worker->pgsql);
+
+	char lsn[PG_LSN_MAXLENGTH] = { 0 };
+
+	sformat(lsn, sizeof(lsn), "%X/%X", LSN_FORMAT_ARGS(worker->commitLSN));
+
+	if (!pgsql_replication_origin_xact_setup(pgsql, lsn, worker->timestamp))
+	{
+		log_error("Failed to setup apply transaction, "
+				  "see above for details");
+		return false;
+	}
+
+	/* calling pgsql_commit() would finish the connection, avoid */
+	if (!pgsql_execute(pgsql, "COMMIT"))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* see stream_apply_sql() COMMIT for details */
+	if (worker->preparedStmt != NULL)
+	{
+		if (!pgsql_execute(pgsql, "DEALLOCATE ALL"))
+		{
+			log_warn("Failed to deallocate prepared statements");
+		}
+
+		PreparedStmt *stmt, *tmp;
+
+		HASH_ITER(hh, worker->preparedStmt, stmt, tmp)
+		{
+			HASH_DEL(worker->preparedStmt, stmt);
+			free(stmt);
+		}
+
+		worker->preparedStmt = NULL;
+	}
+
+	if (!pgsql_sync_pipeline(pgsql))
+	{
+		log_error("Failed to apply transaction %lld with COMMIT LSN %X/%X "
+				  "on apply worker %d, see above for details",
+				  (long long) worker->xid,
+				  LSN_FORMAT_ARGS(worker->commitLSN),
+				  worker->id);
+		return false;
+	}
+
+	log_trace("COMMIT %lld LSN %X/%X on apply worker %d",
+			  (long long) worker->xid,
+			  LSN_FORMAT_ARGS(worker->commitLSN),
+			  worker->id);
+
+	worker->state = APPLY_WORKER_IDLE;
+	worker->pipelineBytes = 0;
+	worker->replayLSN = worker->commitLSN;
+	++(worker->txnCount);
+
+	parallel->committedSeq = worker->seq;
+
+	return true;
+}
+
+
+typedef struct ApplyFKeysContext
+{
+	char sqlstate[SQLSTATE_LENGTH];
+	StreamApplyParallel *parallel;
+	bool parsedOk;
+} ApplyFKeysContext;
+
+
+/*
+ * parseApplyFKeys adds the tables of each foreign key to the same group.
+ */
+static void
+parseApplyFKeys(void *ctx, PGresult *result)
+{
+	ApplyFKeysContext *context = (ApplyFKeysContext *) ctx;
+	StreamApplyParallel *parallel = context->parallel;
+
+	if (PQnfields(result) != 2)
+	{
+		log_error("Query returned %d columns, expected 2", PQnfields(result));
+		context->parsedOk = false;
+		return;
+	}
+
+	for (int row = 0; row < PQntuples(result); row++)
+	{
+		ApplyTableGroup *a =
+			stream_apply_parallel_find_group(parallel,
+											 PQgetvalue(result, row, 0),
+											 true);
+
+		ApplyTableGroup *b =
+			stream_apply_parallel_find_group(parallel,
+											 PQgetvalue(result, row, 1),
+											 true);
+
+		if (a == NULL || b == NULL)
+		{
+			/* errors have already been logged */
+			context->parsedOk = false;
+			return;
+		}
+
+		/* merge the two groups, a and b are the root of their group */
+		if (a != b)
+		{
+			strlcpy(b->group, a->qname, sizeof(b->group));
+		}
+	}
+
+	context->parsedOk = true;
+}
+
+
+/*
+ * stream_apply_parallel_fetch_fkeys fetches the foreign keys from the target
+ * database catalogs, and groups together the tables that are linked by a
+ * foreign key, directly or not.
+ *
+ * Without that, a transaction that inserts a row in a referencing table could
+ * run on another apply worker connection while the transaction that inserted
+ * the referenced row is not committed yet, and fail with a foreign key
+ * violation. The foreign keys are created by pgcopydb clone before the apply
+ * process is allowed to start, see pgcopydb stream sentinel set apply.
+ */
+static bool
+stream_apply_parallel_fetch_fkeys(StreamApplyParallel *parallel, PGSQL *pgsql)
+{
+	char *sql =
+		"select rn.nspname || '.' || r.relname, "
+		"       fn.nspname || '.' || f.relname "
+		"  from pg_catalog.pg_constraint c "
+		"       join pg_catalog.pg_class r on r.oid = c.conrelid "
+		"       join pg_catalog.pg_namespace rn on rn.oid = r.relnamespace "
+		"       join pg_catalog.pg_class f on f.oid = c.confrelid "
+		"       join pg_catalog.pg_namespace fn on fn.oid = f.relnamespace "
+		" where c.contype = 'f'";
+
+	ApplyFKeysContext context = { { 0 }, parallel, false };
+
+	if (!pgsql_execute_with_params(pgsql, sql, 0, NULL, NULL,
+								   &context, &parseApplyFKeys))
+	{
+		log_error("Failed to fetch foreign keys from the target database");
+		return false;
+	}
+
+	if (!context.parsedOk)
+	{
+		log_error("Failed to fetch foreign keys from the target database");
+		return false;
+	}
+
+	log_debug("Tracking %u tables linked by foreign keys as groups",
+			  HASH_COUNT(parallel->groups));
+
+	return true;
+}
+
+
+/*
+ * stream_apply_parallel_find_group returns the root entry of the group of
+ * tables linked by foreign keys that the given table belongs to. When the
+ * table is not part of a group, NULL is returned, unless create is true, in
+ * which case a new group is added for the table.
+ */
+static ApplyTableGroup *
+stream_apply_parallel_find_group(StreamApplyParallel *parallel,
+								 const char *qname,
+								 bool create)
+{
+	ApplyTableGroup *group = NULL;
+
+	HASH_FIND_STR(parallel->groups, qname, group);
+
+	if (group == NULL)
+	{
+		if (!create)
+		{
+			return NULL;
+		}
+
+		group = (ApplyTableGroup *) calloc(1, sizeof(ApplyTableGroup));
+
+		if (group == NULL)
+		{
+			log_error(ALLOCATION_FAILED_ERROR);
+			return NULL;
+		}
+
+		strlcpy(group->qname, qname, sizeof(group->qname));
+		strlcpy(group->group, qname, sizeof(group->group));
+
+		HASH_ADD_STR(parallel->groups, qname, group);
+
+		return group;
+	}
+
+	/* follow the links up to the root of the group */
+	while (strcmp(group->qname, group->group) != 0)
+	{
+		ApplyTableGroup *parent = NULL;
+
+		HASH_FIND_STR(parallel->groups, group->group, parent);
+
+		if (parent == NULL)
+		{
+			break;
+		}
+
+		group = parent;
+	}
+
+	return group;
+}
@@ -0,0 +1,1210 @@
+/*
+ * src/bin/pgcopydb/ld_binary.c
+ *     Binary format for the files written by the transform process and read
+ *     by the apply process.
+ *
+ * With --transform-format binary, the transform process writes records that
+ * the apply process reads without having to parse any SQL text or JSON
+ * parameter array. The SQL text format remains the default, and is still
+ * always used on Unix pipes.
+ *
+ * A binary file begins with the STREAM_BINARY_SIGNATURE and a 4-bytes format
+ * version number, followed by a series of records. Each record is a 1-byte
+ * type, which is a StreamAction, then a 4-bytes payload length, then the
+ * payload. Integers are written in network byte order, and strings are
+ * written as a 4-bytes length, the string bytes, and a terminating zero byte
+ * so that the apply process can use them in-place.
+ *
+ *   B  BEGIN       xid, lsn, commit lsn (or 0/0), timestamp
+ *   C  COMMIT      xid, lsn, timestamp
+ *   R  ROLLBACK    xid, lsn, timestamp
+ *   X  SWITCH      lsn
+ *   K  KEEPALIVE   lsn, timestamp
+ *   E  ENDPOS      lsn
+ *   T  TRUNCATE    sql
+ *   I  INSERT      statement hash, sql
+ *   U  UPDATE      statement hash, sql
+ *   D  DELETE      statement hash, sql
+ *   x  EXECUTE     statement hash, parameter count, parameters
+ *
+ * The INSERT, UPDATE, and DELETE records define a statement only once per
+ * file, and the EXECUTE records then refer to the statement by its hash.
+ * Each EXECUTE parameter is a 1-byte type followed by its value: NULL has no
+ * value, a boolean is 1 byte, int8 and float8 are 8 bytes, and text is a
+ * string.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "postgres.h"
+#include "postgres_fe.h"
+#include "access/xlogdefs.h"
+#include "pqexpbuffer.h"
+
+#include "file_utils.h"
+#include "ld_stream.h"
+#include "log.h"
+#include "pgsql.h"
+#include "string_utils.h"
+
+
+#define BINARY_VALUE_NULL 'n'
+#define BINARY_VALUE_BOOL 'b'
+#define BINARY_VALUE_INT8 'i'
+#define BINARY_VALUE_FLOAT8 'f'
+#define BINARY_VALUE_TEXT 't'
+
+/* record type and payload length */
+#define BINARY_RECORD_HEADER_LEN 5
+
+/* enough for the text representation of an int8 or a float8 */
+#define BINARY_NUMERIC_TEXT_LEN 32
+
+
+/*
+ * The statements definitions that we read from a binary file.
+ */
+typedef struct BinaryStmtDef
+{
+	uint32_t hash;
+	char *sql;                  /* points to the file contents */
+	bool filterOut;
+
+	UT_hash_handle hh;          /* makes this structure hashable */
+} BinaryStmtDef;
+
+
+/*
+ * BinaryCursor allows reading the payload of a record.
+ */
+typedef struct BinaryCursor
+{
+	char *data;
+	uint64_t size;
+	uint64_t pos;
+} BinaryCursor;
+
+
+static void binary_append_uint8(PQExpBuffer buf, uint8_t value);
+static void binary_append_uint32(PQExpBuffer buf, uint32_t value);
+static void binary_append_uint64(PQExpBuffer buf, uint64_t value);
+static void binary_append_string(PQExpBuffer buf, const char *str);
+static bool binary_append_value(PQExpBuffer buf, LogicalMessageValue *value);
+
+static bool binary_write_record(FILE *out, StreamAction action, PQExpBuffer buf);
+
+static bool binary_read_uint8(BinaryCursor *cursor, uint8_t *value);
+static bool binary_read_uint32(BinaryCursor *cursor, uint32_t *value);
+static bool binary_read_uint64(BinaryCursor *cursor, uint64_t *value);
+static bool binary_read_string(BinaryCursor *cursor, char **str);
+
+static bool binary_read_timestamp(BinaryCursor *cursor,
+								  LogicalMessageMetadata *metadata);
+
+static bool binary_read_params(BinaryCursor *cursor,
+							   LogicalMessageMetadata *metadata);
+
+static bool binary_parse_record(StreamAction action,
+								BinaryCursor *cursor,
+								SourceFilters *filters,
+								BinaryStmtDef **stmts,
+								LogicalMessageMetadata *metadata);
+
+
+/*
+ * stream_binary_write_header writes the signature and version of our binary
+ * format at the beginning of a new file.
+ */
+bool
+stream_binary_write_header(FILE *out)
+{
+	PQExpBuffer buf = createPQExpBuffer();
+
+	appendBinaryPQExpBuffer(buf,
+							STREAM_BINARY_SIGNATURE,
+							STREAM_BINARY_SIGNATURE_LEN);
+
+	binary_append_uint32(buf, STREAM_BINARY_VERSION);
+
+	if (PQExpBufferBroken(buf))
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		destroyPQExpBuffer(buf);
+		return false;
+	}
+
+	if (fwrite(buf->data, sizeof(char), buf->len, out) != buf->len)
+	{
+		log_error("Failed to write to stream: %m");
+		destroyPQExpBuffer(buf);
+		return false;
+	}
+
+	destroyPQExpBuffer(buf);
+
+	return true;
+}
+
+
+/*
+ * stream_binary_write_begin writes a BEGIN record.
+ */
+bool
+stream_binary_write_begin(FILE *out, LogicalTransaction *txn)
+{
+	PQExpBuffer buf = createPQExpBuffer();
+
+	binary_append_uint32(buf, txn->xid);
+	binary_append_uint64(buf, txn->beginLSN);
+	binary_append_uint64(buf, txn->commitLSN);
+	binary_append_string(buf, txn->timestamp);
+
+	bool success = binary_write_record(out, STREAM_ACTION_BEGIN, buf);
+
+	destroyPQExpBuffer(buf);
+
+	return success;
+}
+
+
+/*
+ * stream_binary_write_commit writes a COMMIT record.
+ */
+bool
+stream_binary_write_commit(FILE *out, LogicalTransaction *txn)
+{
+	PQExpBuffer buf = createPQExpBuffer();
+
+	binary_append_uint32(buf, txn->xid);
+	binary_append_uint64(buf, txn->commitLSN);
+	binary_append_string(buf, txn->timestamp);
+
+	bool success = binary_write_record(out, STREAM_ACTION_COMMIT, buf);
+
+	destroyPQExpBuffer(buf);
+
+	return success;
+}
+
+
+/*
+ * stream_binary_write_rollback writes a ROLLBACK record.
+ */
+bool
+stream_binary_write_rollback(FILE *out, LogicalTransaction *txn)
+{
+	PQExpBuffer buf = createPQExpBuffer();
+
+	binary_append_uint32(buf, txn->xid);
+	binary_append_uint64(buf, txn->rollbackLSN);
+	binary_append_string(buf, txn->timestamp);
+
+	bool success = binary_write_record(out, STREAM_ACTION_ROLLBACK, buf);
+
+	destroyPQExpBuffer(buf);
+
+	return success;
+}
+
+
+/*
+ * stream_binary_write_lsn writes a SWITCH or an ENDPOS record.
+ */
+bool
+stream_binary_write_lsn(FILE *out, StreamAction action, uint64_t lsn)
+{
+	PQExpBuffer buf = createPQExpBuffer();
+
+	binary_append_uint64(buf, lsn);
+
+	bool success = binary_write_record(out, action, buf);
+
+	destroyPQExpBuffer(buf);
+
+	return success;
+}
+
+
+/*
+ * stream_binary_write_keepalive writes a KEEPALIVE record.
+ */
+bool
+stream_binary_write_keepalive(FILE *out, LogicalMessageKeepalive *keepalive)
+{
+	PQExpBuffer buf = createPQExpBuffer();
+
+	binary_append_uint64(buf, keepalive->lsn);
+	binary_append_string(buf, keepalive->timestamp);
+
+	bool success = binary_write_record(out, STREAM_ACTION_KEEPALIVE, buf);
+
+	destroyPQExpBuffer(buf);
+
+	return success;
+}
+
+
+/*
+ * stream_binary_write_truncate writes a TRUNCATE record.
+ */
+bool
+stream_binary_write_truncate(FILE *out, const char *sql)
+{
+	PQExpBuffer buf = createPQExpBuffer();
+
+	binary_append_string(buf, sql);
+
+	bool success = binary_write_record(out, STREAM_ACTION_TRUNCATE, buf);
+
+	destroyPQExpBuffer(buf);
+
+	return success;
+}
+
+
+/*
+ * stream_binary_write_statement writes the definition of a statement when
+ * it's not been written to the current file yet, and then an EXECUTE record
+ * with the given parameter values.
+ */
+bool
+stream_binary_write_statement(StreamOutput *output,
+							  StreamAction action,
+							  uint32_t hash,
+							  const char *sql,
+							  LogicalMessageValue **values,
+							  int count)
+{
+	StreamBinaryStmt *stmt = NULL;
+
+	if (output->stmts != NULL)
+	{
+		HASH_FIND(hh, *(output->stmts), &hash, sizeof(hash), stmt);
+	}
+
+	if (stmt == NULL)
+	{
+		PQExpBuffer def = createPQExpBuffer();
+
+		binary_append_uint32(def, hash);
+		binary_append_string(def, sql);
+
+		bool success = binary_write_record(output->out, action, def);
+
+		destroyPQExpBuffer(def);
+
+		if (!success)
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (output->stmts != NULL)
+		{
+			stmt = (StreamBinaryStmt *) calloc(1, sizeof(StreamBinaryStmt));
+
+			if (stmt == NULL)
+			{
+				log_error(ALLOCATION_FAILED_ERROR);
+				return false;
+			}
+
+			stmt->hash = hash;
+
+			HASH_ADD(hh, *(output->stmts), hash, sizeof(hash), stmt);
+		}
+	}
+
+	PQExpBuffer buf = createPQExpBuffer();
+
+	binary_append_uint32(buf, hash);
+	binary_append_uint32(buf, count);
+
+	for (int i = 0; i < count; i++)
+	{
+		if (!binary_append_value(buf, values[i]))
+		{
+			/* errors have already been logged */
+			destroyPQExpBuffer(buf);
+			return false;
+		}
+	}
+
+	bool success = binary_write_record(output->out, STREAM_ACTION_EXECUTE, buf);
+
+	destroyPQExpBuffer(buf);
+
+	return success;
+}
+
+
+/*
+ * stream_binary_file_format reads the beginning of the given file to find its
+ * format. An empty file has the STREAM_FORMAT_UNKNOWN format.
+ */
+bool
+stream_binary_file_format(const char *filename, StreamTransformFormat *format)
+{
+	FILE *file = fopen_read_only(filename);
+
+	if (file == NULL)
+	{
+		log_error("Failed to open file \"%s\": %m", filename);
+		return false;
+	}
+
+	char buffer[STREAM_BINARY_SIGNATURE_LEN] = { 0 };
+	size_t bytes = fread(buffer, sizeof(char), sizeof(buffer), file);
+
+	if (ferror(file))
+	{
+		log_error("Failed to read file \"%s\": %m", filename);
+		fclose(file);
+		return false;
+	}
+
+	fclose(file);
+
+	if (bytes == 0)
+	{
+		*format = STREAM_FORMAT_UNKNOWN;
+	}
+	else if (stream_binary_has_signature(buffer, bytes))
+	{
+		*format = STREAM_FORMAT_BINARY;
+	}
+	else
+	{
+		*format = STREAM_FORMAT_SQL;
+	}
+
+	return true;
+}
+
+
+/*
+ * stream_binary_has_signature returns true when the given buffer begins with
+ * the signature of our binary format.
+ */
+bool
+stream_binary_has_signature(const char *buffer, long size)
+{
+	return STREAM_BINARY_SIGNATURE_LEN <= size &&
+		   memcmp(buffer,
+				  STREAM_BINARY_SIGNATURE,
+				  STREAM_BINARY_SIGNATURE_LEN) == 0;
+}
+
+
+/*
+ * stream_binary_parse_buffer parses the contents of a binary file into an
+ * array of LogicalMessageMetadata, ready to be applied with stream_apply_sql.
+ *
+ * The strings and statements found in the metadata point to the given buffer,
+ * which must then be kept around until the messages have been applied.
+ *
+ * A file that is still being written to by the transform process might end
+ * with a partial record, which is then ignored: the next round of apply is
+ * going to read it again.
+ */
+bool
+stream_binary_parse_buffer(char *buffer, long size,
+						   SourceFilters *filters,
+						   LogicalMessageMetadata **messages,
+						   uint64_t *count)
+{
+	uint64_t headerLen = STREAM_BINARY_SIGNATURE_LEN + sizeof(uint32_t);
+
+	if (!stream_binary_has_signature(buffer, size) || size < headerLen)
+	{
+		log_error("Failed to parse binary file: signature not found");
+		return false;
+	}
+
+	BinaryCursor header = {
+		.data = buffer,
+		.size = headerLen,
+		.pos = STREAM_BINARY_SIGNATURE_LEN
+	};
+
+	uint32_t version = 0;
+
+	if (!binary_read_uint32(&header, &version) ||
+		version != STREAM_BINARY_VERSION)
+	{
+		log_error("Failed to parse binary file: unsupported version %u",
+				  version);
+		return false;
+	}
+
+	/* first count the complete records found in the buffer */
+	uint64_t recordCount = 0;
+	uint64_t end = headerLen;
+
+	for (;;)
+	{
+		if (size < end + BINARY_RECORD_HEADER_LEN)
+		{
+			break;
+		}
+
+		BinaryCursor cursor = {
+			.data = buffer + end + 1,
+			.size = sizeof(uint32_t),
+			.pos = 0
+		};
+
+		uint32_t len = 0;
+
+		(void) binary_read_uint32(&cursor, &len);
+
+		if (size < end + BINARY_RECORD_HEADER_LEN + len)
+		{
+			break;
+		}
+
+		++recordCount;
+		end += BINARY_RECORD_HEADER_LEN + len;
+	}
+
+	if (end < size)
+	{
+		log_notice("Skipping partial record of %lld bytes at the end of "
+				   "the binary file",
+				   (long long) (size - end));
+	}
+
+	*count = 0;
+	*messages = NULL;
+
+	if (recordCount == 0)
+	{
+		return true;
+	}
+
+	LogicalMessageMetadata *mArray =
+		(LogicalMessageMetadata *) calloc(recordCount,
+										  sizeof(LogicalMessageMetadata));
+
+	if (mArray == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	BinaryStmtDef *stmts = NULL;
+	uint64_t pos = headerLen;
+	uint64_t n = 0;
+	bool success = true;
+
+	while (pos < end)
+	{
+		StreamAction action = (StreamAction) buffer[pos];
+
+		BinaryCursor lenCursor = {
+			.data = buffer + pos + 1,
+			.size = sizeof(uint32_t),
+			.pos = 0
+		};
+
+		uint32_t len = 0;
+
+		(void) binary_read_uint32(&lenCursor, &len);
+
+		BinaryCursor cursor = {
+			.data = buffer + pos + BINARY_RECORD_HEADER_LEN,
+			.size = len,
+			.pos = 0
+		};
+
+		LogicalMessageMetadata *metadata = &(mArray[n]);
+
+		if (!binary_parse_record(action, &cursor, filters, &stmts, metadata))
+		{
+			log_error("Failed to parse binary record %c at offset %lld",
+					  action,
+					  (long long) pos);
+			success = false;
+			break;
+		}
+
+		/* statement definitions do not need to be applied */
+		if (metadata->action != STREAM_ACTION_UNKNOWN)
+		{
+			++n;
+		}
+
+		pos += BINARY_RECORD_HEADER_LEN + len;
+	}
+
+	BinaryStmtDef *current, *tmp;
+
+	HASH_ITER(hh, stmts, current, tmp)
+	{
+		HASH_DEL(stmts, current);
+		free(current);
+	}
+
+	if (!success)
+	{
+		(void) stream_binary_free_messages(mArray, n);
+		return false;
+	}
+
+	*messages = mArray;
+	*count = n;
+
+	return true;
+}
+
+
+/*
+ * stream_binary_free_messages frees the memory allocated by
+ * stream_binary_parse_buffer.
+ */
+void
+stream_binary_free_messages(LogicalMessageMetadata *messages, uint64_t count)
+{
+	if (messages == NULL)
+	{
+		return;
+	}
+
+	for (uint64_t i = 0; i < count; i++)
+	{
+		free(messages[i].paramValues);
+	}
+
+	free(messages);
+}
+
+
+/*
+ * binary_parse_record parses a single record into the given metadata. The
+ * statement definitions are registered in the stmts hash table, and leave the
+ * metadata action to STREAM_ACTION_UNKNOWN.
+ */
+static bool
+binary_parse_record(StreamAction action,
+					BinaryCursor *cursor,
+					SourceFilters *filters,
+					BinaryStmtDef **stmts,
+					LogicalMessageMetadata *metadata)
+{
+	switch (action)
+	{
+		case STREAM_ACTION_BEGIN:
+		{
+			metadata->action = action;
+
+			return binary_read_uint32(cursor, &(metadata->xid)) &&
+				   binary_read_uint64(cursor, &(metadata->lsn)) &&
+				   binary_read_uint64(cursor, &(metadata->txnCommitLSN)) &&
+				   binary_read_timestamp(cursor, metadata);
+		}
+
+		case STREAM_ACTION_COMMIT:
+		case STREAM_ACTION_ROLLBACK:
+		{
+			metadata->action = action;
+
+			return binary_read_uint32(cursor, &(metadata->xid)) &&
+				   binary_read_uint64(cursor, &(metadata->lsn)) &&
+				   binary_read_timestamp(cursor, metadata);
+		}
+
+		case STREAM_ACTION_SWITCH:
+		case STREAM_ACTION_ENDPOS:
+		{
+			metadata->action = action;
+
+			return binary_read_uint64(cursor, &(metadata->lsn));
+		}
+
+		case STREAM_ACTION_KEEPALIVE:
+		{
+			metadata->action = action;
+
+			return binary_read_uint64(cursor, &(metadata->lsn)) &&
+				   binary_read_timestamp(cursor, metadata);
+		}
+
+		case STREAM_ACTION_TRUNCATE:
+		{
+			char *sql = NULL;
+
+			if (!binary_read_string(cursor, &sql))
+			{
+				return false;
+			}
+
+			/* TRUNCATE is rare enough to re-use the SQL parsing code */
+			if (!parseSQLAction(sql, metadata, filters))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+
+			metadata->stmt = sql;
+
+			return true;
+		}
+
+		case STREAM_ACTION_INSERT:
+		case STREAM_ACTION_UPDATE:
+		case STREAM_ACTION_DELETE:
+		{
+			uint32_t hash = 0;
+			char *sql = NULL;
+
+			if (!binary_read_uint32(cursor, &hash) ||
+				!binary_read_string(cursor, &sql))
+			{
+				return false;
+			}
+
+			BinaryStmtDef *def = NULL;
+
+			HASH_FIND(hh, *stmts, &hash, sizeof(hash), def);
+
+			if (def == NULL)
+			{
+				def = (BinaryStmtDef *) calloc(1, sizeof(BinaryStmtDef));
+
+				if (def == NULL)
+				{
+					log_error(ALLOCATION_FAILED_ERROR);
+					return false;
+				}
+
+				def->hash = hash;
+
+				HASH_ADD(hh, *stmts, hash, sizeof(hash), def);
+			}
+
+			def->sql = sql;
+			def->filterOut = shouldFilterOutStatement(sql, filters);
+
+			/* a statement definition is not a message to apply */
+			metadata->action = STREAM_ACTION_UNKNOWN;
+
+			return true;
+		}
+
+		case STREAM_ACTION_EXECUTE:
+		{
+			uint32_t hash = 0;
+
+			if (!binary_read_uint32(cursor, &hash))
+			{
+				return false;
+			}
+
+			BinaryStmtDef *def = NULL;
+
+			HASH_FIND(hh, *stmts, &hash, sizeof(hash), def);
+
+			if (def == NULL)
+			{
+				log_error("Failed to find statement %x definition", hash);
+				return false;
+			}
+
+			metadata->action = action;
+			metadata->hash = hash;
+			metadata->stmt = def->sql;
+			metadata->filterOut = def->filterOut;
+
+			/* skip decoding the parameters of filtered-out statements */
+			if (def->filterOut)
+			{
+				return true;
+			}
+
+			return binary_read_params(cursor, metadata);
+		}
+
+		default:
+		{
+			log_error("Unknown binary record type %d", action);
+			return false;
+		}
+	}
+}
+
+
+/*
+ * binary_read_params reads the parameters of an EXECUTE record into a single
+ * allocated area: the array of pointers to the parameter values, followed by
+ * the text representation of the int8 and float8 parameters. Text values
+ * point to the file contents directly.
+ */
+static bool
+binary_read_params(BinaryCursor *cursor, LogicalMessageMetadata *metadata)
+{
+	uint32_t count = 0;
+
+	if (!binary_read_uint32(cursor, &count))
+	{
+		return false;
+	}
+
+	metadata->binaryParams = true;
+	metadata->paramCount = 0;
+	metadata->paramValues = NULL;
+
+	/* an EXECUTE without parameters, such as INSERT ... DEFAULT VALUES */
+	if (count == 0)
+	{
+		return true;
+	}
+
+	/* first pass to count the parameters that need a text representation */
+	BinaryCursor scan = *cursor;
+	uint32_t numericCount = 0;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint8_t type = 0;
+
+		if (!binary_read_uint8(&scan, &type))
+		{
+			return false;
+		}
+
+		switch (type)
+		{
+			case BINARY_VALUE_NULL:
+			{
+				break;
+			}
+
+			case BINARY_VALUE_BOOL:
+			{
+				uint8_t b;
+
+				if (!binary_read_uint8(&scan, &b))
+				{
+					return false;
+				}
+				break;
+			}
+
+			case BINARY_VALUE_INT8:
+			case BINARY_VALUE_FLOAT8:
+			{
+				uint64_t u;
+
+				if (!binary_read_uint64(&scan, &u))
+				{
+					return false;
+				}
+
+				++numericCount;
+				break;
+			}
+
+			case BINARY_VALUE_TEXT:
+			{
+				char *str;
+
+				if (!binary_read_string(&scan, &str))
+				{
+					return false;
+				}
+				break;
+			}
+
+			default:
+			{
+				log_error("Unknown binary parameter type %d", type);
+				return false;
+			}
+		}
+	}
+
+	size_t bytes =
+		count * sizeof(char *) + numericCount * BINARY_NUMERIC_TEXT_LEN;
+
+	const char **paramValues = (const char **) calloc(1, bytes);
+
+	if (paramValues == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	char *numeric = (char *) (paramValues + count);
+
+	/* second pass to fill-in the parameter values */
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint8_t type = 0;
+
+		(void) binary_read_uint8(cursor, &type);
+
+		switch (type)
+		{
+			case BINARY_VALUE_NULL:
+			{
+				paramValues[i] = NULL;
+				break;
+			}
+
+			case BINARY_VALUE_BOOL:
+			{
+				uint8_t b = 0;
+
+				(void) binary_read_uint8(cursor, &b);
+
+				paramValues[i] = b ? "t" : "f";
+				break;
+			}
+
+			case BINARY_VALUE_INT8:
+			{
+				uint64_t u = 0;
+
+				(void) binary_read_uint64(cursor, &u);
+
+				sformat(numeric, BINARY_NUMERIC_TEXT_LEN, "%lld",
+						(long long) (int64_t) u);
+
+				paramValues[i] = numeric;
+				numeric += BINARY_NUMERIC_TEXT_LEN;
+				break;
+			}
+
+			case BINARY_VALUE_FLOAT8:
+			{
+				uint64_t u = 0;
+				double d = 0;
+
+				(void) binary_read_uint64(cursor, &u);
+				memcpy(&d, &u, sizeof(d));
+
+				(void) stream_float8_to_string(d, numeric,
+											   BINARY_NUMERIC_TEXT_LEN);
+
+				paramValues[i] = numeric;
+				numeric += BINARY_NUMERIC_TEXT_LEN;
+				break;
+			}
+
+			case BINARY_VALUE_TEXT:
+			{
+				char *str = NULL;
+
+				(void) binary_read_string(cursor, &str);
+
+				paramValues[i] = str;
+				break;
+			}
+		}
+	}
+
+	metadata->paramCount = count;
+	metadata->paramValues = paramValues;
+
+	return true;
+}
+
+
+/*
+ * binary_append_value appends a typed parameter value to the buffer.
+ */
+static bool
+binary_append_value(PQExpBuffer buf, LogicalMessageValue *value)
+{
+	if (value == NULL)
+	{
+		log_error("BUG: binary_append_value value is NULL");
+		return false;
+	}
+
+	if (value->isNull)
+	{
+		binary_append_uint8(buf, BINARY_VALUE_NULL);
+		return true;
+	}
+
+	switch (value->oid)
+	{
+		case BOOLOID:
+		{
+			binary_append_uint8(buf, BINARY_VALUE_BOOL);
+			binary_append_uint8(buf, value->val.boolean ? 1 : 0);
+			break;
+		}
+
+		case INT8OID:
+		{
+			binary_append_uint8(buf, BINARY_VALUE_INT8);
+			binary_append_uint64(buf, value->val.int8);
+			break;
+		}
+
+		case FLOAT8OID:
+		{
+			uint64_t u = 0;
+
+			memcpy(&u, &(value->val.float8), sizeof(u));
+
+			binary_append_uint8(buf, BINARY_VALUE_FLOAT8);
+			binary_append_uint64(buf, u);
+			break;
+		}
+
+		case TEXTOID:
+		case BYTEAOID:
+		{
+			binary_append_uint8(buf, BINARY_VALUE_TEXT);
+			binary_append_string(buf, value->val.str);
+			break;
+		}
+
+		default:
+		{
+			log_error("BUG: binary_append_value value with oid %d",
+					  value->oid);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ * binary_write_record writes a record with the given type and payload.
+ */
+static bool
+binary_write_record(FILE *out, StreamAction action, PQExpBuffer buf)
+{
+	if (PQExpBufferBroken(buf))
+	{
+		log_error("Failed to prepare binary record %c: Out of Memory", action);
+		return false;
+	}
+
+	PQExpBuffer header = createPQExpBuffer();
+
+	binary_append_uint8(header, (uint8_t) action);
+	binary_append_uint32(header, (uint32_t) buf->len);
+
+	if (PQExpBufferBroken(header))
+	{
+		log_error("Failed to prepare binary record %c: Out of Memory", action);
+		destroyPQExpBuffer(header);
+		return false;
+	}
+
+	if (fwrite(header->data, sizeof(char), header->len, out) != header->len ||
+		fwrite(buf->data, sizeof(char), buf->len, out) != buf->len)
+	{
+		log_error("Failed to write to stream: %m");
+		destroyPQExpBuffer(header);
+		return false;
+	}
+
+	destroyPQExpBuffer(header);
+
+	return true;
+}
+
+
+/*
+ * binary_append_uint8 appends a single byte to the buffer.
+ */
+static void
+binary_append_uint8(PQExpBuffer buf, uint8_t value)
+{
+	appendBinaryPQExpBuffer(buf, (const char *) &value, 1);
+}
+
+
+/*
+ * binary_append_uint32 appends a 4-bytes integer in network byte order.
+ */
+static void
+binary_append_uint32(PQExpBuffer buf, uint32_t value)
+{
+	unsigned char bytes[4];
+
+	for (int i = 0; i < 4; i++)
+	{
+		bytes[i] = (value >> (8 * (3 - i))) & 0xFF;
+	}
+
+	appendBinaryPQExpBuffer(buf, (const char *) bytes, sizeof(bytes));
+}
+
+
+/*
+ * binary_append_uint64 appends an 8-bytes integer in network byte order.
+ */
+static void
+binary_append_uint64(PQExpBuffer buf, uint64_t value)
+{
+	unsigned char bytes[8];
+
+	for (int i = 0; i < 8; i++)
+	{
+		bytes[i] = (value >> (8 * (7 - i))) & 0xFF;
+	}
+
+	appendBinaryPQExpBuffer(buf, (const char *) bytes, sizeof(bytes));
+}
+
+
+/*
+ * binary_append_string appends a length, the string, and a zero byte.
+ */
+static void
+binary_append_string(PQExpBuffer buf, const char *str)
+{
+	uint32_t len = str == NULL ? 0 : strlen(str);
+
+	binary_append_uint32(buf, len);
+
+	if (len > 0)
+	{
+		appendBinaryPQExpBuffer(buf, str, len);
+	}
+
+	binary_append_uint8(buf, 0);
+}
+
+
+/*
+ * binary_read_uint8 reads a single byte from the cursor.
+ */
+static bool
+binary_read_uint8(BinaryCursor *cursor, uint8_t *value)
+{
+	if (cursor->size < cursor->pos + 1)
+	{
+		log_error("Failed to read 1 byte at position %lld of a %lld bytes "
+				  "binary record",
+				  (long long) cursor->pos,
+				  (long long) cursor->size);
+		return false;
+	}
+
+	*value = (uint8_t) cursor->data[cursor->pos++];
+
+	return true;
+}
+
+
+/*
+ * binary_read_uint32 reads a 4-bytes integer in network byte order.
+ */
+static bool
+binary_read_uint32(BinaryCursor *cursor, uint32_t *value)
+{
+	if (cursor->size < cursor->pos + 4)
+	{
+		log_error("Failed to read 4 bytes at position %lld of a %lld bytes "
+				  "binary record",
+				  (long long) cursor->pos,
+				  (long long) cursor->size);
+		return false;
+	}
+
+	unsigned char *bytes = (unsigned char *) cursor->data + cursor->pos;
+
+	*value = 0;
+
+	for (int i = 0; i < 4; i++)
+	{
+		*value = (*value << 8) | bytes[i];
+	}
+
+	cursor->pos += 4;
+
+	return true;
+}
+
+
+/*
+ * binary_read_uint64 reads an 8-bytes integer in network byte order.
+ */
+static bool
+binary_read_uint64(BinaryCursor *cursor, uint64_t *value)
+{
+	if (cursor->size < cursor->pos + 8)
+	{
+		log_error("Failed to read 8 bytes at position %lld of a %lld bytes "
+				  "binary record",
+				  (long long) cursor->pos,
+				  (long long) cursor->size);
+		return false;
+	}
+
+	unsigned char *bytes = (unsigned char *) cursor->data + cursor->pos;
+
+	*value = 0;
+
+	for (int i = 0; i < 8; i++)
+	{
+		*value = (*value << 8) | bytes[i];
+	}
+
+	cursor->pos += 8;
+
+	return true;
+}
+
+
+/*
+ * binary_read_string reads a string from the cursor, and points to it in the
+ * record itself.
+ */
+static bool
+binary_read_string(BinaryCursor *cursor, char **str)
+{
+	uint32_t len = 0;
+
+	if (!binary_read_uint32(cursor, &len))
+	{
+		return false;
+	}
+
+	if (cursor->size < cursor->pos + len + 1 ||
+		cursor->data[cursor->pos + len] != '\0')
+	{
+		log_error("Failed to read a string of %u bytes at position %lld of "
+				  "a %lld bytes binary record",
+				  len,
+				  (long long) cursor->pos,
+				  (long long) cursor->size);
+		return false;
+	}
+
+	*str = cursor->data + cursor->pos;
+	cursor->pos += len + 1;
+
+	return true;
+}
+
+
+/*
+ * binary_read_timestamp reads a timestamp string into the metadata.
+ */
+static bool
+binary_read_timestamp(BinaryCursor *cursor, LogicalMessageMetadata *metadata)
+{
+	char *timestamp = NULL;
+
+	if (!binary_read_string(cursor, &timestamp))
+	{
+		return false;
+	}
+
+	strlcpy(metadata->timestamp, timestamp, sizeof(metadata->timestamp));
+
+	return true;
+}
@@ -72,6 +72,7 @@ stream_apply_replay(StreamSpecs *specs)
 	 */
 	ReadFromStreamContext readerContext = {
 		.callback = stream_replay_line,
+		.idleCallback = stream_replay_idle,
 		.ctx = &ctx
 	};
 
@@ -82,6 +83,14 @@ stream_apply_replay(StreamSpecs *specs)
 		return false;
 	}
 
+	/* commit what has been sent to the target database so far */
+	if (!stream_apply_sync_pipeline(context))
+	{
+		log_error("Failed to sync the pipeline, see previous error for "
+				  "details");
+		return false;
+	}
+
 	/* make sure to send a last round of sentinel update before exit */
 	bool findDurableLSN = true;
 
@@ -181,7 +190,7 @@ stream_replay_line(void *ctx, const char *line, bool *stop)
 			/* rate limit to 1 pipeline sync per seconds */
 			if (1 < (now - context->applyPgConn.pipelineSyncTime))
 			{
-				if (!pgsql_sync_pipeline(&(context->applyPgConn)))
+				if (!stream_apply_sync_pipeline(context))
 				{
 					log_error("Failed to sync the pipeline, see previous "
 							  "error for details");
@@ -245,7 +254,7 @@ stream_replay_line(void *ctx, const char *line, bool *stop)
 
 	if (*stop)
 	{
-		if (!pgsql_sync_pipeline(&(context->applyPgConn)))
+		if (!stream_apply_sync_pipeline(context))
 		{
 			log_error("Failed to sync the pipeline, see previous error for "
 					  "details");
@@ -255,3 +264,48 @@ stream_replay_line(void *ctx, const char *line, bool *stop)
 
 	return true;
 }
+
+
+/*
+ * stream_replay_idle is an idle callback function for the
+ * ReadFromStreamContext and read_from_stream infrastructure. It's called when
+ * the input stream has had no data for a while.
+ *
+ * In the main loop the pipeline is only synced once per second, at COMMIT or
+ * KEEPALIVE time. When the source database is mostly idle, the last
+ * transactions received would then wait in the pipeline until the next
+ * KEEPALIVE message, which only comes at the next receive flush or server
+ * keepalive, seconds later. Sync the pipeline now instead, so that the replay
+ * lag stays under a second.
+ */
+bool
+stream_replay_idle(void *ctx)
+{
+	ReplayStreamCtx *replayCtx = (ReplayStreamCtx *) ctx;
+	StreamApplyContext *context = &(replayCtx->applyContext);
+
+	if (context->previousLSN == context->syncedLSN)
+	{
+		return true;
+	}
+
+	log_debug("stream_replay_idle: sync pipeline at %X/%X",
+			  LSN_FORMAT_ARGS(context->previousLSN));
+
+	if (!stream_apply_sync_pipeline(context))
+	{
+		log_error("Failed to sync the pipeline, see previous error for "
+				  "details");
+		return false;
+	}
+
+	bool findDurableLSN = true;
+
+	if (!stream_apply_sync_sentinel(context, findDurableLSN))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
@@ -362,6 +362,8 @@ stream_init_context(StreamSpecs *specs)
 
 	privateContext->connStrings = specs->connStrings;
 
+	privateContext->format = specs->transformFormat;
+
 	/*
 	 * When using PIPEs for inter-process communication, makes sure the PIPEs
 	 * are ready for us to use and not broken, as in EBADF.
@@ -2495,6 +2497,17 @@ stream_cleanup_databases(CopyDataSpec *copySpecs, char *slotName, char *origin)
 		return false;
 	}
 
+	/* also drop the replication origins used with --apply-jobs */
+	char prefix[BUFSIZE] = { 0 };
+
+	sformat(prefix, sizeof(prefix), "%s%s", origin, APPLY_WORKER_ORIGIN_SUFFIX);
+
+	if (!pgsql_replication_origin_drop_prefix(&dst, prefix))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
 	return true;
 }
 
@@ -32,6 +32,14 @@
 #define UPDATE "AS UPDATE "
 #define DELETE "AS DELETE "
 
+/*
+ * With --transform-format binary, the transformed files begin with this
+ * signature followed by a format version number, see ld_binary.c.
+ */
+#define STREAM_BINARY_SIGNATURE "PGCOPYDB\n\377\r\n"
+#define STREAM_BINARY_SIGNATURE_LEN 12
+#define STREAM_BINARY_VERSION 1
+
 typedef enum
 {
 	STREAM_ACTION_UNKNOWN = 0,
@@ -92,6 +100,11 @@ typedef struct LogicalMessageMetadata
 
 	/* the raw message in our internal JSON format */
 	char *jsonBuffer;           /* malloc'ed area */
+
+	/* EXECUTE parameters when reading the binary format */
+	bool binaryParams;
+	int paramCount;
+	const char **paramValues;   /* malloc'ed area, NULL when no parameters */
 } LogicalMessageMetadata;
 
 
@@ -346,6 +359,30 @@ typedef struct MatViewCache
 } MatViewCache;
 
 
+/*
+ * The binary format defines each statement only once per file, then refers to
+ * it by its hash: keep track of the statements already defined.
+ */
+typedef struct StreamBinaryStmt
+{
+	uint32_t hash;
+
+	UT_hash_handle hh;          /* makes this structure hashable */
+} StreamBinaryStmt;
+
+
+/*
+ * StreamOutput is where the transform process writes to, either SQL text or
+ * our binary format.
+ */
+typedef struct StreamOutput
+{
+	FILE *out;
+	StreamTransformFormat format;
+	StreamBinaryStmt **stmts;   /* hash table of the binary format */
+} StreamOutput;
+
+
 /*
  * StreamContext allows tracking the progress of the ld_stream module and is
  * shared also with the ld_transform module, which has its own instance of a
@@ -402,6 +439,13 @@ typedef struct StreamContext
 	FILE *jsonFile;
 	FILE *sqlFile;
 
+	StreamTransformFormat format;           /* --transform-format */
+	StreamTransformFormat sqlFileFormat;    /* format of the sqlFile */
+	StreamBinaryStmt *binaryStmts;          /* statements defined in sqlFile */
+
+	/* COMMIT LSN of continued transactions, registered in batches */
+	TxnCommitLSNBatch txnCommitLSNs;
+
 	StreamCounters counters;
 
 	bool transactionInProgress;
@@ -438,6 +482,80 @@ typedef struct LSNTracking
 	struct LSNTracking *previous;
 } LSNTracking;
 
+/*
+ * With --apply-jobs, transactions are dispatched to several apply worker
+ * connections to the target database, see ld_apply_parallel.c.
+ */
+#define APPLY_WORKER_ORIGIN_SUFFIX "_apply_"
+
+typedef enum
+{
+	APPLY_WORKER_IDLE = 0,
+	APPLY_WORKER_OPEN,          /* transaction statements are being sent */
+	APPLY_WORKER_READY          /* transaction is waiting for its COMMIT */
+} ApplyWorkerState;
+
+typedef struct ApplyWorker
+{
+	int id;
+	char origin[BUFSIZE];
+	PGSQL pgsql;
+	ApplyWorkerState state;
+
+	PreparedStmt *preparedStmt;
+	uint64_t pipelineBytes;
+
+	uint64_t seq;               /* dispatch order of the current transaction */
+	uint32_t xid;
+	uint64_t commitLSN;
+	char timestamp[PG_MAX_TIMESTAMP];
+
+	uint64_t replayLSN;         /* last COMMIT LSN applied by this worker */
+	uint64_t txnCount;
+	uint64_t waitCount;
+} ApplyWorker;
+
+/*
+ * Track which transaction touched a table last, as a transaction that
+ * touches the same table must wait until that one has been committed.
+ */
+typedef struct ApplyTableTracking
+{
+	char qname[PG_NAMEDATALEN_FQ];
+	uint64_t seq;
+
+	UT_hash_handle hh;          /* makes this structure hashable */
+} ApplyTableTracking;
+
+/*
+ * Tables that are linked by a foreign key share the same conflict key, the
+ * qname of the group: a transaction that inserts a row must wait until the
+ * transaction that inserted the referenced row has been committed.
+ */
+typedef struct ApplyTableGroup
+{
+	char qname[PG_NAMEDATALEN_FQ];
+	char group[PG_NAMEDATALEN_FQ];
+
+	UT_hash_handle hh;          /* makes this structure hashable */
+} ApplyTableGroup;
+
+typedef struct StreamApplyParallel
+{
+	int count;
+	ApplyWorker *workers;       /* malloc'ed area */
+	ApplyWorker *current;       /* worker of the transaction being read */
+
+	uint64_t lastSeq;           /* last dispatched transaction */
+	uint64_t committedSeq;      /* last committed transaction */
+	uint64_t barrierSeq;        /* transaction that must commit alone */
+	bool sentinelReset;
+
+	ApplyTableTracking *tables;
+	ApplyTableGroup *groups;
+} StreamApplyParallel;
+
+
 /*
  * StreamApplyContext allows tracking the apply progress.
  */
@@ -462,6 +580,7 @@ typedef struct StreamApplyContext
 	uint32_t WalSegSz;          /* information about source database */
 
 	uint64_t previousLSN;       /* register COMMIT LSN progress */
+	uint64_t syncedLSN;         /* previousLSN at the last pipeline sync */
 	uint64_t switchLSN;         /* helps to find the next .sql file to apply */
 
 	LSNTracking *lsnTrackingList;
@@ -486,6 +605,9 @@ typedef struct StreamApplyContext
 	SourceFilters *filters;     /* table filtering configuration */
 
 	uint64_t pipelineBytes;     /* accumulated bytes in pipeline buffer */
+
+	int applyJobs;              /* --apply-jobs */
+	StreamApplyParallel *parallel;
 } StreamApplyContext;
 
 
@@ -543,6 +665,9 @@ struct StreamSpecs
 	bool resume;
 	bool logSQL;
 
+	int applyJobs;
+	StreamTransformFormat transformFormat;
+
 	/* subprocess management */
 	FollowSubProcess prefetch;
 	FollowSubProcess transform;
@@ -688,25 +813,30 @@ bool stream_transform_file(StreamSpecs *specs,
 
 bool stream_transform_file_at_lsn(StreamSpecs *specs, uint64_t lsn);
 
-bool stream_write_message(FILE *out, LogicalMessage *msg);
-bool stream_write_transaction(FILE *out, LogicalTransaction *tx);
+bool stream_write_message(StreamOutput *output, LogicalMessage *msg);
+bool stream_write_transaction(StreamOutput *output, LogicalTransaction *tx);
 
-bool stream_write_switchwal(FILE *out, LogicalMessageSwitchWAL *switchwal);
-bool stream_write_keepalive(FILE *out, LogicalMessageKeepalive *keepalive);
-bool stream_write_endpos(FILE *out, LogicalMessageEndpos *endpos);
+bool stream_write_switchwal(StreamOutput *output,
+							LogicalMessageSwitchWAL *switchwal);
+bool stream_write_keepalive(StreamOutput *output,
+							LogicalMessageKeepalive *keepalive);
+bool stream_write_endpos(StreamOutput *output, LogicalMessageEndpos *endpos);
 
-bool stream_write_begin(FILE *out, LogicalTransaction *tx);
-bool stream_write_commit(FILE *out, LogicalTransaction *tx);
-bool stream_write_rollback(FILE *out, LogicalTransaction *tx);
+bool stream_write_begin(StreamOutput *output, LogicalTransaction *tx);
+bool stream_write_commit(StreamOutput *output, LogicalTransaction *tx);
+bool stream_write_rollback(StreamOutput *output, LogicalTransaction *tx);
 
-bool stream_write_insert(FILE *out, LogicalMessageInsert *insert);
-bool stream_write_truncate(FILE *out, LogicalMessageTruncate *truncate);
-bool stream_write_update(FILE *out, LogicalMessageUpdate *update);
-bool stream_write_delete(FILE * out, LogicalMessageDelete *delete);
+bool stream_write_insert(StreamOutput *output, LogicalMessageInsert *insert);
+bool stream_write_truncate(StreamOutput *output,
+						   LogicalMessageTruncate *truncate);
+bool stream_write_update(StreamOutput *output, LogicalMessageUpdate *update);
+bool stream_write_delete(StreamOutput *output, LogicalMessageDelete *delete);
 
 bool stream_add_value_in_json_array(LogicalMessageValue *value,
 									JSON_Array *jsArray);
 
+void stream_float8_to_string(double value, char *str, size_t size);
+
 
 bool parseMessage(StreamContext *privateContext, char *message, JSON_Value *json);
 
@@ -715,6 +845,36 @@ bool streamLogicalTransactionAppendStatement(LogicalTransaction *txn,
 
 bool AllocateLogicalMessageTuple(LogicalMessageTuple *tuple, int count);
 
+/* ld_binary.c */
+bool stream_binary_write_header(FILE *out);
+
+bool stream_binary_write_begin(FILE *out, LogicalTransaction *txn);
+bool stream_binary_write_commit(FILE *out, LogicalTransaction *txn);
+bool stream_binary_write_rollback(FILE *out, LogicalTransaction *txn);
+bool stream_binary_write_lsn(FILE *out, StreamAction action, uint64_t lsn);
+bool stream_binary_write_keepalive(FILE *out,
+								   LogicalMessageKeepalive *keepalive);
+bool stream_binary_write_truncate(FILE *out, const char *sql);
+
+bool stream_binary_write_statement(StreamOutput *output,
+								   StreamAction action,
+								   uint32_t hash,
+								   const char *sql,
+								   LogicalMessageValue **values,
+								   int count);
+
+bool stream_binary_file_format(const char *filename,
+							   StreamTransformFormat *format);
+bool stream_binary_has_signature(const char *buffer, long size);
+
+bool stream_binary_parse_buffer(char *buffer, long size,
+								SourceFilters *filters,
+								LogicalMessageMetadata **messages,
+								uint64_t *count);
+
+void stream_binary_free_messages(LogicalMessageMetadata *messages,
+								 uint64_t count);
+
 /* ld_test_decoding.c */
 bool prepareTestDecodingMessage(LogicalStreamContext *context);
 
@@ -761,19 +921,44 @@ bool stream_apply_init_context(StreamApplyContext *context,
 							   SourceFilters *filters);
 
 bool setupReplicationOrigin(StreamApplyContext *context);
+bool setupConnection(PGSQL *pgsql, StreamApplyContext *context);
+
+bool stream_apply_sync_pipeline(StreamApplyContext *context);
 
 bool computeSQLFileName(StreamApplyContext *context);
 
 bool parseSQLAction(const char *query, LogicalMessageMetadata *metadata,
 					SourceFilters *filters);
 
+bool shouldFilterOutStatement(const char *stmt, SourceFilters *filters);
+
 bool stream_apply_find_durable_lsn(StreamApplyContext *context,
 								   uint64_t *durableLSN);
 
 
+/* ld_apply_parallel.c */
+bool stream_apply_parallel_setup(StreamApplyContext *context);
+void stream_apply_parallel_cleanup(StreamApplyContext *context);
+
+bool stream_apply_parallel_begin(StreamApplyContext *context,
+								 LogicalMessageMetadata *metadata);
+bool stream_apply_parallel_commit(StreamApplyContext *context,
+								  LogicalMessageMetadata *metadata);
+void stream_apply_parallel_release(StreamApplyContext *context);
+
+bool stream_apply_parallel_track_table(StreamApplyContext *context,
+									   const char *nspname,
+									   const char *relname);
+bool stream_apply_parallel_barrier(StreamApplyContext *context);
+
+bool stream_apply_parallel_drain(StreamApplyContext *context);
+bool stream_apply_parallel_sync_sentinel(StreamApplyContext *context);
+
+
 /* ld_replay */
 bool stream_apply_replay(StreamSpecs *specs);
 bool stream_replay_line(void *ctx, const char *line, bool *stop);
+bool stream_replay_idle(void *ctx);
 bool stream_replay_reached_endpos(StreamSpecs *specs,
 								  StreamApplyContext *context,
 								  bool stop);
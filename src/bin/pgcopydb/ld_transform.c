@@ -77,6 +77,33 @@ static bool prepareMatViewCache_hook(void *ctx, CatalogMatView *matview);
 
 static bool prepareMatViewCache(StreamSpecs *specs);
 
+static bool stream_transform_open_output(StreamContext *privateContext,
+										 const char *filename,
+										 bool append);
+
+static bool stream_transform_add_txn_commit_lsn(StreamContext *privateContext,
+												LogicalTransaction *txn,
+												uint64_t commitLSN);
+static bool stream_transform_flush_txn_commit_lsn(StreamContext *privateContext);
+
+/*
+ * The parameters of a statement, collected while writing its SQL text.
+ */
+typedef struct StatementParams
+{
+	int count;
+	int capacity;
+	LogicalMessageValue **array; /* malloc'ed area */
+} StatementParams;
+
+static bool stream_params_append(StatementParams *params,
+								 LogicalMessageValue *value);
+
+static bool stream_write_statement(StreamOutput *output,
+								   StreamAction action,
+								   PQExpBuffer sql,
+								   StatementParams *params);
+
 /*
  * stream_transform_context_init initializes StreamContext for the transform
  * operation.
@@ -203,6 +230,12 @@ stream_transform_stream_internal(StreamSpecs *specs)
 		return false;
 	}
 
+	if (!stream_transform_flush_txn_commit_lsn(privateContext))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
 	/* we might have stopped reading mid-file, let's close it. */
 	if (privateContext->sqlFile != NULL)
 	{
@@ -498,10 +531,15 @@ stream_transform_write_message(StreamContext *privateContext,
 		}
 	}
 
-	/* now write the transaction out */
+	/* now write the transaction out, Unix PIPEs always use SQL text */
 	if (privateContext->out != NULL)
 	{
-		if (!stream_write_message(privateContext->out, currentMsg))
+		StreamOutput output = {
+			.out = privateContext->out,
+			.format = STREAM_FORMAT_SQL
+		};
+
+		if (!stream_write_message(&output, currentMsg))
 		{
 			/* errors have already been logged */
 			return false;
@@ -509,12 +547,33 @@ stream_transform_write_message(StreamContext *privateContext,
 	}
 
 	/* now write the transaction out also to file on-disk */
-	if (!stream_write_message(privateContext->sqlFile, currentMsg))
+	StreamOutput fileOutput = {
+		.out = privateContext->sqlFile,
+		.format = privateContext->sqlFileFormat,
+		.stmts = &(privateContext->binaryStmts)
+	};
+
+	if (!stream_write_message(&fileOutput, currentMsg))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
+	/*
+	 * The BEGIN message of a continued transaction has been written before
+	 * its COMMIT LSN was known, register it for the apply process.
+	 */
+	if (metadata->action == STREAM_ACTION_COMMIT && txn->continued)
+	{
+		if (!stream_transform_add_txn_commit_lsn(privateContext,
+												 txn,
+												 metadata->lsn))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
 	if (metadata->action == STREAM_ACTION_COMMIT ||
 		metadata->action == STREAM_ACTION_ROLLBACK)
 	{
@@ -558,6 +617,78 @@ stream_transform_write_message(StreamContext *privateContext,
 }
 
 
+/*
+ * stream_transform_add_txn_commit_lsn adds the COMMIT LSN of the given
+ * continued transaction to the current batch, and flushes the batch to our
+ * catalogs when it is full.
+ */
+static bool
+stream_transform_add_txn_commit_lsn(StreamContext *privateContext,
+									LogicalTransaction *txn,
+									uint64_t commitLSN)
+{
+	TxnCommitLSNBatch *batch = &(privateContext->txnCommitLSNs);
+
+	if (batch->count == TXN_COMMIT_LSN_BATCH_SIZE)
+	{
+		if (!stream_transform_flush_txn_commit_lsn(privateContext))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	TxnCommitLSN *entry = &(batch->array[batch->count++]);
+
+	entry->xid = txn->xid;
+	entry->commitLSN = commitLSN;
+
+	log_debug("stream_transform_add_txn_commit_lsn: transaction %u "
+			  "COMMIT LSN %X/%X",
+			  entry->xid,
+			  LSN_FORMAT_ARGS(entry->commitLSN));
+
+	return true;
+}
+
+
+/*
+ * stream_transform_flush_txn_commit_lsn registers the current batch of
+ * continued transactions COMMIT LSN to our catalogs.
+ */
+static bool
+stream_transform_flush_txn_commit_lsn(StreamContext *privateContext)
+{
+	TxnCommitLSNBatch *batch = &(privateContext->txnCommitLSNs);
+	DatabaseCatalog *sourceDB = privateContext->sourceDB;
+
+	if (batch->count == 0)
+	{
+		return true;
+	}
+
+	/* the apply process also registers continued transactions at COMMIT */
+	if (sourceDB == NULL || sourceDB->db == NULL)
+	{
+		log_debug("stream_transform_flush_txn_commit_lsn: no catalog, "
+				  "skipping %d transactions",
+				  batch->count);
+		batch->count = 0;
+		return true;
+	}
+
+	if (!sentinel_add_txn_commit_lsn_batch(sourceDB, batch))
+	{
+		log_error("Failed to register the COMMIT LSN of %d transactions, "
+				  "see above for details",
+				  batch->count);
+		return false;
+	}
+
+	return true;
+}
+
+
 /*
  * stream_transform_message transforms a single JSON message from our streaming
  * output into a SQL statement, and appends it to the given opened transaction.
@@ -636,6 +767,12 @@ stream_transform_rotate(StreamContext *privateContext)
 		return false;
 	}
 
+	if (!stream_transform_flush_txn_commit_lsn(privateContext))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
 	/* if we had a SQL file opened, close it now */
 	if (!IS_EMPTY_STRING_BUFFER(privateContext->sqlFileName) &&
 		privateContext->sqlFile != NULL)
@@ -659,16 +796,96 @@ stream_transform_rotate(StreamContext *privateContext)
 	strlcpy(privateContext->walFileName, jsonFileName, MAXPGPATH);
 	strlcpy(privateContext->sqlFileName, sqlFileName, MAXPGPATH);
 
-	privateContext->sqlFile =
-		fopen_with_umask(sqlFileName, "ab", FOPEN_FLAGS_A, 0644);
+	bool append = true;
+
+	if (!stream_transform_open_output(privateContext, sqlFileName, append))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * stream_transform_open_output opens the file where the transform process
+ * writes the SQL commands, or their binary format.
+ *
+ * When appending to an existing file, we keep using the format of that file,
+ * which might have been created with another --transform-format.
+ */
+static bool
+stream_transform_open_output(StreamContext *privateContext,
+							 const char *filename,
+							 bool append)
+{
+	/* statements are defined again in each binary file */
+	StreamBinaryStmt *current, *tmp;
+
+	HASH_ITER(hh, privateContext->binaryStmts, current, tmp)
+	{
+		HASH_DEL(privateContext->binaryStmts, current);
+		free(current);
+	}
+
+	bool newFile = true;
+
+	privateContext->sqlFileFormat = privateContext->format;
+
+	if (append && file_exists(filename))
+	{
+		StreamTransformFormat format = STREAM_FORMAT_UNKNOWN;
+
+		if (!stream_binary_file_format(filename, &format))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		/* an empty file is the same as a new file */
+		if (format != STREAM_FORMAT_UNKNOWN)
+		{
+			newFile = false;
+
+			if (format != privateContext->format)
+			{
+				log_notice("Appending to file \"%s\" using the %s format",
+						   filename,
+						   TransformFormatToString(format));
+			}
+
+			privateContext->sqlFileFormat = format;
+		}
+	}
+
+	if (append)
+	{
+		privateContext->sqlFile =
+			fopen_with_umask(filename, "ab", FOPEN_FLAGS_A, 0644);
+	}
+	else
+	{
+		privateContext->sqlFile =
+			fopen_with_umask(filename, "w", FOPEN_FLAGS_W, 0644);
+	}
 
 	if (privateContext->sqlFile == NULL)
 	{
 		/* errors have already been logged */
-		log_error("Failed to open file \"%s\": %m", sqlFileName);
+		log_error("Failed to open file \"%s\": %m", filename);
 		return false;
 	}
 
+	if (newFile && privateContext->sqlFileFormat == STREAM_FORMAT_BINARY)
+	{
+		if (!stream_binary_write_header(privateContext->sqlFile))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
 	return true;
 }
 
@@ -990,12 +1207,11 @@ stream_transform_file(StreamSpecs *specs, char *jsonfilename, char *sqlfilename)
 
 	sformat(tempfilename, sizeof(tempfilename), "%s.partial", sqlfilename);
 
-	privateContext->sqlFile =
-		fopen_with_umask(tempfilename, "w", FOPEN_FLAGS_W, 0644);
+	bool append = false;
 
-	if (privateContext->sqlFile == NULL)
+	if (!stream_transform_open_output(privateContext, tempfilename, append))
 	{
-		log_error("Failed to open file \"%s\"", tempfilename);
+		/* errors have already been logged */
 		return false;
 	}
 
@@ -1088,6 +1304,13 @@ stream_transform_file(StreamSpecs *specs, char *jsonfilename, char *sqlfilename)
 		}
 	}
 
+	/* register COMMIT LSNs before the apply process can see the file */
+	if (!stream_transform_flush_txn_commit_lsn(privateContext))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
 	if (fclose(privateContext->sqlFile) == EOF)
 	{
 		log_error("Failed to close file \"%s\"", tempfilename);
@@ -1771,11 +1994,11 @@ AllocateLogicalMessageTuple(LogicalMessageTuple *tuple, int count)
  * already open out stream.
  */
 bool
-stream_write_message(FILE *out, LogicalMessage *msg)
+stream_write_message(StreamOutput *output, LogicalMessage *msg)
 {
 	if (msg->isTransaction)
 	{
-		return stream_write_transaction(out, &(msg->command.tx));
+		return stream_write_transaction(output, &(msg->command.tx));
 	}
 	else
 	{
@@ -1783,7 +2006,7 @@ stream_write_message(FILE *out, LogicalMessage *msg)
 		{
 			case STREAM_ACTION_SWITCH:
 			{
-				if (!stream_write_switchwal(out, &(msg->command.switchwal)))
+				if (!stream_write_switchwal(output, &(msg->command.switchwal)))
 				{
 					return false;
 				}
@@ -1792,7 +2015,7 @@ stream_write_message(FILE *out, LogicalMessage *msg)
 
 			case STREAM_ACTION_KEEPALIVE:
 			{
-				if (!stream_write_keepalive(out, &(msg->command.keepalive)))
+				if (!stream_write_keepalive(output, &(msg->command.keepalive)))
 				{
 					return false;
 				}
@@ -1801,7 +2024,7 @@ stream_write_message(FILE *out, LogicalMessage *msg)
 
 			case STREAM_ACTION_ENDPOS:
 			{
-				if (!stream_write_endpos(out, &(msg->command.endpos)))
+				if (!stream_write_endpos(output, &(msg->command.endpos)))
 				{
 					return false;
 				}
@@ -1826,7 +2049,7 @@ stream_write_message(FILE *out, LogicalMessage *msg)
  * the already open out stream.
  */
 bool
-stream_write_transaction(FILE *out, LogicalTransaction *txn)
+stream_write_transaction(StreamOutput *output, LogicalTransaction *txn)
 {
 	/*
 	 * Logical decoding also outputs empty transactions that act here kind of
@@ -1836,12 +2059,12 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
 	 */
 	if (!txn->continued && txn->count == 0)
 	{
-		if (!stream_write_begin(out, txn))
+		if (!stream_write_begin(output, txn))
 		{
 			return false;
 		}
 
-		if (!stream_write_commit(out, txn))
+		if (!stream_write_commit(output, txn))
 		{
 			return false;
 		}
@@ -1872,7 +2095,7 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
 					splitTx = true;
 				}
 
-				if (!stream_write_switchwal(out, &(currentStmt->stmt.switchwal)))
+				if (!stream_write_switchwal(output, &(currentStmt->stmt.switchwal)))
 				{
 					return false;
 				}
@@ -1886,7 +2109,7 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
 					splitTx = true;
 				}
 
-				if (!stream_write_keepalive(out, &(currentStmt->stmt.keepalive)))
+				if (!stream_write_keepalive(output, &(currentStmt->stmt.keepalive)))
 				{
 					return false;
 				}
@@ -1900,7 +2123,7 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
 					splitTx = true;
 				}
 
-				if (!stream_write_endpos(out, &(currentStmt->stmt.endpos)))
+				if (!stream_write_endpos(output, &(currentStmt->stmt.endpos)))
 				{
 					return false;
 				}
@@ -1911,14 +2134,14 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
 			{
 				if (!sentBEGIN && !txn->continued)
 				{
-					if (!stream_write_begin(out, txn))
+					if (!stream_write_begin(output, txn))
 					{
 						return false;
 					}
 					sentBEGIN = true;
 				}
 
-				if (!stream_write_insert(out, &(currentStmt->stmt.insert)))
+				if (!stream_write_insert(output, &(currentStmt->stmt.insert)))
 				{
 					return false;
 				}
@@ -1930,14 +2153,14 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
 			{
 				if (!sentBEGIN && !txn->continued)
 				{
-					if (!stream_write_begin(out, txn))
+					if (!stream_write_begin(output, txn))
 					{
 						return false;
 					}
 					sentBEGIN = true;
 				}
 
-				if (!stream_write_update(out, &(currentStmt->stmt.update)))
+				if (!stream_write_update(output, &(currentStmt->stmt.update)))
 				{
 					return false;
 				}
@@ -1948,14 +2171,14 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
 			{
 				if (!sentBEGIN && !txn->continued)
 				{
-					if (!stream_write_begin(out, txn))
+					if (!stream_write_begin(output, txn))
 					{
 						return false;
 					}
 					sentBEGIN = true;
 				}
 
-				if (!stream_write_delete(out, &(currentStmt->stmt.delete)))
+				if (!stream_write_delete(output, &(currentStmt->stmt.delete)))
 				{
 					return false;
 				}
@@ -1966,14 +2189,14 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
 			{
 				if (!sentBEGIN && !txn->continued)
 				{
-					if (!stream_write_begin(out, txn))
+					if (!stream_write_begin(output, txn))
 					{
 						return false;
 					}
 					sentBEGIN = true;
 				}
 
-				if (!stream_write_truncate(out, &(currentStmt->stmt.truncate)))
+				if (!stream_write_truncate(output, &(currentStmt->stmt.truncate)))
 				{
 					return false;
 				}
@@ -2001,7 +2224,7 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
 	 */
 	if ((sentBEGIN && !splitTx) || txn->commit)
 	{
-		if (!stream_write_commit(out, txn))
+		if (!stream_write_commit(output, txn))
 		{
 			return false;
 		}
@@ -2009,14 +2232,14 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
 
 	if (txn->rollback)
 	{
-		if (!stream_write_rollback(out, txn))
+		if (!stream_write_rollback(output, txn))
 		{
 			return false;
 		}
 	}
 
 	/* flush out stream at transaction boundaries */
-	if (fflush(out) != 0)
+	if (fflush(output->out) != 0)
 	{
 		log_error("Failed to flush stream output: %m");
 		return false;
@@ -2036,8 +2259,15 @@ stream_write_transaction(FILE *out, LogicalTransaction *txn)
  * stream_write_begin writes a BEGIN statement to the already open out stream.
  */
 bool
-stream_write_begin(FILE *out, LogicalTransaction *txn)
+stream_write_begin(StreamOutput *output, LogicalTransaction *txn)
 {
+	FILE *out = output->out;
+
+	if (output->format == STREAM_FORMAT_BINARY)
+	{
+		return stream_binary_write_begin(out, txn);
+	}
+
 	/* include commit_lsn only if the transaction has commitLSN */
 	if (txn->commitLSN != InvalidXLogRecPtr)
 	{
@@ -2069,8 +2299,15 @@ stream_write_begin(FILE *out, LogicalTransaction *txn)
  * stream.
  */
 bool
-stream_write_rollback(FILE *out, LogicalTransaction *txn)
+stream_write_rollback(StreamOutput *output, LogicalTransaction *txn)
 {
+	FILE *out = output->out;
+
+	if (output->format == STREAM_FORMAT_BINARY)
+	{
+		return stream_binary_write_rollback(out, txn);
+	}
+
 	FFORMAT(out,
 			"%s{\"xid\":%lld,\"lsn\":\"%X/%X\",\"timestamp\":\"%s\"}\n",
 			OUTPUT_ROLLBACK,
@@ -2087,8 +2324,15 @@ stream_write_rollback(FILE *out, LogicalTransaction *txn)
  * stream.
  */
 bool
-stream_write_commit(FILE *out, LogicalTransaction *txn)
+stream_write_commit(StreamOutput *output, LogicalTransaction *txn)
 {
+	FILE *out = output->out;
+
+	if (output->format == STREAM_FORMAT_BINARY)
+	{
+		return stream_binary_write_commit(out, txn);
+	}
+
 	FFORMAT(out,
 			"%s{\"xid\":%lld,\"lsn\":\"%X/%X\",\"timestamp\":\"%s\"}\n",
 			OUTPUT_COMMIT,
@@ -2105,8 +2349,15 @@ stream_write_commit(FILE *out, LogicalTransaction *txn)
  * stream.
  */
 bool
-stream_write_switchwal(FILE *out, LogicalMessageSwitchWAL *switchwal)
+stream_write_switchwal(StreamOutput *output, LogicalMessageSwitchWAL *switchwal)
 {
+	FILE *out = output->out;
+
+	if (output->format == STREAM_FORMAT_BINARY)
+	{
+		return stream_binary_write_lsn(out, STREAM_ACTION_SWITCH, switchwal->lsn);
+	}
+
 	FFORMAT(out, "%s{\"lsn\":\"%X/%X\"}\n",
 			OUTPUT_SWITCHWAL,
 			LSN_FORMAT_ARGS(switchwal->lsn));
@@ -2120,8 +2371,15 @@ stream_write_switchwal(FILE *out, LogicalMessageSwitchWAL *switchwal)
  * stream.
  */
 bool
-stream_write_keepalive(FILE *out, LogicalMessageKeepalive *keepalive)
+stream_write_keepalive(StreamOutput *output, LogicalMessageKeepalive *keepalive)
 {
+	FILE *out = output->out;
+
+	if (output->format == STREAM_FORMAT_BINARY)
+	{
+		return stream_binary_write_keepalive(out, keepalive);
+	}
+
 	FFORMAT(out, "%s{\"lsn\":\"%X/%X\",\"timestamp\":\"%s\"}\n",
 			OUTPUT_KEEPALIVE,
 			LSN_FORMAT_ARGS(keepalive->lsn),
@@ -2136,8 +2394,15 @@ stream_write_keepalive(FILE *out, LogicalMessageKeepalive *keepalive)
  * stream.
  */
 bool
-stream_write_endpos(FILE *out, LogicalMessageEndpos *endpos)
+stream_write_endpos(StreamOutput *output, LogicalMessageEndpos *endpos)
 {
+	FILE *out = output->out;
+
+	if (output->format == STREAM_FORMAT_BINARY)
+	{
+		return stream_binary_write_lsn(out, STREAM_ACTION_ENDPOS, endpos->lsn);
+	}
+
 	FFORMAT(out, "%s{\"lsn\":\"%X/%X\"}\n",
 			OUTPUT_ENDPOS,
 			LSN_FORMAT_ARGS(endpos->lsn));
@@ -2151,7 +2416,7 @@ stream_write_endpos(FILE *out, LogicalMessageEndpos *endpos)
  * stream.
  */
 bool
-stream_write_insert(FILE *out, LogicalMessageInsert *insert)
+stream_write_insert(StreamOutput *output, LogicalMessageInsert *insert)
 {
 	/* loop over INSERT statements targeting the same table */
 	for (int s = 0; s < insert->new.count; s++)
@@ -2159,9 +2424,7 @@ stream_write_insert(FILE *out, LogicalMessageInsert *insert)
 		LogicalMessageTuple *stmt = &(insert->new.array[s]);
 
 		PQExpBuffer buf = createPQExpBuffer();
-
-		JSON_Value *js = json_value_init_array();
-		JSON_Array *jsArray = json_value_get_array(js);
+		StatementParams params = { 0 };
 
 		/*
 		 * First, the PREPARE part.
@@ -2232,10 +2495,11 @@ stream_write_insert(FILE *out, LogicalMessageInsert *insert)
 									  v > 0 ? ", " : "",
 									  ++pos);
 
-					if (!stream_add_value_in_json_array(value, jsArray))
+					if (!stream_params_append(&params, value))
 					{
 						/* errors have already been logged */
 						destroyPQExpBuffer(buf);
+						free(params.array);
 						return false;
 					}
 				}
@@ -2248,23 +2512,24 @@ stream_write_insert(FILE *out, LogicalMessageInsert *insert)
 		{
 			log_error("Failed to transform INSERT statement: Out of Memory");
 			destroyPQExpBuffer(buf);
+			free(params.array);
 			return false;
 		}
 
-		uint32_t hash = hashlittle(buf->data, buf->len, 5381);
-
-		FFORMAT(out, "PREPARE %x AS %s;\n", hash, buf->data);
-
-		destroyPQExpBuffer(buf);
-
 		/*
-		 * Second, the EXECUTE part.
+		 * Then write the PREPARE and EXECUTE parts.
 		 */
-		char *serialized_string = json_serialize_to_string(js);
+		bool success =
+			stream_write_statement(output, STREAM_ACTION_INSERT, buf, &params);
 
-		FFORMAT(out, "EXECUTE %x%s;\n", hash, serialized_string);
+		destroyPQExpBuffer(buf);
+		free(params.array);
 
-		json_free_serialized_string(serialized_string);
+		if (!success)
+		{
+			/* errors have already been logged */
+			return false;
+		}
 	}
 
 	return true;
@@ -2307,7 +2572,7 @@ appendWhereClauseColumn(PQExpBuffer buf, LogicalMessageAttribute *attr,
  * stream.
  */
 bool
-stream_write_update(FILE *out, LogicalMessageUpdate *update)
+stream_write_update(StreamOutput *output, LogicalMessageUpdate *update)
 {
 	if (update->old.count != update->new.count)
 	{
@@ -2341,9 +2606,7 @@ stream_write_update(FILE *out, LogicalMessageUpdate *update)
 		}
 
 		PQExpBuffer buf = createPQExpBuffer();
-
-		JSON_Value *js = json_value_init_array();
-		JSON_Array *jsArray = json_value_get_array(js);
+		StatementParams params = { 0 };
 
 		/*
 		 * First, the PREPARE part.
@@ -2375,6 +2638,7 @@ stream_write_update(FILE *out, LogicalMessageUpdate *update)
 							  values->cols,
 							  new->attributes.count);
 					destroyPQExpBuffer(buf);
+					free(params.array);
 					return false;
 				}
 
@@ -2421,10 +2685,11 @@ stream_write_update(FILE *out, LogicalMessageUpdate *update)
 										  attr->attname,
 										  ++pos);
 
-						if (!stream_add_value_in_json_array(value, jsArray))
+						if (!stream_params_append(&params, value))
 						{
 							/* errors have already been logged */
 							destroyPQExpBuffer(buf);
+							free(params.array);
 							return false;
 						}
 					}
@@ -2458,6 +2723,7 @@ stream_write_update(FILE *out, LogicalMessageUpdate *update)
 							  values->cols,
 							  old->attributes.count);
 					destroyPQExpBuffer(buf);
+					free(params.array);
 					return false;
 				}
 
@@ -2475,10 +2741,11 @@ stream_write_update(FILE *out, LogicalMessageUpdate *update)
 				{
 					appendWhereClauseColumn(buf, attr, firstWhereCol, &pos);
 
-					if (!stream_add_value_in_json_array(value, jsArray))
+					if (!stream_params_append(&params, value))
 					{
 						/* errors have already been logged */
 						destroyPQExpBuffer(buf);
+						free(params.array);
 						return false;
 					}
 				}
@@ -2491,6 +2758,7 @@ stream_write_update(FILE *out, LogicalMessageUpdate *update)
 		{
 			log_error("Failed to transform INSERT statement: Out of Memory");
 			destroyPQExpBuffer(buf);
+			free(params.array);
 			return false;
 		}
 
@@ -2516,23 +2784,24 @@ stream_write_update(FILE *out, LogicalMessageUpdate *update)
 					 "the same as the old");
 
 			destroyPQExpBuffer(buf);
+			free(params.array);
 			return true;
 		}
 
-		uint32_t hash = hashlittle(buf->data, buf->len, 5381);
-
-		FFORMAT(out, "PREPARE %x AS %s;\n", hash, buf->data);
-
-		destroyPQExpBuffer(buf);
-
 		/*
-		 * Second, the EXECUTE part.
+		 * Then write the PREPARE and EXECUTE parts.
 		 */
-		char *serialized_string = json_serialize_to_string(js);
+		bool success =
+			stream_write_statement(output, STREAM_ACTION_UPDATE, buf, &params);
 
-		FFORMAT(out, "EXECUTE %x%s;\n", hash, serialized_string);
+		destroyPQExpBuffer(buf);
+		free(params.array);
 
-		json_free_serialized_string(serialized_string);
+		if (!success)
+		{
+			/* errors have already been logged */
+			return false;
+		}
 	}
 
 	return true;
@@ -2544,7 +2813,7 @@ stream_write_update(FILE *out, LogicalMessageUpdate *update)
  * stream.
  */
 bool
-stream_write_delete(FILE *out, LogicalMessageDelete *delete)
+stream_write_delete(StreamOutput *output, LogicalMessageDelete *delete)
 {
 	/* loop over DELETE statements targeting the same table */
 	for (int s = 0; s < delete->old.count; s++)
@@ -2552,8 +2821,7 @@ stream_write_delete(FILE *out, LogicalMessageDelete *delete)
 		LogicalMessageTuple *old = &(delete->old.array[s]);
 
 		PQExpBuffer buf = createPQExpBuffer();
-		JSON_Value *js = json_value_init_array();
-		JSON_Array *jsArray = json_value_get_array(js);
+		StatementParams params = { 0 };
 
 		/*
 		 * First, the PREPARE part.
@@ -2583,6 +2851,7 @@ stream_write_delete(FILE *out, LogicalMessageDelete *delete)
 							  values->cols,
 							  old->attributes.count);
 					destroyPQExpBuffer(buf);
+					free(params.array);
 					return false;
 				}
 
@@ -2600,10 +2869,11 @@ stream_write_delete(FILE *out, LogicalMessageDelete *delete)
 				{
 					appendWhereClauseColumn(buf, attr, firstWhereCol, &pos);
 
-					if (!stream_add_value_in_json_array(value, jsArray))
+					if (!stream_params_append(&params, value))
 					{
 						/* errors have already been logged */
 						destroyPQExpBuffer(buf);
+						free(params.array);
 						return false;
 					}
 				}
@@ -2612,20 +2882,20 @@ stream_write_delete(FILE *out, LogicalMessageDelete *delete)
 			}
 		}
 
-		uint32_t hash = hashlittle(buf->data, buf->len, 5381);
-
-		FFORMAT(out, "PREPARE %x AS %s;\n", hash, buf->data);
-
-		destroyPQExpBuffer(buf);
-
 		/*
-		 * Second, the EXECUTE part.
+		 * Then write the PREPARE and EXECUTE parts.
 		 */
-		char *serialized_string = json_serialize_to_string(js);
+		bool success =
+			stream_write_statement(output, STREAM_ACTION_DELETE, buf, &params);
 
-		FFORMAT(out, "EXECUTE %x%s;\n", hash, serialized_string);
+		destroyPQExpBuffer(buf);
+		free(params.array);
 
-		json_free_serialized_string(serialized_string);
+		if (!success)
+		{
+			/* errors have already been logged */
+			return false;
+		}
 	}
 
 	return true;
@@ -2637,8 +2907,21 @@ stream_write_delete(FILE *out, LogicalMessageDelete *delete)
  * stream.
  */
 bool
-stream_write_truncate(FILE *out, LogicalMessageTruncate *truncate)
+stream_write_truncate(StreamOutput *output, LogicalMessageTruncate *truncate)
 {
+	FILE *out = output->out;
+
+	if (output->format == STREAM_FORMAT_BINARY)
+	{
+		char sql[BUFSIZE] = { 0 };
+
+		sformat(sql, sizeof(sql), "TRUNCATE ONLY %s.%s",
+				truncate->table.nspname,
+				truncate->table.relname);
+
+		return stream_binary_write_truncate(out, sql);
+	}
+
 	FFORMAT(out,
 			"TRUNCATE ONLY %s.%s\n",
 			truncate->table.nspname,
@@ -2648,6 +2931,93 @@ stream_write_truncate(FILE *out, LogicalMessageTruncate *truncate)
 }
 
 
+/*
+ * stream_write_statement writes a DML statement and its parameters to the
+ * given output, either as a PREPARE and EXECUTE pair of SQL commands, or in
+ * our binary format.
+ */
+static bool
+stream_write_statement(StreamOutput *output,
+					   StreamAction action,
+					   PQExpBuffer sql,
+					   StatementParams *params)
+{
+	FILE *out = output->out;
+	uint32_t hash = hashlittle(sql->data, sql->len, 5381);
+
+	if (output->format == STREAM_FORMAT_BINARY)
+	{
+		return stream_binary_write_statement(output,
+											 action,
+											 hash,
+											 sql->data,
+											 params->array,
+											 params->count);
+	}
+
+	FFORMAT(out, "PREPARE %x AS %s;\n", hash, sql->data);
+
+	JSON_Value *js = json_value_init_array();
+	JSON_Array *jsArray = json_value_get_array(js);
+
+	for (int i = 0; i < params->count; i++)
+	{
+		if (!stream_add_value_in_json_array(params->array[i], jsArray))
+		{
+			/* errors have already been logged */
+			json_value_free(js);
+			return false;
+		}
+	}
+
+	char *serialized_string = json_serialize_to_string(js);
+
+	FFORMAT(out, "EXECUTE %x%s;\n", hash, serialized_string);
+
+	json_free_serialized_string(serialized_string);
+	json_value_free(js);
+
+	return true;
+}
+
+
+/*
+ * stream_params_append appends a value to the given statement parameters.
+ */
+static bool
+stream_params_append(StatementParams *params, LogicalMessageValue *value)
+{
+	if (value == NULL)
+	{
+		log_error("BUG: stream_params_append value is NULL");
+		return false;
+	}
+
+	if (params->count == params->capacity)
+	{
+		int capacity = params->capacity == 0 ? 16 : 2 * params->capacity;
+
+		LogicalMessageValue **array =
+			(LogicalMessageValue **) realloc(params->array,
+											 capacity *
+											 sizeof(LogicalMessageValue *));
+
+		if (array == NULL)
+		{
+			log_error(ALLOCATION_FAILED_ERROR);
+			return false;
+		}
+
+		params->array = array;
+		params->capacity = capacity;
+	}
+
+	params->array[params->count++] = value;
+
+	return true;
+}
+
+
 /*
  * stream_values_as_json_array fills-in a JSON array with the string
  * representation of the given values.
@@ -2691,15 +3061,9 @@ stream_add_value_in_json_array(LogicalMessageValue *value, JSON_Array *jsArray)
 			{
 				char string[BUFSIZE] = { 0 };
 
-				if (fmod(value->val.float8, 1) == 0.0)
-				{
-					sformat(string, sizeof(string), "%lld",
-							(long long) value->val.float8);
-				}
-				else
-				{
-					sformat(string, sizeof(string), "%f", value->val.float8);
-				}
+				(void) stream_float8_to_string(value->val.float8,
+											   string,
+											   sizeof(string));
 
 				json_array_append_string(jsArray, string);
 				break;
@@ -2725,6 +3089,24 @@ stream_add_value_in_json_array(LogicalMessageValue *value, JSON_Array *jsArray)
 }
 
 
+/*
+ * stream_float8_to_string writes the string representation of a FLOAT8 value
+ * that we use as a statement parameter.
+ */
+void
+stream_float8_to_string(double value, char *str, size_t size)
+{
+	if (fmod(value, 1) == 0.0)
+	{
+		sformat(str, size, "%lld", (long long) value);
+	}
+	else
+	{
+		sformat(str, size, "%f", value);
+	}
+}
+
+
 /*
  * LogicalMessageValueEq compares two LogicalMessageValue instances and return
  * true when they represent the same value. NULL are considered Equal, like in
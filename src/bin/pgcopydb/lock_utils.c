@@ -119,6 +119,9 @@ semaphore_finish(Semaphore *semaphore)
 /*
  * semaphore_create creates a new semaphore with the value 1, or the value
  * semaphore->initValue when it's not zero.
+ *
+ * The semaphore set also contains a second semaphore with the value 1, which
+ * semaphore_lock_units uses to serve the requests in their arrival order.
  */
 bool
 semaphore_create(Semaphore *semaphore)
@@ -126,7 +129,7 @@ semaphore_create(Semaphore *semaphore)
 	union semun semun;
 
 	semaphore->owner = getpid();
-	semaphore->semId = semget(IPC_PRIVATE, 1, 0600);
+	semaphore->semId = semget(IPC_PRIVATE, 2, 0600);
 
 	if (semaphore->semId < 0)
 	{
@@ -150,6 +153,15 @@ semaphore_create(Semaphore *semaphore)
 		return false;
 	}
 
+	semun.val = 1;
+	if (semctl(semaphore->semId, 1, SETVAL, semun) < 0)
+	{
+		/* the semaphore_log_lock_function has not been set yet */
+		log_fatal("Failed to set semaphore %d/%d to value %d : %m\n",
+				  semaphore->semId, 1, semun.val);
+		return false;
+	}
+
 	/* register the semaphore to the System V resources clean-up array */
 	if (!copydb_register_sysv_semaphore(&system_res_array, semaphore))
 	{
@@ -393,6 +405,122 @@ semaphore_unlock(Semaphore *semaphore)
 }
 
 
+/*
+ * semaphore_lock_units acquires the given number of units from a counting
+ * semaphore (decrement count by units), blocking until that many units are
+ * available. The semaphore initValue is then the total number of units.
+ *
+ * Only one process at a time waits for its units, while holding the second
+ * semaphore of the set: other processes queue on that one, in their arrival
+ * order. Otherwise small requests would keep taking the units released, and
+ * a large request might never see enough of them at once.
+ */
+bool
+semaphore_lock_units(Semaphore *semaphore, int units)
+{
+	int errStatus = 0;
+	struct sembuf turnstile;
+	struct sembuf sops;
+
+	turnstile.sem_op = -1;      /* decrement */
+	turnstile.sem_flg = SEM_UNDO;
+	turnstile.sem_num = 1;
+
+	sops.sem_op = -units;       /* decrement */
+	sops.sem_flg = SEM_UNDO;
+	sops.sem_num = 0;
+
+	do {
+		if (errStatus < 0 &&
+			(asked_to_stop || asked_to_stop_fast || asked_to_quit))
+		{
+			return false;
+		}
+
+		errStatus = semop(semaphore->semId, &turnstile, 1);
+	} while (errStatus < 0 && errno == EINTR);
+
+	if (errStatus < 0)
+	{
+		log_error("Failed to acquire semaphore %d/%d: %m",
+				  semaphore->semId, 1);
+		return false;
+	}
+
+	do {
+		if (errStatus < 0 &&
+			(asked_to_stop || asked_to_stop_fast || asked_to_quit))
+		{
+			break;
+		}
+
+		errStatus = semop(semaphore->semId, &sops, 1);
+	} while (errStatus < 0 && errno == EINTR);
+
+	bool success = errStatus == 0;
+
+	if (errStatus < 0 &&
+		!(asked_to_stop || asked_to_stop_fast || asked_to_quit))
+	{
+		log_error("Failed to acquire %d units from semaphore %d: %m",
+				  units,
+				  semaphore->semId);
+	}
+
+	/* let the next process in line wait for its units now */
+	turnstile.sem_op = 1;       /* increment */
+
+	do {
+		errStatus = semop(semaphore->semId, &turnstile, 1);
+	} while (errStatus < 0 && errno == EINTR);
+
+	if (errStatus < 0)
+	{
+		log_error("Failed to release semaphore %d/%d: %m",
+				  semaphore->semId, 1);
+		return false;
+	}
+
+	return success;
+}
+
+
+/*
+ * semaphore_unlock_units releases the given number of units to a counting
+ * semaphore (increment count by units).
+ */
+bool
+semaphore_unlock_units(Semaphore *semaphore, int units)
+{
+	int errStatus = 0;
+	struct sembuf sops;
+
+	sops.sem_op = units;        /* increment */
+	sops.sem_flg = SEM_UNDO;
+	sops.sem_num = 0;
+
+	do {
+		if (errStatus < 0 &&
+			(asked_to_stop || asked_to_stop_fast || asked_to_quit))
+		{
+			return false;
+		}
+
+		errStatus = semop(semaphore->semId, &sops, 1);
+	} while (errStatus < 0 && errno == EINTR);
+
+	if (errStatus < 0)
+	{
+		log_error("Failed to release %d units to semaphore %d: %m",
+				  units,
+				  semaphore->semId);
+		return false;
+	}
+
+	return true;
+}
+
+
 /*
  * semaphore_log_lock_function integrates our semaphore facility with the
  * logging tool in use in this project.
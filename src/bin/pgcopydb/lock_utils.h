@@ -45,6 +45,9 @@ bool semaphore_cleanup(const char *pidfile);
 bool semaphore_lock(Semaphore *semaphore);
 bool semaphore_unlock(Semaphore *semaphore);
 
+bool semaphore_lock_units(Semaphore *semaphore, int units);
+bool semaphore_unlock_units(Semaphore *semaphore, int units);
+
 void semaphore_log_lock_function(void *udata, int mode);
 
 #endif /* LOCK_UTILS_H */
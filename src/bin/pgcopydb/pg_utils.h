@@ -50,7 +50,17 @@
 #define TEXTOID 25
 #define OIDOID 26
 #define LSNOID 3220
+#define DATEOID 1082
+#define TIMESTAMPOID 1114
 #define TIMESTAMPTZOID 1184
+#define INTERVALOID 1186
+#define NUMERICOID 1700
+
+/*
+ * OIDs below this value are assigned at initdb time, from PostgreSQL
+ * src/include/access/transam.h (FirstNormalObjectId).
+ */
+#define PG_FIRST_NORMAL_OBJECT_ID 16384
 
 /*
  * Catalog OID values from PostgreSQL src/include/catalog/pg_namespace.h
@@ -70,6 +80,10 @@
 #define STR_ERRCODE_FOREIGN_KEY_VIOLATION "23503"
 #define STR_ERRCODE_INVALID_SCHEMA_NAME "3F000"
 #define STR_ERRCODE_UNDEFINED_TABLE "42P01"
+#define STR_ERRCODE_INVALID_BINARY_REPRESENTATION "22P03"
+#define STR_ERRCODE_BAD_COPY_FILE_FORMAT "22P04"
+#define STR_ERRCODE_UNDEFINED_FUNCTION "42883"
+#define STR_ERRCODE_DATATYPE_MISMATCH "42804"
 
 /*
  * From postgres/src/include/access/xlogdefs.h
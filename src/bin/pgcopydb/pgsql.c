@@ -2,6 +2,8 @@
  * src/bin/pgcopydb/pgsql.c
  *	 API for sending SQL commands to a PostgreSQL server
  */
+#include <arpa/inet.h>
+#include <poll.h>
 #include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
@@ -63,6 +65,52 @@ static bool pg_copy_data(PGSQL *src, PGSQL *dst,
 static bool pg_copy_send_query(PGSQL *pgsql, CopyArgs *args,
 							   ExecStatusType status);
 
+/*
+ * The COPY loop uses a bounded ring of chunks in between reading from the
+ * source and writing to the target. Source rows are packed into the chunks,
+ * and each chunk is then sent to the target in a single CopyData message.
+ *
+ * Large rows are not packed: the chunk then points to the row buffer that
+ * libpq allocated, and it's sent as-is.
+ */
+typedef struct CopyChunk
+{
+	char *data;
+	uint64_t size;              /* allocated size of data */
+	uint64_t len;               /* bytes in use */
+	uint64_t rows;              /* count of rows packed in this chunk */
+
+	char *rowBuf;               /* a large row owned by libpq, or NULL */
+} CopyChunk;
+
+typedef struct CopyRing
+{
+	CopyChunk *chunks;
+	int slots;
+	uint64_t chunkSize;
+
+	int head;                   /* next chunk to send to the target */
+	int count;                  /* count of chunks ready to be sent */
+
+	/* a source row that did not fit in the ring, owned by libpq */
+	char *pendingBuf;
+	int pendingLen;
+} CopyRing;
+
+static bool pg_copy_pipeline(PGSQL *src, PGSQL *dst,
+							 CopyRing *ring, CopyStats *stats,
+							 void *context, CopyStatsCallback *callback,
+							 bool *failedOnSrc, bool *failedOnDst);
+
+static bool copy_ring_init(CopyRing *ring, uint64_t chunkSize);
+static bool copy_ring_is_full(CopyRing *ring);
+static bool copy_ring_is_empty(CopyRing *ring);
+static bool copy_ring_add_row(CopyRing *ring, char *buf, int len);
+static bool copy_ring_seal(CopyRing *ring);
+static CopyChunk * copy_ring_head(CopyRing *ring);
+static bool copy_ring_pop(CopyRing *ring);
+static bool copy_ring_free(CopyRing *ring);
+
 static void pgcopy_log_error(PGSQL *pgsql, PGresult *res, const char *context);
 
 static void getSequenceValue(void *ctx, PGresult *result);
@@ -1866,6 +1914,50 @@ pgsql_enable_pipeline_mode(PGSQL *pgsql)
 }
 
 
+/*
+ * pgsql_disable_pipeline_mode exits the pipeline mode in the given PGSQL
+ * connection, which must have been synced already, and sets the connection
+ * back to blocking mode.
+ */
+bool
+pgsql_disable_pipeline_mode(PGSQL *pgsql)
+{
+#if defined(LIBPQ_HAS_PIPELINING) && LIBPQ_HAS_PIPELINING
+	PGconn *conn = pgsql->connection;
+
+	if (conn == NULL)
+	{
+		log_error("BUG: pgsql_disable_pipeline_mode called with NULL connection");
+		return false;
+	}
+
+	if (PQpipelineStatus(conn) != PQ_PIPELINE_ON)
+	{
+		log_error("BUG: Connection is not in pipeline mode");
+		return false;
+	}
+
+	/* exit pipeline mode */
+	if (PQexitPipelineMode(conn) != 1)
+	{
+		(void) pgcopy_log_error(pgsql, NULL, "Failed to exit pipeline");
+		return false;
+	}
+
+	/* set blocking mode */
+	if (PQsetnonblocking(conn, 0) != 0)
+	{
+		(void) pgcopy_log_error(pgsql, NULL, "Failed to set blocking mode");
+		return false;
+	}
+
+	log_trace("Disabled pipeline mode");
+#endif
+
+	return true;
+}
+
+
 /*
  * pgsql_sync_pipeline drains the pipeline by sending a SYNC message and
  * reads results until we get a PGRES_PIPELINE_SYNC result.
@@ -2066,6 +2158,91 @@ pgsql_sync_pipeline(PGSQL *pgsql)
 }
 
 
+/*
+ * pgsql_flush_pipeline sends the queries that are still buffered in the libpq
+ * output buffer of a connection in pipeline mode, without waiting for their
+ * results. This allows the server to start executing them before we send a
+ * SYNC message.
+ *
+ * The server might be blocked sending results back to us while we are
+ * flushing our output buffer, so we also consume input here.
+ */
+bool
+pgsql_flush_pipeline(PGSQL *pgsql)
+{
+#if defined(LIBPQ_HAS_PIPELINING) && LIBPQ_HAS_PIPELINING
+	PGconn *conn = pgsql->connection;
+
+	if (conn == NULL)
+	{
+		log_error("BUG: pgsql_flush_pipeline called with NULL connection");
+		return false;
+	}
+
+	int sock = PQsocket(conn);
+
+	if (sock < 0)
+	{
+		(void) pgcopy_log_error(pgsql, NULL,
+								"Failed to get socket for pipeline flush");
+		return false;
+	}
+
+	for (;;)
+	{
+		int r = PQflush(conn);
+
+		if (r == 0)
+		{
+			break;
+		}
+		else if (r < 0)
+		{
+			(void) pgcopy_log_error(pgsql, NULL, "Failed to flush pipeline");
+			return false;
+		}
+
+		if (asked_to_quit || asked_to_stop || asked_to_stop_fast)
+		{
+			log_error("Pipeline flush was interrupted");
+			return false;
+		}
+
+		fd_set input_mask;
+		fd_set output_mask;
+		struct timeval timeout = { .tv_sec = 0, .tv_usec = 10000 };
+
+		FD_ZERO(&input_mask);
+		FD_ZERO(&output_mask);
+		FD_SET(sock, &input_mask);
+		FD_SET(sock, &output_mask);
+
+		int s = select(sock + 1, &input_mask, &output_mask, NULL, &timeout);
+
+		if (s < 0 && errno != EINTR)
+		{
+			(void) pgcopy_log_error(pgsql, NULL, "select failed: %m");
+			return false;
+		}
+
+		if (s > 0 && FD_ISSET(sock, &input_mask))
+		{
+			if (PQconsumeInput(conn) == 0)
+			{
+				(void) pgsql_stream_log_error(pgsql, NULL,
+											  "Failed to consume input");
+				return false;
+			}
+		}
+	}
+
+	return true;
+#else
+	return true;
+#endif
+}
+
+
 /*
  * pgsql_prepare implements server-side prepared statements by using the
  * Postgres protocol prepare/bind/execute messages. Use with
@@ -2462,6 +2639,26 @@ pgsql_state_is_connection_error(PGSQL *pgsql)
 }
 
 
+/*
+ * pgsql_state_is_copy_binary_error returns true when the PGSQL sqlstate is
+ * one that Postgres reports when the COPY binary format can not be used for
+ * a table, and the text format might still work:
+ *
+ * 22P03	invalid_binary_representation
+ * 22P04	bad_copy_file_format
+ * 42804	datatype_mismatch (array or record element type OIDs)
+ * 42883	undefined_function (no binary send or receive function)
+ */
+bool
+pgsql_state_is_copy_binary_error(PGSQL *pgsql)
+{
+	return streq(pgsql->sqlstate, STR_ERRCODE_INVALID_BINARY_REPRESENTATION) ||
+		   streq(pgsql->sqlstate, STR_ERRCODE_BAD_COPY_FILE_FORMAT) ||
+		   streq(pgsql->sqlstate, STR_ERRCODE_DATATYPE_MISMATCH) ||
+		   streq(pgsql->sqlstate, STR_ERRCODE_UNDEFINED_FUNCTION);
+}
+
+
 /*
  * clear_results consumes results on a connection until NULL is returned.
  * If an error is returned it returns false.
@@ -2637,6 +2834,23 @@ pgsql_truncate(PGSQL *pgsql, const char *qname)
 }
 
 
+/*
+ * pgsql_delete_where executes a DELETE command on the given quoted relation
+ * name qname, with the given WHERE clause, in the given Postgres connection.
+ */
+bool
+pgsql_delete_where(PGSQL *pgsql, const char *qname, const char *whereClause)
+{
+	char sql[BUFSIZE] = { 0 };
+
+	sformat(sql, sizeof(sql), "DELETE FROM ONLY %s %s", qname, whereClause);
+
+	log_notice("%s", sql);
+
+	return pgsql_execute(pgsql, sql);
+}
+
+
 /*
  * pg_copy implements a COPY operation from a source Postgres instance (src) to
  * a target Postgres instance (dst), for the data found in the table referenced
@@ -2691,7 +2905,6 @@ pg_copy_data(PGSQL *src, PGSQL *dst,
 			 CopyArgs *args, CopyStats *stats,
 			 void *context, CopyStatsCallback *callback)
 {
-	PGconn *srcConn = src->connection;
 	PGconn *dstConn = dst->connection;
 
 	if (!pgsql_begin(dst))
@@ -2708,6 +2921,19 @@ pg_copy_data(PGSQL *src, PGSQL *dst,
 		}
 	}
 
+	/*
+	 * When copying again a range of rows that might have been copied in a
+	 * previous run already, delete them first, in the same transaction.
+	 */
+	if (args->dstWhereClause != NULL)
+	{
+		if (!pgsql_delete_where(dst, args->dstQname, args->dstWhereClause))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
 	/*
 	 * COPY FREEZE is only accepted by Postgres if the table was created or
 	 * truncated in the current transaction.
@@ -2729,167 +2955,63 @@ pg_copy_data(PGSQL *src, PGSQL *dst,
 		return false;
 	}
 
-	/* now implement the copy loop */
-	char *copybuf;
+	/*
+	 * Now implement the copy loop. The target connection is switched to
+	 * non-blocking mode so that we may keep reading from the source while the
+	 * target is busy absorbing the rows we have already sent.
+	 */
+	if (PQsetnonblocking(dstConn, 1) != 0)
+	{
+		pgcopy_log_error(dst, NULL, "Failed to set target connection non-blocking");
+		return false;
+	}
+
+	CopyRing ring = { 0 };
+	uint64_t chunkSize =
+		args->bufferSize > 0 ? args->bufferSize : DEFAULT_COPY_BUFFER_SIZE;
+
+	if (!copy_ring_init(&ring, chunkSize))
+	{
+		(void) PQsetnonblocking(dstConn, 0);
+		return false;
+	}
+
 	bool failedOnSrc = false;
 	bool failedOnDst = false;
 
 	/* also init and maintain copy statistics */
 	stats->startTime = time(NULL);
 	stats->bytesTransmitted = 0;
+	stats->wireBytes = 0;
+	stats->rowsTransmitted = 0;
+	stats->sendCount = 0;
 
-	for (;;)
+	if (!pg_copy_pipeline(src, dst, &ring, stats, context, callback,
+						  &failedOnSrc, &failedOnDst))
 	{
-		/* handle signals */
-		if (asked_to_quit || asked_to_stop || asked_to_stop_fast)
+		/* errors have already been logged, or we were asked to stop */
+		if (!failedOnSrc && !failedOnDst)
 		{
-			log_debug("COPY was asked to stop");
+			(void) copy_ring_free(&ring);
+			(void) PQsetnonblocking(dstConn, 0);
 			return false;
 		}
+	}
 
-		int bufsize = PQgetCopyData(srcConn, &copybuf, 1);
-
-		/*
-		 * A result of -2 indicates that an error occurred.
-		 */
-		if (bufsize == -2)
-		{
-			failedOnSrc = true;
-
-			pgcopy_log_error(src, NULL, "Failed to fetch data from source");
-			break;
-		}
-
-		/*
-		 * PQgetCopyData returns -1 to indicate that the COPY is done. Call
-		 * PQgetResult to obtain the final result status of the COPY command.
-		 */
-		else if (bufsize == -1)
-		{
-			PGresult *res = PQgetResult(srcConn);
-
-			if (PQresultStatus(res) != PGRES_COMMAND_OK)
-			{
-				failedOnSrc = true;
-
-				pgcopy_log_error(src, res, "Failed to fetch data from source");
-				break;
-			}
-
-			/* we're done here */
-			clear_results(src);
-
-			/* make sure to pass through and send this last COPY buffer */
-		}
-
-		/*
-		 * In async mode, and no data available.
-		 */
-		else if (bufsize == 0)
-		{
-			fd_set input_mask;
-			int sock = PQsocket(srcConn);
-
-			if (sock < 0)
-			{
-				failedOnSrc = true;
-
-				pgcopy_log_error(src, NULL, "invalid socket");
-				break;
-			}
-
-			struct timeval timeout;
-			struct timeval *timeoutptr = NULL;
-
-			/* sleep for 10ms to wait for input on the Postgres socket */
-			timeout.tv_sec = 0;
-			timeout.tv_usec = 10000;
-			timeoutptr = &timeout;
-
-			FD_ZERO(&input_mask);
-			FD_SET(sock, &input_mask);
-
-			int r = select(sock + 1, &input_mask, NULL, NULL, timeoutptr);
-
-			if (r == 0 || (r < 0 && errno == EINTR))
-			{
-				/*
-				 * Got a timeout or signal. Continue the loop and either
-				 * deliver a status packet to the server or just go back into
-				 * blocking.
-				 */
-				continue;
-			}
-			else if (r < 0)
-			{
-				failedOnSrc = true;
-
-				pgcopy_log_error(src, NULL, "select failed: %m");
-				break;
-			}
-
-			/* there is actually data on the socket */
-			if (PQconsumeInput(srcConn) == 0)
-			{
-				failedOnSrc = true;
-
-				pgcopy_log_error(src, NULL, "could not receive data");
-				break;
-			}
-		}
-
-		/*
-		 * If successful PQgetCopyData returns the row length as a result.
-		 */
-		else if (bufsize > 0)
-		{
-			stats->bytesTransmitted += bufsize;
-
-			if (callback != NULL)
-			{
-				/*
-				 * Allow the Copy Stats user callback to fail, still continue
-				 * with the copy.
-				 */
-				if (!(*callback)(context, stats))
-				{
-					log_debug("Copy Stats Callback failed, "
-							  "see above for details");
-				}
-			}
-		}
-
-		/*
-		 * We got a COPY buffer from the source database, send it over as-is to
-		 * the target database, which speaks the same COPY protocol, after all.
-		 */
-		if (copybuf)
-		{
-			int ret = PQputCopyData(dstConn, copybuf, bufsize);
-			PQfreemem(copybuf);
-
-			if (ret == -1)
-			{
-				failedOnDst = true;
-
-				pgcopy_log_error(dst, NULL, "Failed to copy data to target");
-
-				clear_results(src);
-
-				break;
-			}
-		}
+	/* release rows that we might not have sent because of an error */
+	(void) copy_ring_free(&ring);
 
-		/* when we've reached the end of COPY from the source, stop here */
-		if (bufsize == -1)
-		{
-			break;
-		}
+	/*
+	 * The COPY loop is over now. Switching back to blocking mode flushes any
+	 * pending output, and the connection is re-used for the next table.
+	 */
+	if (PQsetnonblocking(dstConn, 0) != 0)
+	{
+		failedOnDst = true;
+		pgcopy_log_error(dst, NULL, "Failed to copy data to target");
 	}
 
 	/*
-	 * The COPY loop is over now.
-	 *
 	 * Time to send end-of-data indication to the server during COPY_IN state.
 	 */
 	if (!failedOnDst)
@@ -2926,30 +3048,611 @@ pg_copy_data(PGSQL *src, PGSQL *dst,
 
 
 /*
- * pg_copy_from_stdin prepares the SQL query to open a COPY streaming to upload
- * data to a Postgres table.
+ * pg_copy_pipeline runs the COPY loop proper. Rows are read from the source
+ * connection and packed into a bounded ring of chunks, and the ring is drained
+ * into the target connection, which is expected to be in non-blocking mode.
+ *
+ * The COPY protocol does not require CopyData messages to align with rows, so
+ * each chunk is sent in a single PQputCopyData call, which saves libpq calls
+ * and allocations on tables with many narrow rows.
+ *
+ * Reading from the source stops when the ring is full, which applies
+ * back-pressure on the source server through TCP flow control. Writing to the
+ * target stops when libpq can not flush its output buffer to the socket. When
+ * neither side can make progress, we wait for either socket to be ready.
+ *
+ * Returns false when the COPY failed or was interrupted. In the former case,
+ * either failedOnSrc or failedOnDst is set.
  */
-bool
-pg_copy_from_stdin(PGSQL *pgsql, const char *qname)
+static bool
+pg_copy_pipeline(PGSQL *src, PGSQL *dst, CopyRing *ring, CopyStats *stats,
+				 void *context, CopyStatsCallback *callback,
+				 bool *failedOnSrc, bool *failedOnDst)
 {
-	char sql[BUFSIZE] = { 0 };
+	PGconn *srcConn = src->connection;
+	PGconn *dstConn = dst->connection;
 
-	sformat(sql, sizeof(sql), "COPY %s FROM stdin", qname);
+	bool srcDone = false;
+	bool flushPending = false;
+
+	for (;;)
+	{
+		/* handle signals */
+		if (asked_to_quit || asked_to_stop || asked_to_stop_fast)
+		{
+			log_debug("COPY was asked to stop");
+			return false;
+		}
+
+		/*
+		 * Reader: fill-in the ring with as many rows as are available from
+		 * the source connection without blocking.
+		 */
+		bool needInput = false;
+
+		while (!srcDone && !copy_ring_is_full(ring))
+		{
+			char *copybuf = NULL;
+			int bufsize = PQgetCopyData(srcConn, &copybuf, 1);
+
+			/*
+			 * A result of -2 indicates that an error occurred.
+			 */
+			if (bufsize == -2)
+			{
+				*failedOnSrc = true;
+
+				pgcopy_log_error(src, NULL, "Failed to fetch data from source");
+				return false;
+			}
+
+			/*
+			 * PQgetCopyData returns -1 to indicate that the COPY is done. Call
+			 * PQgetResult to obtain the final result status of the COPY
+			 * command.
+			 */
+			else if (bufsize == -1)
+			{
+				PGresult *res = PQgetResult(srcConn);
+
+				if (PQresultStatus(res) != PGRES_COMMAND_OK)
+				{
+					*failedOnSrc = true;
+
+					pgcopy_log_error(src, res, "Failed to fetch data from source");
+					return false;
+				}
+
+				/* we're done here */
+				clear_results(src);
+				srcDone = true;
+			}
+
+			/*
+			 * In async mode, and no data available.
+			 */
+			else if (bufsize == 0)
+			{
+				needInput = true;
+				break;
+			}
+
+			/*
+			 * If successful PQgetCopyData returns the row length as a result.
+			 */
+			else
+			{
+				if (!copy_ring_add_row(ring, copybuf, bufsize))
+				{
+					/* errors have already been logged */
+					*failedOnSrc = true;
+					return false;
+				}
+
+				stats->bytesTransmitted += bufsize;
+				stats->wireBytes += bufsize + COPY_DATA_MESSAGE_HEADER_SIZE;
+				++(stats->rowsTransmitted);
+
+				if (callback != NULL)
+				{
+					/*
+					 * Allow the Copy Stats user callback to fail, still
+					 * continue with the copy.
+					 */
+					if (!(*callback)(context, stats))
+					{
+						log_debug("Copy Stats Callback failed, "
+								  "see above for details");
+					}
+				}
+			}
+		}
+
+		/*
+		 * Writer: send the COPY buffers we got from the source database over
+		 * as-is to the target database, which speaks the same COPY protocol,
+		 * after all. Stop as soon as libpq has more data to send than the
+		 * socket accepts.
+		 */
+		if (flushPending)
+		{
+			int ret = PQflush(dstConn);
+
+			if (ret == -1)
+			{
+				*failedOnDst = true;
+
+				pgcopy_log_error(dst, NULL, "Failed to copy data to target");
+				clear_results(src);
+
+				return false;
+			}
+
+			flushPending = ret == 1;
+		}
+
+		/*
+		 * When the target is idle and the source has no more rows for us at
+		 * the moment, send the chunk that's being filled rather than wait
+		 * for it to be full.
+		 */
+		if (!flushPending && ring->count == 0 && (srcDone || needInput))
+		{
+			(void) copy_ring_seal(ring);
+		}
+
+		while (!flushPending && ring->count > 0)
+		{
+			CopyChunk *chunk = copy_ring_head(ring);
+			char *data = chunk->rowBuf != NULL ? chunk->rowBuf : chunk->data;
+
+			int ret = PQputCopyData(dstConn, data, chunk->len);
+
+			if (ret == -1)
+			{
+				*failedOnDst = true;
+
+				pgcopy_log_error(dst, NULL, "Failed to copy data to target");
+				clear_results(src);
+
+				return false;
+			}
+
+			/* libpq could not queue the data, wait until we can flush */
+			if (ret == 0)
+			{
+				flushPending = true;
+				break;
+			}
+
+			++(stats->sendCount);
+
+			/* this might pack a pending row in the chunk we just freed */
+			if (!copy_ring_pop(ring))
+			{
+				/* errors have already been logged */
+				*failedOnSrc = true;
+				return false;
+			}
+
+			/*
+			 * libpq would otherwise grow its output buffer without limits in
+			 * non-blocking mode, check that the socket keeps up.
+			 */
+			ret = PQflush(dstConn);
+
+			if (ret == -1)
+			{
+				*failedOnDst = true;
+
+				pgcopy_log_error(dst, NULL, "Failed to copy data to target");
+				clear_results(src);
+
+				return false;
+			}
+
+			flushPending = ret == 1;
+		}
+
+		/* when we've sent everything we got from the source, stop here */
+		if (srcDone && copy_ring_is_empty(ring) && !flushPending)
+		{
+			return true;
+		}
+
+		/*
+		 * When either side can still make progress, loop over. Otherwise wait
+		 * until one of the sockets is ready.
+		 */
+		bool readerBlocked = srcDone || needInput || copy_ring_is_full(ring);
+		bool writerBlocked = flushPending || ring->count == 0;
+
+		if (!readerBlocked || !writerBlocked)
+		{
+			continue;
+		}
+
+		bool waitForSource = needInput && !srcDone && !copy_ring_is_full(ring);
+
+		if (!waitForSource && !flushPending)
+		{
+			/* the chunk being filled is ready to be sent now */
+			continue;
+		}
+
+		int srcSock = PQsocket(srcConn);
+		int dstSock = PQsocket(dstConn);
+
+		if (srcSock < 0)
+		{
+			*failedOnSrc = true;
+
+			pgcopy_log_error(src, NULL, "invalid socket");
+			return false;
+		}
+
+		if (dstSock < 0)
+		{
+			*failedOnDst = true;
+
+			pgcopy_log_error(dst, NULL, "invalid socket");
+			return false;
+		}
+
+		/*
+		 * Wait until either socket is ready. A signal that arrives after we
+		 * checked for signals at the top of the loop and before poll() is
+		 * called would not interrupt it, so keep the wait bounded.
+		 */
+		struct pollfd fds[2] = { 0 };
+
+		/* always watch the target for errors and notices */
+		fds[0].fd = dstSock;
+		fds[0].events = POLLIN | (flushPending ? POLLOUT : 0);
+
+		/* a negative fd is ignored by poll() */
+		fds[1].fd = waitForSource ? srcSock : -1;
+		fds[1].events = POLLIN;
+
+		int r = poll(fds, 2, COPY_PIPELINE_POLL_TIMEOUT_MS);
+
+		if (r == 0 || (r < 0 && errno == EINTR))
+		{
+			/* timeout or signal, continue the loop and check for signals */
+			continue;
+		}
+		else if (r < 0)
+		{
+			*failedOnSrc = true;
+
+			pgcopy_log_error(src, NULL, "poll failed: %m");
+			return false;
+		}
+
+		/*
+		 * There is actually data on the socket. Errors and hang-ups are
+		 * reported by PQconsumeInput, or by the next libpq call.
+		 */
+		if (fds[1].revents != 0)
+		{
+			if (PQconsumeInput(srcConn) == 0)
+			{
+				*failedOnSrc = true;
+
+				pgcopy_log_error(src, NULL, "could not receive data");
+				return false;
+			}
+		}
+
+		if ((fds[0].revents & ~POLLOUT) != 0)
+		{
+			if (PQconsumeInput(dstConn) == 0)
+			{
+				*failedOnDst = true;
+
+				pgcopy_log_error(dst, NULL, "could not receive data");
+				clear_results(src);
+
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ * copy_ring_init allocates the ring chunks. We keep about
+ * COPY_PIPELINE_RING_BYTES in the ring, and always at least two chunks so
+ * that we can fill one while sending the other.
+ */
+static bool
+copy_ring_init(CopyRing *ring, uint64_t chunkSize)
+{
+	int slots = COPY_PIPELINE_RING_BYTES / chunkSize;
+
+	if (slots < COPY_PIPELINE_RING_MIN_CHUNKS)
+	{
+		slots = COPY_PIPELINE_RING_MIN_CHUNKS;
+	}
+	else if (slots > COPY_PIPELINE_RING_MAX_CHUNKS)
+	{
+		slots = COPY_PIPELINE_RING_MAX_CHUNKS;
+	}
+
+	ring->slots = slots;
+	ring->chunkSize = chunkSize;
+	ring->head = 0;
+	ring->count = 0;
+	ring->pendingBuf = NULL;
+	ring->pendingLen = 0;
+
+	ring->chunks = (CopyChunk *) calloc(slots, sizeof(CopyChunk));
+
+	if (ring->chunks == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	for (int i = 0; i < slots; i++)
+	{
+		CopyChunk *chunk = &(ring->chunks[i]);
+
+		chunk->data = (char *) malloc(chunkSize * sizeof(char));
+
+		if (chunk->data == NULL)
+		{
+			log_error(ALLOCATION_FAILED_ERROR);
+			return false;
+		}
+
+		chunk->size = chunkSize;
+	}
+
+	return true;
+}
+
+
+/*
+ * copy_ring_is_full returns true when there is no chunk left to pack source
+ * rows into.
+ */
+static bool
+copy_ring_is_full(CopyRing *ring)
+{
+	return ring->count == ring->slots || ring->pendingBuf != NULL;
+}
+
+
+/*
+ * copy_ring_is_empty returns true when the ring has no data at all.
+ */
+static bool
+copy_ring_is_empty(CopyRing *ring)
+{
+	if (ring->count > 0 || ring->pendingBuf != NULL)
+	{
+		return false;
+	}
+
+	/* the chunk being filled might have some data still */
+	CopyChunk *filling = &(ring->chunks[ring->head]);
+
+	return filling->len == 0;
+}
+
+
+/*
+ * copy_ring_add_row packs a source row into the chunk being filled. When the
+ * row does not fit, the chunk is ready to be sent and the row goes into the
+ * next chunk, or is kept pending when the ring is full.
+ *
+ * Rows of COPY_PIPELINE_DIRECT_ROW_BYTES or more get a chunk of their own,
+ * which points to the row buffer rather than copying it, so that wide rows
+ * (think bytea) are not copied an extra time.
+ *
+ * The ring takes ownership of the row buffer, which has been allocated by
+ * libpq.
+ */
+static bool
+copy_ring_add_row(CopyRing *ring, char *buf, int len)
+{
+	if (copy_ring_is_full(ring))
+	{
+		log_error("BUG: copy_ring_add_row called on a full ring");
+		return false;
+	}
+
+	int fillingIndex = (ring->head + ring->count) % ring->slots;
+	CopyChunk *filling = &(ring->chunks[fillingIndex]);
+
+	bool direct = len >= COPY_PIPELINE_DIRECT_ROW_BYTES;
+
+	if (filling->len > 0 && (direct || (filling->len + len) > filling->size))
+	{
+		(void) copy_ring_seal(ring);
+
+		if (copy_ring_is_full(ring))
+		{
+			ring->pendingBuf = buf;
+			ring->pendingLen = len;
+
+			return true;
+		}
+
+		fillingIndex = (ring->head + ring->count) % ring->slots;
+		filling = &(ring->chunks[fillingIndex]);
+	}
+
+	/* a single row might be larger than our chunks */
+	if (direct || (uint64_t) len > filling->size)
+	{
+		filling->rowBuf = buf;
+		filling->len = len;
+		filling->rows = 1;
+
+		(void) copy_ring_seal(ring);
+
+		return true;
+	}
+
+	memcpy(filling->data + filling->len, buf, len);
+
+	filling->len += len;
+	++(filling->rows);
+
+	PQfreemem(buf);
+
+	return true;
+}
+
+
+/*
+ * copy_ring_seal marks the chunk being filled as ready to be sent, unless it
+ * is empty.
+ */
+static bool
+copy_ring_seal(CopyRing *ring)
+{
+	if (ring->count == ring->slots)
+	{
+		return false;
+	}
+
+	int fillingIndex = (ring->head + ring->count) % ring->slots;
+	CopyChunk *filling = &(ring->chunks[fillingIndex]);
+
+	if (filling->len == 0)
+	{
+		return false;
+	}
+
+	++(ring->count);
+
+	return true;
+}
+
+
+/*
+ * copy_ring_head returns the chunk at the head of the ring.
+ */
+static CopyChunk *
+copy_ring_head(CopyRing *ring)
+{
+	return &(ring->chunks[ring->head]);
+}
+
+
+/*
+ * copy_ring_pop removes the chunk at the head of the ring, making it available
+ * again for packing rows. When a source row is pending, it's packed now.
+ */
+static bool
+copy_ring_pop(CopyRing *ring)
+{
+	if (ring->count == 0)
+	{
+		log_error("BUG: copy_ring_pop called on an empty ring");
+		return false;
+	}
+
+	CopyChunk *chunk = &(ring->chunks[ring->head]);
+
+	if (chunk->rowBuf != NULL)
+	{
+		PQfreemem(chunk->rowBuf);
+		chunk->rowBuf = NULL;
+	}
+
+	chunk->len = 0;
+	chunk->rows = 0;
+
+	ring->head = (ring->head + 1) % ring->slots;
+	--(ring->count);
+
+	if (ring->pendingBuf != NULL)
+	{
+		char *buf = ring->pendingBuf;
+		int len = ring->pendingLen;
+
+		ring->pendingBuf = NULL;
+		ring->pendingLen = 0;
+
+		return copy_ring_add_row(ring, buf, len);
+	}
+
+	return true;
+}
+
+
+/*
+ * copy_ring_free releases the source rows that are still owned by the ring.
+ * The chunks themselves are garbage collected.
+ */
+static bool
+copy_ring_free(CopyRing *ring)
+{
+	for (int i = 0; i < ring->slots; i++)
+	{
+		CopyChunk *chunk = &(ring->chunks[i]);
+
+		if (chunk->rowBuf != NULL)
+		{
+			PQfreemem(chunk->rowBuf);
+			chunk->rowBuf = NULL;
+		}
+	}
+
+	if (ring->pendingBuf != NULL)
+	{
+		PQfreemem(ring->pendingBuf);
+
+		ring->pendingBuf = NULL;
+		ring->pendingLen = 0;
+	}
+
+	return true;
+}
+
+
+/*
+ * pg_copy_from_stdin prepares the SQL query to open a COPY streaming to upload
+ * data to a Postgres table. The qname may be followed by a column list.
+ */
+bool
+pg_copy_from_stdin(PGSQL *pgsql, const char *qname)
+{
+	PQExpBuffer sql = createPQExpBuffer();
+
+	appendPQExpBuffer(sql, "COPY %s FROM stdin", qname);
+
+	if (PQExpBufferBroken(sql))
+	{
+		log_error("Failed to prepare COPY %s: Out of Memory", qname);
+		destroyPQExpBuffer(sql);
+		return false;
+	}
 
 	char *endpoint =
 		pgsql->connectionType == PGSQL_CONN_SOURCE ? "SOURCE" : "TARGET";
 
-	log_sql("[%s %d] %s;", endpoint, PQbackendPID(pgsql->connection), sql);
+	log_sql("[%s %d] %s;", endpoint, PQbackendPID(pgsql->connection), sql->data);
 
-	PGresult *res = PQexec(pgsql->connection, sql);
+	PGresult *res = PQexec(pgsql->connection, sql->data);
 
 	if (PQresultStatus(res) != PGRES_COPY_IN)
 	{
-		pgcopy_log_error(pgsql, res, sql);
+		pgcopy_log_error(pgsql, res, sql->data);
+		destroyPQExpBuffer(sql);
 
 		return false;
 	}
 
+	PQclear(res);
+	destroyPQExpBuffer(sql);
+
 	return true;
 }
 
@@ -3004,30 +3707,114 @@ pg_copy_row_from_stdin(PGSQL *pgsql, char *fmt, ...)
 				break;
 			}
 
-			/* at the moment we don't need to support numeric fields etc */
-			default:
-			{
-				va_end(args);
+			/* at the moment we don't need to support numeric fields etc */
+			default:
+			{
+				va_end(args);
+
+				log_error("BUG: COPY data type %c is not supported", fmt[i]);
+				pgsql_finish(pgsql);
+
+				return false;
+			}
+		}
+	}
+
+	if (PQputCopyData(pgsql->connection, "\n", 1) == -1)
+	{
+		va_end(args);
+
+		pgcopy_log_error(pgsql, NULL, "Failed to copy row from stdin");
+		pgsql_finish(pgsql);
+
+		return false;
+	}
+
+	va_end(args);
+
+	return true;
+}
+
+
+/*
+ * pg_copy_values_from_stdin streams a row of data made of the given text
+ * values into the already opened COPY protocol stream, escaping the values
+ * for the COPY text format. NULL values are sent as \N.
+ */
+bool
+pg_copy_values_from_stdin(PGSQL *pgsql, int count, const char **values)
+{
+	PQExpBuffer row = createPQExpBuffer();
+
+	for (int i = 0; i < count; i++)
+	{
+		if (i > 0)
+		{
+			appendPQExpBufferChar(row, '\t');
+		}
+
+		if (values[i] == NULL)
+		{
+			appendPQExpBufferStr(row, "\\N");
+			continue;
+		}
+
+		for (const char *ptr = values[i]; *ptr != '\0'; ptr++)
+		{
+			switch (*ptr)
+			{
+				case '\\':
+				{
+					appendPQExpBufferStr(row, "\\\\");
+					break;
+				}
+
+				case '\n':
+				{
+					appendPQExpBufferStr(row, "\\n");
+					break;
+				}
+
+				case '\r':
+				{
+					appendPQExpBufferStr(row, "\\r");
+					break;
+				}
 
-				log_error("BUG: COPY data type %c is not supported", fmt[i]);
-				pgsql_finish(pgsql);
+				case '\t':
+				{
+					appendPQExpBufferStr(row, "\\t");
+					break;
+				}
 
-				return false;
+				default:
+				{
+					appendPQExpBufferChar(row, *ptr);
+					break;
+				}
 			}
 		}
 	}
 
-	if (PQputCopyData(pgsql->connection, "\n", 1) == -1)
+	appendPQExpBufferChar(row, '\n');
+
+	if (PQExpBufferBroken(row))
 	{
-		va_end(args);
+		log_error("Failed to prepare COPY row: Out of Memory");
+		destroyPQExpBuffer(row);
+		return false;
+	}
 
+	if (PQputCopyData(pgsql->connection, row->data, row->len) == -1)
+	{
 		pgcopy_log_error(pgsql, NULL, "Failed to copy row from stdin");
 		pgsql_finish(pgsql);
+		destroyPQExpBuffer(row);
 
 		return false;
 	}
 
-	va_end(args);
+	destroyPQExpBuffer(row);
 
 	return true;
 }
@@ -3047,12 +3834,78 @@ pg_copy_end(PGSQL *pgsql)
 		return false;
 	}
 
-	clear_results(pgsql);
+	if (!clear_results(pgsql))
+	{
+		/* errors have already been logged */
+		return false;
+	}
 
 	return true;
 }
 
 
+/*
+ * CopyDataFormatFromString converts a string to a CopyDataFormat enum value.
+ */
+CopyDataFormat
+CopyDataFormatFromString(const char *format)
+{
+	if (strcmp(format, "text") == 0)
+	{
+		return COPY_FORMAT_TEXT;
+	}
+	else if (strcmp(format, "binary") == 0)
+	{
+		return COPY_FORMAT_BINARY;
+	}
+	else if (strcmp(format, "auto") == 0)
+	{
+		return COPY_FORMAT_AUTO;
+	}
+
+	return COPY_FORMAT_UNKNOWN;
+}
+
+
+/*
+ * CopyDataFormatToString converts a CopyDataFormat enum value to string.
+ */
+char *
+CopyDataFormatToString(CopyDataFormat format)
+{
+	switch (format)
+	{
+		case COPY_FORMAT_UNKNOWN:
+		{
+			return "unknown";
+		}
+
+		case COPY_FORMAT_TEXT:
+		{
+			return "text";
+		}
+
+		case COPY_FORMAT_BINARY:
+		{
+			return "binary";
+		}
+
+		case COPY_FORMAT_AUTO:
+		{
+			return "auto";
+		}
+
+		default:
+		{
+			log_error("Unknown COPY format %d", format);
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+
 /*
  * pg_copy_send_query prepares the SQL query that opens a COPY protocol from or
  * to a Postgres instance, and checks that the server's result is as expected.
@@ -3570,31 +4423,381 @@ pg_copy_large_object(PGSQL *src,
 		bytesWritten =
 			lo_write(dst->connection, dstfd, buffer, (size_t) bytesRead);
 
-		if (bytesWritten != bytesRead)
-		{
-			char context[BUFSIZE] = { 0 };
+		if (bytesWritten != bytesRead)
+		{
+			char context[BUFSIZE] = { 0 };
+
+			sformat(context, sizeof(context),
+					"Failed to write large object %u", blobOid);
+
+			(void) pgcopy_log_error(dst, NULL, context);
+
+			lo_close(src->connection, srcfd);
+			lo_close(dst->connection, dstfd);
+
+			pgsql_finish(src);
+			pgsql_finish(dst);
+
+			return false;
+		}
+
+		*bytesTransmitted += bytesRead;
+	} while (bytesRead > 0);
+
+	lo_close(src->connection, srcfd);
+	lo_close(dst->connection, dstfd);
+
+	return true;
+}
+
+
+/*
+ * pg_large_object_batch_init allocates the arrays of the given batch for up
+ * to size large objects.
+ */
+bool
+pg_large_object_batch_init(LargeObjectBatch *batch, int size)
+{
+	batch->size = size;
+	batch->oids = (uint32_t *) calloc(size, sizeof(uint32_t));
+	batch->smallRows = (int *) calloc(size, sizeof(int));
+	batch->largeOids = (uint32_t *) calloc(size, sizeof(uint32_t));
+
+	if (batch->oids == NULL ||
+		batch->smallRows == NULL ||
+		batch->largeOids == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	(void) pg_large_object_batch_reset(batch);
+
+	return true;
+}
+
+
+/*
+ * pg_large_object_batch_reset prepares the given batch to be filled again.
+ */
+void
+pg_large_object_batch_reset(LargeObjectBatch *batch)
+{
+	if (batch->result != NULL)
+	{
+		PQclear(batch->result);
+	}
+
+	batch->count = 0;
+	batch->estBytes = 0;
+	batch->result = NULL;
+	batch->smallCount = 0;
+	batch->largeCount = 0;
+	batch->bytes = 0;
+	batch->sent = false;
+}
+
+
+/*
+ * pg_large_object_batch_free releases the memory used by the given batch.
+ */
+void
+pg_large_object_batch_free(LargeObjectBatch *batch)
+{
+	(void) pg_large_object_batch_reset(batch);
+
+	free(batch->oids);
+	free(batch->smallRows);
+	free(batch->largeOids);
+}
+
+
+/*
+ * pg_large_object_batch_oids_array prepares a Postgres array literal of the
+ * given large object OIDs, such as {16385,16386}.
+ */
+static bool
+pg_large_object_batch_oids_array(PQExpBuffer buffer, uint32_t *oids, int count)
+{
+	appendPQExpBufferChar(buffer, '{');
+
+	for (int i = 0; i < count; i++)
+	{
+		appendPQExpBuffer(buffer, "%s%u", i == 0 ? "" : ",", oids[i]);
+	}
+
+	appendPQExpBufferChar(buffer, '}');
+
+	if (PQExpBufferBroken(buffer))
+	{
+		log_error("Failed to prepare large objects batch: out of memory");
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * pg_large_object_batch_fetch fetches the contents of all the large objects
+ * of the batch at once with lo_get(), reading at most
+ * LARGE_OBJECT_BATCH_MAX_BYTES + 1 bytes of each of them. The large objects
+ * that are bigger than that are registered in batch->largeOids, and need to
+ * be copied with pg_copy_large_object.
+ */
+bool
+pg_large_object_batch_fetch(PGSQL *src, LargeObjectBatch *batch)
+{
+	char *sql =
+		"select t.oid, lo_get(t.oid, 0, $2::integer) "
+		"  from unnest($1::oid[]) as t(oid)";
+
+	PQExpBuffer oids = createPQExpBuffer();
+
+	if (!pg_large_object_batch_oids_array(oids, batch->oids, batch->count))
+	{
+		destroyPQExpBuffer(oids);
+		return false;
+	}
+
+	char maxBytes[BUFSIZE] = { 0 };
+	sformat(maxBytes, sizeof(maxBytes), "%d", LARGE_OBJECT_BATCH_MAX_BYTES + 1);
+
+	const char *paramValues[2] = { oids->data, maxBytes };
+
+	/* fetch the results in binary format, to get the bytea contents as-is */
+	PGresult *result =
+		PQexecParams(src->connection, sql, 2, NULL, paramValues, NULL, NULL, 1);
+
+	destroyPQExpBuffer(oids);
+
+	if (!is_response_ok(result))
+	{
+		(void) pgcopy_log_error(src, result, "Failed to fetch large objects");
+		PQclear(result);
+		return false;
+	}
+
+	if (PQnfields(result) != 2 ||
+		(PQntuples(result) > 0 && PQgetlength(result, 0, 0) != sizeof(uint32_t)))
+	{
+		log_error("Failed to parse large objects batch result");
+		PQclear(result);
+		return false;
+	}
+
+	batch->result = result;
+
+	for (int row = 0; row < PQntuples(result); row++)
+	{
+		uint32_t oid = 0;
+
+		memcpy(&oid, PQgetvalue(result, row, 0), sizeof(uint32_t));
+		oid = ntohl(oid);
+
+		int length = PQgetlength(result, row, 1);
+
+		if (length > LARGE_OBJECT_BATCH_MAX_BYTES)
+		{
+			batch->largeOids[batch->largeCount++] = oid;
+		}
+		else
+		{
+			batch->smallRows[batch->smallCount++] = row;
+			batch->bytes += length;
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ * pg_large_object_batch_send creates the small large objects of the batch on
+ * the target database, and then sends their contents with lo_put() in a
+ * single query, without waiting for the result: the caller then fetches the
+ * next batch from the source database while the target database is busy
+ * writing this one. Use pg_large_object_batch_wait to get the results.
+ *
+ * See pg_copy_large_object for the handling of existing large objects.
+ */
+bool
+pg_large_object_batch_send(PGSQL *dst, LargeObjectBatch *batch, bool dropIfExists)
+{
+	PGresult *srcResult = batch->result;
+
+	if (batch->smallCount == 0)
+	{
+		return true;
+	}
+
+	PQExpBuffer oids = createPQExpBuffer();
+	uint32_t *smallOids = (uint32_t *) calloc(batch->smallCount, sizeof(uint32_t));
+
+	if (smallOids == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		destroyPQExpBuffer(oids);
+		return false;
+	}
+
+	for (int i = 0; i < batch->smallCount; i++)
+	{
+		uint32_t oid = 0;
+
+		memcpy(&oid, PQgetvalue(srcResult, batch->smallRows[i], 0), sizeof(uint32_t));
+		smallOids[i] = ntohl(oid);
+	}
+
+	if (!pg_large_object_batch_oids_array(oids, smallOids, batch->smallCount))
+	{
+		free(smallOids);
+		destroyPQExpBuffer(oids);
+		return false;
+	}
+
+	const Oid paramTypes[1] = { TEXTOID };
+	const char *paramValues[1] = { oids->data };
+
+	if (dropIfExists)
+	{
+		char *unlink =
+			"select lo_unlink(t.oid) "
+			"  from unnest($1::text::oid[]) as t(oid) "
+			" where exists(select 1 "
+			"                from pg_largeobject_metadata m "
+			"               where m.oid = t.oid)";
+
+		if (!pgsql_execute_with_params(dst, unlink, 1, paramTypes, paramValues,
+									   NULL, NULL))
+		{
+			/* errors have already been logged */
+			free(smallOids);
+			destroyPQExpBuffer(oids);
+			return false;
+		}
+	}
+
+	char *create =
+		"select lo_create(t.oid) "
+		"  from unnest($1::text::oid[]) as t(oid) "
+		" where not exists(select 1 "
+		"                    from pg_largeobject_metadata m "
+		"                   where m.oid = t.oid)";
+
+	if (!pgsql_execute_with_params(dst, create, 1, paramTypes, paramValues,
+								   NULL, NULL))
+	{
+		/* errors have already been logged */
+		free(smallOids);
+		destroyPQExpBuffer(oids);
+		return false;
+	}
+
+	destroyPQExpBuffer(oids);
+
+	/*
+	 * Now send the contents, the OIDs in text format and the contents in
+	 * binary format, straight from the source result.
+	 */
+	int nParams = 2 * batch->smallCount;
+
+	PQExpBuffer sql = createPQExpBuffer();
+	char (*oidStrings)[INTSTRING_MAX_DIGITS] =
+		calloc(batch->smallCount, INTSTRING_MAX_DIGITS);
+	const char **values = (const char **) calloc(nParams, sizeof(char *));
+	int *lengths = (int *) calloc(nParams, sizeof(int));
+	int *formats = (int *) calloc(nParams, sizeof(int));
+
+	if (oidStrings == NULL || values == NULL || lengths == NULL || formats == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		free(smallOids);
+		destroyPQExpBuffer(sql);
+		return false;
+	}
+
+	appendPQExpBufferStr(sql,
+						 "select lo_put(v.oid, 0, v.data) from (values ");
+
+	for (int i = 0; i < batch->smallCount; i++)
+	{
+		int row = batch->smallRows[i];
+
+		appendPQExpBuffer(sql, "%s($%d::oid, $%d::bytea)",
+						  i == 0 ? "" : ", ",
+						  2 * i + 1,
+						  2 * i + 2);
+
+		sformat(oidStrings[i], INTSTRING_MAX_DIGITS, "%u", smallOids[i]);
+
+		values[2 * i] = oidStrings[i];
+		formats[2 * i] = 0;
+
+		values[2 * i + 1] = PQgetvalue(srcResult, row, 1);
+		lengths[2 * i + 1] = PQgetlength(srcResult, row, 1);
+		formats[2 * i + 1] = 1;
+	}
+
+	appendPQExpBufferStr(sql, ") as v(oid, data)");
+
+	bool success = true;
+
+	if (PQExpBufferBroken(sql))
+	{
+		log_error("Failed to prepare large objects batch: out of memory");
+		success = false;
+	}
+	else if (!PQsendQueryParams(dst->connection, sql->data, nParams, NULL,
+								values, lengths, formats, 0))
+	{
+		(void) pgcopy_log_error(dst, NULL, "Failed to send large objects");
+		success = false;
+	}
+
+	batch->sent = success;
+
+	free(smallOids);
+	free(oidStrings);
+	free(values);
+	free(lengths);
+	free(formats);
+	destroyPQExpBuffer(sql);
 
-			sformat(context, sizeof(context),
-					"Failed to write large object %u", blobOid);
+	return success;
+}
 
-			(void) pgcopy_log_error(dst, NULL, context);
 
-			lo_close(src->connection, srcfd);
-			lo_close(dst->connection, dstfd);
+/*
+ * pg_large_object_batch_wait waits until the target database is done with
+ * the lo_put() query sent by pg_large_object_batch_send.
+ */
+bool
+pg_large_object_batch_wait(PGSQL *dst, LargeObjectBatch *batch)
+{
+	bool success = true;
 
-			pgsql_finish(src);
-			pgsql_finish(dst);
+	if (!batch->sent)
+	{
+		return true;
+	}
 
-			return false;
+	PGresult *result = NULL;
+
+	while ((result = PQgetResult(dst->connection)) != NULL)
+	{
+		if (!is_response_ok(result))
+		{
+			(void) pgcopy_log_error(dst, result, "Failed to write large objects");
+			success = false;
 		}
 
-		*bytesTransmitted += bytesRead;
-	} while (bytesRead > 0);
+		PQclear(result);
+	}
 
-	lo_close(src->connection, srcfd);
-	lo_close(dst->connection, dstfd);
+	batch->sent = false;
 
-	return true;
+	return success;
 }
 
 
@@ -3696,6 +4899,58 @@ OutputPluginToString(StreamOutputPlugin plugin)
 }
 
 
+/*
+ * TransformFormatFromString returns an enum value from its string
+ * representation.
+ */
+StreamTransformFormat
+TransformFormatFromString(const char *format)
+{
+	if (strcmp(format, "sql") == 0)
+	{
+		return STREAM_FORMAT_SQL;
+	}
+	else if (strcmp(format, "binary") == 0)
+	{
+		return STREAM_FORMAT_BINARY;
+	}
+
+	return STREAM_FORMAT_UNKNOWN;
+}
+
+
+/*
+ * TransformFormatToString converts a StreamTransformFormat enum to string.
+ */
+char *
+TransformFormatToString(StreamTransformFormat format)
+{
+	switch (format)
+	{
+		case STREAM_FORMAT_UNKNOWN:
+		{
+			return "unknown";
+		}
+
+		case STREAM_FORMAT_SQL:
+		{
+			return "sql";
+		}
+
+		case STREAM_FORMAT_BINARY:
+		{
+			return "binary";
+		}
+
+		default:
+		{
+			log_error("Unknown transform format %d", format);
+			return NULL;
+		}
+	}
+}
+
+
 /*
  * Send the CREATE_REPLICATION_SLOT logical replication command.
  *
@@ -4968,6 +6223,90 @@ pgsql_replication_origin_progress(PGSQL *pgsql,
 }
 
 
+/*
+ * pgsql_replication_origin_max_progress fetches the most advanced progress of
+ * the given replication origin and of the replication origins which name
+ * starts with the given prefix, as used by the apply workers.
+ */
+bool
+pgsql_replication_origin_max_progress(PGSQL *pgsql,
+									  char *nodeName,
+									  char *prefix,
+									  bool flush,
+									  uint64_t *lsn)
+{
+	SingleValueResultContext context = { { 0 }, PGSQL_RESULT_STRING, false };
+
+	const char *sql =
+		"select ( "
+		"  select pg_replication_origin_progress(roname, $3) "
+		"    from pg_replication_origin "
+		"   where roname = $1 or left(roname, length($2)) = $2 "
+		"order by 1 desc nulls last "
+		"   limit 1 "
+		")";
+
+	int paramCount = 3;
+	Oid paramTypes[3] = { TEXTOID, TEXTOID, BOOLOID };
+	const char *paramValues[3] = { nodeName, prefix, flush ? "t" : "f" };
+
+	if (!pgsql_execute_with_params(pgsql, sql,
+								   paramCount, paramTypes, paramValues,
+								   &context, &parseSingleValueResult))
+	{
+		log_error("Failed to fetch progress of replication origins \"%s\" "
+				  "and \"%s*\"",
+				  nodeName,
+				  prefix);
+		return false;
+	}
+
+	if (context.isNull)
+	{
+		/* when we get a NULL, return 0/0 instead */
+		*lsn = InvalidXLogRecPtr;
+	}
+	else if (!parseLSN(context.strVal, lsn))
+	{
+		log_error("Failed to parse LSN \"%s\" returned from "
+				  "pg_replication_origin_progress",
+				  context.strVal);
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * pgsql_replication_origin_drop_prefix drops all the replication origins
+ * which name starts with the given prefix.
+ */
+bool
+pgsql_replication_origin_drop_prefix(PGSQL *pgsql, char *prefix)
+{
+	char *sql =
+		"SELECT pg_replication_origin_drop(roname) "
+		"  FROM pg_replication_origin "
+		" WHERE left(roname, length($1)) = $1";
+	int paramCount = 1;
+	Oid paramTypes[1] = { TEXTOID };
+	const char *paramValues[1] = { prefix };
+
+	log_info("Dropping replication origins \"%s*\"", prefix);
+
+	if (!pgsql_execute_with_params(pgsql, sql,
+								   paramCount, paramTypes, paramValues,
+								   NULL, NULL))
+	{
+		log_error("Failed to drop replication origins \"%s*\"", prefix);
+		return false;
+	}
+
+	return true;
+}
+
+
 /*
  * pgsql_replication_slot_exists checks that a replication slot with the given
  * slotName exists on the Postgres server.
@@ -5114,6 +6453,197 @@ pgsql_table_exists(PGSQL *pgsql,
 }
 
 
+/*
+ * pgsql_index_is_invalid checks if the given index exists and is marked
+ * invalid, which happens when CREATE INDEX CONCURRENTLY failed.
+ */
+bool
+pgsql_index_is_invalid(PGSQL *pgsql, const char *qname, bool *invalid)
+{
+	SingleValueResultContext context = { { 0 }, PGSQL_RESULT_BOOL, false };
+
+	char *sql =
+		"select exists( "
+		"         select 1 "
+		"           from pg_index "
+		"          where indexrelid = to_regclass($1) "
+		"            and not indisvalid "
+		"       )";
+
+	int paramCount = 1;
+	const Oid paramTypes[1] = { TEXTOID };
+	const char *paramValues[1] = { qname };
+
+	if (!pgsql_execute_with_params(pgsql, sql,
+								   paramCount, paramTypes, paramValues,
+								   &context, &parseSingleValueResult))
+	{
+		log_error("Failed to check if index %s is valid", qname);
+		return false;
+	}
+
+	if (!context.parsedOk)
+	{
+		log_error("Failed to check if index %s is valid", qname);
+		return false;
+	}
+
+	*invalid = context.boolVal;
+
+	return true;
+}
+
+
+/*
+ * pgsql_fk_constraint_is_not_valid checks if the given FK constraint exists
+ * on the given table and is marked NOT VALID.
+ */
+bool
+pgsql_fk_constraint_is_not_valid(PGSQL *pgsql,
+								 const char *qname,
+								 const char *conname,
+								 bool *notValid)
+{
+	SingleValueResultContext context = { { 0 }, PGSQL_RESULT_BOOL, false };
+
+	char *sql =
+		"select exists( "
+		"         select 1 "
+		"           from pg_constraint "
+		"          where conrelid = to_regclass($1) "
+		"            and format('%I', conname) = $2 "
+		"            and contype = 'f' "
+		"            and not convalidated "
+		"       )";
+
+	int paramCount = 2;
+	const Oid paramTypes[2] = { TEXTOID, TEXTOID };
+	const char *paramValues[2] = { qname, conname };
+
+	if (!pgsql_execute_with_params(pgsql, sql,
+								   paramCount, paramTypes, paramValues,
+								   &context, &parseSingleValueResult))
+	{
+		log_error("Failed to check if constraint %s on %s is valid",
+				  conname, qname);
+		return false;
+	}
+
+	if (!context.parsedOk)
+	{
+		log_error("Failed to check if constraint %s on %s is valid",
+				  conname, qname);
+		return false;
+	}
+
+	*notValid = context.boolVal;
+
+	return true;
+}
+
+
+/*
+ * pgsql_table_is_unlogged checks if the given table exists and is unlogged.
+ */
+bool
+pgsql_table_is_unlogged(PGSQL *pgsql, const char *qname, bool *unlogged)
+{
+	SingleValueResultContext context = { { 0 }, PGSQL_RESULT_BOOL, false };
+
+	char *sql =
+		"select exists( "
+		"         select 1 "
+		"           from pg_class "
+		"          where oid = to_regclass($1) "
+		"            and relpersistence = 'u' "
+		"       )";
+
+	int paramCount = 1;
+	const Oid paramTypes[1] = { TEXTOID };
+	const char *paramValues[1] = { qname };
+
+	if (!pgsql_execute_with_params(pgsql, sql,
+								   paramCount, paramTypes, paramValues,
+								   &context, &parseSingleValueResult))
+	{
+		log_error("Failed to check if table %s is unlogged", qname);
+		return false;
+	}
+
+	if (!context.parsedOk)
+	{
+		log_error("Failed to check if table %s is unlogged", qname);
+		return false;
+	}
+
+	*unlogged = context.boolVal;
+
+	return true;
+}
+
+
+/*
+ * pgsql_table_is_empty checks if the given table has no rows.
+ */
+bool
+pgsql_table_is_empty(PGSQL *pgsql, const char *qname, bool *empty)
+{
+	SingleValueResultContext context = { { 0 }, PGSQL_RESULT_BOOL, false };
+
+	char sql[BUFSIZE] = { 0 };
+
+	sformat(sql, sizeof(sql), "select not exists(select 1 from %s)", qname);
+
+	if (!pgsql_execute_with_params(pgsql, sql, 0, NULL, NULL,
+								   &context, &parseSingleValueResult))
+	{
+		log_error("Failed to check if table %s is empty", qname);
+		return false;
+	}
+
+	if (!context.parsedOk)
+	{
+		log_error("Failed to check if table %s is empty", qname);
+		return false;
+	}
+
+	*empty = context.boolVal;
+
+	return true;
+}
+
+
+/*
+ * pgsql_postmaster_start_time sets startTime to the epoch of the time when
+ * the Postgres server started.
+ */
+bool
+pgsql_postmaster_start_time(PGSQL *pgsql, uint64_t *startTime)
+{
+	SingleValueResultContext context = { { 0 }, PGSQL_RESULT_BIGINT, false };
+
+	char *sql =
+		"select extract(epoch from pg_postmaster_start_time())::bigint";
+
+	if (!pgsql_execute_with_params(pgsql, sql, 0, NULL, NULL,
+								   &context, &parseSingleValueResult))
+	{
+		log_error("Failed to get the Postgres server start time");
+		return false;
+	}
+
+	if (!context.parsedOk)
+	{
+		log_error("Failed to get the Postgres server start time");
+		return false;
+	}
+
+	*startTime = context.bigint;
+
+	return true;
+}
+
+
 /*
  * pgsql_role_exists checks that a role with the given roleName exists on the
  * Postgres server.
@@ -48,6 +48,17 @@
  */
 #define LOBBUFSIZE 16 * 1024 * 1024 /* 16 MB */
 
+/*
+ * The COPY loop reads rows from the source into a bounded ring of chunks and
+ * writes them to the target from there, so that both connections are kept
+ * busy. Each chunk is sent in a single CopyData message.
+ */
+#define COPY_PIPELINE_RING_BYTES (8 * 1024 * 1024)  /* 8 MB */
+#define COPY_PIPELINE_RING_MIN_CHUNKS 2
+#define COPY_PIPELINE_RING_MAX_CHUNKS 64
+#define COPY_PIPELINE_DIRECT_ROW_BYTES (64 * 1024)    /* 64 kB */
+#define COPY_PIPELINE_POLL_TIMEOUT_MS 10
+
 
 /*
  * pg_stat_replication.sync_state is one if:
@@ -257,6 +268,7 @@ int pgsql_compute_connection_retry_sleep_time(ConnectionRetryPolicy *retryPolicy
 bool pgsql_retry_policy_expired(ConnectionRetryPolicy *retryPolicy);
 
 bool pgsql_state_is_connection_error(PGSQL *pgsql);
+bool pgsql_state_is_copy_binary_error(PGSQL *pgsql);
 
 void pgsql_finish(PGSQL *pgsql);
 void parseSingleValueResult(void *ctx, PGresult *result);
@@ -307,7 +319,9 @@ bool pgsql_fetch_results(PGSQL *pgsql, bool *done,
 						 void *context, ParsePostgresResultCB *parseFun);
 
 bool pgsql_enable_pipeline_mode(PGSQL *pgsql);
+bool pgsql_disable_pipeline_mode(PGSQL *pgsql);
 bool pgsql_sync_pipeline(PGSQL *pgsql);
+bool pgsql_flush_pipeline(PGSQL *pgsql);
 
 bool pgsql_prepare(PGSQL *pgsql, const char *name, const char *sql,
 				   int paramCount, const Oid *paramTypes);
@@ -321,6 +335,22 @@ bool validate_connection_string(const char *connectionString);
 bool pgsql_lock_table(PGSQL *pgsql, const char *qname, const char *lockmode);
 
 bool pgsql_truncate(PGSQL *pgsql, const char *qname);
+bool pgsql_delete_where(PGSQL *pgsql, const char *qname, const char *whereClause);
+
+/*
+ * COPY format used for table data: text, binary, or decided for each table
+ * from its column types (auto).
+ */
+typedef enum
+{
+	COPY_FORMAT_UNKNOWN = 0,
+	COPY_FORMAT_TEXT,
+	COPY_FORMAT_BINARY,
+	COPY_FORMAT_AUTO
+} CopyDataFormat;
+
+CopyDataFormat CopyDataFormatFromString(const char *format);
+char * CopyDataFormatToString(CopyDataFormat format);
 
 typedef struct CopyArgs
 {
@@ -329,19 +359,27 @@ typedef struct CopyArgs
 	char *srcWhereClause;
 	char *dstQname;
 	char *dstAttrList;
+	char *dstWhereClause;       /* DELETE those target rows before COPY */
 	char *logCommand;
 	bool truncate;
 	bool freeze;
 	bool useCopyBinary;
+	uint64_t bufferSize;        /* COPY chunk size, see --copy-buffer-size */
 } CopyArgs;
 
 
 typedef struct CopyStats
 {
 	uint64_t startTime;
-	uint64_t bytesTransmitted;
+	uint64_t bytesTransmitted;  /* raw COPY data bytes */
+	uint64_t wireBytes;         /* estimated CopyData messages bytes read */
+	uint64_t rowsTransmitted;
+	uint64_t sendCount;         /* count of PQputCopyData calls */
 } CopyStats;
 
+/* a CopyData message has a 1 byte type and 4 bytes length header */
+#define COPY_DATA_MESSAGE_HEADER_SIZE 5
+
 typedef bool (CopyStatsCallback)(void *context, CopyStats *stats);
 
 bool pg_copy(PGSQL *src, PGSQL *dst,
@@ -350,6 +388,7 @@ bool pg_copy(PGSQL *src, PGSQL *dst,
 
 bool pg_copy_from_stdin(PGSQL *pgsql, const char *qname);
 bool pg_copy_row_from_stdin(PGSQL *pgsql, char *fmt, ...);
+bool pg_copy_values_from_stdin(PGSQL *pgsql, int count, const char **values);
 bool pg_copy_end(PGSQL *pgsql);
 
 bool pgsql_get_sequence(PGSQL *pgsql, const char *qname,
@@ -364,6 +403,45 @@ bool pg_copy_large_object(PGSQL *src,
 						  uint32_t oid,
 						  uint64_t *bytesTransmitted);
 
+/*
+ * Large objects up to LARGE_OBJECT_BATCH_MAX_BYTES are copied in batches of
+ * --large-objects-batch-size, fetched with lo_get() and written with lo_put()
+ * in a single query each. Bigger large objects are copied in chunks.
+ *
+ * A batch is also flushed when the known size of its large objects reaches
+ * LARGE_OBJECT_BATCH_MAX_TOTAL_BYTES, so that a worker does not hold
+ * gigabytes of contents in memory.
+ */
+#define LARGE_OBJECT_BATCH_MAX_BYTES (1024 * 1024) /* 1 MB */
+#define LARGE_OBJECT_BATCH_MAX_TOTAL_BYTES (64 * 1024 * 1024) /* 64 MB */
+
+typedef struct LargeObjectBatch
+{
+	int size;                   /* max count of large objects in the batch */
+	int count;                  /* count of large objects in the batch */
+	uint32_t *oids;             /* malloc'ed area, of size entries */
+	uint64_t estBytes;          /* known size of the large objects */
+
+	PGresult *result;           /* lo_get() contents */
+	int smallCount;
+	int *smallRows;             /* rows in result of the small ones */
+	uint64_t bytes;             /* total size of the small ones */
+
+	int largeCount;
+	uint32_t *largeOids;        /* to copy with pg_copy_large_object */
+
+	bool sent;                  /* lo_put() query results are pending */
+} LargeObjectBatch;
+
+bool pg_large_object_batch_init(LargeObjectBatch *batch, int size);
+void pg_large_object_batch_reset(LargeObjectBatch *batch);
+void pg_large_object_batch_free(LargeObjectBatch *batch);
+bool pg_large_object_batch_fetch(PGSQL *src, LargeObjectBatch *batch);
+bool pg_large_object_batch_send(PGSQL *dst,
+								LargeObjectBatch *batch,
+								bool dropIfExists);
+bool pg_large_object_batch_wait(PGSQL *dst, LargeObjectBatch *batch);
+
 /*
  * Maximum length of serialized pg_lsn value
  * It is taken from postgres file pg_lsn.c.
@@ -419,6 +497,17 @@ typedef enum
 	STREAM_PLUGIN_WAL2JSON
 } StreamOutputPlugin;
 
+/*
+ * Format of the files written by the transform process and read by the apply
+ * process, see ld_binary.c.
+ */
+typedef enum
+{
+	STREAM_FORMAT_UNKNOWN = 0,
+	STREAM_FORMAT_SQL,
+	STREAM_FORMAT_BINARY
+} StreamTransformFormat;
+
 typedef struct LogicalTrackLSN
 {
 	XLogRecPtr written_lsn;
@@ -503,6 +592,9 @@ bool pgsql_init_stream(LogicalStreamClient *client,
 StreamOutputPlugin OutputPluginFromString(char *plugin);
 char * OutputPluginToString(StreamOutputPlugin plugin);
 
+StreamTransformFormat TransformFormatFromString(const char *format);
+char * TransformFormatToString(StreamTransformFormat format);
+
 typedef struct ReplicationSlot
 {
 	char slotName[BUFSIZE];
@@ -544,6 +636,14 @@ bool pgsql_replication_origin_progress(PGSQL *pgsql,
 									   bool flush,
 									   uint64_t *lsn);
 
+bool pgsql_replication_origin_max_progress(PGSQL *pgsql,
+										   char *nodeName,
+										   char *prefix,
+										   bool flush,
+										   uint64_t *lsn);
+
+bool pgsql_replication_origin_drop_prefix(PGSQL *pgsql, char *prefix);
+
 bool pgsql_replication_slot_exists(PGSQL *pgsql,
 								   const char *slotName,
 								   bool *slotExists,
@@ -561,6 +661,15 @@ bool pgsql_table_exists(PGSQL *pgsql,
 						const char *relname,
 						bool *exists);
 
+bool pgsql_index_is_invalid(PGSQL *pgsql, const char *qname, bool *invalid);
+bool pgsql_fk_constraint_is_not_valid(PGSQL *pgsql,
+									  const char *qname,
+									  const char *conname,
+									  bool *notValid);
+bool pgsql_table_is_unlogged(PGSQL *pgsql, const char *qname, bool *unlogged);
+bool pgsql_table_is_empty(PGSQL *pgsql, const char *qname, bool *empty);
+bool pgsql_postmaster_start_time(PGSQL *pgsql, uint64_t *startTime);
+
 bool pgsql_current_wal_flush_lsn(PGSQL *pgsql, uint64_t *lsn);
 
 char * pgsql_escape_identifier(PGSQL *pgsql, char *src);
@@ -62,6 +62,15 @@ static bool copydb_table_parts_array_as_json_hook(void *ctx,
 
 static bool copydb_update_progress_table_hook(void *ctx, SourceTable *table);
 static bool copydb_update_progress_index_hook(void *ctx, SourceIndex *index);
+static bool copydb_update_progress_pending_hook(void *ctx, SourceIndex *index);
+static bool copydb_update_progress_eta(DatabaseCatalog *sourceDB,
+									   CopyProgress *progress);
+static bool copydb_progress_estimate(int64_t total,
+									 int64_t done,
+									 uint64_t startTime,
+									 uint64_t now,
+									 uint64_t *elapsedMs,
+									 uint64_t *etaMs);
 
 
 /*
@@ -719,6 +728,157 @@ copydb_update_progress(CopyDataSpec *copySpecs, CopyProgress *progress)
 		return false;
 	}
 
+	/* list the next indexes to build, in priority order */
+	progress->indexPending.count = 0;
+	progress->indexPending.capacity = PROGRESS_PENDING_INDEX_COUNT;
+	progress->indexPending.array =
+		(SourceIndex *) calloc(progress->indexPending.capacity,
+							   sizeof(SourceIndex));
+
+	if (progress->indexPending.array == NULL)
+	{
+		log_fatal(ALLOCATION_FAILED_ERROR);
+		return false;
+	}
+
+	if (!catalog_iter_s_index_pending(sourceDB,
+									  &context,
+									  &copydb_update_progress_pending_hook))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (!copydb_update_progress_eta(sourceDB, progress))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * copydb_update_progress_pending_hook is an iterator callback function that
+ * keeps the first PROGRESS_PENDING_INDEX_COUNT indexes that are not built
+ * yet.
+ */
+static bool
+copydb_update_progress_pending_hook(void *ctx, SourceIndex *index)
+{
+	TableProgressContext *context = (TableProgressContext *) ctx;
+	SourceIndexArray *indexPending = &(context->progress->indexPending);
+
+	if (indexPending->count < indexPending->capacity)
+	{
+		indexPending->array[indexPending->count++] = *index;
+	}
+
+	return true;
+}
+
+
+/*
+ * copydb_update_progress_eta estimates the time remaining until the COPY of
+ * the table data and the CREATE INDEX commands are done, using the throughput
+ * observed so far: bytes done divided by the time elapsed since the first
+ * command of each kind started.
+ *
+ * Tables and indexes are processed concurrently, so the time remaining for
+ * the whole operation is the largest of the two estimates.
+ */
+static bool
+copydb_update_progress_eta(DatabaseCatalog *sourceDB, CopyProgress *progress)
+{
+	CatalogProgressBytes *bytes = &(progress->bytes);
+
+	if (!catalog_progress_bytes(sourceDB, bytes))
+	{
+		log_error("Failed to compute bytes done in our catalogs");
+		return false;
+	}
+
+	uint64_t now = time(NULL);
+
+	progress->tableEtaKnown =
+		copydb_progress_estimate(bytes->tableBytes,
+								 bytes->tableBytesDone,
+								 bytes->tableStartTime,
+								 now,
+								 &(progress->tableElapsedMs),
+								 &(progress->tableEtaMs));
+
+	progress->indexEtaKnown =
+		copydb_progress_estimate(bytes->indexBytes,
+								 bytes->indexBytesDone,
+								 bytes->indexStartTime,
+								 now,
+								 &(progress->indexElapsedMs),
+								 &(progress->indexEtaMs));
+
+	progress->etaMs = 0;
+
+	if (progress->tableEtaKnown)
+	{
+		progress->etaMs = progress->tableEtaMs;
+	}
+
+	if (progress->indexEtaKnown && progress->indexEtaMs > progress->etaMs)
+	{
+		progress->etaMs = progress->indexEtaMs;
+	}
+
+	log_debug("copydb_update_progress_eta: "
+			  "tables %lld/%lld bytes, indexes %lld/%lld bytes, "
+			  "eta %llds",
+			  (long long) bytes->tableBytesDone,
+			  (long long) bytes->tableBytes,
+			  (long long) bytes->indexBytesDone,
+			  (long long) bytes->indexBytes,
+			  (long long) (progress->etaMs / 1000));
+
+	return true;
+}
+
+
+/*
+ * copydb_progress_estimate computes the elapsed time since startTime and the
+ * time remaining to process the total bytes at the throughput observed so
+ * far. Returns false when the throughput is unknown yet.
+ */
+static bool
+copydb_progress_estimate(int64_t total,
+						 int64_t done,
+						 uint64_t startTime,
+						 uint64_t now,
+						 uint64_t *elapsedMs,
+						 uint64_t *etaMs)
+{
+	*elapsedMs = 0;
+	*etaMs = 0;
+
+	if (startTime == 0 || now < startTime)
+	{
+		return false;
+	}
+
+	*elapsedMs = (now - startTime) * 1000;
+
+	if (done >= total)
+	{
+		return true;
+	}
+
+	if (done <= 0 || *elapsedMs == 0)
+	{
+		return false;
+	}
+
+	double remaining = (double) (total - done);
+
+	*etaMs = (uint64_t) (remaining * (double) *elapsedMs / (double) done);
+
 	return true;
 }
 
@@ -972,7 +1132,72 @@ copydb_progress_as_json(CopyDataSpec *copySpecs,
 		}
 	}
 
+	/* next indexes to build, highest estimated build cost first */
+	JSON_Value *jsPending = json_value_init_array();
+	JSON_Array *jsPendingArray = json_value_get_array(jsPending);
+
+	for (int i = 0; i < progress->indexPending.count; i++)
+	{
+		SourceIndex *index = &(progress->indexPending.array[i]);
+
+		JSON_Value *jsPendingIndex = json_value_init_object();
+		JSON_Object *jsPendingObj = json_value_get_object(jsPendingIndex);
+
+		json_object_set_number(jsPendingObj, "oid", (double) index->indexOid);
+		json_object_set_string(jsPendingObj, "qname", index->indexQname);
+		json_object_dotset_string(jsPendingObj, "table.qname", index->tableQname);
+		json_object_set_number(jsPendingObj, "bytes", (double) index->bytes);
+		json_object_set_number(jsPendingObj, "cost", (double) index->cost);
+
+		json_array_append_value(jsPendingArray, jsPendingIndex);
+	}
+
+	json_object_set_value(jsIndexObj, "pending", jsPending);
+
 	json_object_set_value(jsobj, "indexes", jsIndex);
 
+	/* bytes done and estimated time remaining */
+	JSON_Value *jsEta = json_value_init_object();
+	JSON_Object *jsEtaObj = json_value_get_object(jsEta);
+
+	CatalogProgressBytes *bytes = &(progress->bytes);
+
+	json_object_dotset_number(jsEtaObj, "tables.bytes", bytes->tableBytes);
+	json_object_dotset_number(jsEtaObj, "tables.done", bytes->tableBytesDone);
+
+	if (progress->tableEtaKnown)
+	{
+		json_object_dotset_number(jsEtaObj, "tables.remaining",
+								  progress->tableEtaMs);
+	}
+	else
+	{
+		json_object_dotset_null(jsEtaObj, "tables.remaining");
+	}
+
+	json_object_dotset_number(jsEtaObj, "indexes.bytes", bytes->indexBytes);
+	json_object_dotset_number(jsEtaObj, "indexes.done", bytes->indexBytesDone);
+
+	if (progress->indexEtaKnown)
+	{
+		json_object_dotset_number(jsEtaObj, "indexes.remaining",
+								  progress->indexEtaMs);
+	}
+	else
+	{
+		json_object_dotset_null(jsEtaObj, "indexes.remaining");
+	}
+
+	if (progress->tableEtaKnown || progress->indexEtaKnown)
+	{
+		json_object_set_number(jsEtaObj, "remaining", progress->etaMs);
+	}
+	else
+	{
+		json_object_set_null(jsEtaObj, "remaining");
+	}
+
+	json_object_set_value(jsobj, "eta", jsEta);
+
 	return true;
 }
@@ -40,6 +40,20 @@ typedef struct CopyProgress
 	int indexDoneCount;
 	SourceIndexArray indexInProgress;
 	CopyIndexSummaryArray indexSummaryArray;
+
+	/* next indexes to build, in the CREATE INDEX queue priority order */
+	SourceIndexArray indexPending;
+
+	/* bytes done and observed throughput, to estimate the time remaining */
+	CatalogProgressBytes bytes;
+	uint64_t tableElapsedMs;
+	uint64_t indexElapsedMs;
+
+	bool tableEtaKnown;
+	bool indexEtaKnown;
+	uint64_t tableEtaMs;
+	uint64_t indexEtaMs;
+	uint64_t etaMs;
 } CopyProgress;
 
 
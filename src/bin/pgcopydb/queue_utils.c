@@ -18,6 +18,20 @@
 #include "queue_utils.h"
 #include "signals.h"
 
+/*
+ * The System V message queue calls are used with IPC_NOWAIT, so that we can
+ * check for signals in between attempts: a signal that arrives right before
+ * a blocking msgrcv() would otherwise only be processed when the next
+ * message is received. In between attempts we sleep for QUEUE_MIN_SLEEP_US
+ * first, and then twice as long each time up to QUEUE_MAX_SLEEP_US, so that
+ * messages are processed quickly while idle workers still check for signals
+ * every 10ms.
+ */
+#define QUEUE_MIN_SLEEP_US 100
+#define QUEUE_MAX_SLEEP_US (10 * 1000)
+
+static void queue_wait(int *sleepTimeUs);
+
 
 /*
  * queue_create creates a new message queue.
@@ -85,7 +99,7 @@ bool
 queue_send(Queue *queue, QMessage *msg)
 {
 	int errStatus;
-	bool firstLoop = true;
+	int sleepTimeUs = 0;
 
 	do {
 		if (asked_to_stop || asked_to_stop_fast || asked_to_quit)
@@ -93,14 +107,7 @@ queue_send(Queue *queue, QMessage *msg)
 			return false;
 		}
 
-		if (firstLoop)
-		{
-			firstLoop = false;
-		}
-		else
-		{
-			pg_usleep(10 * 1000); /* 10 ms */
-		}
+		queue_wait(&sleepTimeUs);
 
 		errStatus = msgsnd(queue->qId, msg, sizeof(msg->data), IPC_NOWAIT);
 	} while (errStatus < 0 && (errno == EINTR || errno == EAGAIN));
@@ -126,7 +133,7 @@ bool
 queue_receive(Queue *queue, QMessage *msg)
 {
 	int errStatus;
-	bool firstLoop = true;
+	int sleepTimeUs = 0;
 
 	do {
 		if (asked_to_stop || asked_to_stop_fast || asked_to_quit)
@@ -134,16 +141,91 @@ queue_receive(Queue *queue, QMessage *msg)
 			return false;
 		}
 
-		if (firstLoop)
+		queue_wait(&sleepTimeUs);
+
+		errStatus = msgrcv(queue->qId, msg, sizeof(msg->data), 0, IPC_NOWAIT);
+	} while (errStatus < 0 && (errno == EINTR || errno == ENOMSG));
+
+	if (errStatus < 0)
+	{
+		log_error("Failed to receive a message from %s queue (%d): %m",
+				  queue->name,
+				  queue->qId);
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * queue_send_priority sends a message on a priority queue. Messages with the
+ * lowest priority value are received first, and messages with the same
+ * priority are received in the order they were sent.
+ *
+ * The message type of a System V message is used as the priority, so the
+ * whole QMessage is sent as the payload.
+ */
+bool
+queue_send_priority(Queue *queue, QMessage *msg, long priority)
+{
+	int errStatus;
+	int sleepTimeUs = 0;
+
+	QPriorityMessage pmsg = {
+		.priority = priority < QUEUE_PRIORITY_HIGHEST ?
+					QUEUE_PRIORITY_HIGHEST : priority,
+		.msg = *msg
+	};
+
+	do {
+		if (asked_to_stop || asked_to_stop_fast || asked_to_quit)
 		{
-			firstLoop = false;
+			return false;
 		}
-		else
+
+		queue_wait(&sleepTimeUs);
+
+		errStatus = msgsnd(queue->qId, &pmsg, sizeof(pmsg.msg), IPC_NOWAIT);
+	} while (errStatus < 0 && (errno == EINTR || errno == EAGAIN));
+
+	if (errStatus < 0)
+	{
+		log_error("Failed to send a message to %s queue (%d) "
+				  "with type %ld and priority %ld: %m",
+				  queue->name,
+				  queue->qId,
+				  msg->type,
+				  pmsg.priority);
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * queue_receive_priority receives the message with the lowest priority value
+ * from a priority queue, see msgrcv(2) with a negative msgtyp.
+ */
+bool
+queue_receive_priority(Queue *queue, QMessage *msg)
+{
+	int errStatus;
+	int sleepTimeUs = 0;
+
+	QPriorityMessage pmsg = { 0 };
+
+	do {
+		if (asked_to_stop || asked_to_stop_fast || asked_to_quit)
 		{
-			pg_usleep(10 * 1000); /* 10 ms */
+			return false;
 		}
 
-		errStatus = msgrcv(queue->qId, msg, sizeof(msg->data), 0, IPC_NOWAIT);
+		queue_wait(&sleepTimeUs);
+
+		errStatus = msgrcv(queue->qId, &pmsg, sizeof(pmsg.msg),
+						   -QUEUE_PRIORITY_LOWEST, IPC_NOWAIT);
 	} while (errStatus < 0 && (errno == EINTR || errno == ENOMSG));
 
 	if (errStatus < 0)
@@ -154,10 +236,32 @@ queue_receive(Queue *queue, QMessage *msg)
 		return false;
 	}
 
+	*msg = pmsg.msg;
+
 	return true;
 }
 
 
+/*
+ * queue_wait sleeps in between two attempts at a queue operation, the first
+ * attempt does not sleep.
+ */
+static void
+queue_wait(int *sleepTimeUs)
+{
+	if (*sleepTimeUs == 0)
+	{
+		*sleepTimeUs = QUEUE_MIN_SLEEP_US;
+		return;
+	}
+
+	pg_usleep(*sleepTimeUs);
+
+	*sleepTimeUs = *sleepTimeUs * 2 > QUEUE_MAX_SLEEP_US ?
+				   QUEUE_MAX_SLEEP_US : *sleepTimeUs * 2;
+}
+
+
 /*
  * queue_stats retrieves statistics from the queue.
  */
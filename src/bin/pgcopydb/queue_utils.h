@@ -6,6 +6,7 @@
 #ifndef QUEUE_UTILS_H
 #define QUEUE_UTILS_H
 
+#include <limits.h>
 #include <stdbool.h>
 
 #include <sys/types.h>
@@ -52,6 +53,13 @@ typedef struct QMessage
 			uint32_t oid;
 			uint32_t part;
 		} tp;
+
+		/* large objects, bytes is -1 when unknown */
+		struct lo
+		{
+			uint32_t oid;
+			int64_t bytes;
+		} lo;
 	} data;
 } QMessage;
 
@@ -61,6 +69,23 @@ bool queue_unlink(Queue *queue);
 bool queue_send(Queue *queue, QMessage *msg);
 bool queue_receive(Queue *queue, QMessage *msg);
 
+/*
+ * Priority queues use the System V message type as the priority, and
+ * msgrcv(2) with a negative msgtyp then receives the message with the lowest
+ * type first. The QMessage is sent as the payload.
+ */
+#define QUEUE_PRIORITY_HIGHEST 1
+#define QUEUE_PRIORITY_LOWEST LONG_MAX
+
+typedef struct QPriorityMessage
+{
+	long priority;
+	QMessage msg;
+} QPriorityMessage;
+
+bool queue_send_priority(Queue *queue, QMessage *msg, long priority);
+bool queue_receive_priority(Queue *queue, QMessage *msg);
+
 /* see struct msqid_ds in msgctl(2) */
 typedef struct QueueStats
 {
@@ -128,6 +128,16 @@ typedef struct SourceTablePartKeyMinMaxValueContext
 	bool parsedOk;
 } SourceTablePartKeyMinMaxValueContext;
 
+/* Context used when sampling the live tuples density of a table by ctid */
+typedef struct SourceTableCtidDensityContext
+{
+	char sqlstate[SQLSTATE_LENGTH];
+	int64_t buckets;
+	int64_t *rows;              /* sampled live rows per bucket */
+	int64_t *bytes;             /* sampled live bytes per bucket */
+	bool parsedOk;
+} SourceTableCtidDensityContext;
+
 /* Context used when fetching all the sequence definitions */
 typedef struct SourceSequenceArrayContext
 {
@@ -205,7 +215,18 @@ static bool parseCurrentSourceTableSize(PGresult *result,
 										SourceTableSize *tableSize);
 static void parsePartKeyMinMaxValue(void *ctx, PGresult *result);
 
-static bool getPartKeyMinMaxValue(PGSQL *pgsql, SourceTable *table);
+static void parseCtidDensity(void *ctx, PGresult *result);
+static void schema_free_ctid_density(SourceTableCtidDensityContext *context,
+									 int64_t *partFirst,
+									 int64_t *partRows,
+									 int64_t *partBytes);
+
+static bool schema_list_ctid_partitions(PGSQL *pgsql,
+										DatabaseCatalog *catalog,
+										SourceTable *table,
+										int64_t partsCount,
+										int64_t partsSize,
+										bool *done);
 
 static bool parseAttributesArray(SourceTable *table, JSON_Value *json);
 
@@ -3227,7 +3248,9 @@ schema_list_fk_constraints(PGSQL *pgsql,
 		"       pg_get_constraintdef(c.oid), "
 		"       c.condeferrable, "
 		"       c.condeferred, "
-		"       c.convalidated "
+		"       c.convalidated, "
+		"       format('%I.%I', rn.nspname, ref.relname), "
+		"       r.relkind "
 		"  FROM pg_constraint c "
 		"  JOIN pg_class r ON c.conrelid = r.oid "
 		"  JOIN pg_namespace n ON r.relnamespace = n.oid "
@@ -3329,6 +3352,14 @@ getFKConstraintArray(void *ctx, PGresult *result)
 		value = PQgetvalue(result, rowNumber, 8);
 		fk.convalidated = (*value == 't');
 
+		/* refQname */
+		value = PQgetvalue(result, rowNumber, 9);
+		strlcpy(fk.refQname, value, sizeof(fk.refQname));
+
+		/* relkind */
+		value = PQgetvalue(result, rowNumber, 10);
+		fk.relkind = value[0];
+
 		if (!catalog_add_s_fk_constraint(context->catalog, &fk))
 		{
 			log_error("Failed to add FK constraint \"%s\" to catalog",
@@ -3880,7 +3911,7 @@ schema_list_partitions(PGSQL *pgsql,
 	/* if we have a partKey and it's not "ctid", calculate key bounds  */
 	if (!IS_EMPTY_STRING_BUFFER(table->partKey) && !streq(table->partKey, "ctid"))
 	{
-		if (!getPartKeyMinMaxValue(pgsql, table))
+		if (!schema_get_part_key_min_max(pgsql, table))
 		{
 			/* errors have already been logged */
 			return false;
@@ -3930,6 +3961,32 @@ schema_list_partitions(PGSQL *pgsql,
 		}
 
 		partsSize = ceil((double) table->relpages / partsCount);
+
+		/*
+		 * Parts of the same number of pages can have very different amounts
+		 * of live data when a table is bloated. Sample the table to estimate
+		 * the live data in each part, and adjust the parts when needed.
+		 */
+		if (partsCount > 1)
+		{
+			bool done = false;
+
+			if (!schema_list_ctid_partitions(pgsql,
+											 catalog,
+											 table,
+											 partsCount,
+											 partsSize,
+											 &done))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+
+			if (done)
+			{
+				return true;
+			}
+		}
 	}
 
 	/*
@@ -4028,6 +4085,374 @@ schema_list_partitions(PGSQL *pgsql,
 	return true;
 }
 
+/*
+ * schema_list_ctid_partitions splits a table in partsCount parts by ctid, and
+ * estimates the amount of live data found in each part.
+ *
+ * The table is divided into buckets of consecutive pages, and a sample of the
+ * table pages (TABLESAMPLE SYSTEM) gives the live rows and bytes found in
+ * each bucket.
+ *
+ * When parts of partsSize pages each would have about the same amount of live
+ * data, we use them. When the table is bloated unevenly though, one of those
+ * parts might have a lot more live data than the others, and then parts are
+ * cut at bucket boundaries so that each gets its share of the estimated total
+ * instead.
+ *
+ * When the sample finds no live rows at all, or when the sampling query
+ * fails, *done is set to false and the caller splits the table in parts of
+ * the same number of pages.
+ */
+static bool
+schema_list_ctid_partitions(PGSQL *pgsql,
+							DatabaseCatalog *catalog,
+							SourceTable *table,
+							int64_t partsCount,
+							int64_t partsSize,
+							bool *done)
+{
+	*done = false;
+
+	int64_t relpages = table->relpages;
+	int64_t buckets = partsCount * SPLIT_CTID_BUCKETS_PER_PART;
+
+	if (buckets > relpages)
+	{
+		buckets = relpages;
+	}
+
+	int64_t bucketPages = ceil((double) relpages / (double) buckets);
+
+	buckets = ceil((double) relpages / (double) bucketPages);
+
+	double samplePercent = 100.0 * SPLIT_CTID_SAMPLE_PAGES / (double) relpages;
+
+	if (samplePercent > 100.0)
+	{
+		samplePercent = 100.0;
+	}
+
+	SourceTableCtidDensityContext context = {
+		.buckets = buckets,
+		.rows = (int64_t *) calloc(buckets, sizeof(int64_t)),
+		.bytes = (int64_t *) calloc(buckets, sizeof(int64_t))
+	};
+
+	/* parts boundaries (in buckets) and estimates */
+	int64_t *partFirst = (int64_t *) calloc(partsCount, sizeof(int64_t));
+	int64_t *partRows = (int64_t *) calloc(partsCount, sizeof(int64_t));
+	int64_t *partBytes = (int64_t *) calloc(partsCount, sizeof(int64_t));
+
+	if (context.rows == NULL || context.bytes == NULL ||
+		partFirst == NULL || partRows == NULL || partBytes == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		schema_free_ctid_density(&context, partFirst, partRows, partBytes);
+		return false;
+	}
+
+	char sql[BUFSIZE] = { 0 };
+
+	sformat(sql, sizeof(sql),
+			"  select (ctid::text::point)[0]::bigint / %lld as bucket, "
+			"         count(*), sum(pg_column_size(t.*)) "
+			"    from only %s t tablesample system (%g) "
+			"group by 1",
+			(long long) bucketPages,
+			table->qname,
+			samplePercent);
+
+	/*
+	 * The source connection is usually in a transaction that holds our
+	 * snapshot: use a savepoint so that a failure to sample the table (lack
+	 * of privileges, statement_timeout) does not abort that transaction.
+	 */
+	bool inTransaction =
+		pgsql->connection != NULL &&
+		PQtransactionStatus(pgsql->connection) == PQTRANS_INTRANS;
+
+	if (inTransaction &&
+		!pgsql_execute(pgsql, "SAVEPOINT pgcopydb_ctid_sample"))
+	{
+		/* errors have already been logged */
+		schema_free_ctid_density(&context, partFirst, partRows, partBytes);
+		return false;
+	}
+
+	if (!pgsql_execute_with_params(pgsql, sql, 0, NULL, NULL,
+								   &context, &parseCtidDensity) ||
+		!context.parsedOk)
+	{
+		log_warn("Failed to sample table %s live tuples density, "
+				 "splitting by number of pages",
+				 table->qname);
+
+		bool rolledBack =
+			!inTransaction ||
+			pgsql_execute(pgsql, "ROLLBACK TO SAVEPOINT pgcopydb_ctid_sample");
+
+		schema_free_ctid_density(&context, partFirst, partRows, partBytes);
+
+		/* errors have already been logged */
+		return rolledBack;
+	}
+
+	if (inTransaction &&
+		!pgsql_execute(pgsql, "RELEASE SAVEPOINT pgcopydb_ctid_sample"))
+	{
+		/* errors have already been logged */
+		schema_free_ctid_density(&context, partFirst, partRows, partBytes);
+		return false;
+	}
+
+	int64_t totalBytes = 0;
+
+	for (int64_t b = 0; b < buckets; b++)
+	{
+		totalBytes += context.bytes[b];
+	}
+
+	if (totalBytes == 0)
+	{
+		log_warn("Table %s: sampling found no live rows, "
+				 "splitting by number of pages",
+				 table->qname);
+
+		schema_free_ctid_density(&context, partFirst, partRows, partBytes);
+		return true;
+	}
+
+	/*
+	 * First, estimate the live data in parts of partsSize pages each, using
+	 * the part where each bucket starts.
+	 */
+	int64_t maxPartBytes = 0;
+
+	for (int64_t b = 0; b < buckets; b++)
+	{
+		int64_t p = (b * bucketPages) / partsSize;
+
+		if (p >= partsCount)
+		{
+			p = partsCount - 1;
+		}
+
+		partRows[p] += context.rows[b];
+		partBytes[p] += context.bytes[b];
+	}
+
+	for (int64_t p = 0; p < partsCount; p++)
+	{
+		if (partBytes[p] > maxPartBytes)
+		{
+			maxPartBytes = partBytes[p];
+		}
+	}
+
+	bool splitByDensity =
+		(double) maxPartBytes * partsCount >
+		(double) totalBytes * SPLIT_CTID_MAX_SKEW;
+
+	/*
+	 * Then, when the largest part has too much of the live data, cut parts at
+	 * bucket boundaries as soon as they reach their share of the total, while
+	 * keeping at least one bucket for each of the parts left.
+	 */
+	if (splitByDensity)
+	{
+		int64_t p = 0;
+		int64_t cumBytes = 0;
+
+		bzero(partRows, partsCount * sizeof(int64_t));
+		bzero(partBytes, partsCount * sizeof(int64_t));
+
+		for (int64_t b = 0; b < buckets; b++)
+		{
+			cumBytes += context.bytes[b];
+			partRows[p] += context.rows[b];
+			partBytes[p] += context.bytes[b];
+
+			int64_t bucketsLeft = buckets - b - 1;
+			int64_t partsLeft = partsCount - p - 1;
+
+			bool reachedTarget = cumBytes * partsCount >= totalBytes * (p + 1);
+
+			if (partsLeft > 0 && bucketsLeft > 0 &&
+				(reachedTarget || bucketsLeft == partsLeft))
+			{
+				partFirst[++p] = b + 1;
+			}
+		}
+	}
+
+	/* scale the sample back to the whole table */
+	double scale = 100.0 / samplePercent;
+
+	for (int64_t i = 0; i < partsCount; i++)
+	{
+		SourceTableParts *parts = &(table->partition);
+
+		bzero(parts, sizeof(SourceTableParts));
+
+		parts->partNumber = i + 1;
+		parts->partCount = partsCount;
+
+		if (splitByDensity)
+		{
+			parts->min = partFirst[i] * bucketPages;
+
+			if (i < (partsCount - 1))
+			{
+				parts->max = (partFirst[i + 1] * bucketPages) - 1;
+			}
+		}
+		else
+		{
+			parts->min = i * partsSize;
+			parts->max = ((i + 1) * partsSize) - 1;
+		}
+
+		parts->count = parts->max - parts->min + 1;
+
+		/* the last partition has no upper bound */
+		if (parts->partNumber == partsCount)
+		{
+			parts->max = -1;
+			parts->count = -1;
+		}
+
+		parts->estRows = (int64_t) (partRows[i] * scale);
+		parts->estBytes = (int64_t) (partBytes[i] * scale);
+
+		char bytesPretty[BUFSIZE] = { 0 };
+
+		(void) pretty_print_bytes(bytesPretty, sizeof(bytesPretty),
+								  parts->estBytes);
+
+		log_debug("Partition %s #%d/%d: [%lld .. %lld] (%lld), "
+				  "estimated %lld rows, %s",
+				  table->qname,
+				  parts->partNumber,
+				  parts->partCount,
+				  (long long) parts->min,
+				  (long long) parts->max,
+				  (long long) parts->count,
+				  (long long) parts->estRows,
+				  bytesPretty);
+
+		if (catalog != NULL && catalog->db != NULL)
+		{
+			if (!catalog_add_s_table_part(catalog, table))
+			{
+				/* errors have already been logged */
+				schema_free_ctid_density(&context, partFirst, partRows, partBytes);
+				return false;
+			}
+		}
+	}
+
+	schema_free_ctid_density(&context, partFirst, partRows, partBytes);
+
+	if (splitByDensity)
+	{
+		log_notice("Table %s live data is unevenly spread, "
+				   "split in %lld parts of about the same size "
+				   "from a %.2f%% sample of its pages",
+				   table->qname,
+				   (long long) partsCount,
+				   samplePercent);
+	}
+
+	*done = true;
+
+	return true;
+}
+
+
+/*
+ * schema_free_ctid_density frees the memory allocated to estimate the live
+ * data density of a table split by ctid.
+ */
+static void
+schema_free_ctid_density(SourceTableCtidDensityContext *context,
+						 int64_t *partFirst,
+						 int64_t *partRows,
+						 int64_t *partBytes)
+{
+	free(context->rows);
+	free(context->bytes);
+	free(partFirst);
+	free(partRows);
+	free(partBytes);
+}
+
+
+/*
+ * parseCtidDensity parses the result of the ctid density sampling query: one
+ * row per bucket of pages where live rows were found.
+ */
+static void
+parseCtidDensity(void *ctx, PGresult *result)
+{
+	SourceTableCtidDensityContext *context =
+		(SourceTableCtidDensityContext *) ctx;
+
+	int nTuples = PQntuples(result);
+	int errors = 0;
+
+	if (PQnfields(result) != 3)
+	{
+		log_error("Query returned %d columns, expected 3", PQnfields(result));
+		context->parsedOk = false;
+		return;
+	}
+
+	for (int rowNumber = 0; rowNumber < nTuples; rowNumber++)
+	{
+		int64_t bucket = 0;
+		int64_t rows = 0;
+		int64_t bytes = 0;
+
+		char *value = PQgetvalue(result, rowNumber, 0);
+
+		if (!stringToInt64(value, &bucket) || bucket < 0)
+		{
+			log_error("Invalid bucket value: \"%s\"", value);
+			++errors;
+			continue;
+		}
+
+		value = PQgetvalue(result, rowNumber, 1);
+
+		if (!stringToInt64(value, &rows))
+		{
+			log_error("Invalid rows count value: \"%s\"", value);
+			++errors;
+			continue;
+		}
+
+		value = PQgetvalue(result, rowNumber, 2);
+
+		if (!stringToInt64(value, &bytes))
+		{
+			log_error("Invalid bytes value: \"%s\"", value);
+			++errors;
+			continue;
+		}
+
+		/* relpages is an estimate, the table might have grown since */
+		if (bucket >= context->buckets)
+		{
+			bucket = context->buckets - 1;
+		}
+
+		context->rows[bucket] += rows;
+		context->bytes[bucket] += bytes;
+	}
+
+	context->parsedOk = errors == 0;
+}
+
 
 /*
  * schema_checksum_table runs a SQL query that computes the number of rows of a
@@ -5757,11 +6182,11 @@ getTableArray(void *ctx, PGresult *result)
 
 
 /*
- * getPartKeyMinMaxValue retrieves the min and max values for the
+ * schema_get_part_key_min_max retrieves the min and max values for the
  * candidate partition key of the given table.
  */
-static bool
-getPartKeyMinMaxValue(PGSQL *pgsql, SourceTable *table)
+bool
+schema_get_part_key_min_max(PGSQL *pgsql, SourceTable *table)
 {
 	PQExpBuffer sql = createPQExpBuffer();
 	char *sqlTemplate = "select min(%s), max(%s) "
@@ -6892,6 +7317,369 @@ typedef struct SourceViewContext
 
 static void getViewArray(void *ctx, PGresult *result);
 
+/*
+ * Context for partition roots listing callback
+ */
+typedef struct SourcePartitionRootContext
+{
+	DatabaseCatalog *catalog;
+	bool parsedOk;
+} SourcePartitionRootContext;
+
+static void getPartitionRoots(void *ctx, PGresult *result);
+
+/*
+ * Context for index sizes listing callback
+ */
+typedef struct SourceIndexSizeContext
+{
+	DatabaseCatalog *catalog;
+	bool parsedOk;
+} SourceIndexSizeContext;
+
+static void getIndexSizes(void *ctx, PGresult *result);
+static bool schema_append_index_oid(void *ctx, SourceIndex *index);
+static int64_t schema_index_build_cost(const char *amname,
+									   int natts,
+									   int64_t tableBytes,
+									   int64_t indexBytes);
+
+
+/*
+ * schema_list_partition_roots registers the root partitioned table of each
+ * leaf partition found in our catalogs, so that the COPY queue may interleave
+ * leaves of different partitioned tables.
+ */
+bool
+schema_list_partition_roots(PGSQL *pgsql, DatabaseCatalog *catalog)
+{
+	SourcePartitionRootContext context = { catalog, false };
+
+	log_trace("schema_list_partition_roots");
+
+	if (!pgsql_server_version(pgsql))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	/* declarative partitioning appeared in Postgres 10 */
+	if (pgsql->pgversion_num < 100000)
+	{
+		return true;
+	}
+
+	char *sql =
+		"with recursive leaves(relid, root) as "
+		"( "
+		"  select i.inhrelid, i.inhparent "
+		"    from pg_catalog.pg_inherits i "
+		"         join pg_catalog.pg_class p on p.oid = i.inhparent "
+		"   where p.relkind = 'p' and not p.relispartition "
+		" "
+		"   union all "
+		" "
+		"  select i.inhrelid, leaves.root "
+		"    from pg_catalog.pg_inherits i "
+		"         join leaves on i.inhparent = leaves.relid "
+		") "
+		"select leaves.relid, leaves.root "
+		"  from leaves "
+		"       join pg_catalog.pg_class c on c.oid = leaves.relid "
+		" where c.relkind = 'r'";
+
+	if (!pgsql_execute_with_params(pgsql, sql, 0, NULL, NULL,
+								   &context, &getPartitionRoots))
+	{
+		log_error("Failed to list partitioned tables leaves");
+		return false;
+	}
+
+	if (!context.parsedOk)
+	{
+		log_error("Failed to list partitioned tables leaves");
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * getPartitionRoots loops over the SQL result for the list of leaf partitions
+ * and registers their partitioned table root in our catalogs.
+ */
+static void
+getPartitionRoots(void *ctx, PGresult *result)
+{
+	SourcePartitionRootContext *context = (SourcePartitionRootContext *) ctx;
+	int nTuples = PQntuples(result);
+
+	log_debug("schema_list_partition_roots: %d leaf partitions", nTuples);
+
+	for (int rowNumber = 0; rowNumber < nTuples; rowNumber++)
+	{
+		uint32_t oid = 0;
+		uint32_t parentOid = 0;
+
+		char *value = PQgetvalue(result, rowNumber, 0);
+
+		if (!stringToUInt32(value, &oid))
+		{
+			log_error("Invalid OID \"%s\"", value);
+			context->parsedOk = false;
+			return;
+		}
+
+		value = PQgetvalue(result, rowNumber, 1);
+
+		if (!stringToUInt32(value, &parentOid))
+		{
+			log_error("Invalid OID \"%s\"", value);
+			context->parsedOk = false;
+			return;
+		}
+
+		if (!catalog_update_s_table_parent(context->catalog, oid, parentOid))
+		{
+			log_error("Failed to register partition root %u of table %u",
+					  parentOid,
+					  oid);
+			context->parsedOk = false;
+			return;
+		}
+	}
+
+	context->parsedOk = true;
+}
+
+
+/*
+ * schema_list_index_sizes registers the estimated on-disk size of the indexes
+ * found in our catalogs, so that the COPY queue may account for the CREATE
+ * INDEX work that follows each table, and the estimated cost of building each
+ * index, so that the CREATE INDEX queue may start with the largest builds.
+ *
+ * Only the indexes that are already registered in our catalogs are fetched,
+ * which means that filtered-out indexes are skipped, and the catalog updates
+ * are batched in a single SQLite transaction.
+ */
+bool
+schema_list_index_sizes(PGSQL *pgsql, DatabaseCatalog *catalog)
+{
+	SourceIndexSizeContext context = { catalog, false };
+
+	log_trace("schema_list_index_sizes");
+
+	PQExpBuffer oids = createPQExpBuffer();
+
+	appendPQExpBufferStr(oids, "{");
+
+	if (!catalog_iter_s_index(catalog, oids, &schema_append_index_oid))
+	{
+		log_error("Failed to list indexes from our catalogs");
+		destroyPQExpBuffer(oids);
+		return false;
+	}
+
+	appendPQExpBufferStr(oids, "}");
+
+	if (PQExpBufferBroken(oids))
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		destroyPQExpBuffer(oids);
+		return false;
+	}
+
+	/* no index to create, no size to fetch */
+	if (strcmp(oids->data, "{}") == 0)
+	{
+		destroyPQExpBuffer(oids);
+		return true;
+	}
+
+	char *sql =
+		"select c.oid, "
+		"       c.relpages::bigint "
+		"       * current_setting('block_size')::bigint as bytes, "
+		"       am.amname, "
+		"       i.indnatts, "
+		"       t.relpages::bigint "
+		"       * current_setting('block_size')::bigint as tablebytes "
+		"  from pg_catalog.pg_index i "
+		"       join pg_catalog.pg_class c on c.oid = i.indexrelid "
+		"       join pg_catalog.pg_class t on t.oid = i.indrelid "
+		"       join pg_catalog.pg_am am on am.oid = c.relam "
+		" where c.oid = any($1::oid[])";
+
+	int paramCount = 1;
+	Oid paramTypes[1] = { TEXTOID };
+	const char *paramValues[1] = { oids->data };
+
+	/*
+	 * A SAVEPOINT opens a transaction when none is in progress, and nests
+	 * within the caller's transaction otherwise.
+	 */
+	if (!catalog_execute(catalog, "SAVEPOINT s_index_sizes"))
+	{
+		/* errors have already been logged */
+		destroyPQExpBuffer(oids);
+		return false;
+	}
+
+	if (!pgsql_execute_with_params(pgsql, sql,
+								   paramCount, paramTypes, paramValues,
+								   &context, &getIndexSizes) ||
+		!context.parsedOk)
+	{
+		log_error("Failed to list index sizes");
+		destroyPQExpBuffer(oids);
+
+		(void) catalog_execute(catalog, "ROLLBACK TO SAVEPOINT s_index_sizes");
+		(void) catalog_execute(catalog, "RELEASE SAVEPOINT s_index_sizes");
+
+		return false;
+	}
+
+	destroyPQExpBuffer(oids);
+
+	if (!catalog_execute(catalog, "RELEASE SAVEPOINT s_index_sizes"))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * schema_append_index_oid appends the index OID to the Postgres array literal
+ * being built in the given PQExpBuffer.
+ */
+static bool
+schema_append_index_oid(void *ctx, SourceIndex *index)
+{
+	PQExpBuffer oids = (PQExpBuffer) ctx;
+
+	appendPQExpBuffer(oids, "%s%u",
+					  strcmp(oids->data, "{") == 0 ? "" : ",",
+					  index->indexOid);
+
+	return true;
+}
+
+
+/*
+ * getIndexSizes loops over the SQL result for the list of index sizes and
+ * registers them in our catalogs.
+ */
+static void
+getIndexSizes(void *ctx, PGresult *result)
+{
+	SourceIndexSizeContext *context = (SourceIndexSizeContext *) ctx;
+	int nTuples = PQntuples(result);
+
+	log_debug("schema_list_index_sizes: %d indexes", nTuples);
+
+	for (int rowNumber = 0; rowNumber < nTuples; rowNumber++)
+	{
+		uint32_t oid = 0;
+		int64_t bytes = 0;
+		int natts = 0;
+		int64_t tableBytes = 0;
+
+		char *value = PQgetvalue(result, rowNumber, 0);
+
+		if (!stringToUInt32(value, &oid))
+		{
+			log_error("Invalid OID \"%s\"", value);
+			context->parsedOk = false;
+			return;
+		}
+
+		value = PQgetvalue(result, rowNumber, 1);
+
+		if (!stringToInt64(value, &bytes))
+		{
+			log_error("Invalid index size \"%s\"", value);
+			context->parsedOk = false;
+			return;
+		}
+
+		char *amname = PQgetvalue(result, rowNumber, 2);
+
+		value = PQgetvalue(result, rowNumber, 3);
+
+		if (!stringToInt(value, &natts))
+		{
+			log_error("Invalid index number of attributes \"%s\"", value);
+			context->parsedOk = false;
+			return;
+		}
+
+		value = PQgetvalue(result, rowNumber, 4);
+
+		if (!stringToInt64(value, &tableBytes))
+		{
+			log_error("Invalid table size \"%s\"", value);
+			context->parsedOk = false;
+			return;
+		}
+
+		int64_t cost = schema_index_build_cost(amname, natts, tableBytes, bytes);
+
+		if (!catalog_update_s_index_estimates(context->catalog, oid, bytes, cost))
+		{
+			log_error("Failed to register size of index %u", oid);
+			context->parsedOk = false;
+			return;
+		}
+	}
+
+	context->parsedOk = true;
+}
+
+
+/*
+ * schema_index_build_cost estimates the cost of building an index: the table
+ * is scanned once, and then the index entries are sorted or inserted, which
+ * costs more for some access methods, and more for multi-column indexes.
+ * Only the relative order of the costs matters.
+ */
+static int64_t
+schema_index_build_cost(const char *amname,
+						int natts,
+						int64_t tableBytes,
+						int64_t indexBytes)
+{
+	/* weight of the access method, in quarters */
+	int64_t weight = 8;
+
+	if (streq(amname, "btree") || streq(amname, "hash"))
+	{
+		weight = 4;
+	}
+	else if (streq(amname, "gin"))
+	{
+		weight = 12;
+	}
+	else if (streq(amname, "gist") || streq(amname, "spgist"))
+	{
+		weight = 16;
+	}
+	else if (streq(amname, "brin"))
+	{
+		/* BRIN indexes only summarize the table pages */
+		weight = 0;
+	}
+
+	/* each extra column adds a quarter to the comparison costs */
+	int64_t columns = 3 + (natts < 1 ? 1 : natts);
+
+	return tableBytes + (indexBytes / 16) * weight * columns;
+}
+
 
 /*
  * schema_list_views grabs the list of views from the given source
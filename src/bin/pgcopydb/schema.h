@@ -117,6 +117,16 @@ typedef struct SourceTableParts
 	int64_t max;                /*   AND partKey  < max */
 
 	int64_t count;              /* max - min + 1 */
+
+	int64_t estRows;            /* estimated live rows, zero when unknown */
+	int64_t estBytes;           /* estimated live bytes, zero when unknown */
+
+	/* progress of a part copied in several steps, see table-data.c */
+	int64_t bound;              /* last value, estimated when max is -1 */
+	int64_t step;               /* values copied per COPY command */
+	int64_t claimed;            /* first value not claimed by a worker yet */
+	int64_t copied;             /* first value not copied to the target yet */
+	int64_t reclaimed;          /* first value not claimed in a previous run */
 } SourceTableParts;
 
 
@@ -175,6 +185,12 @@ typedef struct SourceTable
 	char partKey[PG_NAMEDATALEN];
 	SourceTableParts partition;
 
+	/* root of the partitioned table, zero when not a leaf partition */
+	uint32_t parentOid;
+
+	/* estimated on-disk size of the table indexes */
+	int64_t indexBytes;
+
 	char *attrList;             /* malloc'ed area */
 	SourceTableAttributeArray attributes;
 
@@ -187,6 +203,7 @@ typedef struct SourceTable
 	/* summary information */
 	uint64_t durationMs;
 	uint64_t bytesTransmitted;
+	uint64_t wireBytes;
 } SourceTable;
 
 
@@ -229,6 +246,18 @@ typedef struct SourceSequence
 } SourceSequence;
 
 
+/*
+ * SourceBlob caches the size of the large objects found in the source
+ * database, estimated from their pg_largeobject pages. The size is -1 when
+ * we are not allowed to read pg_largeobject.
+ */
+typedef struct SourceBlob
+{
+	uint32_t oid;
+	int64_t bytes;
+} SourceBlob;
+
+
 /*
  * SourceView caches the information we need about all the views found
  * in the source database.
@@ -300,6 +329,9 @@ typedef struct SourceIndex
 
 	char indexRestoreListName[RESTORE_LIST_NAMEDATALEN];
 	char constraintRestoreListName[RESTORE_LIST_NAMEDATALEN];
+
+	int64_t bytes;              /* estimated on-disk size on the source */
+	int64_t cost;               /* estimated build cost, see schema.c */
 } SourceIndex;
 
 
@@ -328,10 +360,12 @@ typedef struct SourceFKConstraint
 	char nspname[PG_NAMEDATALEN];
 	char relname[PG_NAMEDATALEN];
 	char tableQname[PG_NAMEDATALEN_FQ];
+	char refQname[PG_NAMEDATALEN_FQ];   /* referenced table */
 	char *constraintDef;        /* malloc'ed area */
 	bool condeferrable;
 	bool condeferred;
 	bool convalidated;          /* false when NOT VALID on source */
+	char relkind;               /* 'p' when the table is partitioned */
 } SourceFKConstraint;
 
 
@@ -506,6 +540,11 @@ bool schema_list_partitions(PGSQL *pgsql,
 							uint64_t partSize,
 							int splitMaxParts);
 
+bool schema_get_part_key_min_max(PGSQL *pgsql, SourceTable *table);
+
+bool schema_list_partition_roots(PGSQL *pgsql, DatabaseCatalog *catalog);
+bool schema_list_index_sizes(PGSQL *pgsql, DatabaseCatalog *catalog);
+
 bool schema_list_sequences(PGSQL *pgsql,
 						   SourceFilters *filters,
 						   DatabaseCatalog *catalog);
@@ -586,3 +586,429 @@ sentinel_sync_apply(DatabaseCatalog *catalog,
 
 	return true;
 }
+
+
+/*
+ * sentinel_reset_apply_workers deletes the progress registered by the apply
+ * workers of a previous run, which might have used a different number of
+ * apply jobs.
+ */
+bool
+sentinel_reset_apply_workers(DatabaseCatalog *catalog)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: sentinel_reset_apply_workers: db is NULL");
+		return false;
+	}
+
+	char *sql = "delete from sentinel_apply_worker";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * sentinel_update_apply_worker registers the progress of the given apply
+ * worker.
+ */
+bool
+sentinel_update_apply_worker(DatabaseCatalog *catalog,
+							 CopyDBSentinelApplyWorker *worker)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: sentinel_update_apply_worker: db is NULL");
+		return false;
+	}
+
+	char *sql =
+		"insert or replace into sentinel_apply_worker"
+		"(id, origin, replay_lsn, lag, txn_count, wait_count) "
+		"values($1, $2, $3, $4, $5, $6)";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	char replayLSN[PG_LSN_MAXLENGTH] = { 0 };
+	sformat(replayLSN, sizeof(replayLSN), "%X/%X",
+			LSN_FORMAT_ARGS(worker->replay_lsn));
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT, "id", worker->id, NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "origin", 0, worker->origin },
+		{ BIND_PARAMETER_TYPE_TEXT, "replay_lsn", 0, (char *) replayLSN },
+		{ BIND_PARAMETER_TYPE_INT64, "lag", worker->lag, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "txn_count", worker->txnCount, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "wait_count", worker->waitCount, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * sentinel_apply_worker_array fetches the progress registered by the apply
+ * workers, if any.
+ */
+bool
+sentinel_apply_worker_array(DatabaseCatalog *catalog,
+							CopyDBSentinelApplyWorkerArray *workers)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: sentinel_apply_worker_array: db is NULL");
+		return false;
+	}
+
+	char *sql =
+		"  select id, origin, replay_lsn, lag, txn_count, wait_count "
+		"    from sentinel_apply_worker "
+		"order by id";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	workers->count = 0;
+	workers->array = NULL;
+
+	for (;;)
+	{
+		int rc = catalog_sql_step(&query);
+
+		if (rc == SQLITE_DONE)
+		{
+			break;
+		}
+
+		if (rc != SQLITE_ROW)
+		{
+			log_error("Failed to step through statement: %s", query.sql);
+			log_error("[SQLite] %s", sqlite3_errmsg(query.db));
+			(void) catalog_sql_finalize(&query);
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+
+		CopyDBSentinelApplyWorker *array =
+			(CopyDBSentinelApplyWorker *)
+			realloc(workers->array,
+					(workers->count + 1) * sizeof(CopyDBSentinelApplyWorker));
+
+		if (array == NULL)
+		{
+			log_error(ALLOCATION_FAILED_ERROR);
+			(void) catalog_sql_finalize(&query);
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+
+		workers->array = array;
+
+		CopyDBSentinelApplyWorker *worker = &(workers->array[workers->count++]);
+
+		bzero(worker, sizeof(CopyDBSentinelApplyWorker));
+
+		worker->id = sqlite3_column_int(query.ppStmt, 0);
+
+		if (sqlite3_column_type(query.ppStmt, 1) != SQLITE_NULL)
+		{
+			strlcpy(worker->origin,
+					(char *) sqlite3_column_text(query.ppStmt, 1),
+					sizeof(worker->origin));
+		}
+
+		if (sqlite3_column_type(query.ppStmt, 2) != SQLITE_NULL)
+		{
+			char *lsn = (char *) sqlite3_column_text(query.ppStmt, 2);
+
+			if (!parseLSN(lsn, &(worker->replay_lsn)))
+			{
+				log_error("Failed to parse apply worker replay_lsn LSN \"%s\"",
+						  lsn);
+				(void) catalog_sql_finalize(&query);
+				(void) semaphore_unlock(&(catalog->sema));
+				return false;
+			}
+		}
+
+		worker->lag = sqlite3_column_int64(query.ppStmt, 3);
+		worker->txnCount = sqlite3_column_int64(query.ppStmt, 4);
+		worker->waitCount = sqlite3_column_int64(query.ppStmt, 5);
+	}
+
+	(void) catalog_sql_finalize(&query);
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * sentinel_add_txn_commit_lsn_batch registers the COMMIT LSN of a batch of
+ * transactions, using a single SQLite transaction.
+ *
+ * The transform process only registers the transactions that have been split
+ * over several parts (SWITCH, KEEPALIVE, ENDPOS), because their BEGIN message
+ * is written before their COMMIT LSN is known.
+ */
+bool
+sentinel_add_txn_commit_lsn_batch(DatabaseCatalog *catalog,
+								  TxnCommitLSNBatch *batch)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: sentinel_add_txn_commit_lsn_batch: db is NULL");
+		return false;
+	}
+
+	if (batch->count == 0)
+	{
+		return true;
+	}
+
+	char *sql =
+		"insert or replace into txn_commit_lsn(xid, commit_lsn) "
+		"values($1, $2)";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (!catalog_begin(catalog, false))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) catalog_execute(catalog, "ROLLBACK");
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	for (int i = 0; i < batch->count; i++)
+	{
+		TxnCommitLSN *entry = &(batch->array[i]);
+
+		char commitLSN[PG_LSN_MAXLENGTH] = { 0 };
+		sformat(commitLSN, sizeof(commitLSN), "%X/%X",
+				LSN_FORMAT_ARGS(entry->commitLSN));
+
+		/* bind our parameters now */
+		BindParam params[] = {
+			{ BIND_PARAMETER_TYPE_INT64, "xid", entry->xid, NULL },
+			{ BIND_PARAMETER_TYPE_TEXT, "commit_lsn", 0, (char *) commitLSN }
+		};
+
+		int count = sizeof(params) / sizeof(params[0]);
+
+		/* catalog_sql_execute resets the statement for the next entry */
+		if (!catalog_sql_bind(&query, params, count) ||
+			!catalog_sql_execute(&query))
+		{
+			/* errors have already been logged */
+			(void) catalog_execute(catalog, "ROLLBACK");
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+	}
+
+	if (!catalog_sql_finalize(&query) ||
+		!catalog_commit(catalog))
+	{
+		/* errors have already been logged */
+		(void) catalog_execute(catalog, "ROLLBACK");
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	log_debug("Registered the COMMIT LSN of %d transactions", batch->count);
+
+	batch->count = 0;
+
+	return true;
+}
+
+
+/*
+ * sentinel_lookup_txn_commit_lsn fetches the COMMIT LSN of the given
+ * transaction, when it has been registered already.
+ */
+bool
+sentinel_lookup_txn_commit_lsn(DatabaseCatalog *catalog,
+							   uint32_t xid,
+							   uint64_t *commitLSN,
+							   bool *found)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: sentinel_lookup_txn_commit_lsn: db is NULL");
+		return false;
+	}
+
+	TxnCommitLSN entry = { .xid = xid, .commitLSN = InvalidXLogRecPtr };
+
+	SQLiteQuery query = {
+		.context = &entry,
+		.fetchFunction = &sentinel_txn_commit_lsn_fetch
+	};
+
+	char *sql = "select commit_lsn from txn_commit_lsn where xid = $1";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "xid", xid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which returns at most one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	*found = entry.commitLSN != InvalidXLogRecPtr;
+	*commitLSN = entry.commitLSN;
+
+	return true;
+}
+
+
+/*
+ * sentinel_txn_commit_lsn_fetch fetches a TxnCommitLSN entry from a query
+ * ppStmt result.
+ */
+bool
+sentinel_txn_commit_lsn_fetch(SQLiteQuery *query)
+{
+	TxnCommitLSN *entry = (TxnCommitLSN *) query->context;
+
+	if (sqlite3_column_type(query->ppStmt, 0) != SQLITE_NULL)
+	{
+		const char *lsn = (const char *) sqlite3_column_text(query->ppStmt, 0);
+
+		if (!parseLSN(lsn, &(entry->commitLSN)))
+		{
+			log_error("Failed to parse transaction %u COMMIT LSN \"%s\"",
+					  entry->xid,
+					  lsn);
+			return false;
+		}
+	}
+
+	return true;
+}
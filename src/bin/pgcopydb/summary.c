@@ -133,6 +133,10 @@ static bool prepare_summary_table_hook(void *context, SourceTable *table);
 static bool prepare_summary_table_index_hook(void *ctx, SourceIndex *index);
 static bool summary_prepare_toplevel_durations_hook(void *ctx,
 													TopLevelTiming *timing);
+static bool summary_execute_with_params(DatabaseCatalog *catalog,
+										char *sql,
+										BindParam *params,
+										int count);
 
 
 /*
@@ -157,7 +161,7 @@ summary_lookup_table(DatabaseCatalog *catalog, CopyTableDataSpec *tableSpecs)
 
 	char *sql =
 		"  select pid, start_time_epoch, done_time_epoch, duration, "
-		"         bytes, command "
+		"         bytes, command, wire_bytes "
 		"    from summary "
 		"   where tableoid = $1 and partnum = $2";
 
@@ -224,6 +228,7 @@ summary_table_fetch(SQLiteQuery *query)
 	tableSummary->doneTime = sqlite3_column_int64(query->ppStmt, 2);
 	tableSummary->durationMs = sqlite3_column_int64(query->ppStmt, 3);
 	tableSummary->bytesTransmitted = sqlite3_column_int64(query->ppStmt, 4);
+	tableSummary->wireBytes = sqlite3_column_int64(query->ppStmt, 6);
 
 	if (sqlite3_column_type(query->ppStmt, 5) == SQLITE_NULL)
 	{
@@ -436,8 +441,9 @@ summary_finish_table(DatabaseCatalog *catalog, CopyTableDataSpec *tableSpecs)
 	}
 
 	char *sql =
-		"update summary set done_time_epoch = $1, duration = $2, bytes = $3 "
-		"where pid = $4 and tableoid = $5 and partnum = $6";
+		"update summary set done_time_epoch = $1, duration = $2, bytes = $3, "
+		"                   wire_bytes = $4, copy_format = $5, freeze = $6 "
+		"where pid = $7 and tableoid = $8 and partnum = $9";
 
 	if (!semaphore_lock(&(catalog->sema)))
 	{
@@ -465,6 +471,15 @@ summary_finish_table(DatabaseCatalog *catalog, CopyTableDataSpec *tableSpecs)
 		{ BIND_PARAMETER_TYPE_INT64, "bytes",
 		  tableSummary->bytesTransmitted, NULL },
 
+		{ BIND_PARAMETER_TYPE_INT64, "wire_bytes",
+		  tableSummary->wireBytes, NULL },
+
+		{ BIND_PARAMETER_TYPE_TEXT, "copy_format", 0,
+		  CopyDataFormatToString(tableSummary->copyFormat) },
+
+		{ BIND_PARAMETER_TYPE_INT, "freeze",
+		  tableSummary->freeze ? 1 : 0, NULL },
+
 		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
 		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL },
 
@@ -516,8 +531,8 @@ summary_update_table_copy_stats(DatabaseCatalog *catalog,
 	CopyTableSummary *tableSummary = &(tableSpecs->summary);
 
 	char *sql =
-		"update summary set duration = $1, bytes = $2 "
-		"where pid = $3 and tableoid = $4 and partnum = $5";
+		"update summary set duration = $1, bytes = $2, wire_bytes = $3 "
+		"where pid = $4 and tableoid = $5 and partnum = $6";
 
 	if (!semaphore_lock(&(catalog->sema)))
 	{
@@ -542,6 +557,86 @@ summary_update_table_copy_stats(DatabaseCatalog *catalog,
 		{ BIND_PARAMETER_TYPE_INT64, "bytes",
 		  tableSummary->bytesTransmitted, NULL },
 
+		{ BIND_PARAMETER_TYPE_INT64, "wire_bytes",
+		  tableSummary->wireBytes, NULL },
+
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL },
+
+		{ BIND_PARAMETER_TYPE_INT64, "partnum",
+		  table->partition.partNumber, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_update_table_copy_format UPDATEs a summary entry to our internal
+ * catalogs database with the COPY command and format, when the COPY format
+ * of a table changes after a failure to use the binary format.
+ */
+bool
+summary_update_table_copy_format(DatabaseCatalog *catalog,
+								 CopyTableDataSpec *tableSpecs)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_update_table_copy_format: db is NULL");
+		return false;
+	}
+
+	SourceTable *table = tableSpecs->sourceTable;
+	CopyTableSummary *tableSummary = &(tableSpecs->summary);
+
+	char *sql =
+		"update summary set command = $1, copy_format = $2 "
+		"where pid = $3 and tableoid = $4 and partnum = $5";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_TEXT, "command", 0,
+		  (char *) tableSummary->command },
+
+		{ BIND_PARAMETER_TYPE_TEXT, "copy_format", 0,
+		  CopyDataFormatToString(tableSummary->copyFormat) },
+
 		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
 		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL },
 
@@ -592,7 +687,8 @@ summary_table_count_parts_done(DatabaseCatalog *catalog,
 	SourceTable *table = tableSpecs->sourceTable;
 
 	char *sql =
-		"select count(s.oid) "
+		"select count(s.oid), "
+		"       (select count(*) from s_table_part where oid = $1) "
 		" from s_table t "
 		"      join s_table_part p on t.oid = p.oid "
 		"      left join summary s "
@@ -658,6 +754,156 @@ summary_table_fetch_count_parts_done(SQLiteQuery *query)
 
 	tableSpecs->countPartsDone = sqlite3_column_int(query->ppStmt, 0);
 
+	/* parts may have been split by COPY workers since we started */
+	tableSpecs->sourceTable->partition.partCount =
+		sqlite3_column_int(query->ppStmt, 1);
+
+	return true;
+}
+
+
+/*
+ * summary_table_count_parts_started counts the parts of a table that have
+ * already been started, or done, in a previous run, and the parts that are
+ * done.
+ */
+bool
+summary_table_count_parts_started(DatabaseCatalog *catalog,
+								  SourceTable *table,
+								  TablePartsCount *count)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_table_count_parts_started: db is NULL");
+		return false;
+	}
+
+	char *sql =
+		"select count(*), "
+		"       sum(case when done_time_epoch > 0 then 1 else 0 end) "
+		"  from summary "
+		" where tableoid = $1 and partnum > 0";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = {
+		.context = count,
+		.fetchFunction = &summary_table_fetch_count_parts_started
+	};
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL }
+	};
+
+	int paramsCount = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, paramsCount))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which returns exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_table_fetch_count_parts_started fetches the count of parts already
+ * started, and done, from a SQLiteQuery ppStmt result.
+ */
+bool
+summary_table_fetch_count_parts_started(SQLiteQuery *query)
+{
+	TablePartsCount *count = (TablePartsCount *) query->context;
+
+	count->started = sqlite3_column_int(query->ppStmt, 0);
+	count->done = sqlite3_column_int(query->ppStmt, 1);
+
+	return true;
+}
+
+
+/*
+ * summary_delete_table_parts deletes the summary entries of all the parts of
+ * the given table, so that they are all copied again.
+ */
+bool
+summary_delete_table_parts(DatabaseCatalog *catalog, SourceTable *table)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_delete_table_parts: db is NULL");
+		return false;
+	}
+
+	char *sql = "delete from summary where tableoid = $1 and partnum > 0";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
 	return true;
 }
 
@@ -679,11 +925,787 @@ summary_add_table_parts_done(DatabaseCatalog *catalog,
 		return false;
 	}
 
-	SourceTable *table = tableSpecs->sourceTable;
-
+	SourceTable *table = tableSpecs->sourceTable;
+
+	char *sql =
+		"insert or ignore into s_table_parts_done(tableoid, pid) "
+		"values($1, $2)";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which return exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_lookup_table_parts_done selects the PID that went there first.
+ *
+ * We could use insert or ignore ... returning ... but that's supported by
+ * SQLite since version 3.35.0 (2021-03-12) and debian oldstable (bullseye) is
+ * still around with Package: libsqlite3-0 (3.34.1-3).
+ */
+bool
+summary_lookup_table_parts_done(DatabaseCatalog *catalog,
+								CopyTableDataSpec *tableSpecs)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_lookup_table_parts_done: db is NULL");
+		return false;
+	}
+
+	SourceTable *table = tableSpecs->sourceTable;
+
+	char *sql = "select pid from s_table_parts_done where tableoid = $1 ";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = {
+		.context = tableSpecs,
+		.fetchFunction = &summary_table_parts_done_fetch
+	};
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_table_parts_done_fetch fetches a row from s_table_parts_done.
+ */
+bool
+summary_table_parts_done_fetch(SQLiteQuery *query)
+{
+	CopyTableDataSpec *tableSpecs = (CopyTableDataSpec *) query->context;
+
+	tableSpecs->partsDonePid = sqlite3_column_int(query->ppStmt, 0);
+
+	return true;
+}
+
+
+/*
+ * summary_add_table_indexes_early registers our pid as the process that sends
+ * the indexes of a table to the CREATE INDEX queue before all its parts are
+ * done, unless another process did that first. Uses "insert or ignore" for
+ * concurrency control.
+ */
+bool
+summary_add_table_indexes_early(DatabaseCatalog *catalog,
+								CopyTableDataSpec *tableSpecs)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_add_table_indexes_early: db is NULL");
+		return false;
+	}
+
+	SourceTable *table = tableSpecs->sourceTable;
+
+	char *sql =
+		"insert or ignore into s_table_indexes_early(tableoid, pid) "
+		"values($1, $2)";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which does not return any row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_lookup_table_indexes_early selects the PID that sent the indexes of
+ * the table early, if any.
+ */
+bool
+summary_lookup_table_indexes_early(DatabaseCatalog *catalog,
+								   CopyTableDataSpec *tableSpecs)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_lookup_table_indexes_early: db is NULL");
+		return false;
+	}
+
+	SourceTable *table = tableSpecs->sourceTable;
+
+	char *sql = "select pid from s_table_indexes_early where tableoid = $1 ";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = {
+		.context = tableSpecs,
+		.fetchFunction = &summary_table_indexes_early_fetch
+	};
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which returns at most one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_table_indexes_early_fetch fetches a row from s_table_indexes_early.
+ */
+bool
+summary_table_indexes_early_fetch(SQLiteQuery *query)
+{
+	CopyTableDataSpec *tableSpecs = (CopyTableDataSpec *) query->context;
+
+	tableSpecs->indexesEarlyPid = sqlite3_column_int(query->ppStmt, 0);
+
+	return true;
+}
+
+
+/*
+ * summary_lookup_table_frozen sets tableSpecs->vSummary.frozen to true when
+ * all the COPY parts of the table have been done using COPY FREEZE, and the
+ * table has not been rewritten by ALTER TABLE ... SET LOGGED since, and sets
+ * tableSpecs->vSummary.bytesCopied.
+ */
+bool
+summary_lookup_table_frozen(DatabaseCatalog *catalog,
+							CopyTableDataSpec *tableSpecs)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_lookup_table_frozen: db is NULL");
+		return false;
+	}
+
+	SourceTable *table = tableSpecs->sourceTable;
+
+	char *sql =
+		"select count(*), coalesce(sum(freeze), 0), coalesce(sum(bytes), 0), "
+		"       exists(select 1 from s_table_unlogged where tableoid = $1) "
+		"  from summary "
+		" where tableoid = $1 and done_time_epoch is not null";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = {
+		.context = tableSpecs,
+		.fetchFunction = &summary_table_frozen_fetch
+	};
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which returns exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_table_frozen_fetch fetches the count of COPY parts done, the count
+ * of those done using COPY FREEZE, and the bytes they sent.
+ */
+bool
+summary_table_frozen_fetch(SQLiteQuery *query)
+{
+	CopyTableDataSpec *tableSpecs = (CopyTableDataSpec *) query->context;
+
+	int64_t partsDone = sqlite3_column_int64(query->ppStmt, 0);
+	int64_t partsFrozen = sqlite3_column_int64(query->ppStmt, 1);
+
+	/* ALTER TABLE ... SET LOGGED rewrites the table without frozen rows */
+	bool unlogged = sqlite3_column_int(query->ppStmt, 3) == 1;
+
+	tableSpecs->vSummary.frozen =
+		!unlogged && partsDone > 0 && partsFrozen == partsDone;
+	tableSpecs->vSummary.bytesCopied = sqlite3_column_int64(query->ppStmt, 2);
+
+	return true;
+}
+
+
+/*
+ * summary_add_table_unlogged registers that the given table has been set
+ * UNLOGGED on the target database, along with the start time of the target
+ * server, as found with pg_postmaster_start_time().
+ */
+bool
+summary_add_table_unlogged(DatabaseCatalog *catalog, SourceTable *table,
+						   uint64_t targetStartTime)
+{
+	char *sql =
+		"insert or replace into s_table_unlogged"
+		"(tableoid, pid, unlogged_time_epoch, target_start_time_epoch) "
+		"values($1, $2, $3, $4)";
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "unlogged_time_epoch", time(NULL), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "target_start_time_epoch",
+		  targetStartTime, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	return summary_execute_with_params(catalog, sql, params, count);
+}
+
+
+/*
+ * summary_delete_table_unlogged removes the given table from the list of
+ * tables that have been set UNLOGGED on the target database.
+ */
+bool
+summary_delete_table_unlogged(DatabaseCatalog *catalog, SourceTable *table)
+{
+	char *sql = "delete from s_table_unlogged where tableoid = $1";
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	return summary_execute_with_params(catalog, sql, params, count);
+}
+
+
+/*
+ * summary_start_table_logged registers the start time of the ALTER TABLE ...
+ * SET LOGGED command for the given table.
+ */
+bool
+summary_start_table_logged(DatabaseCatalog *catalog, SourceTable *table)
+{
+	char *sql =
+		"update s_table_unlogged "
+		"   set pid = $1, logged_start_time_epoch = $2 "
+		" where tableoid = $3";
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "logged_start_time_epoch", time(NULL), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	return summary_execute_with_params(catalog, sql, params, count);
+}
+
+
+/*
+ * summary_finish_table_logged registers that the given table has been set
+ * LOGGED again on the target database.
+ */
+bool
+summary_finish_table_logged(DatabaseCatalog *catalog,
+							SourceTable *table,
+							uint64_t durationMs)
+{
+	char *sql =
+		"update s_table_unlogged "
+		"   set logged_done_time_epoch = $1, logged_duration = $2 "
+		" where tableoid = $3 and pid = $4";
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "logged_done_time_epoch", time(NULL), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "logged_duration", durationMs, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	return summary_execute_with_params(catalog, sql, params, count);
+}
+
+
+/*
+ * summary_reset_table_copy forgets about the COPY progress of the given
+ * table, so that all its parts are copied again.
+ */
+bool
+summary_reset_table_copy(DatabaseCatalog *catalog, SourceTable *table)
+{
+	char *sqls[] = {
+		"delete from summary where tableoid = $1 and indexoid is null",
+		"delete from s_table_parts_done where tableoid = $1",
+		"delete from vacuum_summary where tableoid = $1",
+		"update s_table_part set claimed = null, copied = null where oid = $1"
+	};
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	for (int i = 0; i < sizeof(sqls) / sizeof(sqls[0]); i++)
+	{
+		if (!summary_execute_with_params(catalog, sqls[i], params, count))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ * summary_lookup_table_unlogged sets pending to true when the given table
+ * has been set UNLOGGED on the target database and not set LOGGED again yet.
+ */
+bool
+summary_lookup_table_unlogged(DatabaseCatalog *catalog,
+							  SourceTable *table,
+							  bool *pending)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_lookup_table_unlogged: db is NULL");
+		return false;
+	}
+
+	char *sql =
+		"select exists(select 1 "
+		"                from s_table_unlogged "
+		"               where tableoid = $1 "
+		"                 and logged_done_time_epoch is null)";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = {
+		.context = pending,
+		.fetchFunction = &summary_table_unlogged_fetch
+	};
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* bind our parameters now */
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	/* now execute the query, which returns exactly one row */
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_table_unlogged_fetch fetches the pending boolean.
+ */
+bool
+summary_table_unlogged_fetch(SQLiteQuery *query)
+{
+	bool *pending = (bool *) query->context;
+
+	*pending = sqlite3_column_int(query->ppStmt, 0) == 1;
+
+	return true;
+}
+
+
+/*
+ * summary_table_unlogged_pending fills in the given array with the tables
+ * that have been set UNLOGGED on the target database and not set LOGGED
+ * again yet, largest tables first.
+ */
+bool
+summary_table_unlogged_pending(DatabaseCatalog *catalog,
+							   TableUnloggedArray *tables)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_table_unlogged_pending: db is NULL");
+		return false;
+	}
+
+	char *sql =
+		"  select u.tableoid, t.qname, u.unlogged_time_epoch, "
+		"         u.target_start_time_epoch, "
+		"         (select coalesce(sum(s.bytes), 0) "
+		"            from summary s "
+		"           where s.tableoid = u.tableoid "
+		"             and s.indexoid is null "
+		"             and s.done_time_epoch is not null) as copied_bytes "
+		"    from s_table_unlogged u "
+		"         join s_table t on t.oid = u.tableoid "
+		"         left join s_table_size ts on ts.oid = t.oid "
+		"   where u.logged_done_time_epoch is null "
+		"order by ts.bytes desc nulls last, u.tableoid";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	tables->count = 0;
+	tables->array = NULL;
+
+	for (;;)
+	{
+		int rc = catalog_sql_step(&query);
+
+		if (rc == SQLITE_DONE)
+		{
+			break;
+		}
+
+		if (rc != SQLITE_ROW)
+		{
+			log_error("Failed to step through statement: %s", query.sql);
+			log_error("[SQLite] %s", sqlite3_errmsg(query.db));
+			(void) catalog_sql_finalize(&query);
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+
+		TableUnlogged *array =
+			(TableUnlogged *) realloc(tables->array,
+									  (tables->count + 1) * sizeof(TableUnlogged));
+
+		if (array == NULL)
+		{
+			log_error(ALLOCATION_FAILED_ERROR);
+			(void) catalog_sql_finalize(&query);
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+
+		tables->array = array;
+
+		TableUnlogged *table = &(tables->array[tables->count++]);
+
+		bzero(table, sizeof(TableUnlogged));
+
+		table->oid = sqlite3_column_int64(query.ppStmt, 0);
+
+		if (sqlite3_column_type(query.ppStmt, 1) != SQLITE_NULL)
+		{
+			strlcpy(table->qname,
+					(char *) sqlite3_column_text(query.ppStmt, 1),
+					sizeof(table->qname));
+		}
+
+		table->unloggedTime = sqlite3_column_int64(query.ppStmt, 2);
+		table->targetStartTime = sqlite3_column_int64(query.ppStmt, 3);
+		table->copiedBytes = sqlite3_column_int64(query.ppStmt, 4);
+	}
+
+	(void) catalog_sql_finalize(&query);
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_add_lo_worker registers a Large Objects worker in our internal
+ * catalogs database, at worker start time.
+ */
+bool
+summary_add_lo_worker(DatabaseCatalog *catalog, LargeObjectWorkerSummary *summary)
+{
+	summary->pid = getpid();
+	summary->startTime = time(NULL);
+	INSTR_TIME_SET_CURRENT(summary->startTimeInstr);
+
+	char *sql =
+		"insert or replace into lo_worker_summary(pid, start_time_epoch) "
+		"values($1, $2)";
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "pid", summary->pid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "start_time_epoch", summary->startTime, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	return summary_execute_with_params(catalog, sql, params, count);
+}
+
+
+/*
+ * summary_finish_lo_worker registers the counters of a Large Objects worker
+ * in our internal catalogs database, when the worker is done.
+ */
+bool
+summary_finish_lo_worker(DatabaseCatalog *catalog,
+						 LargeObjectWorkerSummary *summary)
+{
+	instr_time duration;
+
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, summary->startTimeInstr);
+
+	summary->doneTime = time(NULL);
+	summary->durationMs = INSTR_TIME_GET_MILLISEC(duration);
+
+	char *sql =
+		"update lo_worker_summary "
+		"   set done_time_epoch = $1, duration = $2, "
+		"       count = $3, bytes = $4, batches = $5 "
+		" where pid = $6";
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "done_time_epoch", summary->doneTime, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "duration", summary->durationMs, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "count", summary->count, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "bytes", summary->bytes, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "batches", summary->batches, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "pid", summary->pid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	return summary_execute_with_params(catalog, sql, params, count);
+}
+
+
+/*
+ * summary_lo_worker_array fetches the summary of all the Large Objects
+ * workers that are done.
+ */
+bool
+summary_lo_worker_array(DatabaseCatalog *catalog,
+						LargeObjectWorkerSummaryArray *workers)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_lo_worker_array: db is NULL");
+		return false;
+	}
+
 	char *sql =
-		"insert or ignore into s_table_parts_done(tableoid, pid) "
-		"values($1, $2)";
+		"  select pid, start_time_epoch, done_time_epoch, duration, "
+		"         count, bytes, batches "
+		"    from lo_worker_summary "
+		"   where done_time_epoch is not null "
+		"order by start_time_epoch, pid";
 
 	if (!semaphore_lock(&(catalog->sema)))
 	{
@@ -700,29 +1722,56 @@ summary_add_table_parts_done(DatabaseCatalog *catalog,
 		return false;
 	}
 
-	/* bind our parameters now */
-	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL },
-		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL }
-	};
-
-	int count = sizeof(params) / sizeof(params[0]);
+	workers->count = 0;
+	workers->array = NULL;
 
-	if (!catalog_sql_bind(&query, params, count))
+	for (;;)
 	{
-		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
-		return false;
-	}
+		int rc = catalog_sql_step(&query);
 
-	/* now execute the query, which return exactly one row */
-	if (!catalog_sql_execute_once(&query))
-	{
-		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
-		return false;
+		if (rc == SQLITE_DONE)
+		{
+			break;
+		}
+
+		if (rc != SQLITE_ROW)
+		{
+			log_error("Failed to step through statement: %s", query.sql);
+			log_error("[SQLite] %s", sqlite3_errmsg(query.db));
+			(void) catalog_sql_finalize(&query);
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+
+		LargeObjectWorkerSummary *array =
+			(LargeObjectWorkerSummary *)
+			realloc(workers->array,
+					(workers->count + 1) * sizeof(LargeObjectWorkerSummary));
+
+		if (array == NULL)
+		{
+			log_error(ALLOCATION_FAILED_ERROR);
+			(void) catalog_sql_finalize(&query);
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
+
+		workers->array = array;
+
+		LargeObjectWorkerSummary *worker = &(workers->array[workers->count++]);
+
+		bzero(worker, sizeof(LargeObjectWorkerSummary));
+
+		worker->pid = sqlite3_column_int64(query.ppStmt, 0);
+		worker->startTime = sqlite3_column_int64(query.ppStmt, 1);
+		worker->doneTime = sqlite3_column_int64(query.ppStmt, 2);
+		worker->durationMs = sqlite3_column_int64(query.ppStmt, 3);
+		worker->count = sqlite3_column_int64(query.ppStmt, 4);
+		worker->bytes = sqlite3_column_int64(query.ppStmt, 5);
+		worker->batches = sqlite3_column_int64(query.ppStmt, 6);
 	}
 
+	(void) catalog_sql_finalize(&query);
 	(void) semaphore_unlock(&(catalog->sema));
 
 	return true;
@@ -730,83 +1779,108 @@ summary_add_table_parts_done(DatabaseCatalog *catalog,
 
 
 /*
- * summary_lookup_table_parts_done selects the PID that went there first.
- *
- * We could use insert or ignore ... returning ... but that's supported by
- * SQLite since version 3.35.0 (2021-03-12) and debian oldstable (bullseye) is
- * still around with Package: libsqlite3-0 (3.34.1-3).
+ * Large objects sizes histogram buckets, in bytes. The 1 MB limit matches
+ * LARGE_OBJECT_BATCH_MAX_BYTES.
+ */
+static BlobSizeHistogramBucket blobSizeHistogramBuckets[] = {
+	{ "< 8 kB", 0, 8 * 1024, 0, 0 },
+	{ "8 kB - 64 kB", 8 * 1024, 64 * 1024, 0, 0 },
+	{ "64 kB - 1 MB", 64 * 1024, 1024 * 1024, 0, 0 },
+	{ "1 MB - 16 MB", 1024 * 1024, 16 * 1024 * 1024, 0, 0 },
+	{ "16 MB - 256 MB", 16 * 1024 * 1024, 256 * 1024 * 1024, 0, 0 },
+	{ "256 MB - 1 GB", 256 * 1024 * 1024, 1024 * 1024 * 1024, 0, 0 },
+	{ ">= 1 GB", 1024 * 1024 * 1024, 0, 0, 0 }
+};
+
+static int blobSizeHistogramBucketsCount =
+	sizeof(blobSizeHistogramBuckets) / sizeof(blobSizeHistogramBuckets[0]);
+
+
+/*
+ * summary_blob_size_histogram counts the large objects registered in our
+ * catalogs, and their total size, in each of the histogram buckets. When
+ * the large objects sizes are unknown, the histogram is empty.
  */
 bool
-summary_lookup_table_parts_done(DatabaseCatalog *catalog,
-								CopyTableDataSpec *tableSpecs)
+summary_blob_size_histogram(DatabaseCatalog *catalog,
+							BlobSizeHistogram *histogram)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: summary_lookup_table_parts_done: db is NULL");
+		log_error("BUG: summary_blob_size_histogram: db is NULL");
 		return false;
 	}
 
-	SourceTable *table = tableSpecs->sourceTable;
+	histogram->count = 0;
+	histogram->bytes = 0;
+	histogram->bucketsCount = blobSizeHistogramBucketsCount;
+	histogram->buckets = blobSizeHistogramBuckets;
 
-	char *sql = "select pid from s_table_parts_done where tableoid = $1 ";
+	char *sql =
+		"select count(*), coalesce(sum(bytes), 0) "
+		"  from s_blob "
+		" where bytes >= $1 and ($2 = 0 or bytes < $2)";
 
-	if (!semaphore_lock(&(catalog->sema)))
+	for (int i = 0; i < histogram->bucketsCount; i++)
 	{
-		/* errors have already been logged */
-		return false;
-	}
+		BlobSizeHistogramBucket *bucket = &(histogram->buckets[i]);
 
-	SQLiteQuery query = {
-		.context = tableSpecs,
-		.fetchFunction = &summary_table_parts_done_fetch
-	};
+		if (!semaphore_lock(&(catalog->sema)))
+		{
+			/* errors have already been logged */
+			return false;
+		}
 
-	if (!catalog_sql_prepare(db, sql, &query))
-	{
-		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
-		return false;
-	}
+		SQLiteQuery query = {
+			.context = bucket,
+			.fetchFunction = &summary_blob_size_histogram_fetch
+		};
 
-	/* bind our parameters now */
-	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL }
-	};
+		if (!catalog_sql_prepare(db, sql, &query))
+		{
+			/* errors have already been logged */
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
 
-	int count = sizeof(params) / sizeof(params[0]);
+		BindParam params[] = {
+			{ BIND_PARAMETER_TYPE_INT64, "min", bucket->min, NULL },
+			{ BIND_PARAMETER_TYPE_INT64, "max", bucket->max, NULL }
+		};
 
-	if (!catalog_sql_bind(&query, params, count))
-	{
-		/* errors have already been logged */
-		(void) semaphore_unlock(&(catalog->sema));
-		return false;
-	}
+		int count = sizeof(params) / sizeof(params[0]);
+
+		if (!catalog_sql_bind(&query, params, count) ||
+			!catalog_sql_execute_once(&query))
+		{
+			/* errors have already been logged */
+			(void) semaphore_unlock(&(catalog->sema));
+			return false;
+		}
 
-	/* now execute the query, which does not return any row */
-	if (!catalog_sql_execute_once(&query))
-	{
-		/* errors have already been logged */
 		(void) semaphore_unlock(&(catalog->sema));
-		return false;
-	}
 
-	(void) semaphore_unlock(&(catalog->sema));
+		histogram->count += bucket->count;
+		histogram->bytes += bucket->bytes;
+	}
 
 	return true;
 }
 
 
 /*
- * summary_table_parts_done_fetch fetches a row from s_table_parts_done.
+ * summary_blob_size_histogram_fetch fetches a BlobSizeHistogramBucket from a
+ * query ppStmt result.
  */
 bool
-summary_table_parts_done_fetch(SQLiteQuery *query)
+summary_blob_size_histogram_fetch(SQLiteQuery *query)
 {
-	CopyTableDataSpec *tableSpecs = (CopyTableDataSpec *) query->context;
+	BlobSizeHistogramBucket *bucket = (BlobSizeHistogramBucket *) query->context;
 
-	tableSpecs->partsDonePid = sqlite3_column_int(query->ppStmt, 0);
+	bucket->count = sqlite3_column_int64(query->ppStmt, 0);
+	bucket->bytes = sqlite3_column_int64(query->ppStmt, 1);
 
 	return true;
 }
@@ -843,8 +1917,8 @@ summary_add_vacuum(DatabaseCatalog *catalog, CopyTableDataSpec *tableSpecs)
 	}
 
 	char *sql =
-		"insert into vacuum_summary(pid, tableoid, start_time_epoch)"
-		"values($1, $2, $3)";
+		"insert into vacuum_summary(pid, tableoid, start_time_epoch, action)"
+		"values($1, $2, $3, $4)";
 
 	if (!semaphore_lock(&(catalog->sema)))
 	{
@@ -867,7 +1941,10 @@ summary_add_vacuum(DatabaseCatalog *catalog, CopyTableDataSpec *tableSpecs)
 		{ BIND_PARAMETER_TYPE_INT64, "tableoid", table->oid, NULL },
 
 		{ BIND_PARAMETER_TYPE_INT64, "start_time_epoch",
-		  vacuumSummary->startTime, NULL }
+		  vacuumSummary->startTime, NULL },
+
+		{ BIND_PARAMETER_TYPE_TEXT, "action", 0,
+		  VacuumActionToString(vacuumSummary->action) }
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -1557,27 +2634,169 @@ summary_finish_constraint(DatabaseCatalog *catalog, CopyIndexSpec *indexSpecs)
 
 
 /*
- * summary_lookup_fk_constraint looks up an FK constraint in the
- * fk_constraint_summary table to check if it has already been processed.
+ * summary_lookup_fk_constraint looks up an FK constraint in the
+ * fk_constraint_summary table to check if it has already been processed. An
+ * FK constraint that has been added NOT VALID and has not been through the
+ * VALIDATE CONSTRAINT command yet has validatePending set to true.
+ */
+bool
+summary_lookup_fk_constraint(DatabaseCatalog *catalog, uint32_t conoid,
+							 bool *done, bool *validatePending)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_lookup_fk_constraint: db is NULL");
+		return false;
+	}
+
+	*done = false;
+	*validatePending = false;
+
+	char *sql =
+		"  select done_time_epoch, not_valid, validate_done_time_epoch "
+		"    from fk_constraint_summary "
+		"   where conoid = $1";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "conoid", conoid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	int rc = catalog_sql_step(&query);
+
+	if (rc == SQLITE_ROW)
+	{
+		int64_t doneTime = sqlite3_column_int64(query.ppStmt, 0);
+		bool notValid = sqlite3_column_int(query.ppStmt, 1) == 1;
+		int64_t validateTime = sqlite3_column_int64(query.ppStmt, 2);
+
+		*done = doneTime > 0;
+		*validatePending = *done && notValid && validateTime == 0;
+	}
+
+	if (!catalog_sql_finalize(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_add_fk_constraint inserts a new FK constraint summary entry to track
+ * the start of FK constraint creation.
+ */
+bool
+summary_add_fk_constraint(DatabaseCatalog *catalog, SourceFKConstraint *fk,
+						  const char *command)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_add_fk_constraint: db is NULL");
+		return false;
+	}
+
+	char *sql =
+		"insert or replace into fk_constraint_summary"
+		"(pid, conoid, start_time_epoch, command)"
+		"values($1, $2, $3, $4)";
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "conoid", fk->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "start_time_epoch", time(NULL), NULL },
+		{ BIND_PARAMETER_TYPE_TEXT, "command", 0, (char *) command }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
+/*
+ * summary_finish_fk_constraint updates the FK constraint summary with
+ * completion time and whether it was created as NOT VALID.
  */
 bool
-summary_lookup_fk_constraint(DatabaseCatalog *catalog, uint32_t conoid,
-							 bool *done)
+summary_finish_fk_constraint(DatabaseCatalog *catalog, SourceFKConstraint *fk,
+							 uint64_t durationMs, bool notValid)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: summary_lookup_fk_constraint: db is NULL");
+		log_error("BUG: summary_finish_fk_constraint: db is NULL");
 		return false;
 	}
 
-	*done = false;
-
 	char *sql =
-		"  select done_time_epoch "
-		"    from fk_constraint_summary "
-		"   where conoid = $1";
+		"update fk_constraint_summary "
+		"   set done_time_epoch = $1, duration = $2, not_valid = $3 "
+		" where pid = $4 and conoid = $5";
 
 	if (!semaphore_lock(&(catalog->sema)))
 	{
@@ -1595,7 +2814,11 @@ summary_lookup_fk_constraint(DatabaseCatalog *catalog, uint32_t conoid,
 	}
 
 	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "conoid", conoid, NULL }
+		{ BIND_PARAMETER_TYPE_INT64, "done_time_epoch", time(NULL), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "duration", durationMs, NULL },
+		{ BIND_PARAMETER_TYPE_INT, "not_valid", notValid ? 1 : 0, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "conoid", fk->oid, NULL }
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -1607,15 +2830,7 @@ summary_lookup_fk_constraint(DatabaseCatalog *catalog, uint32_t conoid,
 		return false;
 	}
 
-	int rc = catalog_sql_step(&query);
-
-	if (rc == SQLITE_ROW)
-	{
-		int64_t doneTime = sqlite3_column_int64(query.ppStmt, 0);
-		*done = doneTime > 0;
-	}
-
-	if (!catalog_sql_finalize(&query))
+	if (!catalog_sql_execute_once(&query))
 	{
 		/* errors have already been logged */
 		(void) semaphore_unlock(&(catalog->sema));
@@ -1629,25 +2844,24 @@ summary_lookup_fk_constraint(DatabaseCatalog *catalog, uint32_t conoid,
 
 
 /*
- * summary_add_fk_constraint inserts a new FK constraint summary entry to track
- * the start of FK constraint creation.
+ * summary_start_fk_validation registers the start of the VALIDATE CONSTRAINT
+ * command for an FK constraint that has been added as NOT VALID.
  */
 bool
-summary_add_fk_constraint(DatabaseCatalog *catalog, SourceFKConstraint *fk,
-						  const char *command)
+summary_start_fk_validation(DatabaseCatalog *catalog, SourceFKConstraint *fk)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: summary_add_fk_constraint: db is NULL");
+		log_error("BUG: summary_start_fk_validation: db is NULL");
 		return false;
 	}
 
 	char *sql =
-		"insert or replace into fk_constraint_summary"
-		"(pid, conoid, start_time_epoch, command)"
-		"values($1, $2, $3, $4)";
+		"update fk_constraint_summary "
+		"   set pid = $1, validate_start_time_epoch = $2 "
+		" where conoid = $3";
 
 	if (!semaphore_lock(&(catalog->sema)))
 	{
@@ -1666,9 +2880,9 @@ summary_add_fk_constraint(DatabaseCatalog *catalog, SourceFKConstraint *fk,
 
 	BindParam params[] = {
 		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
-		{ BIND_PARAMETER_TYPE_INT64, "conoid", fk->oid, NULL },
-		{ BIND_PARAMETER_TYPE_INT64, "start_time_epoch", time(NULL), NULL },
-		{ BIND_PARAMETER_TYPE_TEXT, "command", 0, (char *) command }
+		{ BIND_PARAMETER_TYPE_INT64, "validate_start_time_epoch",
+		  time(NULL), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "conoid", fk->oid, NULL }
 	};
 
 	int count = sizeof(params) / sizeof(params[0]);
@@ -1694,24 +2908,26 @@ summary_add_fk_constraint(DatabaseCatalog *catalog, SourceFKConstraint *fk,
 
 
 /*
- * summary_finish_fk_constraint updates the FK constraint summary with
- * completion time and whether it was created as NOT VALID.
+ * summary_finish_fk_validation updates the FK constraint summary with the
+ * VALIDATE CONSTRAINT completion time, and whether the constraint is still
+ * NOT VALID because of pre-existing data violations.
  */
 bool
-summary_finish_fk_constraint(DatabaseCatalog *catalog, SourceFKConstraint *fk,
+summary_finish_fk_validation(DatabaseCatalog *catalog, SourceFKConstraint *fk,
 							 uint64_t durationMs, bool notValid)
 {
 	sqlite3 *db = catalog->db;
 
 	if (db == NULL)
 	{
-		log_error("BUG: summary_finish_fk_constraint: db is NULL");
+		log_error("BUG: summary_finish_fk_validation: db is NULL");
 		return false;
 	}
 
 	char *sql =
 		"update fk_constraint_summary "
-		"   set done_time_epoch = $1, duration = $2, not_valid = $3 "
+		"   set validate_done_time_epoch = $1, validate_duration = $2, "
+		"       not_valid = $3 "
 		" where pid = $4 and conoid = $5";
 
 	if (!semaphore_lock(&(catalog->sema)))
@@ -1730,8 +2946,9 @@ summary_finish_fk_constraint(DatabaseCatalog *catalog, SourceFKConstraint *fk,
 	}
 
 	BindParam params[] = {
-		{ BIND_PARAMETER_TYPE_INT64, "done_time_epoch", time(NULL), NULL },
-		{ BIND_PARAMETER_TYPE_INT64, "duration", durationMs, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "validate_done_time_epoch",
+		  time(NULL), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "validate_duration", durationMs, NULL },
 		{ BIND_PARAMETER_TYPE_INT, "not_valid", notValid ? 1 : 0, NULL },
 		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
 		{ BIND_PARAMETER_TYPE_INT64, "conoid", fk->oid, NULL }
@@ -2035,6 +3252,150 @@ summary_table_indexes_done_fetch(SQLiteQuery *query)
 }
 
 
+/*
+ * summary_start_table_index_group registers the current pid as the process
+ * that builds all the indexes of the given table at once, unless another
+ * process did that first. Use summary_lookup_table_indexes_done to know which
+ * process owns the group.
+ *
+ * The process that builds the index group is also the process that builds
+ * the table constraints, see copydb_table_indexes_are_done.
+ */
+bool
+summary_start_table_index_group(DatabaseCatalog *catalog,
+								CopyTableDataSpec *tableSpecs,
+								int groupCount)
+{
+	char *sql =
+		"insert or ignore into s_table_indexes_done"
+		"(tableoid, pid, group_count, start_time_epoch) "
+		"values($1, $2, $3, $4)";
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid",
+		  tableSpecs->sourceTable->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "group_count", groupCount, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "start_time_epoch", time(NULL), NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	return summary_execute_with_params(catalog, sql, params, count);
+}
+
+
+/*
+ * summary_steal_table_index_group registers the current pid as the process
+ * that builds the indexes of the given table, when the previous owner of the
+ * group (stalePid) is not running anymore.
+ */
+bool
+summary_steal_table_index_group(DatabaseCatalog *catalog,
+								CopyTableDataSpec *tableSpecs,
+								int groupCount,
+								pid_t stalePid)
+{
+	char *sql =
+		"update s_table_indexes_done "
+		"   set pid = $1, group_count = $2, start_time_epoch = $3, "
+		"       done_time_epoch = null "
+		" where tableoid = $4 and pid = $5";
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "group_count", groupCount, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "start_time_epoch", time(NULL), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid",
+		  tableSpecs->sourceTable->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "stale_pid", stalePid, NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	return summary_execute_with_params(catalog, sql, params, count);
+}
+
+
+/*
+ * summary_finish_table_index_group registers the time when all the indexes
+ * of the given table have been built at once.
+ */
+bool
+summary_finish_table_index_group(DatabaseCatalog *catalog,
+								 CopyTableDataSpec *tableSpecs)
+{
+	char *sql =
+		"update s_table_indexes_done "
+		"   set done_time_epoch = $1 "
+		" where tableoid = $2 and pid = $3";
+
+	BindParam params[] = {
+		{ BIND_PARAMETER_TYPE_INT64, "done_time_epoch", time(NULL), NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "tableoid",
+		  tableSpecs->sourceTable->oid, NULL },
+		{ BIND_PARAMETER_TYPE_INT64, "pid", getpid(), NULL }
+	};
+
+	int count = sizeof(params) / sizeof(params[0]);
+
+	return summary_execute_with_params(catalog, sql, params, count);
+}
+
+
+/*
+ * summary_execute_with_params runs a query that does not return any row,
+ * holding the catalog semaphore.
+ */
+static bool
+summary_execute_with_params(DatabaseCatalog *catalog,
+							char *sql,
+							BindParam *params,
+							int count)
+{
+	sqlite3 *db = catalog->db;
+
+	if (db == NULL)
+	{
+		log_error("BUG: summary_execute_with_params: db is NULL");
+		return false;
+	}
+
+	if (!semaphore_lock(&(catalog->sema)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	SQLiteQuery query = { 0 };
+
+	if (!catalog_sql_prepare(db, sql, &query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	if (!catalog_sql_bind(&query, params, count))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	if (!catalog_sql_execute_once(&query))
+	{
+		/* errors have already been logged */
+		(void) semaphore_unlock(&(catalog->sema));
+		return false;
+	}
+
+	(void) semaphore_unlock(&(catalog->sema));
+
+	return true;
+}
+
+
 /*
  * summary_start_timing registers the start time for the given section.
  */
@@ -2713,6 +4074,7 @@ prepare_table_summary_as_json(CopyTableSummary *summary,
 	 */
 	json_object_dotset_number(jsSummaryObj, "network.bytes", summary->bytesTransmitted);
 	json_object_dotset_string(jsSummaryObj, "network.bytes-pretty", bytesPretty);
+	json_object_dotset_number(jsSummaryObj, "network.wire-bytes", summary->wireBytes);
 
 	/* attach the JSON array to the main JSON object under the provided key */
 	json_object_set_value(jsobj, key, jsSummary);
@@ -2800,6 +4162,43 @@ table_vacuum_summary_finish(CopyVacuumTableSummary *summary)
 }
 
 
+/*
+ * VacuumActionToString returns the name of the given VACUUM action, as
+ * registered in the vacuum_summary catalog table.
+ */
+char *
+VacuumActionToString(VacuumAction action)
+{
+	switch (action)
+	{
+		case VACUUM_ACTION_SKIP:
+		{
+			return "skip";
+		}
+
+		case VACUUM_ACTION_ANALYZE:
+		{
+			return "analyze";
+		}
+
+		case VACUUM_ACTION_VACUUM_ANALYZE:
+		{
+			return "vacuum analyze";
+		}
+
+		case VACUUM_ACTION_VACUUM_FREEZE_ANALYZE:
+		{
+			return "vacuum freeze analyze";
+		}
+
+		default:
+		{
+			return "unknown";
+		}
+	}
+}
+
+
 /*
  * prepare_index_summary_as_json prepares the summary information as a JSON
  * object within the given JSON_Value.
@@ -3004,23 +4403,25 @@ print_summary_table(SummaryTable *summary)
 
 	fformat(stdout, "\n");
 
-	fformat(stdout, "%*s | %*s | %*s | %*s | %*s | %*s | %*s | %*s \n",
+	fformat(stdout, "%*s | %*s | %*s | %*s | %*s | %*s | %*s | %*s | %*s \n",
 			headers->maxOidSize, "OID",
 			headers->maxNspnameSize, "Schema",
 			headers->maxRelnameSize, "Name",
 			headers->maxPartCountSize, "Parts",
 			headers->maxTableMsSize, "copy duration",
 			headers->maxBytesSize, "transmitted bytes",
+			headers->maxWireBytesSize, "est. wire bytes",
 			headers->maxIndexCountSize, "indexes",
 			headers->maxIndexMsSize, "create index duration");
 
-	fformat(stdout, "%s-+-%s-+-%s-+-%s-+-%s-+-%s-+-%s-+-%s\n",
+	fformat(stdout, "%s-+-%s-+-%s-+-%s-+-%s-+-%s-+-%s-+-%s-+-%s\n",
 			headers->oidSeparator,
 			headers->nspnameSeparator,
 			headers->relnameSeparator,
 			headers->partCountSeparator,
 			headers->tableMsSeparator,
 			headers->bytesSeparator,
+			headers->wireBytesSeparator,
 			headers->indexCountSeparator,
 			headers->indexMsSeparator);
 
@@ -3028,13 +4429,14 @@ print_summary_table(SummaryTable *summary)
 	{
 		SummaryTableEntry *entry = &(summary->array[i]);
 
-		fformat(stdout, "%*s | %*s | %*s | %*s | %*s | %*s | %*s | %*s\n",
+		fformat(stdout, "%*s | %*s | %*s | %*s | %*s | %*s | %*s | %*s | %*s\n",
 				headers->maxOidSize, entry->oidStr,
 				headers->maxNspnameSize, entry->nspname,
 				headers->maxRelnameSize, entry->relname,
 				headers->maxPartCountSize, entry->partCount,
 				headers->maxTableMsSize, entry->tableMs,
 				headers->maxBytesSize, entry->bytesStr,
+				headers->maxWireBytesSize, entry->wireBytesStr,
 				headers->maxIndexCountSize, entry->indexCount,
 				headers->maxIndexMsSize, entry->indexMs);
 	}
@@ -3043,6 +4445,115 @@ print_summary_table(SummaryTable *summary)
 }
 
 
+/*
+ * print_blob_size_histogram prints the count and size of the large objects
+ * in each of the histogram buckets.
+ */
+void
+print_blob_size_histogram(BlobSizeHistogram *histogram)
+{
+	if (histogram->count == 0)
+	{
+		return;
+	}
+
+	char *d10s = "----------";
+	char *d16s = "----------------";
+
+	fformat(stdout, "\n");
+
+	fformat(stdout, " %16s  %10s  %10s  %10s\n",
+			"LO Size", "Count", "Transfer", "% Bytes");
+
+	fformat(stdout, " %16s  %10s  %10s  %10s\n", d16s, d10s, d10s, d10s);
+
+	for (int i = 0; i < histogram->bucketsCount; i++)
+	{
+		BlobSizeHistogramBucket *bucket = &(histogram->buckets[i]);
+
+		char bytes[BUFSIZE] = { 0 };
+
+		(void) pretty_print_bytes(bytes, sizeof(bytes), bucket->bytes);
+
+		double pct =
+			histogram->bytes > 0
+			? (100.0 * bucket->bytes) / histogram->bytes
+			: 0.0;
+
+		fformat(stdout, " %16s  %10lld  %10s  %9.1f%%\n",
+				bucket->label,
+				(long long) bucket->count,
+				bytes,
+				pct);
+	}
+
+	fformat(stdout, "\n");
+}
+
+
+/*
+ * print_lo_worker_summary prints the throughput of each Large Objects
+ * worker, when large objects have been copied.
+ */
+void
+print_lo_worker_summary(LargeObjectWorkerSummaryArray *workers)
+{
+	uint64_t total = 0;
+
+	for (int i = 0; i < workers->count; i++)
+	{
+		total += workers->array[i].count;
+	}
+
+	if (total == 0)
+	{
+		return;
+	}
+
+	char *d10s = "----------";
+	char *d12s = "------------";
+
+	fformat(stdout, "\n");
+
+	fformat(stdout, " %10s  %10s  %10s  %12s  %10s  %12s\n",
+			"LO Worker", "Duration", "Count", "Transfer", "Batches", "Throughput");
+
+	fformat(stdout, " %10s  %10s  %10s  %12s  %10s  %12s\n",
+			d10s, d10s, d10s, d12s, d10s, d12s);
+
+	for (int i = 0; i < workers->count; i++)
+	{
+		LargeObjectWorkerSummary *worker = &(workers->array[i]);
+
+		char duration[BUFSIZE] = { 0 };
+		char bytes[BUFSIZE] = { 0 };
+		char throughput[BUFSIZE] = { 0 };
+
+		(void) IntervalToString(worker->durationMs, duration, sizeof(duration));
+		(void) pretty_print_bytes(bytes, sizeof(bytes), worker->bytes);
+
+		/* bytes per second */
+		uint64_t rate =
+			worker->durationMs > 0
+			? (worker->bytes * 1000) / worker->durationMs
+			: worker->bytes;
+
+		(void) pretty_print_bytes(throughput, sizeof(throughput), rate);
+		strlcat(throughput, "/s", sizeof(throughput));
+
+		fformat(stdout, " %10d  %10s  %10lld  %12s  %10lld  %12s\n",
+				worker->pid,
+				duration,
+				(long long) worker->count,
+				bytes,
+				(long long) worker->batches,
+				throughput);
+	}
+
+	fformat(stdout, "\n");
+}
+
+
 /*
  * print_summary_as_json writes the current summary of operations (with
  * timings) to given filename, as a structured JSON document.
@@ -3105,6 +4616,11 @@ print_summary_as_json(Summary *summary, const char *filename)
 								  "network.bytes", entry->bytes);
 		json_object_dotset_string(jsTableObj,
 								  "network.bytes-pretty", entry->bytesStr);
+		json_object_dotset_number(jsTableObj,
+								  "network.wire-bytes", entry->wireBytes);
+		json_object_dotset_string(jsTableObj,
+								  "network.wire-bytes-pretty",
+								  entry->wireBytesStr);
 		json_object_dotset_string(jsTableObj,
 								  "network.transmit-rate", entry->transmitRate);
 
@@ -3164,6 +4680,15 @@ print_summary_as_json(Summary *summary, const char *filename)
 	/* add the table array to the main JSON top-level dict */
 	json_object_set_value(jsobj, "tables", jsTables);
 
+	/* raw COPY data bytes and COPY protocol bytes read from the source */
+	json_object_dotset_number(jsobj, "network.bytes", summaryTable->totalBytes);
+	json_object_dotset_string(jsobj, "network.bytes-pretty",
+							  summaryTable->totalBytesStr);
+	json_object_dotset_number(jsobj, "network.wire-bytes",
+							  summaryTable->totalWireBytes);
+	json_object_dotset_string(jsobj, "network.wire-bytes-pretty",
+							  summaryTable->totalWireBytesStr);
+
 	char *serialized_string = json_serialize_to_string_pretty(js);
 	size_t len = strlen(serialized_string);
 
@@ -3193,6 +4718,7 @@ prepare_summary_table_headers(SummaryTable *summary)
 	headers->maxPartCountSize = 5;    /* "parts" */
 	headers->maxTableMsSize = 13;   /* "copy duration" */
 	headers->maxBytesSize = 17;     /* "transmitted bytes" */
+	headers->maxWireBytesSize = 15; /* "est. wire bytes" */
 	headers->maxIndexCountSize = 7; /* "indexes" */
 	headers->maxIndexMsSize = 21;   /* "create index duration" */
 
@@ -3244,6 +4770,13 @@ prepare_summary_table_headers(SummaryTable *summary)
 			headers->maxBytesSize = len;
 		}
 
+		len = strlen(entry->wireBytesStr);
+
+		if (headers->maxWireBytesSize < len)
+		{
+			headers->maxWireBytesSize = len;
+		}
+
 		len = strlen(entry->indexCount);
 
 		if (headers->maxIndexCountSize < len)
@@ -3266,6 +4799,7 @@ prepare_summary_table_headers(SummaryTable *summary)
 	prepareLineSeparator(headers->partCountSeparator, headers->maxPartCountSize);
 	prepareLineSeparator(headers->tableMsSeparator, headers->maxTableMsSize);
 	prepareLineSeparator(headers->bytesSeparator, headers->maxBytesSize);
+	prepareLineSeparator(headers->wireBytesSeparator, headers->maxWireBytesSize);
 	prepareLineSeparator(headers->indexCountSeparator, headers->maxIndexCountSize);
 	prepareLineSeparator(headers->indexMsSeparator, headers->maxIndexMsSize);
 }
@@ -3334,6 +4868,31 @@ print_summary(CopyDataSpec *specs)
 	(void) summary_prepare_toplevel_durations(specs);
 	(void) print_toplevel_summary(&summary);
 
+	/* and the Large Objects sizes and per-worker throughput */
+	if (!specs->skipLargeObjects)
+	{
+		BlobSizeHistogram histogram = { 0 };
+
+		if (!summary_blob_size_histogram(&(specs->catalogs.source), &histogram))
+		{
+			log_error("Failed to prepare the Large Objects summary");
+			return false;
+		}
+
+		(void) print_blob_size_histogram(&histogram);
+
+		LargeObjectWorkerSummaryArray workers = { 0, NULL };
+
+		if (!summary_lo_worker_array(&(specs->catalogs.source), &workers))
+		{
+			log_error("Failed to prepare the Large Objects summary");
+			return false;
+		}
+
+		(void) print_lo_worker_summary(&workers);
+		free(workers.array);
+	}
+
 	return true;
 }
 
@@ -3357,6 +4916,7 @@ prepare_summary_table(Summary *summary, CopyDataSpec *specs)
 	SummaryTable *summaryTable = &(summary->table);
 
 	summaryTable->totalBytes = 0;
+	summaryTable->totalWireBytes = 0;
 
 	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
 	CatalogCounts count = { 0 };
@@ -3407,6 +4967,10 @@ prepare_summary_table(Summary *summary, CopyDataSpec *specs)
 							  BUFSIZE,
 							  summary->table.totalBytes);
 
+	(void) pretty_print_bytes(summary->table.totalWireBytesStr,
+							  BUFSIZE,
+							  summary->table.totalWireBytes);
+
 	return true;
 }
 
@@ -3452,6 +5016,13 @@ prepare_summary_table_hook(void *ctx, SourceTable *table)
 					   sizeof(entry->bytesStr),
 					   entry->bytes);
 
+	entry->wireBytes = table->wireBytes;
+	summaryTable->totalWireBytes += table->wireBytes;
+
+	pretty_print_bytes(entry->wireBytesStr,
+					   sizeof(entry->wireBytesStr),
+					   entry->wireBytes);
+
 	pretty_print_bytes_per_second(entry->transmitRate,
 								  sizeof(entry->transmitRate),
 								  entry->bytes,
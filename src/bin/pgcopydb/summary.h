@@ -35,10 +35,103 @@ typedef struct CopyTableSummary
 	instr_time startTimeInstr;  /* internal instr_time tracker */
 	instr_time durationInstr;   /* internal instr_time tracker */
 	uint64_t bytesTransmitted;  /* total number of bytes copied */
+	uint64_t wireBytes;         /* estimated COPY protocol bytes read */
+	CopyDataFormat copyFormat;  /* text or binary */
+	bool freeze;                /* COPY ... WITH (FREEZE) was used */
 	char *command;              /* malloc'ed area */
 } CopyTableSummary;
 
 
+/*
+ * Count of the parts of a split table found in our summary.
+ */
+typedef struct TablePartsCount
+{
+	int started;                /* parts started, or done */
+	int done;                   /* parts done */
+} TablePartsCount;
+
+
+/*
+ * Tables that have been set UNLOGGED on the target database for the COPY,
+ * and are waiting to be set LOGGED again.
+ */
+typedef struct TableUnlogged
+{
+	uint32_t oid;
+	char qname[PG_NAMEDATALEN_FQ];
+	uint64_t unloggedTime;      /* time(NULL) at ALTER TABLE SET UNLOGGED */
+	uint64_t targetStartTime;   /* target pg_postmaster_start_time() then */
+	uint64_t copiedBytes;       /* bytes registered as copied already */
+} TableUnlogged;
+
+typedef struct TableUnloggedArray
+{
+	int count;
+	TableUnlogged *array;       /* malloc'ed area */
+} TableUnloggedArray;
+
+
+/*
+ * Each Large Objects worker registers how many large objects it copied, and
+ * how fast, to show per-worker throughput in the summary.
+ */
+typedef struct LargeObjectWorkerSummary
+{
+	pid_t pid;
+	uint64_t startTime;         /* time(NULL) at start time */
+	uint64_t doneTime;          /* time(NULL) at done time */
+	uint64_t durationMs;        /* instr_time duration in milliseconds */
+	instr_time startTimeInstr;  /* internal instr_time tracker */
+	uint64_t count;             /* count of large objects copied */
+	uint64_t bytes;             /* total number of bytes copied */
+	uint64_t batches;           /* count of batches, see --large-objects-batch-size */
+} LargeObjectWorkerSummary;
+
+typedef struct LargeObjectWorkerSummaryArray
+{
+	int count;
+	LargeObjectWorkerSummary *array; /* malloc'ed area */
+} LargeObjectWorkerSummaryArray;
+
+
+/*
+ * Histogram of the large objects sizes, to help tuning --large-objects-jobs
+ * and --large-objects-batch-size.
+ */
+typedef struct BlobSizeHistogramBucket
+{
+	char *label;
+	uint64_t min;               /* in bytes, included */
+	uint64_t max;               /* in bytes, excluded, 0 for no limit */
+	uint64_t count;
+	uint64_t bytes;
+} BlobSizeHistogramBucket;
+
+typedef struct BlobSizeHistogram
+{
+	uint64_t count;
+	uint64_t bytes;
+	int bucketsCount;
+	BlobSizeHistogramBucket *buckets;
+} BlobSizeHistogram;
+
+
+/*
+ * After COPY, a table is either analyzed only, when its pages have been
+ * frozen and marked all-visible by COPY FREEZE, or vacuumed and analyzed,
+ * freezing the rows when using --freeze. Empty tables are skipped.
+ */
+typedef enum
+{
+	VACUUM_ACTION_UNKNOWN = 0,
+	VACUUM_ACTION_SKIP,
+	VACUUM_ACTION_ANALYZE,
+	VACUUM_ACTION_VACUUM_ANALYZE,
+	VACUUM_ACTION_VACUUM_FREEZE_ANALYZE
+} VacuumAction;
+
+
 typedef struct CopyVacuumTableSummary
 {
 	pid_t pid;                  /* pid */
@@ -48,6 +141,9 @@ typedef struct CopyVacuumTableSummary
 	uint64_t durationMs;        /* instr_time duration in milliseconds */
 	instr_time startTimeInstr;  /* internal instr_time tracker */
 	instr_time durationInstr;   /* internal instr_time tracker */
+	bool frozen;                /* all the COPY parts used FREEZE */
+	uint64_t bytesCopied;       /* bytes sent by the COPY parts */
+	VacuumAction action;        /* skip, analyze, or vacuum analyze */
 } CopyVacuumTableSummary;
 
 typedef struct CopyIndexSummary
@@ -97,6 +193,7 @@ typedef struct SummaryTableHeaders
 	int maxPartCountSize;
 	int maxTableMsSize;
 	int maxBytesSize;
+	int maxWireBytesSize;
 	int maxIndexCountSize;
 	int maxIndexMsSize;
 
@@ -106,6 +203,7 @@ typedef struct SummaryTableHeaders
 	char partCountSeparator[NAMEDATALEN];
 	char tableMsSeparator[NAMEDATALEN];
 	char bytesSeparator[NAMEDATALEN];
+	char wireBytesSeparator[NAMEDATALEN];
 	char indexCountSeparator[NAMEDATALEN];
 	char indexMsSeparator[NAMEDATALEN];
 } SummaryTableHeaders;
@@ -139,7 +237,9 @@ typedef struct SummaryTableEntry
 	char partCount[INTSTRING_MAX_DIGITS];
 	char tableMs[INTERVAL_MAXLEN];
 	uint64_t bytes;
+	uint64_t wireBytes;
 	char bytesStr[INTSTRING_MAX_DIGITS];
+	char wireBytesStr[INTSTRING_MAX_DIGITS];
 	char transmitRate[INTSTRING_MAX_DIGITS];
 	char indexCount[INTSTRING_MAX_DIGITS];
 	char indexMs[INTERVAL_MAXLEN];
@@ -154,7 +254,9 @@ typedef struct SummaryTable
 	int count;
 	SummaryTableHeaders headers;
 	uint64_t totalBytes;
+	uint64_t totalWireBytes;
 	char totalBytesStr[INTSTRING_MAX_DIGITS];
+	char totalWireBytesStr[INTSTRING_MAX_DIGITS];
 	SummaryTableEntry *array;   /* calloc'ed area */
 } SummaryTable;
 
@@ -226,6 +328,7 @@ bool table_summary_finish(CopyTableSummary *summary);
 
 bool table_vacuum_summary_init(CopyVacuumTableSummary *summary);
 bool table_vacuum_summary_finish(CopyVacuumTableSummary *summary);
+char * VacuumActionToString(VacuumAction action);
 
 bool index_summary_init(CopyIndexSummary *summary);
 bool index_summary_finish(CopyIndexSummary *summary);
@@ -248,6 +351,8 @@ void print_summary_as_json(Summary *summary, const char *filename);
  */
 void print_toplevel_summary(Summary *summary);
 void print_summary_table(SummaryTable *summary);
+void print_lo_worker_summary(LargeObjectWorkerSummaryArray *workers);
+void print_blob_size_histogram(BlobSizeHistogram *histogram);
 void prepare_summary_table_headers(SummaryTable *summary);
 
 int TopLevelTimingConcurrency(Summary *summary, TopLevelTiming *timing);
@@ -6,6 +6,7 @@
 #include <errno.h>
 #include <getopt.h>
 #include <inttypes.h>
+#include <math.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -26,8 +27,53 @@
 #include "summary.h"
 
 
+/* tables to add to the COPY queue */
+typedef struct CopyQueueTable
+{
+	SourceTable table;          /* as fetched by the catalog iterator */
+	uint32_t parentOid;         /* partitioned table root, or zero */
+	int64_t cost;               /* table bytes plus index bytes */
+	int rank;                   /* position in the catalog iterator order */
+	int next;                   /* next table with the same parentOid */
+} CopyQueueTable;
+
+typedef struct CopyQueueTableArray
+{
+	int count;
+	int capacity;
+	CopyQueueTable *array;      /* malloc'ed area */
+} CopyQueueTableArray;
+
+static bool copydb_copy_supervisor_collect_table_hook(void *ctx,
+													  SourceTable *table);
+static int copydb_copy_queue_table_cmp(const void *a, const void *b);
+static bool copydb_copy_supervisor_order_tables(CopyDataSpec *specs,
+												CopyQueueTableArray *tables,
+												int *order);
 static bool copydb_copy_supervisor_add_table_hook(void *ctx, SourceTable *table);
 static bool copydb_update_copy_stats_hook(void *ctx, CopyStats *stats);
+static bool copydb_prepare_table_part_steps(PGSQL *src, PGSQL *dst,
+											CopyTableDataSpec *tableSpecs,
+											bool *useSteps);
+static bool copydb_copy_table_steps(CopyDataSpec *specs,
+									PGSQL *src, PGSQL *dst,
+									CopyTableDataSpec *tableSpecs,
+									CopyStats *stats);
+static bool copydb_copy_table_range(CopyDataSpec *specs,
+									PGSQL *src, PGSQL *dst,
+									CopyTableDataSpec *tableSpecs,
+									CopyStats *stats);
+static bool copydb_steal_table_parts(CopyDataSpec *specs,
+									 PGSQL *src, PGSQL *dst,
+									 uint64_t *errors);
+static bool copydb_table_part_can_delete(CopyTableDataSpec *tableSpecs);
+static bool copydb_prepare_copy_range_query(CopyTableDataSpec *tableSpecs,
+											CopyArgs *args,
+											int64_t min, int64_t max);
+static bool copydb_reset_copy_connections(CopyDataSpec *specs,
+										  PGSQL *src, PGSQL *dst);
+static bool copydb_update_summary_copy_format(CopyDataSpec *specs,
+											  CopyTableDataSpec *tableSpecs);
 
 /*
  * copydb_table_data fetches the list of tables from the source database and
@@ -43,6 +89,16 @@ copydb_copy_all_table_data(CopyDataSpec *specs)
 {
 	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
 
+	/*
+	 * Tables that were left UNLOGGED by a previous run might have lost their
+	 * contents if the target server crashed since then.
+	 */
+	if (specs->resume && !copydb_unlogged_tables_resume(specs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
 	if (specs->runState.tableCopyIsDone &&
 		specs->runState.indexCopyIsDone &&
 		specs->runState.sequenceCopyIsDone &&
@@ -547,16 +603,63 @@ copydb_copy_worker_queue_tables(CopyDataSpec *specs)
 		context.dst = &dst;
 	}
 
+	/*
+	 * Collect the tables to COPY, then decide in which order to queue them,
+	 * interleaving leaf partitions of different partitioned tables.
+	 */
+	CopyQueueTableArray tables = { 0 };
+
 	if (!catalog_iter_s_table(sourceDB,
-							  &context,
-							  copydb_copy_supervisor_add_table_hook))
+							  &tables,
+							  copydb_copy_supervisor_collect_table_hook))
+	{
+		log_fatal("Failed to list tables to COPY, terminating");
+		free(tables.array);
+		(void) pgsql_finish(&dst);
+		(void) copydb_fatal_exit();
+		return false;
+	}
+
+	int *order = (int *) calloc(tables.count + 1, sizeof(int));
+
+	if (order == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		free(tables.array);
+		(void) pgsql_finish(&dst);
+		(void) copydb_fatal_exit();
+		return false;
+	}
+
+	if (!copydb_copy_supervisor_order_tables(specs, &tables, order))
 	{
-		log_fatal("Failed to add tables to the COPY worker queue, terminating");
+		log_fatal("Failed to order tables to COPY, terminating");
+		free(order);
+		free(tables.array);
 		(void) pgsql_finish(&dst);
 		(void) copydb_fatal_exit();
 		return false;
 	}
 
+	for (int i = 0; i < tables.count; i++)
+	{
+		CopyQueueTable *entry = &(tables.array[order[i]]);
+
+		if (!copydb_copy_supervisor_add_table_hook(&context, &(entry->table)))
+		{
+			log_fatal("Failed to add tables to the COPY worker queue, "
+					  "terminating");
+			free(order);
+			free(tables.array);
+			(void) pgsql_finish(&dst);
+			(void) copydb_fatal_exit();
+			return false;
+		}
+	}
+
+	free(order);
+	free(tables.array);
+
 	if (stats.countSplits > 0)
 	{
 		(void) pgsql_finish(&dst);
@@ -586,6 +689,228 @@ copydb_copy_worker_queue_tables(CopyDataSpec *specs)
 }
 
 
+/*
+ * copydb_copy_supervisor_collect_table_hook is an iterator callback function
+ * that collects the tables to COPY, in the iterator order (bytes desc), and
+ * computes their cost: the table bytes to COPY and then the index bytes to
+ * build once the COPY is done.
+ */
+static bool
+copydb_copy_supervisor_collect_table_hook(void *ctx, SourceTable *table)
+{
+	CopyQueueTableArray *tables = (CopyQueueTableArray *) ctx;
+
+	if (tables->count == tables->capacity)
+	{
+		int capacity = tables->capacity == 0 ? 1024 : 2 * tables->capacity;
+
+		CopyQueueTable *array =
+			(CopyQueueTable *) realloc(tables->array,
+									   capacity * sizeof(CopyQueueTable));
+
+		if (array == NULL)
+		{
+			log_error(ALLOCATION_FAILED_ERROR);
+			return false;
+		}
+
+		tables->array = array;
+		tables->capacity = capacity;
+	}
+
+	CopyQueueTable *entry = &(tables->array[tables->count++]);
+
+	entry->table = *table;
+	entry->table.attrList = NULL;
+	entry->parentOid = table->parentOid;
+	entry->cost = table->bytes + table->indexBytes;
+	entry->rank = tables->count - 1;
+	entry->next = -1;
+
+	return true;
+}
+
+
+/*
+ * copydb_copy_queue_table_cmp sorts tables by cost, largest first, keeping
+ * the catalog iterator order for tables of the same cost.
+ */
+static int
+copydb_copy_queue_table_cmp(const void *a, const void *b)
+{
+	const CopyQueueTable *ta = (const CopyQueueTable *) a;
+	const CopyQueueTable *tb = (const CopyQueueTable *) b;
+
+	if (ta->cost != tb->cost)
+	{
+		return ta->cost > tb->cost ? -1 : 1;
+	}
+
+	return ta->rank - tb->rank;
+}
+
+
+/*
+ * copydb_copy_supervisor_order_tables computes the order in which to add the
+ * tables to the COPY queue. Tables are sorted by cost, that is the table size
+ * plus the size of its indexes, largest tables first, so that the longest
+ * jobs start early and the smaller ones fill-in the gaps at the end of the
+ * run. We keep that order except for leaf partitions.
+ *
+ * When the largest table left is a leaf partition and the previous
+ * (tableJobs - 1) tables queued include a leaf of the same partitioned table,
+ * then the largest table left that is not a leaf of one of the partitioned
+ * tables being copied is queued first. This interleaves leaves of different
+ * partitioned tables, and other tables, so that workers are not all busy with
+ * the leaves of the same partitioned table, building their indexes at the
+ * same time.
+ *
+ * The order is returned as an array of indexes into tables->array.
+ */
+static bool
+copydb_copy_supervisor_order_tables(CopyDataSpec *specs,
+									CopyQueueTableArray *tables,
+									int *order)
+{
+	/* groups of leaf partitions, one per partitioned table root */
+	int groupCount = 0;
+	int *groupHead = (int *) calloc(tables->count + 1, sizeof(int));
+	int *groupTail = (int *) calloc(tables->count + 1, sizeof(int));
+	uint32_t *groupParent = (uint32_t *) calloc(tables->count + 1,
+												sizeof(uint32_t));
+
+	/* window of the partitioned table roots of the last queued tables */
+	int windowSize = specs->tableJobs - 1;
+	uint32_t *window = (uint32_t *) calloc(windowSize + 1, sizeof(uint32_t));
+
+	if (groupHead == NULL || groupTail == NULL || groupParent == NULL ||
+		window == NULL)
+	{
+		log_error(ALLOCATION_FAILED_ERROR);
+		free(groupHead);
+		free(groupTail);
+		free(groupParent);
+		free(window);
+		return false;
+	}
+
+	/* sort by cost first, the iterator only sorts by table bytes */
+	if (tables->count > 1)
+	{
+		qsort(tables->array,
+			  tables->count,
+			  sizeof(CopyQueueTable),
+			  copydb_copy_queue_table_cmp);
+	}
+
+	/* group zero is for tables that are not leaf partitions */
+	groupHead[0] = groupTail[0] = -1;
+	groupCount = 1;
+
+	for (int i = 0; i < tables->count; i++)
+	{
+		uint32_t parentOid = tables->array[i].parentOid;
+		int g = 0;
+
+		if (parentOid != 0)
+		{
+			for (g = 1; g < groupCount; g++)
+			{
+				if (groupParent[g] == parentOid)
+				{
+					break;
+				}
+			}
+
+			if (g == groupCount)
+			{
+				groupParent[g] = parentOid;
+				groupHead[g] = groupTail[g] = -1;
+				++groupCount;
+			}
+		}
+
+		if (groupHead[g] == -1)
+		{
+			groupHead[g] = i;
+		}
+		else
+		{
+			tables->array[groupTail[g]].next = i;
+		}
+
+		groupTail[g] = i;
+	}
+
+	for (int n = 0; n < tables->count; n++)
+	{
+		int pick = -1;
+		int fallback = -1;
+
+		/* each group head is the largest table left in that group */
+		for (int g = 0; g < groupCount; g++)
+		{
+			int head = groupHead[g];
+
+			if (head == -1)
+			{
+				continue;
+			}
+
+			if (fallback == -1 || head < fallback)
+			{
+				fallback = head;
+			}
+
+			bool busy = false;
+
+			for (int w = 0; g > 0 && w < windowSize; w++)
+			{
+				if (window[w] == groupParent[g])
+				{
+					busy = true;
+					break;
+				}
+			}
+
+			if (!busy && (pick == -1 || head < pick))
+			{
+				pick = head;
+			}
+		}
+
+		if (pick == -1)
+		{
+			pick = fallback;
+		}
+
+		order[n] = pick;
+
+		/* advance the head of the group we picked from */
+		for (int g = 0; g < groupCount; g++)
+		{
+			if (groupHead[g] == pick)
+			{
+				groupHead[g] = tables->array[pick].next;
+				break;
+			}
+		}
+
+		if (windowSize > 0)
+		{
+			window[n % windowSize] = tables->array[pick].parentOid;
+		}
+	}
+
+	free(groupHead);
+	free(groupTail);
+	free(groupParent);
+	free(window);
+
+	return true;
+}
+
+
 /*
  * copydb_copy_supervisor_add_table_hook is an iterator callback function.
  */
@@ -622,7 +947,60 @@ copydb_copy_supervisor_add_table_hook(void *ctx, SourceTable *table)
 			return false;
 		}
 
-		if (granted)
+		/*
+		 * When resuming a previous run, parts that have been copied already,
+		 * entirely or up to their last step, are not copied again: then the
+		 * target table must not be truncated. Ranges that might have been
+		 * copied without being registered are deleted on the target before
+		 * being copied again, see copydb_table_create_lockfile.
+		 *
+		 * Target rows can not be matched to a range of source ctid values
+		 * though, so a table split by ctid that has not been copied entirely
+		 * is copied again from scratch. With --freeze, the first part copies
+		 * the whole table, and then a table that has not been copied entirely
+		 * is also copied again from scratch.
+		 */
+		DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+		TablePartsCount partsCount = { 0 };
+
+		if (!summary_table_count_parts_started(sourceDB, table, &partsCount))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (!granted &&
+			partsCount.started > 0 &&
+			partsCount.done < table->partition.partCount &&
+			streq(table->partKey, "ctid"))
+		{
+			log_warn("Table %s is split by ctid and was partially copied "
+					 "in a previous run, and TRUNCATE is not granted: rows "
+					 "of the parts being copied then might be duplicated",
+					 table->qname);
+		}
+
+		if (granted &&
+			partsCount.started > 0 &&
+			partsCount.done < table->partition.partCount &&
+			(streq(table->partKey, "ctid") || specs->freeze))
+		{
+			log_notice("Table %s was partially copied in a previous run, "
+					   "copying it again",
+					   table->qname);
+
+			if (!summary_delete_table_parts(sourceDB, table) ||
+				!catalog_s_table_part_reset(sourceDB, table))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+
+			partsCount.started = 0;
+		}
+
+		/* with --freeze, the first part truncates the table itself */
+		if (granted && partsCount.started == 0 && !specs->freeze)
 		{
 			if (!pgsql_truncate(dst, table->qname))
 			{
@@ -816,6 +1194,16 @@ copydb_table_data_worker(CopyDataSpec *specs)
 			{
 				stop = true;
 				log_debug("Stop message received by COPY worker");
+
+				/*
+				 * The queue is empty now, help the workers that are still
+				 * copying a table part by stealing some of their work.
+				 */
+				if (!copydb_steal_table_parts(specs, src, &dst, &errors))
+				{
+					pgsql_finish(&dst);
+					return false;
+				}
 				break;
 			}
 
@@ -882,6 +1270,65 @@ copydb_table_data_worker(CopyDataSpec *specs)
 }
 
 
+/*
+ * copydb_steal_table_parts loops over stealing the upper half of the range
+ * left to copy in table parts that other workers are still copying, and then
+ * copies the stolen part, until no part has enough work left to be split.
+ */
+static bool
+copydb_steal_table_parts(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
+						 uint64_t *errors)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+
+	while (!(asked_to_stop || asked_to_stop_fast || asked_to_quit))
+	{
+		uint32_t oid = 0;
+		int part = 0;
+		bool found = false;
+
+		if (!catalog_s_table_part_steal(sourceDB, &oid, &part, &found))
+		{
+			log_error("Failed to split a table part being copied, "
+					  "see above for details");
+			++(*errors);
+			return !specs->failFast;
+		}
+
+		if (!found)
+		{
+			break;
+		}
+
+		if (!copydb_copy_data_by_oid(specs, src, dst, oid, part))
+		{
+			log_error("Failed to copy data for table with oid %u "
+					  "and part number %d, see above for details",
+					  oid,
+					  part);
+
+			++(*errors);
+
+			if (specs->failFast)
+			{
+				return false;
+			}
+
+			/* clean-up our target connection state for next table */
+			(void) copydb_close_snapshot(specs);
+
+			if (!copydb_set_snapshot(specs))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
 /*
  * copydb_copy_data_by_oid finds the SourceTable entry by its OID and then
  * COPY the table data to the target database.
@@ -1039,8 +1486,39 @@ copydb_copy_data_by_oid(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
 			/* errors have already been logged */
 			return false;
 		}
+		else if (!allPartsDone)
+		{
+			/*
+			 * Tables listed in the [concurrent-index-table] filtering section
+			 * have their indexes built while the other parts are copied,
+			 * unless the first part is copying the whole table.
+			 */
+			if (!specs->deferIndexes &&
+				!tableSpecs->copiedByFirstPart &&
+				copydb_table_has_concurrent_indexes(&(specs->filters),
+													tableSpecs->sourceTable))
+			{
+				if (!copydb_add_table_indexes_early(specs, tableSpecs))
+				{
+					log_error("Failed to add the indexes for %s, "
+							  "see above for details",
+							  tableSpecs->sourceTable->qname);
+					return false;
+				}
+			}
+		}
 		else if (allPartsDone && !indexesAreBeingProcessed)
 		{
+			/*
+			 * With --unlogged, set the table LOGGED again before building
+			 * its indexes, which SET LOGGED would otherwise rewrite too.
+			 */
+			if (!copydb_set_table_logged(specs, dst, tableSpecs->sourceTable))
+			{
+				/* errors have already been logged */
+				return false;
+			}
+
 			/*
 			 * The VACUUM command takes a conflicting lock with the CREATE
 			 * INDEX and ALTER TABLE commands used for indexes and constraints,
@@ -1077,7 +1555,32 @@ copydb_copy_data_by_oid(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
 			}
 			else if (!specs->deferIndexes)
 			{
-				if (!copydb_add_table_indexes(specs, tableSpecs))
+				bool addedEarly = false;
+
+				if (!copydb_table_indexes_were_added_early(specs,
+														   tableSpecs,
+														   &addedEarly))
+				{
+					/* errors have already been logged */
+					return false;
+				}
+
+				/*
+				 * When the indexes have been sent to the CREATE INDEX queue
+				 * already, the constraints are still waiting for the COPY to
+				 * be done, and are now ours to build if the indexes are done.
+				 */
+				if (addedEarly)
+				{
+					if (!copydb_finish_table_indexes(specs,
+													 dst,
+													 tableSpecs->sourceTable))
+					{
+						/* errors have already been logged */
+						return false;
+					}
+				}
+				else if (!copydb_add_table_indexes(specs, tableSpecs))
 				{
 					log_error("Failed to add the indexes for %s, "
 							  "see above for details",
@@ -1129,6 +1632,8 @@ copydb_table_create_lockfile(CopyDataSpec *specs,
 		return true;
 	}
 
+	bool resumed = false;
+
 	if (tableSummary->pid != 0)
 	{
 		/* if we can signal the pid, it is still running */
@@ -1155,6 +1660,8 @@ copydb_table_create_lockfile(CopyDataSpec *specs,
 				return false;
 			}
 
+			resumed = true;
+
 			/* pass through to the rest of this function */
 		}
 	}
@@ -1170,15 +1677,26 @@ copydb_table_create_lockfile(CopyDataSpec *specs,
 
 	/* COPY FROM tablename, or maybe COPY FROM (SELECT ... WHERE ...) */
 	CopyArgs *args = &(tableSpecs->copyArgs);
+	SourceTable *table = tableSpecs->sourceTable;
+	bool splitTable = table->partition.partCount > 1;
 
 	args->srcQname = tableSpecs->sourceTable->qname;
 	args->srcAttrList = tableSpecs->sourceTable->attrList;
 	args->srcWhereClause = NULL;
 	args->dstQname = tableSpecs->sourceTable->qname;
 	args->dstAttrList = tableSpecs->sourceTable->attrList;
+	args->dstWhereClause = NULL;
 	args->truncate = false;     /* default value, see below */
-	args->freeze = tableSpecs->sourceTable->partition.partCount <= 1;
-	args->useCopyBinary = specs->useCopyBinary;
+	args->freeze = !splitTable;
+	args->bufferSize = specs->copyBufferSize;
+
+	if (!copydb_table_use_copy_binary(specs,
+									  tableSpecs,
+									  &(args->useCopyBinary)))
+	{
+		/* errors have already been logged */
+		return false;
+	}
 
 	/*
 	 * Check to see if we want to TRUNCATE the table and benefit from the COPY
@@ -1186,33 +1704,66 @@ copydb_table_create_lockfile(CopyDataSpec *specs,
 	 *
 	 * First, if the table COPY is partitionned then we truncate at the
 	 * top-level rather than for each partition, disabling the COPY FREEZE
-	 * optimisation.
+	 * optimisation. With --freeze though, the first part truncates the table
+	 * and copies all of its rows in a single COPY FREEZE command, and the
+	 * other parts have nothing left to copy.
 	 *
 	 * Second, we need the permission to run the TRUNCATE command on the target
 	 * table on the target database.
 	 */
-	if (tableSpecs->sourceTable->partition.partCount <= 1)
+	if (!splitTable || specs->freeze)
 	{
 		bool granted = false;
 
-		if (!pgsql_has_table_privilege(dst,
-									   tableSpecs->sourceTable->qname,
-									   "TRUNCATE",
-									   &granted))
+		if (!pgsql_has_table_privilege(dst, table->qname, "TRUNCATE", &granted))
 		{
 			/* errors have already been logged */
 			return false;
 		}
 
-		args->truncate = granted;
+		if (!splitTable)
+		{
+			args->truncate = granted;
+		}
+		else if (granted && table->partition.partNumber == 1)
+		{
+			args->truncate = true;
+			args->freeze = true;
+		}
+		else if (granted)
+		{
+			tableSpecs->copiedByFirstPart = true;
+		}
+
+		/* only warn once per table, split or not */
+		if (specs->freeze && !granted && table->partition.partNumber <= 1)
+		{
+			log_warn("Missing TRUNCATE privilege on table %s, "
+					 "COPY FREEZE is not possible and the table rows are "
+					 "going to be frozen by VACUUM",
+					 table->qname);
+		}
 	}
 
-	if (!copydb_prepare_copy_query(tableSpecs, args))
+	/* the first part of a split table might copy the whole table */
+	if (!args->freeze && !copydb_prepare_copy_query(tableSpecs, args))
 	{
 		/* errors have already been logged */
 		return false;
 	}
 
+	/*
+	 * A table part that was being copied in a previous run might have been
+	 * committed on the target without being registered in our catalogs. The
+	 * table is not truncated then, so delete the part rows before copying.
+	 * Parts copied in steps only delete the rows of the steps that were
+	 * claimed in the previous run, see copydb_copy_table_steps.
+	 */
+	if (resumed && copydb_table_part_can_delete(tableSpecs))
+	{
+		args->dstWhereClause = args->srcWhereClause;
+	}
+
 	if (!copydb_prepare_summary_command(tableSpecs))
 	{
 		/* errors have already been logged */
@@ -1340,6 +1891,8 @@ typedef struct UpdateCopyStatsContext
 {
 	CopyDataSpec *specs;
 	CopyTableDataSpec *tableSpecs;
+	uint64_t bytesBase;         /* bytes sent in previous steps */
+	uint64_t wireBytesBase;     /* wire bytes read in previous steps */
 	uint64_t lastWrite;
 } UpdateCopyStatsContext;
 
@@ -1365,8 +1918,19 @@ copydb_copy_table(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
 	CopyTableSummary *summary = &(tableSpecs->summary);
 	CopyStats stats = { 0 };
 
-	/*
-	 * Set longer retry policy on src/dst connections so that
+	if (tableSpecs->copiedByFirstPart)
+	{
+		log_notice("Skipping COPY of table %s part %d, "
+				   "the first part copies the whole table with COPY FREEZE",
+				   tableSpecs->sourceTable->qname,
+				   tableSpecs->part.partNumber);
+
+		summary->freeze = true;
+		return true;
+	}
+
+	/*
+	 * Set longer retry policy on src/dst connections so that
 	 * pgsql_retry_open_connection() uses 5-min timeout with 30s sleep cap
 	 * instead of the default 60s/2s. This lets COPY workers survive source
 	 * outages (e.g. Supabase maintenance, IP lockouts) lasting minutes.
@@ -1374,6 +1938,267 @@ copydb_copy_table(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
 	pgsql_set_copy_retry_policy(&(src->retryPolicy));
 	pgsql_set_copy_retry_policy(&(dst->retryPolicy));
 
+	bool useSteps = false;
+	bool success = false;
+
+	if (!copydb_prepare_table_part_steps(src, dst, tableSpecs, &useSteps))
+	{
+		/* errors have already been logged */
+		success = false;
+	}
+	else if (useSteps)
+	{
+		success = copydb_copy_table_steps(specs, src, dst, tableSpecs, &stats);
+	}
+	else
+	{
+		success = copydb_copy_table_range(specs, src, dst, tableSpecs, &stats);
+	}
+
+	/* restore default retry policy on connections */
+	pgsql_set_interactive_retry_policy(&(src->retryPolicy));
+	pgsql_set_interactive_retry_policy(&(dst->retryPolicy));
+
+	/* publish bytesTransmitted accumulated value to the summary */
+	summary->bytesTransmitted = stats.bytesTransmitted;
+	summary->wireBytes = stats.wireBytes;
+	summary->copyFormat =
+		tableSpecs->copyArgs.useCopyBinary ? COPY_FORMAT_BINARY : COPY_FORMAT_TEXT;
+	summary->freeze = !useSteps && tableSpecs->copyArgs.freeze;
+
+	if (success && stats.sendCount > 0)
+	{
+		log_debug("COPY %s sent %lld rows in %lld messages, "
+				  "%.1f rows per message on average",
+				  tableSpecs->sourceTable->qname,
+				  (long long) stats.rowsTransmitted,
+				  (long long) stats.sendCount,
+				  (double) stats.rowsTransmitted / (double) stats.sendCount);
+	}
+
+	return success;
+}
+
+
+/*
+ * copydb_prepare_table_part_steps decides if a table part is copied in steps,
+ * each step being its own COPY command for a range of the part values. Steps
+ * allow workers that are done with the queue to steal the rest of a part that
+ * is still being copied, and allow resuming a part from its last step.
+ *
+ * The NULL values part can not be split, and neither can ctid parts when the
+ * source server is older than Postgres 14, as each step would then scan the
+ * whole table rather than only the pages in its range.
+ *
+ * The rows of a ctid range can not be found on the target database, so a
+ * table split by ctid that has been partially copied is truncated and copied
+ * again from scratch when resuming. Without the TRUNCATE privilege that is
+ * not possible, and then the table parts are not split in steps, so that
+ * they are never stolen either.
+ *
+ * With --freeze, the first part of a split table copies the whole table in a
+ * single COPY FREEZE command, which is not split in steps either.
+ */
+static bool
+copydb_prepare_table_part_steps(PGSQL *src, PGSQL *dst,
+								CopyTableDataSpec *tableSpecs,
+								bool *useSteps)
+{
+	SourceTable *table = tableSpecs->sourceTable;
+	SourceTableParts *part = &(table->partition);
+	bool splitByCTID = streq(tableSpecs->part.partKey, "ctid");
+
+	*useSteps = false;
+
+	if (part->partCount <= 1 ||
+		tableSpecs->copyArgs.freeze ||
+		(!splitByCTID && part->min == -1 && part->max == -1) ||
+		(splitByCTID && src->pgversion_num < 140000))
+	{
+		return true;
+	}
+
+	if (splitByCTID)
+	{
+		bool granted = false;
+
+		if (!pgsql_has_table_privilege(dst, table->qname, "TRUNCATE", &granted))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		if (!granted)
+		{
+			log_debug("Missing TRUNCATE privilege on table %s, "
+					  "not splitting part %d in steps",
+					  table->qname,
+					  part->partNumber);
+			return true;
+		}
+	}
+
+	/* the last part has no upper bound, estimate one */
+	if (part->max != -1)
+	{
+		part->bound = part->max;
+	}
+	else if (splitByCTID)
+	{
+		part->bound = table->relpages - 1;
+	}
+	else
+	{
+		if (!schema_get_part_key_min_max(src, table))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		part->bound = table->partmax;
+	}
+
+	if (part->bound < part->min)
+	{
+		part->bound = part->min;
+	}
+
+	part->step = ceil((double) (part->bound - part->min + 1) / COPY_PART_STEPS);
+
+	*useSteps = true;
+
+	return true;
+}
+
+
+/*
+ * copydb_copy_table_steps copies a table part one step at a time, claiming
+ * each step in our catalogs first so that other workers may steal the steps
+ * that are not claimed yet, and registering each step once copied so that a
+ * later run resumes from there.
+ */
+static bool
+copydb_copy_table_steps(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
+						CopyTableDataSpec *tableSpecs,
+						CopyStats *stats)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+	SourceTable *table = tableSpecs->sourceTable;
+	SourceTableParts *part = &(table->partition);
+
+	if (!catalog_s_table_part_start(sourceDB, table))
+	{
+		log_error("Failed to register table %s part %d progress",
+				  table->qname,
+				  part->partNumber);
+		return false;
+	}
+
+	if (part->copied > part->min)
+	{
+		log_info("Resuming COPY of table %s part %d at %lld",
+				 table->qname,
+				 part->partNumber,
+				 (long long) part->copied);
+	}
+
+	/*
+	 * The step bounds are only used for the COPY query of each step, the
+	 * part bounds in tableSpecs->part and the part WHERE clause are kept
+	 * as-is for the summary and the other users of the part.
+	 */
+	CopyArgs *args = &(tableSpecs->copyArgs);
+	char *partWhereClause = args->srcWhereClause;
+	bool success = true;
+
+	for (;;)
+	{
+		int64_t stepMin = 0;
+		int64_t stepMax = 0;
+		bool done = false;
+
+		if (!catalog_s_table_part_claim(sourceDB,
+										table,
+										&stepMin,
+										&stepMax,
+										&done))
+		{
+			log_error("Failed to claim the next step of table %s part %d",
+					  table->qname,
+					  part->partNumber);
+			success = false;
+			break;
+		}
+
+		if (done)
+		{
+			break;
+		}
+
+		args->srcWhereClause = NULL;
+
+		if (!copydb_prepare_copy_range_query(tableSpecs, args, stepMin, stepMax))
+		{
+			/* errors have already been logged */
+			success = false;
+			break;
+		}
+
+		/* steps claimed in a previous run might be on the target already */
+		args->dstWhereClause = NULL;
+
+		if (stepMin < part->reclaimed &&
+			copydb_table_part_can_delete(tableSpecs))
+		{
+			args->dstWhereClause = args->srcWhereClause;
+		}
+
+		log_debug("COPY %s part %d step [%lld .. %lld]",
+				  table->qname,
+				  part->partNumber,
+				  (long long) stepMin,
+				  (long long) stepMax);
+
+		success = copydb_copy_table_range(specs, src, dst, tableSpecs, stats);
+
+		free(args->srcWhereClause);
+
+		args->srcWhereClause = partWhereClause;
+		args->dstWhereClause = NULL;
+
+		if (!success)
+		{
+			/* errors have already been logged */
+			break;
+		}
+
+		part->copied = part->claimed;
+
+		if (!catalog_s_table_part_copied(sourceDB, table))
+		{
+			log_error("Failed to register table %s part %d progress",
+					  table->qname,
+					  part->partNumber);
+			success = false;
+			break;
+		}
+	}
+
+	args->srcWhereClause = partWhereClause;
+
+	return success;
+}
+
+
+/*
+ * copydb_copy_table_range runs the COPY command prepared in tableSpecs, with
+ * retries, and adds its statistics to the given stats.
+ */
+static bool
+copydb_copy_table_range(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
+						CopyTableDataSpec *tableSpecs,
+						CopyStats *stats)
+{
 	/*
 	 * Use a time-budgeted outer retry loop (30 min) instead of a fixed
 	 * attempt count. This pairs with the longer connection retry to let
@@ -1390,6 +2215,7 @@ copydb_copy_table(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
 
 	int attempts = 0;
 	bool success = false;
+	CopyStats attempt = { 0 };
 
 	while (!success)
 	{
@@ -1397,16 +2223,18 @@ copydb_copy_table(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
 
 		/* re-init stats between attempts */
 		CopyStats empty = { 0 };
-		stats = empty;
+		attempt = empty;
 
 		UpdateCopyStatsContext context = {
 			.specs = specs,
-			.tableSpecs = tableSpecs
+			.tableSpecs = tableSpecs,
+			.bytesBase = stats->bytesTransmitted,
+			.wireBytesBase = stats->wireBytes
 		};
 
 		/* ignore previous attempts, we need only one success here */
 		success = pg_copy(src, dst,
-						  &(tableSpecs->copyArgs), &stats,
+						  &(tableSpecs->copyArgs), &attempt,
 						  &context, &copydb_update_copy_stats_hook);
 
 		if (success)
@@ -1426,6 +2254,44 @@ copydb_copy_table(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
 			pgsql_state_is_connection_error(src) ||
 			pgsql_state_is_connection_error(dst);
 
+		/*
+		 * With --copy-format auto, when a table fails to COPY in binary
+		 * format because of the binary format itself, try again in text
+		 * format. Other errors, such as data errors, are not retried. Our
+		 * connections have been closed or left in a failed transaction, so
+		 * start again from fresh ones.
+		 */
+		bool isBinaryFormatError =
+			pgsql_state_is_copy_binary_error(src) ||
+			pgsql_state_is_copy_binary_error(dst);
+
+		if (!isConnectionError &&
+			isBinaryFormatError &&
+			specs->copyFormat == COPY_FORMAT_AUTO &&
+			tableSpecs->copyArgs.useCopyBinary &&
+			!(asked_to_quit || asked_to_stop || asked_to_stop_fast))
+		{
+			log_warn("Failed to copy table %s in binary format, "
+					 "retrying in text format",
+					 tableSpecs->sourceTable->qname);
+
+			tableSpecs->copyArgs.useCopyBinary = false;
+
+			if (!copydb_update_summary_copy_format(specs, tableSpecs))
+			{
+				/* errors have already been logged */
+				break;
+			}
+
+			if (!copydb_reset_copy_connections(specs, src, dst))
+			{
+				/* errors have already been logged */
+				break;
+			}
+
+			continue;
+		}
+
 		if (!isConnectionError)
 		{
 			log_error("Failed to copy table %s due to non-connection error, "
@@ -1461,17 +2327,45 @@ copydb_copy_table(CopyDataSpec *specs, PGSQL *src, PGSQL *dst,
 		pg_usleep(sleepTimeMs * 1000);
 	}
 
-	/* restore default retry policy on connections */
-	pgsql_set_interactive_retry_policy(&(src->retryPolicy));
-	pgsql_set_interactive_retry_policy(&(dst->retryPolicy));
-
-	/* publish bytesTransmitted accumulated value to the summary */
-	summary->bytesTransmitted = stats.bytesTransmitted;
+	if (success)
+	{
+		stats->bytesTransmitted += attempt.bytesTransmitted;
+		stats->wireBytes += attempt.wireBytes;
+		stats->rowsTransmitted += attempt.rowsTransmitted;
+		stats->sendCount += attempt.sendCount;
+	}
 
 	return success;
 }
 
 
+/*
+ * copydb_update_summary_copy_format updates the COPY command that we log and
+ * register in our summary, and the COPY format registered there, after the
+ * COPY format of a table has changed.
+ */
+static bool
+copydb_update_summary_copy_format(CopyDataSpec *specs,
+								  CopyTableDataSpec *tableSpecs)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+	CopyTableSummary *summary = &(tableSpecs->summary);
+
+	free(summary->command);
+
+	if (!copydb_prepare_summary_command(tableSpecs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	summary->copyFormat =
+		tableSpecs->copyArgs.useCopyBinary ? COPY_FORMAT_BINARY : COPY_FORMAT_TEXT;
+
+	return summary_update_table_copy_format(sourceDB, tableSpecs);
+}
+
+
 /*
  * copydb_update_copy_stats_hook updates the bytesTransmitted data in our
  * SQLite summary.
@@ -1501,7 +2395,8 @@ copydb_update_copy_stats_hook(void *ctx, CopyStats *stats)
 	}
 
 	/* update tablespecs summary durationMs and bytesTransmitted */
-	summary->bytesTransmitted = stats->bytesTransmitted;
+	summary->bytesTransmitted = context->bytesBase + stats->bytesTransmitted;
+	summary->wireBytes = context->wireBytesBase + stats->wireBytes;
 
 	instr_time duration;
 
@@ -1523,12 +2418,41 @@ copydb_update_copy_stats_hook(void *ctx, CopyStats *stats)
 }
 
 
+/*
+ * copydb_table_part_can_delete returns true when the rows of the table part
+ * can be deleted on the target database using the source WHERE clause, which
+ * is not the case for parts of a table split by ctid.
+ */
+static bool
+copydb_table_part_can_delete(CopyTableDataSpec *tableSpecs)
+{
+	return tableSpecs->sourceTable->partition.partCount > 1 &&
+		   !streq(tableSpecs->part.partKey, "ctid");
+}
+
+
 /*
  * copydb_prepare_copy_query prepares a COPY query using the list of attribute
  * names from the SourceTable instance.
  */
 bool
 copydb_prepare_copy_query(CopyTableDataSpec *tableSpecs, CopyArgs *args)
+{
+	return copydb_prepare_copy_range_query(tableSpecs,
+										   args,
+										   tableSpecs->part.min,
+										   tableSpecs->part.max);
+}
+
+
+/*
+ * copydb_prepare_copy_range_query prepares a COPY query for the given range
+ * of values of the table part key, which is the whole part range, or only
+ * one of its steps.
+ */
+static bool
+copydb_prepare_copy_range_query(CopyTableDataSpec *tableSpecs, CopyArgs *args,
+								int64_t min, int64_t max)
 {
 	/*
 	 * On a source COPY query we might want to add filtering.
@@ -1544,27 +2468,26 @@ copydb_prepare_copy_query(CopyTableDataSpec *tableSpecs, CopyArgs *args)
 		 */
 		if (streq(tableSpecs->part.partKey, "ctid"))
 		{
-			if (tableSpecs->part.max == -1)
+			if (max == -1)
 			{
 				/* the last part for ctid splits covers "extra" relpages */
 				appendPQExpBuffer(srcWhereClause,
 								  "WHERE ctid >= '(%lld,0)'::tid",
-								  (long long) tableSpecs->part.min);
+								  (long long) min);
 			}
 			else
 			{
 				appendPQExpBuffer(srcWhereClause,
 								  "WHERE ctid >= '(%lld,0)'::tid"
 								  " and ctid < '(%lld,0)'::tid",
-								  (long long) tableSpecs->part.min,
-								  (long long) tableSpecs->part.max + 1);
+								  (long long) min,
+								  (long long) max + 1);
 			}
 		}
 		else
 		{
 			/* partition to take care of NULL values */
-			if (tableSpecs->part.min == -1 &&
-				tableSpecs->part.max == -1)
+			if (min == -1 && max == -1)
 			{
 				appendPQExpBuffer(srcWhereClause,
 								  "WHERE %s IS NULL",
@@ -1572,20 +2495,20 @@ copydb_prepare_copy_query(CopyTableDataSpec *tableSpecs, CopyArgs *args)
 			}
 
 			/* the last partition has no upper bound */
-			else if (tableSpecs->part.max == -1)
+			else if (max == -1)
 			{
 				appendPQExpBuffer(srcWhereClause,
 								  "WHERE %s >= %lld",
 								  tableSpecs->part.partKey,
-								  (long long) tableSpecs->part.min);
+								  (long long) min);
 			}
 			else
 			{
 				appendPQExpBuffer(srcWhereClause,
 								  "WHERE %s BETWEEN %lld AND %lld",
 								  tableSpecs->part.partKey,
-								  (long long) tableSpecs->part.min,
-								  (long long) tableSpecs->part.max);
+								  (long long) min,
+								  (long long) max);
 			}
 		}
 
@@ -1604,10 +2527,152 @@ copydb_prepare_copy_query(CopyTableDataSpec *tableSpecs, CopyArgs *args)
 }
 
 
+/*
+ * copydb_table_use_copy_binary decides if the given table should be copied
+ * using the COPY binary format. With --copy-format auto the decision is made
+ * from the table column types found in our s_attr catalog:
+ *
+ * - user-defined types (enums, composite types, extension types, arrays of
+ *   those) use text, because their binary representation may embed type OIDs
+ *   that differ between the source and target databases, and some extension
+ *   types do not implement binary send and receive functions at all,
+ *
+ * - tables with a bytea column use binary, which avoids doubling the data
+ *   size with the hex text encoding,
+ *
+ * - tables where at least half of the columns are numeric, date, timestamp or
+ *   interval use binary, which skips the costly text output and parsing of
+ *   those types.
+ *
+ * Other tables use text, where binary would not make much of a difference.
+ */
+bool
+copydb_table_use_copy_binary(CopyDataSpec *specs,
+							 CopyTableDataSpec *tableSpecs,
+							 bool *useCopyBinary)
+{
+	SourceTable *table = tableSpecs->sourceTable;
+
+	*useCopyBinary = specs->copyFormat == COPY_FORMAT_BINARY;
+
+	if (specs->copyFormat != COPY_FORMAT_AUTO)
+	{
+		return true;
+	}
+
+	if (table->attributes.array == NULL)
+	{
+		DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+
+		if (!catalog_s_table_fetch_attrs(sourceDB, table))
+		{
+			log_error("Failed to fetch table %s attributes, "
+					  "see above for details",
+					  table->qname);
+			return false;
+		}
+	}
+
+	int columns = 0;
+	int binaryColumns = 0;
+	bool hasBytea = false;
+
+	for (int i = 0; i < table->attributes.count; i++)
+	{
+		SourceTableAttribute *attr = &(table->attributes.array[i]);
+
+		/* generated columns are not part of the COPY */
+		if (attr->attisgenerated)
+		{
+			continue;
+		}
+
+		if (attr->atttypid >= PG_FIRST_NORMAL_OBJECT_ID)
+		{
+			log_debug("Table %s column %s has user-defined type %u, "
+					  "using COPY text format",
+					  table->qname,
+					  attr->attname,
+					  attr->atttypid);
+			return true;
+		}
+
+		++columns;
+
+		switch (attr->atttypid)
+		{
+			case BYTEAOID:
+			{
+				hasBytea = true;
+				break;
+			}
+
+			case NUMERICOID:
+			case DATEOID:
+			case TIMESTAMPOID:
+			case TIMESTAMPTZOID:
+			case INTERVALOID:
+			{
+				++binaryColumns;
+				break;
+			}
+
+			default:
+			{
+				break;
+			}
+		}
+	}
+
+	*useCopyBinary = hasBytea || (columns > 0 && (2 * binaryColumns) >= columns);
+
+	log_debug("Table %s: using COPY %s format",
+			  table->qname,
+			  *useCopyBinary ? "binary" : "text");
+
+	return true;
+}
+
+
+/*
+ * copydb_reset_copy_connections gets our source and target connections back
+ * to a clean state after a failed COPY: the source snapshot is set again, and
+ * the target connection is opened again with our GUC settings.
+ */
+static bool
+copydb_reset_copy_connections(CopyDataSpec *specs, PGSQL *src, PGSQL *dst)
+{
+	if (src == &(specs->sourceSnapshot.pgsql))
+	{
+		(void) copydb_close_snapshot(specs);
+
+		if (!copydb_set_snapshot(specs))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+	}
+
+	if (dst->connection != NULL)
+	{
+		(void) pgsql_rollback(dst);
+	}
+
+	if (!pgsql_set_gucs(dst, dstSettings))
+	{
+		log_error("Failed to set our GUC settings on the target connection, "
+				  "see above for details");
+		return false;
+	}
+
+	return true;
+}
+
+
 /*
  * copydb_prepare_summary_command prepares the table summary command:
  *
- *  COPY qname WHERE ...
+ *  COPY qname WHERE ... WITH (FORMAT binary)
  */
 bool
 copydb_prepare_summary_command(CopyTableDataSpec *tableSpecs)
@@ -1623,6 +2688,11 @@ copydb_prepare_summary_command(CopyTableDataSpec *tableSpecs)
 		appendPQExpBuffer(command, " %s", tableSpecs->copyArgs.srcWhereClause);
 	}
 
+	if (tableSpecs->copyArgs.useCopyBinary)
+	{
+		appendPQExpBufferStr(command, " WITH (FORMAT binary)");
+	}
+
 	tableSummary->command =
 		command->data != NULL ? strdup(command->data) : NULL;
 
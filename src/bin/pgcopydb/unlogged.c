@@ -0,0 +1,381 @@
+/*
+ * src/bin/pgcopydb/unlogged.c
+ *     Implementation of a CLI to copy a database between two Postgres instances
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include "catalog.h"
+#include "copydb.h"
+#include "log.h"
+#include "signals.h"
+#include "summary.h"
+
+
+typedef struct UnloggedTablesContext
+{
+	CopyDataSpec *specs;
+	PGSQL *dst;
+	uint64_t targetStartTime;
+	int count;
+} UnloggedTablesContext;
+
+
+static bool copydb_target_set_table_unlogged_hook(void *ctx, SourceTable *table);
+
+
+/*
+ * copydb_target_set_tables_unlogged runs ALTER TABLE ... SET UNLOGGED on the
+ * target database for all the tables that we are going to COPY, right after
+ * the pre-data section has been restored, when using --unlogged.
+ *
+ * COPY into an unlogged table does not write WAL. The tables are set LOGGED
+ * again as soon as their data has been copied, see copydb_set_table_logged.
+ *
+ * The tables are registered in the s_table_unlogged catalog table before
+ * being set UNLOGGED, so that we know to set them LOGGED again when resuming
+ * after a failure.
+ */
+bool
+copydb_target_set_tables_unlogged(CopyDataSpec *specs)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+
+	if (!specs->unlogged)
+	{
+		return true;
+	}
+
+	PGSQL dst = { 0 };
+
+	uint64_t startTime = 0;
+
+	if (!pgsql_init(&dst, specs->connStrings.target_pguri, PGSQL_CONN_TARGET) ||
+		!pgsql_postmaster_start_time(&dst, &startTime))
+	{
+		/* errors have already been logged */
+		(void) pgsql_finish(&dst);
+		return false;
+	}
+
+	UnloggedTablesContext context = {
+		.specs = specs,
+		.dst = &dst,
+		.targetStartTime = startTime,
+		.count = 0
+	};
+
+	if (!catalog_iter_s_table(sourceDB,
+							  &context,
+							  &copydb_target_set_table_unlogged_hook))
+	{
+		log_error("Failed to set tables UNLOGGED on the target database, "
+				  "see above for details");
+		(void) pgsql_finish(&dst);
+		return false;
+	}
+
+	(void) pgsql_finish(&dst);
+
+	log_info("Set %d tables UNLOGGED on the target database for COPY",
+			 context.count);
+
+	return true;
+}
+
+
+/*
+ * copydb_target_set_table_unlogged_hook is an iterator callback function.
+ */
+static bool
+copydb_target_set_table_unlogged_hook(void *ctx, SourceTable *table)
+{
+	UnloggedTablesContext *context = (UnloggedTablesContext *) ctx;
+	DatabaseCatalog *sourceDB = &(context->specs->catalogs.source);
+	PGSQL *dst = context->dst;
+
+	/* skip materialized views, and tables that we do not copy */
+	if (table->relkind != 'r' || table->excludeData)
+	{
+		return true;
+	}
+
+	/*
+	 * Tables listed in the [concurrent-index-table] filtering section have
+	 * their indexes built while their other parts are being copied, and SET
+	 * LOGGED would then have to wait for CREATE INDEX CONCURRENTLY and to
+	 * rewrite the indexes too: keep those tables LOGGED.
+	 */
+	if (copydb_table_has_concurrent_indexes(&(context->specs->filters), table))
+	{
+		log_notice("Skipping SET UNLOGGED for table %s, "
+				   "listed in the [concurrent-index-table] section",
+				   table->qname);
+		return true;
+	}
+
+	/* tables that are unlogged on the source must remain unlogged */
+	bool unlogged = false;
+
+	if (!pgsql_table_is_unlogged(dst, table->qname, &unlogged))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (unlogged)
+	{
+		log_debug("Table %s is already UNLOGGED", table->qname);
+		return true;
+	}
+
+	if (!summary_add_table_unlogged(sourceDB, table, context->targetStartTime))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	char sql[BUFSIZE] = { 0 };
+
+	sformat(sql, sizeof(sql), "ALTER TABLE %s SET UNLOGGED", table->qname);
+
+	log_notice("%s", sql);
+
+	if (!pgsql_execute(dst, sql))
+	{
+		log_warn("Failed to set table %s UNLOGGED, "
+				 "COPY is going to write WAL for this table",
+				 table->qname);
+
+		return summary_delete_table_unlogged(sourceDB, table);
+	}
+
+	++(context->count);
+
+	return true;
+}
+
+
+/*
+ * copydb_set_table_logged runs ALTER TABLE ... SET LOGGED on the target
+ * database for the given table, when it has been set UNLOGGED before COPY.
+ *
+ * This is called by the COPY worker that finishes the last part of the
+ * table, before sending the table indexes to the CREATE INDEX queue: SET
+ * LOGGED rewrites the table and all of its indexes, and takes an ACCESS
+ * EXCLUSIVE lock, so it is cheaper to run it before the indexes exist, while
+ * the indexes of other tables are being built.
+ */
+bool
+copydb_set_table_logged(CopyDataSpec *specs, PGSQL *dst, SourceTable *table)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+
+	bool pending = false;
+
+	if (!summary_lookup_table_unlogged(sourceDB, table, &pending))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (!pending)
+	{
+		return true;
+	}
+
+	if (!summary_start_table_logged(sourceDB, table))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	char sql[BUFSIZE] = { 0 };
+
+	sformat(sql, sizeof(sql), "ALTER TABLE %s SET LOGGED", table->qname);
+
+	log_notice("%s", sql);
+
+	instr_time startTime;
+	INSTR_TIME_SET_CURRENT(startTime);
+
+	if (!pgsql_execute(dst, sql))
+	{
+		log_error("Failed to set table %s LOGGED, see above for details",
+				  table->qname);
+		return false;
+	}
+
+	instr_time duration;
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, startTime);
+	uint64_t durationMs = INSTR_TIME_GET_MILLISEC(duration);
+
+	if (!summary_finish_table_logged(sourceDB, table, durationMs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ * copydb_set_tables_logged sets LOGGED again all the tables that are still
+ * UNLOGGED on the target database, which happens when the COPY worker that
+ * would have done it failed, or when resuming a previous run.
+ *
+ * This must be done before restoring the post-data section, because a
+ * permanent table can not have a foreign key to an unlogged table.
+ */
+bool
+copydb_set_tables_logged(CopyDataSpec *specs)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+	TableUnloggedArray tables = { 0, NULL };
+
+	if (!summary_table_unlogged_pending(sourceDB, &tables))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (tables.count == 0)
+	{
+		return true;
+	}
+
+	log_info("Setting %d tables LOGGED on the target database", tables.count);
+
+	PGSQL dst = { 0 };
+
+	if (!pgsql_init(&dst, specs->connStrings.target_pguri, PGSQL_CONN_TARGET))
+	{
+		/* errors have already been logged */
+		free(tables.array);
+		return false;
+	}
+
+	bool success = true;
+
+	for (int i = 0; i < tables.count; i++)
+	{
+		SourceTable table = { .oid = tables.array[i].oid };
+
+		strlcpy(table.qname, tables.array[i].qname, sizeof(table.qname));
+
+		if (!copydb_set_table_logged(specs, &dst, &table))
+		{
+			/* errors have already been logged */
+			success = false;
+			break;
+		}
+	}
+
+	(void) pgsql_finish(&dst);
+	free(tables.array);
+
+	return success;
+}
+
+
+/*
+ * copydb_unlogged_tables_resume checks the tables that have been set
+ * UNLOGGED on a previous run and not set LOGGED again. When the target
+ * server has been restarted since, the contents of those tables might have
+ * been reset by crash recovery: then forget about their COPY progress so
+ * that their data is copied again.
+ *
+ * The target server start time is compared to the one registered when the
+ * table was set UNLOGGED, so that we never compare our own clock with the
+ * target server clock. A table that is empty when our catalogs say that
+ * some of its data has been copied is also copied again.
+ */
+bool
+copydb_unlogged_tables_resume(CopyDataSpec *specs)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+	TableUnloggedArray tables = { 0, NULL };
+
+	if (!summary_table_unlogged_pending(sourceDB, &tables))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (tables.count == 0)
+	{
+		return true;
+	}
+
+	PGSQL dst = { 0 };
+	uint64_t startTime = 0;
+
+	if (!pgsql_init(&dst, specs->connStrings.target_pguri, PGSQL_CONN_TARGET) ||
+		!pgsql_postmaster_start_time(&dst, &startTime))
+	{
+		/* errors have already been logged */
+		(void) pgsql_finish(&dst);
+		free(tables.array);
+		return false;
+	}
+
+	bool success = true;
+
+	for (int i = 0; i < tables.count; i++)
+	{
+		TableUnlogged *unlogged = &(tables.array[i]);
+
+		if (startTime != unlogged->targetStartTime)
+		{
+			log_warn("Target server restarted since table %s was set "
+					 "UNLOGGED, copying its data again",
+					 unlogged->qname);
+		}
+		else if (unlogged->copiedBytes > 0)
+		{
+			bool empty = false;
+
+			if (!pgsql_table_is_empty(&dst, unlogged->qname, &empty))
+			{
+				/* errors have already been logged */
+				success = false;
+				break;
+			}
+
+			if (!empty)
+			{
+				continue;
+			}
+
+			log_warn("Table %s is empty on the target server, "
+					 "copying its data again",
+					 unlogged->qname);
+		}
+		else
+		{
+			continue;
+		}
+
+		SourceTable table = { .oid = unlogged->oid };
+
+		strlcpy(table.qname, unlogged->qname, sizeof(table.qname));
+
+		if (!summary_reset_table_copy(sourceDB, &table))
+		{
+			/* errors have already been logged */
+			success = false;
+			break;
+		}
+
+		specs->runState.tableCopyIsDone = false;
+	}
+
+	(void) pgsql_finish(&dst);
+	free(tables.array);
+
+	return success;
+}
@@ -297,7 +297,8 @@ vacuum_worker(CopyDataSpec *specs)
 /*
  * vacuum_analyze_table_by_oid reads the done file for the given table OID,
  * fetches the schemaname and relname from there, and then connects to the
- * target database to issue a VACUUM ANALYZE command.
+ * target database to issue the cheapest maintenance command that is needed
+ * for the table, see vacuum_choose_action.
  */
 bool
 vacuum_analyze_table_by_oid(CopyDataSpec *specs, uint32_t oid)
@@ -333,11 +334,44 @@ vacuum_analyze_table_by_oid(CopyDataSpec *specs, uint32_t oid)
 		return false;
 	}
 
-	/* finally, vacuum analyze the table and its indexes */
+	if (!vacuum_choose_action(specs, &dst, &tableSpecs))
+	{
+		/* errors have already been logged */
+		(void) pgsql_finish(&dst);
+		return false;
+	}
+
+	CopyVacuumTableSummary *vSummary = &(tableSpecs.vSummary);
+
+	if (vSummary->action == VACUUM_ACTION_SKIP)
+	{
+		log_notice("Skipping VACUUM ANALYZE %s: no rows were copied",
+				   table.qname);
+
+		(void) pgsql_finish(&dst);
+
+		if (!summary_add_vacuum(sourceDB, &tableSpecs) ||
+			!summary_finish_vacuum(sourceDB, &tableSpecs))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		return true;
+	}
+
+	/* finally, vacuum analyze the table and its indexes, or just analyze */
 	char vacuum[BUFSIZE] = { 0 };
 
+	char *command =
+		vSummary->action == VACUUM_ACTION_ANALYZE ? "ANALYZE" :
+		vSummary->action == VACUUM_ACTION_VACUUM_FREEZE_ANALYZE ?
+		"VACUUM (FREEZE, ANALYZE)" :
+		"VACUUM ANALYZE";
+
 	sformat(vacuum, sizeof(vacuum),
-			"VACUUM ANALYZE %s.%s",
+			"%s %s.%s",
+			command,
 			table.nspname,
 			table.relname);
 
@@ -397,6 +431,69 @@ vacuum_analyze_table_by_oid(CopyDataSpec *specs, uint32_t oid)
 }
 
 
+/*
+ * vacuum_choose_action sets tableSpecs->vSummary.action to the cheapest
+ * maintenance command that is needed for the table after COPY:
+ *
+ *  - when no rows have been copied in a table that was truncated in the same
+ *    transaction, the table is empty and there is nothing to do,
+ *
+ *  - when all the COPY parts used FREEZE, the pages are already frozen and,
+ *    since Postgres 14, marked all-visible in the visibility map, so VACUUM
+ *    would only scan the whole heap to find nothing to do: ANALYZE only,
+ *
+ *  - otherwise, VACUUM ANALYZE the table, and when using --freeze then
+ *    VACUUM (FREEZE, ANALYZE) the table so that all its rows are frozen now
+ *    rather than by an anti-wraparound vacuum later.
+ */
+bool
+vacuum_choose_action(CopyDataSpec *specs, PGSQL *dst,
+					 CopyTableDataSpec *tableSpecs)
+{
+	DatabaseCatalog *sourceDB = &(specs->catalogs.source);
+	CopyVacuumTableSummary *vSummary = &(tableSpecs->vSummary);
+
+	vSummary->action = VACUUM_ACTION_VACUUM_ANALYZE;
+
+	if (!summary_lookup_table_frozen(sourceDB, tableSpecs))
+	{
+		/* errors have already been logged */
+		return false;
+	}
+
+	if (vSummary->frozen && vSummary->bytesCopied == 0)
+	{
+		vSummary->action = VACUUM_ACTION_SKIP;
+	}
+	else if (vSummary->frozen)
+	{
+		if (!pgsql_server_version(dst))
+		{
+			/* errors have already been logged */
+			return false;
+		}
+
+		/* COPY FREEZE sets the visibility map bits since Postgres 14 */
+		if (dst->pgversion_num >= 140000)
+		{
+			vSummary->action = VACUUM_ACTION_ANALYZE;
+		}
+	}
+	else if (specs->freeze)
+	{
+		vSummary->action = VACUUM_ACTION_VACUUM_FREEZE_ANALYZE;
+	}
+
+	log_debug("vacuum_choose_action: %s %s (frozen: %s, %lld bytes copied)",
+			  VacuumActionToString(vSummary->action),
+			  tableSpecs->sourceTable->qname,
+			  vSummary->frozen ? "yes" : "no",
+			  (long long) vSummary->bytesCopied);
+
+	return true;
+}
+
+
 /*
  * vacuum_add_table sends a message to the VACUUM process queue to process
  * given table.
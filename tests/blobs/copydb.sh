@@ -67,11 +67,19 @@ pgcopydb restore post-data --resume
 
 pgcopydb list progress --summary
 
+psql -d ${PGCOPYDB_TARGET_PGURI} -1 -c "${SQL}" > /tmp/target.lo
+
+diff /tmp/source.lo /tmp/target.lo
+
+# now copy the large objects again, in batches this time
+pgcopydb copy blobs --large-objects-jobs 2 --large-objects-batch-size 10 \
+         --drop-if-exists --dir /tmp/pgcopydb-batch
+
 echo 'commit;' >&"${COPROC[1]}"
 echo '\q' >&"${COPROC[1]}"
 
 wait ${COPROC_PID}
 
-psql -d ${PGCOPYDB_TARGET_PGURI} -1 -c "${SQL}" > /tmp/target.lo
+psql -d ${PGCOPYDB_TARGET_PGURI} -1 -c "${SQL}" > /tmp/target-batch.lo
 
-diff /tmp/source.lo /tmp/target.lo
+diff /tmp/source.lo /tmp/target-batch.lo
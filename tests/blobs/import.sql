@@ -4,3 +4,7 @@
 \lo_import 'imgs/nam-anh-QJbyG6O0ick-unsplash.jpg'
 \lo_import 'imgs/redcharlie-Y--zr3CPaPs-unsplash.jpg'
 \lo_import 'imgs/richard-jacobs-8oenpCXktqQ-unsplash.jpg'
+
+-- many small large objects, copied in batches
+select lo_from_bytea(0, convert_to(repeat('pgcopydb ', x), 'UTF8'))
+  from generate_series(1, 100) as t(x);
@@ -86,6 +86,75 @@ pgcopydb stream apply --trace --resume /tmp/${SQLFILE}
 # now apply AGAIN the SQL file to the target database, skipping transactions
 pgcopydb stream apply --debug --resume /tmp/${SQLFILE}
 
+# transform the JSON file again, using the binary format this time, and
+# apply it: transactions are skipped again, the file must be parsed fine
+BINFILE=/tmp/binary/${SQLFILENAME}
+mkdir -p /tmp/binary
+
+pgcopydb stream transform --debug --transform-format binary \
+         ${SHAREDIR}/${WALFILE} ${BINFILE}
+
+pgcopydb stream apply --debug --resume ${BINFILE}
+
+#
+# now apply fresh changes from the binary format, and compare the target
+# rows with the result of applying the same changes from the SQL format
+#
+TYPESDDL="create table public.binary_types(id int8 primary key default 7, f float8, b bool, t text)"
+
+psql -d ${PGCOPYDB_SOURCE_PGURI} -c "${TYPESDDL}"
+psql -d ${PGCOPYDB_TARGET_PGURI} -c "${TYPESDDL}"
+
+psql -d ${PGCOPYDB_SOURCE_PGURI} <<EOF
+begin;
+insert into public.binary_types
+     values (1, 3.141592653589793, true, 'pi'),
+            (9223372036854775807, -1.5e-300, false, E'it''s a\ttab'),
+            (-42, null, null, null),
+            (3, 0, true, '');
+update public.binary_types set b = null, t = 'updated' where id = 3;
+delete from public.binary_types where id = 1;
+commit;
+
+insert into public.binary_types default values;
+EOF
+
+lsn=`psql -At -d ${PGCOPYDB_SOURCE_PGURI} -c 'select pg_current_wal_lsn()'`
+
+pgcopydb stream receive --debug --resume --endpos "${lsn}"
+
+FRESHWAL=`ls -1 ${SHAREDIR}/*.json | sort | tail -1`
+FRESHSQL=/tmp/fresh/`basename ${FRESHWAL} .json`.sql
+FRESHBIN=/tmp/fresh/binary/`basename ${FRESHWAL} .json`.sql
+mkdir -p /tmp/fresh/binary
+
+pgcopydb stream transform --debug ${FRESHWAL} ${FRESHSQL}
+
+pgcopydb stream transform --debug --transform-format binary \
+         ${FRESHWAL} ${FRESHBIN}
+
+origin="select pg_replication_origin_progress('pgcopydb', true)"
+prevlsn=`psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${origin}"`
+
+rows="select * from public.binary_types order by id"
+
+pgcopydb stream apply --debug --resume --endpos "${lsn}" ${FRESHBIN}
+psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${rows}" > /tmp/fresh/binary.out
+
+# rewind the replication origin and apply the same changes from SQL
+psql -d ${PGCOPYDB_TARGET_PGURI} -c 'truncate public.binary_types'
+psql -At -d ${PGCOPYDB_TARGET_PGURI} \
+     -c "select pg_replication_origin_advance('pgcopydb', '${prevlsn}')"
+
+pgcopydb stream apply --debug --resume --endpos "${lsn}" ${FRESHSQL}
+psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${rows}" > /tmp/fresh/sql.out
+psql -At -d ${PGCOPYDB_SOURCE_PGURI} -c "${rows}" > /tmp/fresh/source.out
+
+test `wc -l < /tmp/fresh/binary.out` -eq 4
+
+diff /tmp/fresh/sql.out /tmp/fresh/binary.out
+diff /tmp/fresh/source.out /tmp/fresh/binary.out
+
 #
 # switching to "live streaming" tests, using unix pipes
 #
@@ -124,9 +193,84 @@ done
 # and check that the last time there nothing more to do
 pgcopydb stream replay --resume --endpos "${lsn}"
 
+#
+# in live replay, a single committed row must reach the target well before
+# the next KEEPALIVE message, which is sent every 10s
+#
+pgcopydb stream sentinel set endpos 0/0
+
+pgcopydb stream replay --resume &
+REPLAY_PID=$!
+
+sleep 2
+
+psql -d ${PGCOPYDB_SOURCE_PGURI} \
+     -c "insert into public.binary_types(id, t) values (100, 'live')"
+
+sql="select count(*) from public.binary_types where id = 100"
+
+for i in `seq 30`
+do
+    if [ `psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${sql}"` -eq 1 ]
+    then
+        break
+    fi
+    sleep 0.1
+done
+
+test `psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${sql}"` -eq 1
+
+pgcopydb stream sentinel set endpos --current
+wait ${REPLAY_PID}
+
+# now apply changes using several connections to the target database
+psql -d ${PGCOPYDB_SOURCE_PGURI} -f /usr/src/pgcopydb/dml.sql
+
+lsn=`psql -At -d ${PGCOPYDB_SOURCE_PGURI} -c 'select pg_current_wal_lsn()'`
+
+pgcopydb stream replay --verbose --resume --apply-jobs 2 --endpos "${lsn}"
+pgcopydb stream sentinel get
+
+# parent and child rows inserted in separate transactions must be applied
+# in order even with several connections to the target database
+FKDDL="create table public.fk_parent(id int primary key);
+create table public.fk_child(id int primary key,
+                             pid int not null references public.fk_parent(id));"
+
+psql -d ${PGCOPYDB_SOURCE_PGURI} -c "${FKDDL}"
+psql -d ${PGCOPYDB_TARGET_PGURI} -c "${FKDDL}"
+
+for i in `seq 20`
+do
+    echo "insert into public.fk_parent(id) values (${i});"
+    echo "insert into public.fk_child(id, pid) values (${i}, ${i});"
+done | psql -d ${PGCOPYDB_SOURCE_PGURI}
+
+lsn=`psql -At -d ${PGCOPYDB_SOURCE_PGURI} -c 'select pg_current_wal_lsn()'`
+
+pgcopydb stream replay --verbose --resume --apply-jobs 2 --endpos "${lsn}"
+
+sql="select count(*) from public.fk_child"
+test `psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${sql}"` -eq 20
+
+# a bulk INSERT in a single transaction is applied from files using COPY
+psql -d ${PGCOPYDB_SOURCE_PGURI} <<EOF
+insert into public.actor(first_name, last_name)
+     select 'COPY', 'Actor ' || x from generate_series(1, 5000) as t(x);
+EOF
+
+lsn=`psql -At -d ${PGCOPYDB_SOURCE_PGURI} -c 'select pg_current_wal_lsn()'`
+
+pgcopydb stream prefetch --resume --endpos "${lsn}"
+pgcopydb stream catchup --resume --endpos "${lsn}"
+
+sql="select count(*) from public.actor where first_name = 'COPY'"
+test `psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${sql}"` -eq 5000
+
 # pipeline deadlock test
-# reset the replication origin to 0/0 to execute the pipeline-deadlock.sql
-psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "select pg_replication_origin_advance('pgcopydb', '0/0');"
+# reset the replication origins to 0/0 to execute the pipeline-deadlock.sql
+sql="select pg_replication_origin_advance(roname, '0/0') from pg_replication_origin where roname = 'pgcopydb' or roname like 'pgcopydb\\_apply\\_%'"
+psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${sql}"
 pgcopydb stream apply /usr/src/pgcopydb/pipeline-deadlock.sql
 
 # cleanup
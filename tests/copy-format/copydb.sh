@@ -0,0 +1,52 @@
+#!/bin/bash
+
+set -x
+set -e
+
+# Disable pager for psql to avoid hanging in non-interactive environments
+export PAGER=cat
+
+# This script expects the following environment variables to be set:
+#
+#  - PGCOPYDB_SOURCE_PGURI
+#  - PGCOPYDB_TARGET_PGURI
+
+# make sure source and target databases are ready
+pgcopydb ping
+
+psql -d ${PGCOPYDB_SOURCE_PGURI} -f /usr/src/pgcopydb/ddl.sql
+
+pgcopydb clone --copy-format auto --notice
+
+# check the COPY format that has been used for each table
+db=${TMPDIR:-/tmp}/pgcopydb/schema/source.db
+
+sql="
+select t.relname, s.copy_format
+  from summary s join s_table t on t.oid = s.tableoid
+ where s.tableoid is not null
+   and s.indexoid is null
+   and s.conoid is null
+order by t.relname
+"
+
+sqlite3 -batch -separator ' ' ${db} "${sql}" > /tmp/formats.out
+
+cat > /tmp/formats.expected <<END
+blobs binary
+grants text
+measures binary
+moods text
+notes text
+END
+
+diff /tmp/formats.expected /tmp/formats.out
+
+# check that the data made it to the target
+for t in blobs measures notes moods grants
+do
+    sql="select md5(string_agg(t::text, ',' order by id)) from ${t} t"
+    src=$(psql -At -d ${PGCOPYDB_SOURCE_PGURI} -c "${sql}")
+    dst=$(psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${sql}")
+    test "${src}" = "${dst}"
+done
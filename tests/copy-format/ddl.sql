@@ -0,0 +1,63 @@
+create type mood as enum ('sad', 'ok', 'happy');
+
+create table blobs
+ (
+   id bigint primary key,
+   payload bytea
+ );
+
+insert into blobs
+     select x, decode(md5(x::text), 'hex')
+       from generate_series(1, 1000) as t(x);
+
+create table measures
+ (
+   id bigint primary key,
+   value numeric,
+   measured_at timestamptz
+ );
+
+insert into measures
+     select x, x * 1.5, '2024-01-01'::timestamptz + x * interval '1 min'
+       from generate_series(1, 1000) as t(x);
+
+create table notes
+ (
+   id bigint primary key,
+   title text,
+   body text
+ );
+
+insert into notes
+     select x, 'title ' || x, repeat('body ', x % 10)
+       from generate_series(1, 1000) as t(x);
+
+create table moods
+ (
+   id bigint primary key,
+   payload bytea,
+   mood mood
+ );
+
+insert into moods
+     select x, decode(md5(x::text), 'hex'), 'happy'
+       from generate_series(1, 1000) as t(x);
+
+--
+-- the aclitem data type has no binary send and receive functions: the table
+-- is first copied in binary format because of its bytea column, and then
+-- copied again in text format
+--
+create table grants
+ (
+   id bigint primary key,
+   payload bytea,
+   acl aclitem
+ );
+
+insert into grants
+     select x, decode(md5(x::text), 'hex'),
+            makeaclitem(r.oid, r.oid, 'SELECT', false)
+       from generate_series(1, 1000) as t(x),
+            pg_roles r
+      where r.rolname = current_user;
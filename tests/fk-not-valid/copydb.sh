@@ -19,9 +19,11 @@ pgcopydb ping
 #
 # Create test schema on source with FK constraints.
 #
-# We test two scenarios:
+# We test three scenarios:
 #  1. A FK constraint with orphaned data (should be created as NOT VALID)
 #  2. A FK constraint with clean data (should be created normally as VALID)
+#  3. A FK constraint on a partitioned table, which Postgres before 18 does
+#     not accept NOT VALID (should be created as VALID in a single step)
 #
 psql -d ${PGCOPYDB_SOURCE_PGURI} <<'SQL'
 
@@ -63,6 +65,29 @@ INSERT INTO upgate_transaction (assigned_user_id) VALUES
 INSERT INTO valid_parent VALUES (1, 'vp1'), (2, 'vp2');
 INSERT INTO valid_child VALUES (1, 1), (2, 2);
 
+-- Partitioned table with a FK constraint
+CREATE TABLE event_owner (
+    id integer PRIMARY KEY,
+    name text
+);
+
+CREATE TABLE event (
+    id integer,
+    owner_id integer,
+    created date,
+    CONSTRAINT event_owner_id_fkey
+        FOREIGN KEY (owner_id) REFERENCES event_owner(id)
+) PARTITION BY RANGE (created);
+
+CREATE TABLE event_2024 PARTITION OF event
+    FOR VALUES FROM ('2024-01-01') TO ('2025-01-01');
+
+CREATE TABLE event_2025 PARTITION OF event
+    FOR VALUES FROM ('2025-01-01') TO ('2026-01-01');
+
+INSERT INTO event_owner VALUES (1, 'eo1'), (2, 'eo2');
+INSERT INTO event VALUES (1, 1, '2024-06-01'), (2, 2, '2025-06-01');
+
 -- Create orphaned references by bypassing FK checks via session_replication_role.
 -- This simulates how real orphaned data accumulates in production databases.
 SET session_replication_role = 'replica';
@@ -161,6 +186,21 @@ if [ "${valid_fk}" != "t" ]; then
     exit 1
 fi
 
+#
+# Verify FK constraint on the partitioned table is fully VALID.
+#
+partitioned_fk=$(psql -AtX -d ${PGCOPYDB_TARGET_PGURI} -c \
+  "SELECT convalidated FROM pg_constraint
+   WHERE conname = 'event_owner_id_fkey'
+     AND conrelid = 'event'::regclass")
+
+echo "Partitioned table FK constraint VALID: ${partitioned_fk}"
+
+if [ "${partitioned_fk}" != "t" ]; then
+    echo "ERROR: FK constraint on partitioned table should be VALID!"
+    exit 1
+fi
+
 #
 # Verify total FK constraint count matches source.
 #
@@ -203,4 +243,5 @@ echo "  - ${tgt_txn_count} rows copied (including ${tgt_orphan_count} orphans)"
 echo "  - ${tgt_fk_count} FK constraints created"
 echo "  - Violated FK constraint created as NOT VALID"
 echo "  - Clean FK constraint created as VALID"
+echo "  - Partitioned table FK constraint created as VALID"
 echo "  - Future writes correctly enforced on NOT VALID constraint"
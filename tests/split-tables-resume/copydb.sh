@@ -0,0 +1,138 @@
+#!/bin/bash
+
+set -x
+set -e
+
+# Disable pager for psql to avoid hanging in non-interactive environments
+export PAGER=cat
+
+# This script expects the following environment variables to be set:
+#
+#  - PGCOPYDB_SOURCE_PGURI
+#  - PGCOPYDB_TARGET_PGURI
+#  - PGCOPYDB_TABLE_JOBS
+#  - PGCOPYDB_INDEX_JOBS
+
+# make sure source and target databases are ready
+pgcopydb ping
+
+psql -d ${PGCOPYDB_SOURCE_PGURI} -f /usr/src/pgcopydb/ddl.sql
+
+pgcopydb clone --split-tables-larger-than 4MB --notice
+
+db=${TMPDIR:-/tmp}/pgcopydb/schema/source.db
+
+sqlite3 -batch ${db} "select oid, partnum, min, max, step, claimed, copied
+                        from s_table_part order by oid, partnum"
+
+#
+# Now pretend that the COPY of the first two parts of each table has been
+# committed on the target, entirely for part 1 and up to a step for part 2,
+# but the run was killed before registering that progress in our catalogs.
+# Resuming the copy must not duplicate any rows on the target.
+#
+sqlite3 -batch ${db} <<END
+update s_table_part
+   set copied = case when partnum = 1 then min else min + step end
+ where partnum in (1, 2);
+
+update summary
+   set pid = 999999999, done_time_epoch = null
+ where partnum in (1, 2)
+   and indexoid is null
+   and conoid is null;
+
+delete from s_table_parts_done;
+delete from timings;
+END
+
+pgcopydb copy table-data --resume --not-consistent --notice
+
+# check that the data made it to the target, exactly once
+for t in split_by_id split_by_ctid
+do
+    sql="select count(*), md5(string_agg(t::text, ',' order by id)) from ${t} t"
+    src=$(psql -At -d ${PGCOPYDB_SOURCE_PGURI} -c "${sql}")
+    dst=$(psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${sql}")
+    test "${src}" = "${dst}"
+done
+
+#
+# With --freeze, the first part of each split table copies the whole table
+# in a single COPY FREEZE command, and the other parts have nothing to copy.
+#
+freezedir=${TMPDIR:-/tmp}/pgcopydb-freeze
+
+pgcopydb copy table-data --freeze --split-tables-larger-than 4MB \
+         --dir ${freezedir} --not-consistent --notice
+
+db=${freezedir}/schema/source.db
+
+sql="select count(*) from summary
+      where tableoid is not null and indexoid is null and conoid is null
+        and not freeze"
+
+test `sqlite3 -batch ${db} "${sql}"` -eq 0
+
+for t in split_by_id split_by_ctid
+do
+    sql="select count(*), md5(string_agg(t::text, ',' order by id)) from ${t} t"
+    src=$(psql -At -d ${PGCOPYDB_SOURCE_PGURI} -c "${sql}")
+    dst=$(psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${sql}")
+    test "${src}" = "${dst}"
+done
+
+#
+# Tables listed in the [concurrent-index-table] section have their indexes
+# built with CREATE INDEX CONCURRENTLY while their other parts are copied.
+#
+cicdir=${TMPDIR:-/tmp}/pgcopydb-cic
+
+pgcopydb clone --drop-if-exists --split-tables-larger-than 4MB \
+         --filters /usr/src/pgcopydb/concurrent.ini \
+         --dir ${cicdir} --not-consistent --notice
+
+indexes="select count(*), count(*) filter(where not i.indisvalid)
+           from pg_index i join pg_class c on c.oid = i.indrelid
+          where c.relname in ('split_by_id', 'split_by_ctid')"
+
+src=$(psql -At -d ${PGCOPYDB_SOURCE_PGURI} -c "${indexes}")
+dst=$(psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${indexes}")
+test "${src}" = "${dst}"
+
+#
+# A failed CREATE INDEX CONCURRENTLY leaves an invalid index behind, which
+# must be dropped and built again when resuming.
+#
+psql -d ${PGCOPYDB_TARGET_PGURI} -c "drop index public.split_by_ctid_id_idx"
+
+psql -d ${PGCOPYDB_TARGET_PGURI} \
+     -c "create unique index concurrently split_by_ctid_id_idx
+                on public.split_by_ctid((id % 2))" || true
+
+test `psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${indexes}" | cut -d'|' -f2` -eq 1
+
+sqlite3 -batch ${cicdir}/schema/source.db <<END
+delete from summary
+ where indexoid in (select oid from s_index
+                     where relname = 'split_by_ctid_id_idx');
+
+delete from timings;
+END
+
+pgcopydb copy indexes --resume --not-consistent --dir ${cicdir} --notice
+
+dst=$(psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${indexes}")
+test "${src}" = "${dst}"
+
+#
+# With --shared-index-scan the indexes of a table are built at the same time,
+# using at most --index-jobs connections to the target database.
+#
+sharedir=${TMPDIR:-/tmp}/pgcopydb-shared
+
+pgcopydb clone --drop-if-exists --shared-index-scan --index-jobs 2 \
+         --dir ${sharedir} --not-consistent --notice
+
+dst=$(psql -At -d ${PGCOPYDB_TARGET_PGURI} -c "${indexes}")
+test "${src}" = "${dst}"
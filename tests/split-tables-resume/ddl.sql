@@ -0,0 +1,28 @@
+create table split_by_id
+ (
+   id bigint primary key,
+   payload text
+ );
+
+insert into split_by_id
+     select x, repeat(md5(x::text), 4)
+       from generate_series(1, 200000) as t(x);
+
+--
+-- without a primary key or unique integer column, the table is split by
+-- ctid ranges
+--
+create table split_by_ctid
+ (
+   id bigint,
+   payload text
+ );
+
+insert into split_by_ctid
+     select x, repeat(md5(x::text), 4)
+       from generate_series(1, 200000) as t(x);
+
+create index split_by_ctid_id_idx on split_by_ctid(id);
+
+create index split_by_id_payload_idx on split_by_id(payload);
+create index split_by_id_md5_idx on split_by_id(md5(payload));